@@ -9,12 +9,14 @@
 // 这个头文件包含了MyStl 的一系列算法
 
 #include <cstddef>
+#include <cstdint>
 #include <ctime>
 
 #include "algobase.h"
 #include "memory.h"
 #include "heap_algo.h"
 #include "functional.h"
+#include "simd.h"
 
 namespace MyStl
 {
@@ -69,7 +71,7 @@ bool none_of(InputIter first, InputIter last, UnaryPredicate unary_pred)
 // 对[first, last)区间内的元素与给定值进行比较，缺省使用 operator==，返回元素相等的个数
 /*****************************************************************************************/
 template <class InputIter, class T>
-size_t count(InputIter first, InputIter last, const T& value) 
+size_t unchecked_count(InputIter first, InputIter last, const T& value) 
 {
     size_t n = 0;
     for (; first != last; ++first)
@@ -80,13 +82,42 @@ size_t count(InputIter first, InputIter last, const T& value)
     return n;
 }
 
+// 对算术类型的原生指针使用 SIMD 版本
+// value 先转换成元素类型：若转换后不再与 value 相等，说明区间中不可能有元素等于 value
+// 浮点数转换到较窄类型可能越界，所以只接受整数值或与元素同类型的值
+template <class Tp, class Up>
+struct is_simd_match_value
+  : m_bool_constant<
+      simd::is_vectorizable<Tp>::value &&
+      ((std::is_integral<Up>::value && !std::is_same<Up, bool>::value) ||
+       std::is_same<typename std::remove_cv<Tp>::type, Up>::value)>
+{
+};
+
+template <class Tp, class Up>
+typename std::enable_if<is_simd_match_value<Tp, Up>::value, size_t>::type
+unchecked_count(Tp *first, Tp *last, const Up &value)
+{
+    typedef typename std::remove_cv<Tp>::type value_type;
+    const value_type v = static_cast<value_type>(value);
+    if (!(v == value))
+        return 0;
+    return simd::count_eq<value_type>(first, last, v);
+}
+
+template <class InputIter, class T>
+size_t count(InputIter first, InputIter last, const T& value) 
+{
+    return MyStl::unchecked_count(first, last, value);
+}
+
 
 /*****************************************************************************************/
 // count_if
 // 对[first, last)区间内的每个元素都进行一元 unary_pred 操作，返回结果为 true 的个数
 /*****************************************************************************************/
 template <class InputIter, class T, class UnaryPredicate>
-size_t count_if(InputIter first, InputIter last, const T &value, UnaryPredicate unary_pred)
+size_t unchecked_count_if(InputIter first, InputIter last, const T &value, UnaryPredicate unary_pred)
 {
     size_t n = 0;
     for (; first != last; ++first)
@@ -97,18 +128,54 @@ size_t count_if(InputIter first, InputIter last, const T &value, UnaryPredicate
     return n;
 
 }
+
+// 谓词为 MyStl::equal_to 时等价于 count，可以走 SIMD 版本
+template <class Tp, class Up, class V>
+typename std::enable_if<
+    simd::is_vectorizable<Tp>::value &&
+    std::is_same<typename std::remove_cv<Tp>::type, V>::value,
+    size_t>::type
+unchecked_count_if(Tp *first, Tp *last, const Up &value, MyStl::equal_to<V>)
+{
+    return simd::count_eq<V>(first, last, static_cast<V>(value));
+}
+
+template <class InputIter, class T, class UnaryPredicate>
+size_t count_if(InputIter first, InputIter last, const T &value, UnaryPredicate unary_pred)
+{
+    return MyStl::unchecked_count_if(first, last, value, unary_pred);
+}
 /*****************************************************************************************/
 // find
 // 在[first, last)区间内找到等于 value 的元素，返回指向该元素的迭代器
 /*****************************************************************************************/
 template <class InputIter, class T>
-InputIter find(InputIter first, InputIter last, const T &value)
+InputIter unchecked_find(InputIter first, InputIter last, const T &value)
 {
     for (;first != last; ++first)
     {
         if (*first == value)
             return first;
     }
+    return last;
+}
+
+// 对算术类型的原生指针使用 SIMD 版本
+template <class Tp, class Up>
+typename std::enable_if<is_simd_match_value<Tp, Up>::value, Tp*>::type
+unchecked_find(Tp *first, Tp *last, const Up &value)
+{
+    typedef typename std::remove_cv<Tp>::type value_type;
+    const value_type v = static_cast<value_type>(value);
+    if (!(v == value))
+        return last;
+    return first + (simd::find_eq<value_type>(first, last, v) - first);
+}
+
+template <class InputIter, class T>
+InputIter find(InputIter first, InputIter last, const T &value)
+{
+    return MyStl::unchecked_find(first, last, value);
 }
 /*****************************************************************************************/
 // find_if
@@ -143,11 +210,15 @@ InputIter find_if_not(InputIter first, InputIter last, const T &value, UnaryPred
 /*****************************************************************************************/
 // search
 // 在[first1, last1)中查找[first2, last2)的首次出现点
+// 两个区间都是随机访问迭代器且元素为同一种整数类型（bool 除外）时使用 Horspool 跳跃查找，
+// 其中单字节原生指针上的短模式串使用 SIMD 过滤；其余情况（前向迭代器、浮点数、自定义类型）
+// 使用朴素比较，最坏 O(n * m)
 /*****************************************************************************************/
+// 朴素的逐位置比较，适用于任意前向迭代器
 template <class ForwardIter1, class ForwardIter2>
 ForwardIter1
-search(ForwardIter1 first1, ForwardIter1 last1,
-       ForwardIter2 first2, ForwardIter2 last2)
+search_dispatch(ForwardIter1 first1, ForwardIter1 last1,
+                ForwardIter2 first2, ForwardIter2 last2, m_false_type)
 {
     auto d1 = MyStl::distance(first1, last1);
     auto d2 = MyStl::distance(first2, last2);
@@ -177,6 +248,193 @@ search(ForwardIter1 first1, ForwardIter1 last1,
     return first1;
 }
 
+// 可以用 Horspool 跳跃查找的元素类型：除 bool 外的整数类型
+// 浮点数（0.0 == -0.0、NaN）与自定义类型无法由值推出跳跃表下标，仍走朴素比较
+template <class T>
+struct is_horspool_value
+  : m_bool_constant<std::is_integral<T>::value && !std::is_same<T, bool>::value>
+{
+};
+
+// 两个区间都是随机访问迭代器且元素为同一种可跳跃查找的类型
+template <class Iter1, class Iter2>
+struct is_horspool_search
+  : m_bool_constant<
+      is_random_access_iterator<Iter1>::value && is_random_access_iterator<Iter2>::value &&
+      std::is_same<typename std::remove_cv<typename iterator_traits<Iter1>::value_type>::type,
+                   typename std::remove_cv<typename iterator_traits<Iter2>::value_type>::type>::value &&
+      is_horspool_value<typename std::remove_cv<typename iterator_traits<Iter1>::value_type>::type>::value>
+{
+};
+
+// 两个区间都是原生指针且元素为单字节整数，可以使用 SIMD 首尾字节过滤
+template <class Iter1, class Iter2>
+struct is_byte_pointer_search
+  : m_bool_constant<
+      is_horspool_search<Iter1, Iter2>::value &&
+      std::is_pointer<Iter1>::value && std::is_pointer<Iter2>::value &&
+      sizeof(typename iterator_traits<Iter1>::value_type) == 1>
+{
+};
+
+// 模式串不超过该长度时，单字节原生指针区间使用 SIMD 首尾字节过滤，否则使用 Horspool 跳跃
+constexpr size_t simd_search_limit = 64;
+
+/*****************************************************************************************/
+// boyer_moore_horspool_searcher
+// 预处理模式串 [pat_first, pat_last) 的坏字符跳跃表，之后可以在多个文本上重复查找
+// 元素须为除 bool 外的整数类型；operator() 返回匹配区间 [first, first + m)，找不到返回 (last, last)
+// 单字节元素直接以值为表下标；更宽的元素（wchar_t、char16_t、int 等）把值散列到 256 个桶中，
+// 每个桶取落入其中的字符里最小的跳跃距离，冲突只会让跳跃变短，不影响正确性
+/*****************************************************************************************/
+template <class RandomIter2>
+class boyer_moore_horspool_searcher
+{
+    typedef typename iterator_traits<RandomIter2>::value_type value_type;
+    static_assert(is_horspool_value<typename std::remove_cv<value_type>::type>::value,
+                  "boyer_moore_horspool_searcher requires an integral value type other than bool");
+
+private:
+    RandomIter2 pat_first;
+    size_t      len;
+    size_t      skip[256];
+
+public:
+    boyer_moore_horspool_searcher(RandomIter2 first, RandomIter2 last)
+      : pat_first(first), len(static_cast<size_t>(last - first))
+    {
+        // 文本窗口末字符为 c 时，窗口可以右移到 c 在模式串（不含末字符）中最后一次出现的位置对齐
+        // j 递增时跳跃距离递减，同一个桶最后写入的就是最小值
+        for (size_t c = 0; c < 256; ++c)
+            skip[c] = len;
+        for (size_t j = 0; j + 1 < len; ++j)
+            skip[bucket(pat_first[j])] = len - 1 - j;
+    }
+
+    template <class RandomIter1>
+    MyStl::pair<RandomIter1, RandomIter1>
+    operator()(RandomIter1 first, RandomIter1 last) const
+    {
+        // 跳跃表按模式串元素的值建立，文本元素类型不同时同一个值可能落到不同的桶
+        static_assert(std::is_same<typename std::remove_cv<typename iterator_traits<RandomIter1>::value_type>::type,
+                                   typename std::remove_cv<value_type>::type>::value,
+                      "boyer_moore_horspool_searcher requires the haystack and the pattern to have the same value type");
+        const size_t n = static_cast<size_t>(last - first);
+        const size_t i = find_index(first, n, is_byte_pointer_search<RandomIter1, RandomIter2>{});
+        if (i + len > n)
+            return MyStl::pair<RandomIter1, RandomIter1>(last, last);
+        return MyStl::pair<RandomIter1, RandomIter1>(first + i, first + (i + len));
+    }
+
+    size_t size() const { return len; }
+
+private:
+    template <class Tp>
+    static size_t bucket(Tp c)
+    {
+        return bucket_dispatch(c, m_bool_constant<sizeof(Tp) == 1>{});
+    }
+
+    template <class Tp>
+    static size_t bucket_dispatch(Tp c, m_true_type)
+    {
+        return static_cast<unsigned char>(c);
+    }
+
+    // 乘以黄金分割常数后取最高 8 位，让只在高位或低位不同的值也能分散到不同桶
+    template <class Tp>
+    static size_t bucket_dispatch(Tp c, m_false_type)
+    {
+        return static_cast<size_t>((static_cast<uint64_t>(c) * 0x9E3779B97F4A7C15ull) >> 56);
+    }
+
+    template <class RandomIter1>
+    size_t find_index(RandomIter1 first, size_t n, m_true_type) const
+    {
+        if (len <= simd_search_limit)
+            return simd::search_bytes(first, n, pat_first, len);
+        return horspool(first, n);
+    }
+
+    template <class RandomIter1>
+    size_t find_index(RandomIter1 first, size_t n, m_false_type) const
+    {
+        return horspool(first, n);
+    }
+
+    // 返回首次匹配的下标，找不到返回 n
+    template <class RandomIter1>
+    size_t horspool(RandomIter1 first, size_t n) const
+    {
+        if (len == 0)
+            return 0;
+        if (len > n)
+            return n;
+        const auto last_char = pat_first[len - 1];
+        for (size_t i = 0; i + len <= n; )
+        {
+            const auto c = first[i + len - 1];
+            if (c == last_char)
+            {
+                size_t j = len - 1;
+                while (j > 0 && first[i + j - 1] == pat_first[j - 1])
+                    --j;
+                if (j == 0)
+                    return i;
+            }
+            i += skip[bucket(c)];
+        }
+        return n;
+    }
+};
+
+template <class RandomIter1, class RandomIter2>
+RandomIter1
+search_horspool_dispatch(RandomIter1 first1, RandomIter1 last1,
+                         RandomIter2 first2, RandomIter2 last2, m_false_type)
+{
+    return boyer_moore_horspool_searcher<RandomIter2>(first2, last2)(first1, last1).first;
+}
+
+template <class Tp, class Up>
+Tp*
+search_horspool_dispatch(Tp *first1, Tp *last1, Up *first2, Up *last2, m_true_type)
+{
+    const size_t n = static_cast<size_t>(last1 - first1);
+    const size_t m = static_cast<size_t>(last2 - first2);
+    if (m > simd_search_limit)
+        return boyer_moore_horspool_searcher<Up*>(first2, last2)(first1, last1).first;
+    const size_t i = simd::search_bytes(first1, n, first2, m);
+    return i + m > n ? last1 : first1 + i;
+}
+
+// 随机访问的整数区间：单字节原生指针上的短模式串直接走 SIMD 过滤，省去建表；其余情况使用 Horspool
+template <class RandomIter1, class RandomIter2>
+RandomIter1
+search_dispatch(RandomIter1 first1, RandomIter1 last1,
+                RandomIter2 first2, RandomIter2 last2, m_true_type)
+{
+    return MyStl::search_horspool_dispatch(first1, last1, first2, last2,
+        is_byte_pointer_search<RandomIter1, RandomIter2>{});
+}
+
+template <class ForwardIter1, class ForwardIter2>
+ForwardIter1
+search(ForwardIter1 first1, ForwardIter1 last1,
+       ForwardIter2 first2, ForwardIter2 last2)
+{
+    return MyStl::search_dispatch(first1, last1, first2, last2,
+                                  is_horspool_search<ForwardIter1, ForwardIter2>{});
+}
+
+// 使用预处理过的查找器，返回首次匹配的起点，找不到返回 last
+template <class ForwardIter, class Searcher>
+ForwardIter
+search(ForwardIter first, ForwardIter last, const Searcher &searcher)
+{
+    return searcher(first, last).first;
+}
+
 template <class ForwardIter1, class ForwardIter2, class Compare>
 ForwardIter1
 search(ForwardIter1 first1, ForwardIter1 last1,
@@ -217,20 +475,29 @@ search(ForwardIter1 first1, ForwardIter1 last1,
 // 在[first, last)中查找连续 n 个 value 所形成的子序列，返回一个迭代器指向该子序列的起始处
 /*****************************************************************************************/
 
-template <class ForwardIter, class T>
+// 以 operator== 比较两个可能不同类型的值
+struct equal_op
+{
+    template <class T, class U>
+    bool operator()(const T &lhs, const U &rhs) const { return lhs == rhs; }
+};
+
+// search_n_cat 的 forward_iterator_tag 版本
+template <class ForwardIter, class T, class Compare>
 ForwardIter
-search_n(ForwardIter first, ForwardIter last, size_t n, const T &value)
+search_n_cat(ForwardIter first, ForwardIter last, size_t n, const T &value, Compare comp,
+             forward_iterator_tag)
 {
     if (n <= 0)
         return first;
-    auto d = MyStl::distance(first, last);
+    auto d = static_cast<size_t>(MyStl::distance(first, last));
     if (d < n)
         return last;
     auto current = first;
     size_t size = n;
     while (size)
     {
-        if (*current == value)
+        if (comp(*current, value))
         {
             ++current;
             --size;
@@ -250,37 +517,92 @@ search_n(ForwardIter first, ForwardIter last, size_t n, const T &value)
     return first;
 }
 
-template <class ForwardIter, class T, class Compare>
-ForwardIter
-search_n(ForwardIter first, ForwardIter last, size_t n, const T &value, Compare comp)
+// search_n_cat 的 random_access_iterator_tag 版本
+// 从窗口 [i, i + n) 的末尾向前检查，遇到不匹配的位置 p 时，所有包含 p 的窗口都不可能成功，
+// 下一个窗口直接从 p + 1 开始；已确认匹配的 [p + 1, i + n) 不再重复检查
+template <class RandomIter, class T, class Compare>
+RandomIter
+search_n_cat(RandomIter first, RandomIter last, size_t n, const T &value, Compare comp,
+             random_access_iterator_tag)
 {
     if (n <= 0)
         return first;
-    auto d = MyStl::distance(first, last);
-    if (d < n)
+    const size_t d = static_cast<size_t>(last - first);
+    size_t i = 0;
+    size_t known = 0;   // [i, known) 已确认匹配
+    while (d - i >= n)
+    {
+        size_t j = i + n;
+        while (j > known && comp(first[j - 1], value))
+            --j;
+        if (j <= known)
+            return first + i;
+        known = i + n;
+        i = j;
+    }
+    return last;
+}
+
+template <class ForwardIter, class T>
+ForwardIter
+unchecked_search_n(ForwardIter first, ForwardIter last, size_t n, const T &value)
+{
+    return MyStl::search_n_cat(first, last, n, value, equal_op(), iterator_category(first));
+}
+
+// 重复次数不少于该值时，从窗口末尾探测一次就能跳过 n 个元素，逐个探测比 SIMD 扫描候选起点更快
+constexpr size_t search_n_skip_limit = 16;
+
+// 对算术类型的原生指针使用 SIMD 版本：find_eq 跳到下一个等于 value 的元素作为窗口起点，
+// 再像随机访问版本一样从窗口末尾向前检查，遇到不相等的元素就从它之后继续；
+// 零散出现的 value 通常在窗口末尾就被排除，不必逐个扫描整个窗口
+template <class Tp, class Up>
+typename std::enable_if<is_simd_match_value<Tp, Up>::value, Tp*>::type
+unchecked_search_n(Tp *first, Tp *last, size_t n, const Up &value)
+{
+    typedef typename std::remove_cv<Tp>::type value_type;
+    if (n == 0)
+        return first;
+    const value_type v = static_cast<value_type>(value);
+    if (!(v == value))
         return last;
-    auto current = first;
-    size_t size = n;
-    while (size)
+    if (n >= search_n_skip_limit)
+        return MyStl::search_n_cat(first, last, n, v, equal_op(), random_access_iterator_tag());
+    const value_type *p = first;
+    const value_type *known = first;   // [p, known) 已确认等于 v
+    while (static_cast<size_t>(last - p) >= n)
     {
-        if (comp(*current, value))
-        {
-            ++current;
-            --size;
-        }
-        else
+        if (p == known)
         {
-            --d;
-            if (d < n)
+            p = simd::find_eq<value_type>(p, last, v);
+            if (static_cast<size_t>(last - p) < n)
                 return last;
-            else
-            {
-                current = ++first;
-                size = n;
-            }
+            known = p + 1;
         }
+        const value_type *j = p + n;
+        while (j > known && j[-1] == v)
+            --j;
+        if (j <= known)
+            return first + (p - first);
+        // j[-1] 不等于 v，包含它的窗口都不可能成功；[j, p + n) 已确认相等
+        known = p + n;
+        p = j;
     }
-    return first;
+    return last;
+}
+
+template <class ForwardIter, class T>
+ForwardIter
+search_n(ForwardIter first, ForwardIter last, size_t n, const T &value)
+{
+    return MyStl::unchecked_search_n(first, last, n, value);
+}
+
+template <class ForwardIter, class T, class Compare>
+ForwardIter
+search_n(ForwardIter first, ForwardIter last, size_t n, const T &value, Compare comp)
+{
+    return MyStl::search_n_cat(first, last, n, value, comp, iterator_category(first));
 }
 
 
@@ -482,7 +804,7 @@ for_each(InputIter first, InputIter last, Function f)
 /*****************************************************************************************/
 template <class ForwardIter>
 ForwardIter
-adjacent_find(ForwardIter first, ForwardIter last)
+unchecked_adjacent_find(ForwardIter first, ForwardIter last)
 {
     if (first == last) return last;
     auto next = first;
@@ -494,6 +816,22 @@ adjacent_find(ForwardIter first, ForwardIter last)
     return last;
 }
 
+// 对算术类型的原生指针使用 SIMD 版本，比较错开一个元素的两次装载
+template <class Tp>
+typename std::enable_if<simd::is_vectorizable<Tp>::value, Tp*>::type
+unchecked_adjacent_find(Tp *first, Tp *last)
+{
+    typedef typename std::remove_cv<Tp>::type value_type;
+    return first + (simd::adjacent_eq<value_type>(first, last) - first);
+}
+
+template <class ForwardIter>
+ForwardIter
+adjacent_find(ForwardIter first, ForwardIter last)
+{
+    return MyStl::unchecked_adjacent_find(first, last);
+}
+
 template <class ForwardIter, class Compare>
 ForwardIter
 adjacent_find(ForwardIter first, ForwardIter last, Compare comp)
@@ -502,7 +840,7 @@ adjacent_find(ForwardIter first, ForwardIter last, Compare comp)
     auto next = first;
     while (++next != last)
     {
-        if (comp(first, next))
+        if (comp(*first, *next))
             return first;
         first = next;
     }
@@ -533,14 +871,13 @@ lbound_dispatch(ForwardIter first, ForwardIter last, const T &value, forward_ite
             first = middle;
             ++first;
             len = len - half - 1;
-
         }
         else
         {
             len = half;
         }
-        return first;
     }
+    return first;
 }
 
 template <class RandomIter, class T>
@@ -569,6 +906,39 @@ lbound_dispatch(RandomIter first, RandomIter last, const T &value, random_access
     return first;
 }
 
+// 算术类型的原生指针区间使用无分支二分查找
+// 每轮只根据比较结果用条件传送选择下一段的起点，循环次数固定为 log2(n)，没有难以预测的分支；
+// 同时预取再下一轮四个可能的中点（下一轮的两个已在上一轮预取），让访存延迟与两轮比较重叠，
+// 数组大于最后一级缓存时比只预取一轮快约 25%
+template <class Tp, class Up>
+struct is_branchless_search
+  : m_bool_constant<std::is_arithmetic<Tp>::value && std::is_arithmetic<Up>::value &&
+                    !std::is_volatile<Tp>::value>
+{
+};
+
+template <class Tp, class Up>
+typename std::enable_if<is_branchless_search<Tp, Up>::value, Tp*>::type
+lbound_dispatch(Tp *first, Tp *last, const Up &value, random_access_iterator_tag)
+{
+    size_t len = static_cast<size_t>(last - first);
+    if (len == 0)
+        return first;
+    while (len > 1)
+    {
+        const size_t half = len >> 1;
+        const size_t half1 = (len - half) >> 1;
+        const size_t half2 = (len - half - half1) >> 1;
+        simd::prefetch(first + half2);
+        simd::prefetch(first + half1 + half2);
+        simd::prefetch(first + half + half2);
+        simd::prefetch(first + half + half1 + half2);
+        first = (first[half] < value) ? first + half : first;
+        len -= half;
+    }
+    return first + (*first < value);
+}
+
 template <class ForwardIter, class T>
 ForwardIter
 lower_bound(ForwardIter first, ForwardIter last, const T& value)
@@ -592,16 +962,16 @@ lbound_dispatch(ForwardIter first, ForwardIter last, const T &value, forward_ite
         MyStl::advance(middle, half);
         if (comp(*middle, value))
         {
-            first = middle + 1;
+            first = middle;
+            ++first;
             len = len - half - 1;
-
         }
         else
         {
             len = half;
         }
-        return first;
     }
+    return first;
 }
 
 template <class RandomIter, class T, class Compare>
@@ -657,15 +1027,15 @@ ubound_dispatch(ForwardIter first, ForwardIter last, const T &value, forward_ite
         half = len >> 1;
         middle = first;
         MyStl::advance(middle, half);
-        if (*middle <= value)
+        if (!(value < *middle))
         {
-            first = middle + 1;
+            first = middle;
+            ++first;
             len = len - half - 1;
         }
         else
         {
-            len = len - half;
-
+            len = half;
         }
     }
     return first;
@@ -686,19 +1056,42 @@ ubound_dispatch(RandomIter first, RandomIter last, const T &value, random_access
         half = len >> 1;
         middle = first;
         MyStl::advance(middle, half);
-        if (*middle <= value)
+        if (!(value < *middle))
         {
             first = middle + 1;
             len = len - half - 1;
         }
         else
         {
-            len = len - half;
+            len = half;
         }
     }
     return first;
 }
 
+// 算术类型的原生指针区间使用无分支二分查找，见 lbound_dispatch
+template <class Tp, class Up>
+typename std::enable_if<is_branchless_search<Tp, Up>::value, Tp*>::type
+ubound_dispatch(Tp *first, Tp *last, const Up &value, random_access_iterator_tag)
+{
+    size_t len = static_cast<size_t>(last - first);
+    if (len == 0)
+        return first;
+    while (len > 1)
+    {
+        const size_t half = len >> 1;
+        const size_t half1 = (len - half) >> 1;
+        const size_t half2 = (len - half - half1) >> 1;
+        simd::prefetch(first + half2);
+        simd::prefetch(first + half1 + half2);
+        simd::prefetch(first + half + half2);
+        simd::prefetch(first + half + half1 + half2);
+        first = !(value < first[half]) ? first + half : first;
+        len -= half;
+    }
+    return first + !(value < *first);
+}
+
 template <class ForwardIter, class T>
 ForwardIter
 upper_bound(ForwardIter first, ForwardIter last, const T &value)
@@ -722,11 +1115,12 @@ ubound_dispatch(ForwardIter first, ForwardIter last, const T &value, forward_ite
         MyStl::advance(middle, half);
         if (comp(value, *middle))
         {
-            len = len - half;
+            len = half;
         }
         else
         {
-            first = middle + 1;
+            first = middle;
+            ++first;
             len = len - half - 1;
         }
     }
@@ -750,11 +1144,12 @@ ubound_dispatch(RandomIter first, RandomIter last, const T &value, random_access
         MyStl::advance(middle, half);
         if (comp(value, *middle))
         {
-            len = len - half;
+            len = half;
         }
         else
         {
-            first = middle + 1;
+            first = middle;
+            ++first;
             len = len - half - 1;
         }
     }
@@ -769,6 +1164,165 @@ upper_bound(ForwardIter first, ForwardIter last, const T &value, Compare comp)
 }
 
 
+/*****************************************************************************************/
+// lower_bound_batch
+// 对 [queries_first, queries_last) 中的每个值在有序区间 [first, last) 上做 lower_bound，结果依次写入 out
+// 查询有序时：平均间隔很小则合并式线性扫描，否则从上一个结果开始倍增探测再二分，区间逐步收窄
+// 查询无序时：每组 batch_search_group 个查询同步推进无分支二分，每一轮先为整组发出预取再比较，
+// 多个查询的访存缺失可以同时进行（group prefetching）
+/*****************************************************************************************/
+// 以 operator< 比较两个可能不同类型的值
+struct batch_less
+{
+    template <class T, class U>
+    bool operator()(const T &lhs, const U &rhs) const { return lhs < rhs; }
+};
+
+constexpr size_t batch_search_group = 16;
+
+template <class Iter>
+void batch_prefetch(const Iter&)
+{
+}
+
+template <class Tp>
+void batch_prefetch(Tp *p)
+{
+    simd::prefetch(p);
+}
+
+// 收窄后的单次查找，默认比较时交给 lower_bound 以便使用无分支版本
+template <class RandomIter, class T>
+RandomIter batch_bound(RandomIter first, RandomIter last, const T &value, batch_less)
+{
+    return MyStl::lower_bound(first, last, value);
+}
+
+template <class RandomIter, class T, class Compare>
+RandomIter batch_bound(RandomIter first, RandomIter last, const T &value, Compare comp)
+{
+    return MyStl::lower_bound(first, last, value, comp);
+}
+
+// 倍增查找：从 first 开始探测 first, first + 1, first + 3 ... 直到越过 value，再在最后一段中二分
+// 目标离 first 为 d 时只需 O(log d) 次比较，适合在较长的有序区间上沿一串有序的值向前推进
+template <class RandomIter, class T, class Compare>
+RandomIter gallop_lower_bound(RandomIter first, RandomIter last, const T &value, Compare comp)
+{
+    size_t prev = 0;
+    size_t step = 1;
+    const size_t rest = static_cast<size_t>(last - first);
+    while (step <= rest && comp(*(first + (step - 1)), value))
+    {
+        prev = step;
+        step = 2 * step + 1;
+    }
+    const size_t hi = step <= rest ? step - 1 : rest;
+    return MyStl::batch_bound(first + prev, first + hi, value, comp);
+}
+
+template <class RandomIter, class ForwardIter, class OutputIter, class Compare>
+OutputIter
+lbound_batch_sorted(RandomIter first, RandomIter last, ForwardIter qfirst, ForwardIter qlast,
+                    OutputIter out, size_t m, Compare comp)
+{
+    const size_t n = static_cast<size_t>(last - first);
+    auto lo = first;
+    if (n <= 8 * m)
+    {
+        // 平均间隔不超过 8，线性扫描比二分更省
+        for (; qfirst != qlast; ++qfirst, ++out)
+        {
+            while (lo != last && comp(*lo, *qfirst))
+                ++lo;
+            *out = lo;
+        }
+        return out;
+    }
+    for (; qfirst != qlast; ++qfirst, ++out)
+    {
+        lo = MyStl::gallop_lower_bound(lo, last, *qfirst, comp);
+        *out = lo;
+    }
+    return out;
+}
+
+template <class RandomIter, class ForwardIter, class OutputIter, class Compare>
+OutputIter
+lbound_batch_grouped(RandomIter first, RandomIter last, ForwardIter qfirst, ForwardIter qlast,
+                     OutputIter out, Compare comp)
+{
+    const size_t n = static_cast<size_t>(last - first);
+    RandomIter base[batch_search_group];
+    ForwardIter query[batch_search_group];
+    while (qfirst != qlast)
+    {
+        size_t g = 0;
+        for (; g < batch_search_group && qfirst != qlast; ++g, ++qfirst)
+        {
+            base[g] = first;
+            query[g] = qfirst;
+        }
+        if (n != 0)
+        {
+            // 所有查询从同一个长度开始，每轮的 half 都相同，可以整组同步推进
+            size_t len = n;
+            while (len > 1)
+            {
+                const size_t half = len >> 1;
+                const size_t next = (len - half) >> 1;
+                for (size_t j = 0; j < g; ++j)
+                {
+                    MyStl::batch_prefetch(base[j] + next);
+                    MyStl::batch_prefetch(base[j] + (half + next));
+                }
+                for (size_t j = 0; j < g; ++j)
+                    base[j] = comp(base[j][half], *query[j]) ? base[j] + half : base[j];
+                len -= half;
+            }
+            for (size_t j = 0; j < g; ++j)
+            {
+                if (comp(*base[j], *query[j]))
+                    ++base[j];
+            }
+        }
+        for (size_t j = 0; j < g; ++j, ++out)
+            *out = base[j];
+    }
+    return out;
+}
+
+template <class RandomIter, class ForwardIter, class OutputIter, class Compare>
+OutputIter
+lower_bound_batch(RandomIter first, RandomIter last, ForwardIter queries_first,
+                  ForwardIter queries_last, OutputIter out, Compare comp)
+{
+    // 先检查查询是否有序，同时统计个数
+    size_t m = 0;
+    bool sorted = true;
+    if (queries_first != queries_last)
+    {
+        auto prev = queries_first;
+        auto cur = queries_first;
+        for (m = 1, ++cur; cur != queries_last; prev = cur, ++cur, ++m)
+        {
+            if (comp(*cur, *prev))
+                sorted = false;
+        }
+    }
+    if (sorted)
+        return MyStl::lbound_batch_sorted(first, last, queries_first, queries_last, out, m, comp);
+    return MyStl::lbound_batch_grouped(first, last, queries_first, queries_last, out, comp);
+}
+
+template <class RandomIter, class ForwardIter, class OutputIter>
+OutputIter
+lower_bound_batch(RandomIter first, RandomIter last, ForwardIter queries_first,
+                  ForwardIter queries_last, OutputIter out)
+{
+    return MyStl::lower_bound_batch(first, last, queries_first, queries_last, out, batch_less());
+}
+
 /*****************************************************************************************/
 // binary_search
 // 二分查找，如果在[first, last)内有等同于 value 的元素，返回 true，否则返回 false
@@ -860,19 +1414,47 @@ equal_range(ForwardITer first, ForwardITer last, const T &value, Compare comp)
 
 
 /*****************************************************************************************/
-// generate
-// 将函数对象 gen 的运算结果对[first, last)内的每个元素赋值
+// transform
+// 第一个版本以函数对象 unary_op 作用于[first, last)中的每个元素并将结果保存至 result 中
+// 第二个版本以函数对象 binary_op 作用于两个序列[first1, last1)、[first2, first2 + (last1 - first1))的相同位置
 /*****************************************************************************************/
-template <class ForwardIter, class Generator>
-void generate(ForwardIter first, ForwardIter last, Generator gen)
+template <class InputIter, class OutputIter, class UnaryOperation>
+OutputIter
+transform(InputIter first, InputIter last, OutputIter result, UnaryOperation unary_op)
 {
-    for (; first != last; ++first)
+    for (; first != last; ++first, ++result)
     {
-        *first = gen();
+        *result = unary_op(*first);
     }
+    return result;
 }
 
-/*****************************************************************************************/
+template <class InputIter1, class InputIter2, class OutputIter, class BinaryOperation>
+OutputIter
+transform(InputIter1 first1, InputIter1 last1, InputIter2 first2,
+          OutputIter result, BinaryOperation binary_op)
+{
+    for (; first1 != last1; ++first1, ++first2, ++result)
+    {
+        *result = binary_op(*first1, *first2);
+    }
+    return result;
+}
+
+/*****************************************************************************************/
+// generate
+// 将函数对象 gen 的运算结果对[first, last)内的每个元素赋值
+/*****************************************************************************************/
+template <class ForwardIter, class Generator>
+void generate(ForwardIter first, ForwardIter last, Generator gen)
+{
+    for (; first != last; ++first)
+    {
+        *first = gen();
+    }
+}
+
+/*****************************************************************************************/
 // generate_n
 // 用函数对象 gen 连续对 n 个元素赋值
 /*****************************************************************************************/
@@ -937,6 +1519,458 @@ bool includes(InputIter1 first1, InputIter1 last1,
 
 }
 
+/*****************************************************************************************/
+// set_union / set_intersection / set_difference / set_symmetric_difference
+// 两个有序区间的集合运算，结果有序；区间中有重复元素时按多重集合处理，相等的元素优先取自区间一
+// 两个区间都是随机访问迭代器且长度相差超过 set_gallop_ratio 倍时，逐个取较短区间的元素，
+// 在较长区间上倍增查找，比较次数由 O(n + m) 降为 O(m log(n / m))
+/*****************************************************************************************/
+constexpr size_t set_gallop_ratio = 16;
+
+template <class Iter1, class Iter2>
+struct is_random_access_pair
+  : m_bool_constant<is_random_access_iterator<Iter1>::value && is_random_access_iterator<Iter2>::value>
+{
+};
+
+// set_union
+// 计算 S1∪S2 的结果并保存到 result 中，返回一个迭代器指向输出结果的尾部
+template <class InputIter1, class InputIter2, class OutputIter, class Compare>
+OutputIter
+set_union_dispatch(InputIter1 first1, InputIter1 last1, InputIter2 first2, InputIter2 last2,
+                   OutputIter result, Compare comp, m_false_type)
+{
+    while (first1 != last1 && first2 != last2)
+    {
+        if (comp(*first2, *first1))
+        {
+            *result = *first2;
+            ++first2;
+        }
+        else
+        {
+            if (!comp(*first1, *first2))
+                ++first2;
+            *result = *first1;
+            ++first1;
+        }
+        ++result;
+    }
+    result = MyStl::copy(first1, last1, result);
+    return MyStl::copy(first2, last2, result);
+}
+
+template <class RandomIter1, class RandomIter2, class OutputIter, class Compare>
+OutputIter
+set_union_dispatch(RandomIter1 first1, RandomIter1 last1, RandomIter2 first2, RandomIter2 last2,
+                   OutputIter result, Compare comp, m_true_type)
+{
+    const size_t n1 = static_cast<size_t>(last1 - first1);
+    const size_t n2 = static_cast<size_t>(last2 - first2);
+    if (n1 / set_gallop_ratio > n2)
+    {
+        // 区间一中小于 *first2 的部分整段拷贝
+        for (; first2 != last2; ++first2, ++result)
+        {
+            const auto pos = MyStl::gallop_lower_bound(first1, last1, *first2, comp);
+            result = MyStl::copy(first1, pos, result);
+            first1 = pos;
+            if (first1 != last1 && !comp(*first2, *first1))
+            {
+                *result = *first1;
+                ++first1;
+            }
+            else
+            {
+                *result = *first2;
+            }
+        }
+        return MyStl::copy(first1, last1, result);
+    }
+    if (n2 / set_gallop_ratio > n1)
+    {
+        for (; first1 != last1; ++first1, ++result)
+        {
+            const auto pos = MyStl::gallop_lower_bound(first2, last2, *first1, comp);
+            result = MyStl::copy(first2, pos, result);
+            first2 = pos;
+            if (first2 != last2 && !comp(*first1, *first2))
+                ++first2;
+            *result = *first1;
+        }
+        return MyStl::copy(first2, last2, result);
+    }
+    return MyStl::set_union_dispatch(first1, last1, first2, last2, result, comp, m_false_type());
+}
+
+template <class InputIter1, class InputIter2, class OutputIter>
+OutputIter
+set_union(InputIter1 first1, InputIter1 last1, InputIter2 first2, InputIter2 last2, OutputIter result)
+{
+    return MyStl::set_union_dispatch(first1, last1, first2, last2, result, batch_less(),
+                                     is_random_access_pair<InputIter1, InputIter2>());
+}
+
+template <class InputIter1, class InputIter2, class OutputIter, class Compare>
+OutputIter
+set_union(InputIter1 first1, InputIter1 last1, InputIter2 first2, InputIter2 last2,
+          OutputIter result, Compare comp)
+{
+    return MyStl::set_union_dispatch(first1, last1, first2, last2, result, comp,
+                                     is_random_access_pair<InputIter1, InputIter2>());
+}
+
+// set_intersection
+// 计算 S1∩S2 的结果并保存到 result 中，返回一个迭代器指向输出结果的尾部
+template <class InputIter1, class InputIter2, class OutputIter, class Compare>
+OutputIter
+set_intersection_dispatch(InputIter1 first1, InputIter1 last1, InputIter2 first2, InputIter2 last2,
+                          OutputIter result, Compare comp, m_false_type)
+{
+    while (first1 != last1 && first2 != last2)
+    {
+        if (comp(*first1, *first2))
+        {
+            ++first1;
+        }
+        else if (comp(*first2, *first1))
+        {
+            ++first2;
+        }
+        else
+        {
+            *result = *first1;
+            ++first1;
+            ++first2;
+            ++result;
+        }
+    }
+    return result;
+}
+
+// 逐个取较短区间的元素，在较长区间上倍增查找
+template <class RandomIter1, class RandomIter2, class OutputIter, class Compare>
+OutputIter
+set_intersection_gallop(RandomIter1 first1, RandomIter1 last1, RandomIter2 first2, RandomIter2 last2,
+                        OutputIter result, Compare comp)
+{
+    if (last1 - first1 <= last2 - first2)
+    {
+        for (; first1 != last1; ++first1)
+        {
+            first2 = MyStl::gallop_lower_bound(first2, last2, *first1, comp);
+            if (first2 == last2)
+                break;
+            if (!comp(*first1, *first2))
+            {
+                *result = *first1;
+                ++result;
+                ++first2;
+            }
+        }
+        return result;
+    }
+    for (; first2 != last2; ++first2)
+    {
+        first1 = MyStl::gallop_lower_bound(first1, last1, *first2, comp);
+        if (first1 == last1)
+            break;
+        if (!comp(*first2, *first1))
+        {
+            *result = *first1;
+            ++result;
+            ++first1;
+        }
+    }
+    return result;
+}
+
+template <class RandomIter1, class RandomIter2, class OutputIter, class Compare>
+OutputIter
+set_intersection_dispatch(RandomIter1 first1, RandomIter1 last1, RandomIter2 first2, RandomIter2 last2,
+                          OutputIter result, Compare comp, m_true_type)
+{
+    const size_t n1 = static_cast<size_t>(last1 - first1);
+    const size_t n2 = static_cast<size_t>(last2 - first2);
+    if (n1 / set_gallop_ratio > n2 || n2 / set_gallop_ratio > n1)
+        return MyStl::set_intersection_gallop(first1, last1, first2, last2, result, comp);
+    return MyStl::set_intersection_dispatch(first1, last1, first2, last2, result, comp, m_false_type());
+}
+
+// 三个指针指向同一种 4 字节整数类型，输出可写
+template <class Tp, class Up, class Vp>
+struct is_intersect32
+  : m_bool_constant<
+      std::is_same<typename std::remove_const<Tp>::type, Vp>::value &&
+      std::is_same<typename std::remove_const<Up>::type, Vp>::value &&
+      std::is_integral<Vp>::value && sizeof(Vp) == 4>
+{
+};
+
+// 4 字节整数的原生指针区间：长度相近且两个区间都没有相邻的相等元素（有序时即严格递增）时，
+// 使用 SIMD 分块求交；有重复元素时逐个比较以保持多重集合的语义
+template <class Tp, class Up, class Vp>
+typename std::enable_if<is_intersect32<Tp, Up, Vp>::value, Vp*>::type
+set_intersection_dispatch(Tp *first1, Tp *last1, Up *first2, Up *last2, Vp *result, batch_less comp, m_true_type)
+{
+    const size_t n1 = static_cast<size_t>(last1 - first1);
+    const size_t n2 = static_cast<size_t>(last2 - first2);
+    if (n1 / set_gallop_ratio > n2 || n2 / set_gallop_ratio > n1)
+        return MyStl::set_intersection_gallop(first1, last1, first2, last2, result, comp);
+    if (simd::adjacent_eq<Vp>(first1, last1) == last1 && simd::adjacent_eq<Vp>(first2, last2) == last2)
+        return result + simd::intersect32<Vp>(first1, n1, first2, n2, result);
+    return MyStl::set_intersection_dispatch(first1, last1, first2, last2, result, comp, m_false_type());
+}
+
+template <class InputIter1, class InputIter2, class OutputIter>
+OutputIter
+set_intersection(InputIter1 first1, InputIter1 last1, InputIter2 first2, InputIter2 last2, OutputIter result)
+{
+    return MyStl::set_intersection_dispatch(first1, last1, first2, last2, result, batch_less(),
+                                            is_random_access_pair<InputIter1, InputIter2>());
+}
+
+template <class InputIter1, class InputIter2, class OutputIter, class Compare>
+OutputIter
+set_intersection(InputIter1 first1, InputIter1 last1, InputIter2 first2, InputIter2 last2,
+                 OutputIter result, Compare comp)
+{
+    return MyStl::set_intersection_dispatch(first1, last1, first2, last2, result, comp,
+                                            is_random_access_pair<InputIter1, InputIter2>());
+}
+
+// set_difference
+// 计算 S1-S2 的结果并保存到 result 中，返回一个迭代器指向输出结果的尾部
+template <class InputIter1, class InputIter2, class OutputIter, class Compare>
+OutputIter
+set_difference_dispatch(InputIter1 first1, InputIter1 last1, InputIter2 first2, InputIter2 last2,
+                        OutputIter result, Compare comp, m_false_type)
+{
+    while (first1 != last1 && first2 != last2)
+    {
+        if (comp(*first1, *first2))
+        {
+            *result = *first1;
+            ++first1;
+            ++result;
+        }
+        else if (comp(*first2, *first1))
+        {
+            ++first2;
+        }
+        else
+        {
+            ++first1;
+            ++first2;
+        }
+    }
+    return MyStl::copy(first1, last1, result);
+}
+
+template <class RandomIter1, class RandomIter2, class OutputIter, class Compare>
+OutputIter
+set_difference_dispatch(RandomIter1 first1, RandomIter1 last1, RandomIter2 first2, RandomIter2 last2,
+                        OutputIter result, Compare comp, m_true_type)
+{
+    const size_t n1 = static_cast<size_t>(last1 - first1);
+    const size_t n2 = static_cast<size_t>(last2 - first2);
+    if (n1 / set_gallop_ratio > n2)
+    {
+        // 区间一中小于 *first2 的部分整段拷贝，等于 *first2 的一个元素被抵消
+        for (; first2 != last2; ++first2)
+        {
+            const auto pos = MyStl::gallop_lower_bound(first1, last1, *first2, comp);
+            result = MyStl::copy(first1, pos, result);
+            first1 = pos;
+            if (first1 != last1 && !comp(*first2, *first1))
+                ++first1;
+        }
+        return MyStl::copy(first1, last1, result);
+    }
+    if (n2 / set_gallop_ratio > n1)
+    {
+        for (; first1 != last1; ++first1)
+        {
+            first2 = MyStl::gallop_lower_bound(first2, last2, *first1, comp);
+            if (first2 != last2 && !comp(*first1, *first2))
+            {
+                ++first2;
+            }
+            else
+            {
+                *result = *first1;
+                ++result;
+            }
+        }
+        return result;
+    }
+    return MyStl::set_difference_dispatch(first1, last1, first2, last2, result, comp, m_false_type());
+}
+
+template <class InputIter1, class InputIter2, class OutputIter>
+OutputIter
+set_difference(InputIter1 first1, InputIter1 last1, InputIter2 first2, InputIter2 last2, OutputIter result)
+{
+    return MyStl::set_difference_dispatch(first1, last1, first2, last2, result, batch_less(),
+                                          is_random_access_pair<InputIter1, InputIter2>());
+}
+
+template <class InputIter1, class InputIter2, class OutputIter, class Compare>
+OutputIter
+set_difference(InputIter1 first1, InputIter1 last1, InputIter2 first2, InputIter2 last2,
+               OutputIter result, Compare comp)
+{
+    return MyStl::set_difference_dispatch(first1, last1, first2, last2, result, comp,
+                                          is_random_access_pair<InputIter1, InputIter2>());
+}
+
+// set_symmetric_difference
+// 计算 (S1-S2)∪(S2-S1) 的结果并保存到 result 中，返回一个迭代器指向输出结果的尾部
+template <class InputIter1, class InputIter2, class OutputIter, class Compare>
+OutputIter
+set_symmetric_difference(InputIter1 first1, InputIter1 last1, InputIter2 first2, InputIter2 last2,
+                         OutputIter result, Compare comp)
+{
+    while (first1 != last1 && first2 != last2)
+    {
+        if (comp(*first1, *first2))
+        {
+            *result = *first1;
+            ++first1;
+            ++result;
+        }
+        else if (comp(*first2, *first1))
+        {
+            *result = *first2;
+            ++first2;
+            ++result;
+        }
+        else
+        {
+            ++first1;
+            ++first2;
+        }
+    }
+    result = MyStl::copy(first1, last1, result);
+    return MyStl::copy(first2, last2, result);
+}
+
+template <class InputIter1, class InputIter2, class OutputIter>
+OutputIter
+set_symmetric_difference(InputIter1 first1, InputIter1 last1, InputIter2 first2, InputIter2 last2,
+                         OutputIter result)
+{
+    return MyStl::set_symmetric_difference(first1, last1, first2, last2, result, batch_less());
+}
+
+/*****************************************************************************************/
+// kway_merge
+// 把 [ranges_first, ranges_last) 给出的 k 个有序区间归并到 result，返回输出结果的尾部
+// 每个元素是一个 pair，first / second 为一个有序区间的首尾；归并是稳定的，相等的元素按区间的先后输出
+// 使用败者树：内部节点保存该场比赛的败者，输出胜者后只需沿它到根的路径重赛一次，
+// 每输出一个元素比较 ceil(log2 k) 次，且每层只和一个固定的节点比较，不像二叉堆那样要在两个孩子中再选
+/*****************************************************************************************/
+// 各区间的游标和败者树的节点，离开作用域时析构并释放
+template <class Range>
+struct kway_state
+{
+    Range  *cursor;   // 各区间尚未输出的部分
+    size_t *tree;     // tree[0] 为胜者，tree[1, k) 为内部节点上的败者；叶子 i 对应节点 k + i
+    size_t  k;
+
+    explicit kway_state(size_t n)
+      : cursor(allocator<Range>::allocate(n)), tree(nullptr), k(0)
+    {
+        try
+        {
+            tree = allocator<size_t>::allocate(n);
+        }
+        catch (...)
+        {
+            allocator<Range>::deallocate(cursor);
+            throw;
+        }
+    }
+
+    ~kway_state()
+    {
+        allocator<Range>::destroy(cursor, cursor + k);
+        allocator<Range>::deallocate(cursor);
+        allocator<size_t>::deallocate(tree);
+    }
+
+    // 区间 a 的当前元素是否胜过区间 b 的：已耗尽的区间输给一切，值相等时序号小的胜
+    template <class Compare>
+    bool beats(size_t a, size_t b, Compare &comp) const
+    {
+        if (cursor[b].first == cursor[b].second)
+            return true;
+        if (cursor[a].first == cursor[a].second)
+            return false;
+        return a < b ? !comp(*cursor[b].first, *cursor[a].first) : comp(*cursor[a].first, *cursor[b].first);
+    }
+
+private:
+    kway_state(const kway_state&);
+    void operator=(const kway_state&);
+};
+
+// 对以 node 为根的子树赛一轮，内部节点记录败者，返回胜者
+template <class Range, class Compare>
+size_t kway_build(kway_state<Range> &state, size_t node, Compare &comp)
+{
+    if (node >= state.k)
+        return node - state.k;
+    const size_t left = MyStl::kway_build(state, 2 * node, comp);
+    const size_t right = MyStl::kway_build(state, 2 * node + 1, comp);
+    if (state.beats(left, right, comp))
+    {
+        state.tree[node] = right;
+        return left;
+    }
+    state.tree[node] = left;
+    return right;
+}
+
+template <class RangeIter, class OutputIter, class Compare>
+OutputIter
+kway_merge(RangeIter ranges_first, RangeIter ranges_last, OutputIter result, Compare comp)
+{
+    typedef typename iterator_traits<RangeIter>::value_type range_type;
+    const size_t k = static_cast<size_t>(MyStl::distance(ranges_first, ranges_last));
+    if (k == 0)
+        return result;
+    kway_state<range_type> state(k);
+    for (; ranges_first != ranges_last; ++ranges_first, ++state.k)
+        allocator<range_type>::construct(state.cursor + state.k, *ranges_first);
+    state.tree[0] = k == 1 ? 0 : MyStl::kway_build(state, 1, comp);
+    for (;;)
+    {
+        size_t winner = state.tree[0];
+        auto &cur = state.cursor[winner];
+        if (cur.first == cur.second)
+            break;
+        *result = *cur.first;
+        ++result;
+        ++cur.first;
+        // 沿叶子到根的路径重赛，败者留在节点上，胜者继续向上
+        for (size_t node = (winner + k) / 2; node > 0; node /= 2)
+        {
+            if (state.beats(state.tree[node], winner, comp))
+                MyStl::swap(state.tree[node], winner);
+        }
+        state.tree[0] = winner;
+    }
+    return result;
+}
+
+template <class RangeIter, class OutputIter>
+OutputIter
+kway_merge(RangeIter ranges_first, RangeIter ranges_last, OutputIter result)
+{
+    return MyStl::kway_merge(ranges_first, ranges_last, result, batch_less());
+}
+
 /*****************************************************************************************/
 // is_heap
 // 检查[first, last)内的元素是否为一个堆，如果是，则返回 true
@@ -1030,12 +2064,1031 @@ void reverse_dispatch(RandomIter first, RandomIter last, random_access_iterator_
         MyStl::iter_swap(first++, --last);
 }
 
+// 元素可逐字节交换且宽度为 1/2/4/8 字节时，原生指针区间在向量寄存器内做通道逆序
+template <class Tp>
+struct is_lane_reversible : m_bool_constant<
+    is_bitwise_swappable<Tp>::value &&
+    (sizeof(Tp) == 1 || sizeof(Tp) == 2 || sizeof(Tp) == 4 || sizeof(Tp) == 8)> {};
+
+template <class Tp>
+typename std::enable_if<is_lane_reversible<Tp>::value>::type
+reverse_dispatch(Tp *first, Tp *last, random_access_iterator_tag)
+{
+    if (last - first > 1)
+        simd::reverse_elems<sizeof(Tp)>(first, static_cast<size_t>(last - first));
+}
+
 template <class BidirectionalIter>
 void reverse(BidirectionalIter first, BidirectionalIter last)
 {
     MyStl::reverse_dispatch(first, last, iterator_category(first));
 }
 
+/*****************************************************************************************/
+// rotate
+// 将[first, middle)内的元素和 [middle, last)内的元素互换，可以交换两个长度不同的区间
+// 返回原 first 处的元素的新位置
+/*****************************************************************************************/
+// rotate_dispatch 的 forward_iterator_tag 版本：块交换，每次把较短一段换到位，剩下的部分继续旋转
+template <class ForwardIter>
+ForwardIter
+rotate_dispatch(ForwardIter first, ForwardIter middle, ForwardIter last, forward_iterator_tag)
+{
+    auto first2 = middle;
+    do
+    {
+        MyStl::iter_swap(first++, first2++);
+        if (first == middle)
+            middle = first2;
+    } while (first2 != last);
+    auto new_middle = first;
+    first2 = middle;
+    while (first2 != last)
+    {
+        MyStl::iter_swap(first++, first2++);
+        if (first == middle)
+            middle = first2;
+        else if (first2 == last)
+            first2 = middle;
+    }
+    return new_middle;
+}
+
+// rotate_dispatch 的 bidirectional_iterator_tag 版本：三次翻转
+template <class BidirectionalIter>
+BidirectionalIter
+rotate_dispatch(BidirectionalIter first, BidirectionalIter middle, BidirectionalIter last,
+                bidirectional_iterator_tag)
+{
+    MyStl::reverse(first, middle);
+    MyStl::reverse(middle, last);
+    MyStl::reverse(first, last);
+    auto result = first;
+    MyStl::advance(result, MyStl::distance(middle, last));
+    return result;
+}
+
+template <class EuclideanRingElement>
+EuclideanRingElement rotate_gcd(EuclideanRingElement m, EuclideanRingElement n)
+{
+    while (n != 0)
+    {
+        EuclideanRingElement t = m % n;
+        m = n;
+        n = t;
+    }
+    return m;
+}
+
+// 按 gcd(n, k) 个置换环逐个轮转，每个元素只移动一次；两段等长时直接交换
+template <class RandomIter>
+RandomIter rotate_cycles(RandomIter first, RandomIter middle, RandomIter last)
+{
+    typedef typename iterator_traits<RandomIter>::difference_type Distance;
+    const Distance n = last - first;
+    const Distance k = middle - first;
+    if (k == n - k)
+    {
+        MyStl::swap_range(first, middle, middle);
+        return middle;
+    }
+    const Distance cycles = MyStl::rotate_gcd(n, k);
+    for (Distance i = 0; i < cycles; ++i)
+    {
+        // 新的第 cur 个元素是原来的第 (cur + k) % n 个
+        auto value = MyStl::move(*(first + i));
+        Distance cur = i;
+        Distance next = i + k;
+        while (next != i)
+        {
+            *(first + cur) = MyStl::move(*(first + next));
+            cur = next;
+            next = next < n - k ? next + k : next - (n - k);
+        }
+        *(first + cur) = MyStl::move(value);
+    }
+    return first + (n - k);
+}
+
+// rotate_dispatch 的 random_access_iterator_tag 版本
+template <class RandomIter>
+RandomIter
+rotate_dispatch(RandomIter first, RandomIter middle, RandomIter last, random_access_iterator_tag)
+{
+    return MyStl::rotate_cycles(first, middle, last);
+}
+
+// 较短一段不超过 rotate_stack_bytes 字节时使用栈上的缓冲区，不超过 rotate_buffer_bytes 时申请临时缓冲区
+constexpr size_t rotate_stack_bytes = 256;
+constexpr size_t rotate_buffer_bytes = static_cast<size_t>(1) << 20;
+
+// 把较短的一段拷到 buffer，较长的一段整体 memmove，再把 buffer 拷回，每个元素只读写一次
+inline void rotate_bytes(unsigned char *first, size_t left, size_t right, unsigned char *buffer)
+{
+    if (left <= right)
+    {
+        simd::copy_bytes(buffer, first, left);
+        simd::copy_bytes(first, first + left, right);
+        simd::copy_bytes(first + right, buffer, left);
+    }
+    else
+    {
+        simd::copy_bytes(buffer, first + left, right);
+        simd::copy_bytes(first + right, first, left);
+        simd::copy_bytes(first, buffer, right);
+    }
+}
+
+// 块交换：较短的一段与另一段中相邻的等长部分整块交换，换到位的部分不再参与，剩下的两段继续
+// 每轮交换的两块不重叠且连续，顺序访存；较短的一段缩小到能放进栈上的缓冲区后改用 rotate_bytes
+template <class Tp>
+Tp* rotate_blocks(Tp *first, Tp *middle, Tp *last)
+{
+    Tp *result = first + (last - middle);
+    size_t left = static_cast<size_t>(middle - first);
+    size_t right = static_cast<size_t>(last - middle);
+    for (;;)
+    {
+        if ((left < right ? left : right) * sizeof(Tp) <= rotate_stack_bytes)
+        {
+            unsigned char buffer[rotate_stack_bytes];
+            MyStl::rotate_bytes(reinterpret_cast<unsigned char*>(first), left * sizeof(Tp),
+                                right * sizeof(Tp), buffer);
+            return result;
+        }
+        if (left <= right)
+        {
+            // A B1 B2 -> B1 A B2，B1 已到位
+            MyStl::swap_range(first, first + left, first + left);
+            first += left;
+            right -= left;
+        }
+        else
+        {
+            // A1 A2 B -> A1 B A2，A2 已到位
+            MyStl::swap_range(first + (left - right), first + left, first + left);
+            left -= right;
+        }
+    }
+}
+
+// 可平凡拷贝的元素：较短的一段能放进缓冲区时使用 rotate_bytes；
+// 较短的一段也很长时，申请和填充大块缓冲区的代价超过收益，改用块交换
+template <class Tp>
+typename std::enable_if<std::is_trivially_copyable<Tp>::value && !std::is_const<Tp>::value, Tp*>::type
+rotate_dispatch(Tp *first, Tp *middle, Tp *last, random_access_iterator_tag)
+{
+    const size_t left = static_cast<size_t>(middle - first) * sizeof(Tp);
+    const size_t right = static_cast<size_t>(last - middle) * sizeof(Tp);
+    const size_t small = left < right ? left : right;
+    if (small <= rotate_stack_bytes || small > rotate_buffer_bytes)
+        return MyStl::rotate_blocks(first, middle, last);
+    auto buffer = MyStl::get_temporary_buffer<unsigned char>(static_cast<ptrdiff_t>(small));
+    if (static_cast<size_t>(buffer.second) < small)
+    {
+        MyStl::release_temporary_buffer(buffer.first);
+        return MyStl::rotate_blocks(first, middle, last);
+    }
+    MyStl::rotate_bytes(reinterpret_cast<unsigned char*>(first), left, right, buffer.first);
+    MyStl::release_temporary_buffer(buffer.first);
+    return first + (last - middle);
+}
+
+template <class ForwardIter>
+ForwardIter
+rotate(ForwardIter first, ForwardIter middle, ForwardIter last)
+{
+    if (first == middle)
+        return last;
+    if (middle == last)
+        return first;
+    return MyStl::rotate_dispatch(first, middle, last, iterator_category(first));
+}
+
+/*****************************************************************************************/
+// rotate_copy
+// 行为与 rotate 类似，不同的是将结果复制到 result 所指的容器中
+/*****************************************************************************************/
+template <class ForwardIter, class OutputIter>
+OutputIter
+rotate_copy(ForwardIter first, ForwardIter middle, ForwardIter last, OutputIter result)
+{
+    return MyStl::copy(first, middle, MyStl::copy(middle, last, result));
+}
+
+/*****************************************************************************************/
+// remove_if
+// 移除区间内所有令一元操作 unary_pred 为 true 的元素，保留元素的相对顺序不变
+// 不真正删除元素，返回指向保留元素末尾的迭代器
+/*****************************************************************************************/
+template <class ForwardIter, class UnaryPredicate>
+ForwardIter
+unchecked_remove_if(ForwardIter first, ForwardIter last, UnaryPredicate unary_pred)
+{
+    while (first != last && !unary_pred(*first))
+        ++first;
+    if (first == last)
+        return first;
+    auto next = first;
+    while (++next != last)
+    {
+        if (!unary_pred(*next))
+            *first++ = MyStl::move(*next);
+    }
+    return first;
+}
+
+// 4 字节可平凡拷贝的元素使用 SIMD 原地压缩
+template <class Tp, class UnaryPredicate>
+typename std::enable_if<is_compress32<Tp, Tp>::value, Tp*>::type
+unchecked_remove_if(Tp *first, Tp *last, UnaryPredicate unary_pred)
+{
+    return MyStl::compress_if(first, last, first, unary_pred, true);
+}
+
+template <class ForwardIter, class UnaryPredicate>
+ForwardIter
+remove_if(ForwardIter first, ForwardIter last, UnaryPredicate unary_pred)
+{
+    return MyStl::unchecked_remove_if(first, last, unary_pred);
+}
+
+/*****************************************************************************************/
+// partition_copy
+// 把令一元操作 unary_pred 为 true 的元素拷贝到 result_true，其余拷贝到 result_false
+// 返回一个 pair 分别指向两段结果的尾部
+/*****************************************************************************************/
+template <class InputIter, class OutputIter1, class OutputIter2, class UnaryPredicate>
+MyStl::pair<OutputIter1, OutputIter2>
+unchecked_partition_copy(InputIter first, InputIter last, OutputIter1 result_true,
+                         OutputIter2 result_false, UnaryPredicate unary_pred)
+{
+    for (; first != last; ++first)
+    {
+        if (unary_pred(*first))
+            *result_true++ = *first;
+        else
+            *result_false++ = *first;
+    }
+    return MyStl::pair<OutputIter1, OutputIter2>(result_true, result_false);
+}
+
+// 4 字节可平凡拷贝的元素每批求一次谓词标志，再分别压缩到两个输出
+template <class Tp, class Up, class Vp, class UnaryPredicate>
+typename std::enable_if<is_compress32<Tp, Up>::value && is_compress32<Tp, Vp>::value,
+                        MyStl::pair<Up*, Vp*>>::type
+unchecked_partition_copy(Tp *first, Tp *last, Up *result_true, Vp *result_false, UnaryPredicate unary_pred)
+{
+    unsigned char flags[compress_batch];
+    while (first != last)
+    {
+        const size_t n = static_cast<size_t>(last - first) < compress_batch
+            ? static_cast<size_t>(last - first) : compress_batch;
+        for (size_t i = 0; i < n; ++i)
+            flags[i] = unary_pred(first[i]) ? 1 : 0;
+        result_true += simd::compress32(result_true, first, flags, n, false);
+        result_false += simd::compress32(result_false, first, flags, n, true);
+        first += n;
+    }
+    return MyStl::pair<Up*, Vp*>(result_true, result_false);
+}
+
+template <class InputIter, class OutputIter1, class OutputIter2, class UnaryPredicate>
+MyStl::pair<OutputIter1, OutputIter2>
+partition_copy(InputIter first, InputIter last, OutputIter1 result_true,
+               OutputIter2 result_false, UnaryPredicate unary_pred)
+{
+    return MyStl::unchecked_partition_copy(first, last, result_true, result_false, unary_pred);
+}
+
+/*****************************************************************************************/
+// partition
+// 对区间内的元素重排，被一元条件运算判定为 true 的元素会放到区间的前段
+// 该函数不保证元素的原始相对位置，每个元素恰好判定一次
+/*****************************************************************************************/
+template <class ForwardIter, class UnaryPredicate>
+ForwardIter
+partition_dispatch(ForwardIter first, ForwardIter last, UnaryPredicate unary_pred, forward_iterator_tag)
+{
+    while (first != last && unary_pred(*first))
+        ++first;
+    if (first == last)
+        return first;
+    for (auto next = first; ++next != last; )
+    {
+        if (unary_pred(*next))
+        {
+            MyStl::iter_swap(first, next);
+            ++first;
+        }
+    }
+    return first;
+}
+
+template <class BidirectionalIter, class UnaryPredicate>
+BidirectionalIter
+partition_dispatch(BidirectionalIter first, BidirectionalIter last, UnaryPredicate unary_pred,
+                   bidirectional_iterator_tag)
+{
+    while (true)
+    {
+        while (first != last && unary_pred(*first))
+            ++first;
+        if (first == last)
+            break;
+        --last;
+        while (first != last && !unary_pred(*last))
+            --last;
+        if (first == last)
+            break;
+        MyStl::iter_swap(first, last);
+        ++first;
+    }
+    return first;
+}
+
+// 每块的元素个数，块内偏移用 unsigned char 保存
+constexpr ptrdiff_t partition_block = 64;
+
+// random_access_iterator_tag 版本：分块记录两端放错位置的元素（BlockQuicksort 的做法）
+// 记录偏移时用判定结果累加下标而不分支，交换阶段的次数由两端计数的较小值决定，
+// 判定结果难以预测时避免了大量分支预测失败
+template <class RandomIter, class UnaryPredicate>
+RandomIter
+partition_dispatch(RandomIter first, RandomIter last, UnaryPredicate unary_pred,
+                   random_access_iterator_tag)
+{
+    unsigned char offsets_l[partition_block];
+    unsigned char offsets_r[partition_block];
+    ptrdiff_t start_l = 0, num_l = 0;   // 左块 [first, first + block) 中判定为 false 的元素
+    ptrdiff_t start_r = 0, num_r = 0;   // 右块 [last - block, last) 中判定为 true 的元素，偏移从 last - 1 往前数
+    // 不变式：[原 first, first) 全为 true，[last, 原 last) 全为 false
+    while (last - first >= 2 * partition_block)
+    {
+        if (num_l == 0)
+        {
+            start_l = 0;
+            for (ptrdiff_t i = 0; i < partition_block; ++i)
+            {
+                offsets_l[num_l] = static_cast<unsigned char>(i);
+                num_l += !unary_pred(first[i]);
+            }
+        }
+        if (num_r == 0)
+        {
+            start_r = 0;
+            for (ptrdiff_t i = 0; i < partition_block; ++i)
+            {
+                offsets_r[num_r] = static_cast<unsigned char>(i);
+                num_r += !!unary_pred(*(last - 1 - i));
+            }
+        }
+        const ptrdiff_t num = num_l < num_r ? num_l : num_r;
+        for (ptrdiff_t k = 0; k < num; ++k)
+            MyStl::iter_swap(first + offsets_l[start_l + k], last - 1 - offsets_r[start_r + k]);
+        num_l -= num;
+        num_r -= num;
+        start_l += num;
+        start_r += num;
+        if (num_l == 0)
+            first += partition_block;
+        if (num_r == 0)
+            last -= partition_block;
+    }
+    // 最多一端还有未处理的放错元素；先划分尚未判定的中间部分，再把它们换到分界处
+    if (num_l != 0)
+    {
+        auto mid = MyStl::partition_dispatch(first + partition_block, last, unary_pred,
+                                             bidirectional_iterator_tag());
+        for (ptrdiff_t k = start_l + num_l; k-- > start_l; )
+        {
+            --mid;
+            if (first + offsets_l[k] != mid)
+                MyStl::iter_swap(first + offsets_l[k], mid);
+        }
+        return mid;
+    }
+    if (num_r != 0)
+    {
+        auto mid = MyStl::partition_dispatch(first, last - partition_block, unary_pred,
+                                             bidirectional_iterator_tag());
+        for (ptrdiff_t k = start_r + num_r; k-- > start_r; )
+        {
+            const auto pos = last - 1 - offsets_r[k];
+            if (pos != mid)
+                MyStl::iter_swap(pos, mid);
+            ++mid;
+        }
+        return mid;
+    }
+    return MyStl::partition_dispatch(first, last, unary_pred, bidirectional_iterator_tag());
+}
+
+template <class ForwardIter, class UnaryPredicate>
+ForwardIter
+partition(ForwardIter first, ForwardIter last, UnaryPredicate unary_pred)
+{
+    return MyStl::partition_dispatch(first, last, unary_pred, iterator_category(first));
+}
+
+/*****************************************************************************************/
+// stable_partition
+// 与 partition 相同，但保持元素的原始相对位置
+// 有足够的临时缓冲区时一趟完成：true 的元素原地前移，false 的元素移动构造到未初始化的缓冲区再接到后面
+// 缓冲区不足时分治：两半各自划分后，把左半的 false 段与右半的 true 段交换位置
+/*****************************************************************************************/
+// len 为 [first, last) 的长度，buffer 为可以容纳 buffer_size 个元素的未初始化缓冲区
+// false 的元素移动构造到缓冲区，接回区间后销毁；谓词抛出异常时先把缓冲区中的元素移回空出的位置
+template <class BidirectionalIter, class UnaryPredicate, class Distance>
+BidirectionalIter
+stable_partition_adaptive(BidirectionalIter first, BidirectionalIter last, UnaryPredicate &unary_pred,
+                          Distance len, typename iterator_traits<BidirectionalIter>::value_type *buffer,
+                          Distance buffer_size)
+{
+    if (len <= buffer_size)
+    {
+        auto result = first;
+        auto buf_end = buffer;
+        try
+        {
+            for (; first != last; ++first)
+            {
+                if (unary_pred(*first))
+                {
+                    *result = MyStl::move(*first);
+                    ++result;
+                }
+                else
+                {
+                    MyStl::construct(buf_end, MyStl::move(*first));
+                    ++buf_end;
+                }
+            }
+        }
+        catch (...)
+        {
+            MyStl::move_out_of_buffer(buffer, buf_end, result);
+            throw;
+        }
+        MyStl::move_out_of_buffer(buffer, buf_end, result);
+        return result;
+    }
+    if (len == 1)
+        return unary_pred(*first) ? last : first;
+    auto middle = first;
+    MyStl::advance(middle, len / 2);
+    auto left = MyStl::stable_partition_adaptive(first, middle, unary_pred, len / 2, buffer, buffer_size);
+    auto right = MyStl::stable_partition_adaptive(middle, last, unary_pred, len - len / 2, buffer, buffer_size);
+    // 交换 [left, middle) 与 [middle, right)
+    return MyStl::rotate(left, middle, right);
+}
+
+template <class BidirectionalIter, class UnaryPredicate>
+BidirectionalIter
+stable_partition(BidirectionalIter first, BidirectionalIter last, UnaryPredicate unary_pred)
+{
+    typedef typename iterator_traits<BidirectionalIter>::value_type value_type;
+    // 开头已经为 true 的元素不需要移动
+    while (first != last && unary_pred(*first))
+        ++first;
+    if (first == last)
+        return first;
+    typedef typename iterator_traits<BidirectionalIter>::difference_type Distance;
+    const Distance len = MyStl::distance(first, last);
+    move_buffer<value_type> buf(static_cast<ptrdiff_t>(len));
+    return MyStl::stable_partition_adaptive(first, last, unary_pred, len,
+                                            buf.begin(), static_cast<Distance>(buf.size()));
+}
+
+/*****************************************************************************************/
+// merge
+// 将两个经过排序的集合 S1 和 S2 合并起来置于另一段空间，返回一个迭代器指向最后一个元素的下一位置
+// 相等的元素先输出 S1 中的，合并是稳定的
+/*****************************************************************************************/
+template <class InputIter1, class InputIter2, class OutputIter, class Compared>
+OutputIter
+unchecked_merge(InputIter1 first1, InputIter1 last1, InputIter2 first2, InputIter2 last2,
+                OutputIter result, Compared comp)
+{
+    while (first1 != last1 && first2 != last2)
+    {
+        if (comp(*first2, *first1))
+        {
+            *result = *first2;
+            ++first2;
+        }
+        else
+        {
+            *result = *first1;
+            ++first1;
+        }
+        ++result;
+    }
+    result = MyStl::copy(first1, last1, result);
+    return MyStl::copy(first2, last2, result);
+}
+
+// 两个输入和输出都是同一种算术类型的原生指针
+template <class Tp, class Up, class Vp>
+struct is_branchless_merge
+  : m_bool_constant<
+      std::is_same<typename std::remove_const<Tp>::type, Vp>::value &&
+      std::is_same<typename std::remove_const<Up>::type, Vp>::value &&
+      std::is_arithmetic<Vp>::value && !std::is_same<Vp, bool>::value>
+{
+};
+
+// 默认比较的算术类型：比较结果只用来选值和推进指针，编译为条件传送，
+// 两段交错得没有规律时不会因为分支预测失败而停顿
+template <class Tp, class Up, class Vp>
+typename std::enable_if<is_branchless_merge<Tp, Up, Vp>::value, Vp*>::type
+unchecked_merge(Tp *first1, Tp *last1, Up *first2, Up *last2, Vp *result, batch_less)
+{
+    while (first1 != last1 && first2 != last2)
+    {
+        const Vp x = *first1;
+        const Vp y = *first2;
+        const bool take2 = y < x;
+        *result++ = take2 ? y : x;
+        first1 += !take2;
+        first2 += take2;
+    }
+    result = MyStl::copy(first1, last1, result);
+    return MyStl::copy(first2, last2, result);
+}
+
+template <class InputIter1, class InputIter2, class OutputIter>
+OutputIter
+merge(InputIter1 first1, InputIter1 last1, InputIter2 first2, InputIter2 last2, OutputIter result)
+{
+    return MyStl::unchecked_merge(first1, last1, first2, last2, result, batch_less());
+}
+
+template <class InputIter1, class InputIter2, class OutputIter, class Compared>
+OutputIter
+merge(InputIter1 first1, InputIter1 last1, InputIter2 first2, InputIter2 last2,
+      OutputIter result, Compared comp)
+{
+    return MyStl::unchecked_merge(first1, last1, first2, last2, result, comp);
+}
+
+/*****************************************************************************************/
+// inplace_merge
+// 把连接在一起的两个有序序列 [first, middle) 和 [middle, last) 结合成单一序列并保持有序，合并是稳定的
+// 缓冲区能容纳较短的一段时，把它移到缓冲区再归并回原处，O(n) 次移动；
+// 否则递归分割，用旋转把两段交错的部分换位，直到子问题能放进缓冲区或只剩一个元素
+// 随机访问迭代器使用 SymMerge（Kim & Kutzner）的对称分割，双向迭代器在较长一段的中点分割
+// 缓冲区未初始化，元素移动构造进去，移出后立即销毁；不拷贝元素，只能移动的类型也可以归并
+// 比较或移动抛出异常时，缓冲区中的元素移回区间中空出的位置，所有元素都还在区间内，但顺序未定
+/*****************************************************************************************/
+// [first, middle) 移到缓冲区，从前向后归并回 [first, last)
+// 缓冲区中还剩 k 个元素时，[first, first + k) 正好是空出的位置
+template <class BidirectionalIter, class T, class Compared>
+void merge_buffer_forward(BidirectionalIter first, BidirectionalIter middle, BidirectionalIter last,
+                          T *buffer, Compared &comp)
+{
+    T *buffer_end = MyStl::move_into_buffer(first, middle, buffer);
+    try
+    {
+        while (buffer != buffer_end && middle != last)
+        {
+            if (comp(*middle, *buffer))
+            {
+                *first = MyStl::move(*middle);
+                ++middle;
+            }
+            else
+            {
+                *first = MyStl::move(*buffer);
+                MyStl::destroy(buffer);
+                ++buffer;
+            }
+            ++first;
+        }
+    }
+    catch (...)
+    {
+        MyStl::move_out_of_buffer(buffer, buffer_end, first);
+        throw;
+    }
+    // [middle, last) 剩下的部分已经在原位
+    MyStl::move_out_of_buffer(buffer, buffer_end, first);
+}
+
+// [middle, last) 移到缓冲区，从后向前归并回 [first, last)
+// 缓冲区中还剩 k 个元素时，[middle, last) 正好是 k 个空出的位置
+template <class BidirectionalIter, class T, class Compared>
+void merge_buffer_backward(BidirectionalIter first, BidirectionalIter middle, BidirectionalIter last,
+                           T *buffer, Compared &comp)
+{
+    T *buffer_end = MyStl::move_into_buffer(middle, last, buffer);
+    try
+    {
+        while (first != middle && buffer != buffer_end)
+        {
+            auto left = middle;
+            --left;
+            auto dest = last;
+            --dest;
+            if (comp(*(buffer_end - 1), *left))
+            {
+                *dest = MyStl::move(*left);
+                middle = left;
+            }
+            else
+            {
+                *dest = MyStl::move(*(buffer_end - 1));
+                --buffer_end;
+                MyStl::destroy(buffer_end);
+            }
+            last = dest;
+        }
+    }
+    catch (...)
+    {
+        MyStl::move_out_of_buffer_backward(buffer, buffer_end, last);
+        throw;
+    }
+    // [first, middle) 剩下的部分已经在原位
+    MyStl::move_out_of_buffer_backward(buffer, buffer_end, last);
+}
+
+// 较短的一段能放进缓冲区时归并并返回 true
+template <class BidirectionalIter, class Distance, class Pointer, class Compared>
+bool merge_with_buffer(BidirectionalIter first, BidirectionalIter middle, BidirectionalIter last,
+                       Distance len1, Distance len2, Pointer buffer, Distance buffer_size, Compared &comp)
+{
+    if (len1 <= len2 && len1 <= buffer_size)
+    {
+        MyStl::merge_buffer_forward(first, middle, last, buffer, comp);
+        return true;
+    }
+    if (len2 < len1 && len2 <= buffer_size)
+    {
+        MyStl::merge_buffer_backward(first, middle, last, buffer, comp);
+        return true;
+    }
+    return false;
+}
+
+// merge_adaptive 的 bidirectional_iterator_tag 版本
+// 在较长一段的中点 cut 处分割，在另一段中二分出对应位置，旋转后两边各自递归
+template <class BidirectionalIter, class Distance, class Pointer, class Compared>
+void merge_adaptive(BidirectionalIter first, BidirectionalIter middle, BidirectionalIter last,
+                    Distance len1, Distance len2, Pointer buffer, Distance buffer_size,
+                    Compared &comp, bidirectional_iterator_tag)
+{
+    if (len1 == 0 || len2 == 0)
+        return;
+    if (MyStl::merge_with_buffer(first, middle, last, len1, len2, buffer, buffer_size, comp))
+        return;
+    if (len1 + len2 == 2)
+    {
+        if (comp(*middle, *first))
+            MyStl::iter_swap(first, middle);
+        return;
+    }
+    auto first_cut = first;
+    auto second_cut = middle;
+    Distance len11 = 0;
+    Distance len22 = 0;
+    if (len1 > len2)
+    {
+        len11 = len1 / 2;
+        MyStl::advance(first_cut, len11);
+        second_cut = MyStl::lower_bound(middle, last, *first_cut, comp);
+        len22 = MyStl::distance(middle, second_cut);
+    }
+    else
+    {
+        len22 = len2 / 2;
+        MyStl::advance(second_cut, len22);
+        first_cut = MyStl::upper_bound(first, middle, *second_cut, comp);
+        len11 = MyStl::distance(first, first_cut);
+    }
+    auto new_middle = MyStl::rotate(first_cut, middle, second_cut);
+    MyStl::merge_adaptive(first, first_cut, new_middle, len11, len22, buffer, buffer_size,
+                          comp, bidirectional_iterator_tag());
+    MyStl::merge_adaptive(new_middle, second_cut, last, len1 - len11, len2 - len22, buffer, buffer_size,
+                          comp, bidirectional_iterator_tag());
+}
+
+// merge_adaptive 的 random_access_iterator_tag 版本：SymMerge
+// 以整个区间的中点 mid 为对称轴，二分找最小的 start 使得 [start, middle) 与 [middle, end) 对称交换后
+// 两边各自有序（end = mid + middle - start），旋转这两段，再分别递归 [first, mid) 和 [mid, last)
+// 只剩一个元素的一段直接二分插入
+template <class RandomIter, class Distance, class Pointer, class Compared>
+void merge_adaptive(RandomIter first, RandomIter middle, RandomIter last,
+                    Distance len1, Distance len2, Pointer buffer, Distance buffer_size,
+                    Compared &comp, random_access_iterator_tag)
+{
+    if (len1 == 0 || len2 == 0)
+        return;
+    if (MyStl::merge_with_buffer(first, middle, last, len1, len2, buffer, buffer_size, comp))
+        return;
+    if (len1 == 1)
+    {
+        // *first 放到 [middle, last) 中第一个不小于它的元素之前
+        auto pos = MyStl::lower_bound(middle, last, *first, comp);
+        auto value = MyStl::move(*first);
+        *MyStl::move(middle, pos, first) = MyStl::move(value);
+        return;
+    }
+    if (len2 == 1)
+    {
+        // *middle 放到 [first, middle) 中第一个大于它的元素之前
+        auto pos = MyStl::upper_bound(first, middle, *middle, comp);
+        auto value = MyStl::move(*middle);
+        MyStl::move_backward(pos, middle, middle + 1);
+        *pos = MyStl::move(value);
+        return;
+    }
+    const Distance len = len1 + len2;
+    const Distance mid = len / 2;
+    const Distance n = mid + len1;
+    Distance start = len1 > mid ? n - len : 0;
+    Distance r = len1 > mid ? mid : len1;
+    const Distance p = n - 1;
+    while (start < r)
+    {
+        const Distance c = start + (r - start) / 2;
+        if (!comp(*(first + (p - c)), *(first + c)))
+            start = c + 1;
+        else
+            r = c;
+    }
+    const Distance end = n - start;
+    if (start < len1 && len1 < end)
+        MyStl::rotate(first + start, middle, first + end);
+    if (0 < start && start < mid)
+        MyStl::merge_adaptive(first, first + start, first + mid, start, mid - start, buffer, buffer_size,
+                              comp, random_access_iterator_tag());
+    if (mid < end && end < len)
+        MyStl::merge_adaptive(first + mid, first + end, last, end - mid, len - end, buffer, buffer_size,
+                              comp, random_access_iterator_tag());
+}
+
+template <class BidirectionalIter, class Compared>
+void inplace_merge(BidirectionalIter first, BidirectionalIter middle, BidirectionalIter last, Compared comp)
+{
+    typedef typename iterator_traits<BidirectionalIter>::value_type value_type;
+    typedef typename iterator_traits<BidirectionalIter>::difference_type Distance;
+    if (first == middle || middle == last)
+        return;
+    const Distance len1 = MyStl::distance(first, middle);
+    const Distance len2 = MyStl::distance(middle, last);
+    // 缓冲区只需容纳较短的一段
+    move_buffer<value_type> buf(static_cast<ptrdiff_t>(len1 <= len2 ? len1 : len2));
+    MyStl::merge_adaptive(first, middle, last, len1, len2, buf.begin(), static_cast<Distance>(buf.size()),
+                          comp, iterator_category(first));
+}
+
+template <class BidirectionalIter>
+void inplace_merge(BidirectionalIter first, BidirectionalIter middle, BidirectionalIter last)
+{
+    MyStl::inplace_merge(first, middle, last, batch_less());
+}
+
+/*****************************************************************************************/
+// insertion_sort
+// 小区间上的插入排序，供 nth_element 等算法收尾使用
+/*****************************************************************************************/
+template <class RandomIter, class Compared>
+void insertion_sort(RandomIter first, RandomIter last, Compared comp)
+{
+    if (first == last)
+        return;
+    for (auto i = first + 1; i != last; ++i)
+    {
+        auto value = MyStl::move(*i);
+        auto hole = i;
+        if (comp(value, *first))
+        {
+            // 比首元素还小，整段后移，不需要逐个比较
+            MyStl::move_backward(first, i, i + 1);
+            hole = first;
+        }
+        else
+        {
+            for (auto prev = hole - 1; comp(value, *prev); --prev)
+            {
+                *hole = MyStl::move(*prev);
+                hole = prev;
+            }
+        }
+        *hole = MyStl::move(value);
+    }
+}
+
+/*****************************************************************************************/
+// nth_element
+// 对序列重排，使得所有小于第 n 个元素的元素出现在它的前面，大于它的出现在它的后面
+// introselect：以三点中值为枢轴做快速选择，递归深度超过 2 * log2(n) 时改用中位数的中位数，
+// 保证最坏情况下线性时间
+/*****************************************************************************************/
+// 区间不超过该长度时直接插入排序
+constexpr ptrdiff_t select_threshold = 16;
+
+// 把 a, b, c 的中值与 result 交换
+template <class RandomIter, class Compared>
+void move_median_to_first(RandomIter result, RandomIter a, RandomIter b, RandomIter c, Compared comp)
+{
+    if (comp(*a, *b))
+    {
+        if (comp(*b, *c))
+            MyStl::iter_swap(result, b);
+        else if (comp(*a, *c))
+            MyStl::iter_swap(result, c);
+        else
+            MyStl::iter_swap(result, a);
+    }
+    else if (comp(*a, *c))
+        MyStl::iter_swap(result, a);
+    else if (comp(*b, *c))
+        MyStl::iter_swap(result, c);
+    else
+        MyStl::iter_swap(result, b);
+}
+
+// 以 *pivot 为枢轴划分 [first, last)，要求两端各有一个可以作为哨兵的元素
+// 返回 cut，[first, cut) 不大于枢轴，[cut, last) 不小于枢轴
+template <class RandomIter, class Compared>
+RandomIter unguarded_partition(RandomIter first, RandomIter last, RandomIter pivot, Compared comp)
+{
+    while (true)
+    {
+        while (comp(*first, *pivot))
+            ++first;
+        --last;
+        while (comp(*pivot, *last))
+            --last;
+        if (!(first < last))
+            return first;
+        MyStl::iter_swap(first, last);
+        ++first;
+    }
+}
+
+// 中位数的中位数：每 5 个一组取中位数移到区间前部，递归选出它们的中位数作为枢轴
+template <class RandomIter, class Compared>
+void median_of_medians_select(RandomIter first, RandomIter nth, RandomIter last, Compared comp)
+{
+    while (last - first > select_threshold)
+    {
+        auto groups = first;
+        for (auto p = first; last - p >= 5; p += 5, ++groups)
+        {
+            MyStl::insertion_sort(p, p + 5, comp);
+            MyStl::iter_swap(groups, p + 2);
+        }
+        const auto median = first + (groups - first) / 2;
+        MyStl::median_of_medians_select(first, median, groups, comp);
+        MyStl::iter_swap(first, median);
+        // 枢轴放在 first 作为右侧扫描的哨兵，左侧扫描至少会停在另一组中位数较大的元素上
+        auto cut = MyStl::unguarded_partition(first + 1, last, first, comp);
+        MyStl::iter_swap(first, cut - 1);
+        const auto pos = cut - 1;
+        if (nth == pos)
+            return;
+        if (nth < pos)
+            last = pos;
+        else
+            first = pos + 1;
+    }
+    MyStl::insertion_sort(first, last, comp);
+}
+
+template <class RandomIter, class Compared>
+void nth_element(RandomIter first, RandomIter nth, RandomIter last, Compared comp)
+{
+    if (nth == last)
+        return;
+    size_t depth_limit = 0;
+    for (auto n = last - first; n > 1; n >>= 1)
+        depth_limit += 2;
+    while (last - first > select_threshold)
+    {
+        if (depth_limit == 0)
+        {
+            MyStl::median_of_medians_select(first, nth, last, comp);
+            return;
+        }
+        --depth_limit;
+        MyStl::move_median_to_first(first, first + 1, first + (last - first) / 2, last - 1, comp);
+        auto cut = MyStl::unguarded_partition(first + 1, last, first, comp);
+        if (cut <= nth)
+            first = cut;
+        else
+            last = cut;
+    }
+    MyStl::insertion_sort(first, last, comp);
+}
+
+template <class RandomIter>
+void nth_element(RandomIter first, RandomIter nth, RandomIter last)
+{
+    MyStl::nth_element(first, nth, last, MyStl::less<typename iterator_traits<RandomIter>::value_type>());
+}
+
+/*****************************************************************************************/
+// partial_sort
+// 对整个序列做部分排序，保证较小的 N 个元素以递增顺序置于[first, first + N)中
+// 用 [first, middle) 维护一个 max-heap，比堆顶小的元素替换堆顶，最后对堆排序
+/*****************************************************************************************/
+template <class RandomIter, class Compared>
+void partial_sort(RandomIter first, RandomIter middle, RandomIter last, Compared comp)
+{
+    if (first == middle)
+        return;
+    MyStl::make_heap(first, middle, comp);
+    for (auto i = middle; i < last; ++i)
+    {
+        if (comp(*i, *first))
+        {
+            auto value = MyStl::move(*i);
+            MyStl::pop_heap_aux(first, middle, i, MyStl::move(value), comp);
+        }
+    }
+    MyStl::sort_heap(first, middle, comp);
+}
+
+template <class RandomIter>
+void partial_sort(RandomIter first, RandomIter middle, RandomIter last)
+{
+    MyStl::partial_sort(first, middle, last, MyStl::less<typename iterator_traits<RandomIter>::value_type>());
+}
+
+/*****************************************************************************************/
+// partial_sort_copy
+// 行为与 partial_sort 类似，不同的是把排序结果复制到 result 容器中
+// 只需要输入迭代器：结果区间作为有界的 max-heap，输入只遍历一遍
+/*****************************************************************************************/
+template <class InputIter, class RandomIter, class Compared>
+RandomIter
+partial_sort_copy(InputIter first, InputIter last, RandomIter result_first, RandomIter result_last,
+                  Compared comp)
+{
+    typedef typename iterator_traits<RandomIter>::difference_type Distance;
+    if (result_first == result_last)
+        return result_last;
+    auto result_iter = result_first;
+    for (; first != last && result_iter != result_last; ++first, ++result_iter)
+        *result_iter = *first;
+    MyStl::make_heap(result_first, result_iter, comp);
+    const Distance len = result_iter - result_first;
+    for (; first != last; ++first)
+    {
+        if (comp(*first, *result_first))
+            MyStl::adjust_heap(result_first, static_cast<Distance>(0), len,
+                               typename iterator_traits<RandomIter>::value_type(*first), comp);
+    }
+    MyStl::sort_heap(result_first, result_iter, comp);
+    return result_iter;
+}
+
+template <class InputIter, class RandomIter>
+RandomIter
+partial_sort_copy(InputIter first, InputIter last, RandomIter result_first, RandomIter result_last)
+{
+    return MyStl::partial_sort_copy(first, last, result_first, result_last,
+                                    MyStl::less<typename iterator_traits<RandomIter>::value_type>());
+}
+
+/*****************************************************************************************/
+// top_k
+// 从输入序列中选出 comp 意义下最大的 k 个元素（k 为结果区间的长度），按递减顺序写入结果区间
+// 输入只遍历一遍，额外空间只有结果区间本身，适合在流式数据上求前 k 名
+// 返回结果的尾部；输入不足 k 个时只写出全部元素
+/*****************************************************************************************/
+// 交换参数顺序的比较函数对象，把 max-heap 变成 min-heap
+template <class Compared>
+struct reverse_compare
+{
+    Compared comp;
+
+    explicit reverse_compare(Compared c) : comp(c) {}
+
+    template <class T, class U>
+    bool operator()(const T &lhs, const U &rhs) { return comp(rhs, lhs); }
+};
+
+template <class InputIter, class RandomIter, class Compared>
+RandomIter
+top_k(InputIter first, InputIter last, RandomIter result_first, RandomIter result_last, Compared comp)
+{
+    return MyStl::partial_sort_copy(first, last, result_first, result_last,
+                                    reverse_compare<Compared>(comp));
+}
+
+template <class InputIter, class RandomIter>
+RandomIter
+top_k(InputIter first, InputIter last, RandomIter result_first, RandomIter result_last)
+{
+    return MyStl::top_k(first, last, result_first, result_last,
+                        MyStl::less<typename iterator_traits<RandomIter>::value_type>());
+}
+
+
 
 }
 
@@ -2,10 +2,13 @@
 #define MYSTL_ALGOBASE_H_
 
 // 这个头文件包含了mystl的基本算法
+#include <climits>
+#include <cstddef>
 #include <cstring>
 #include <iostream>
 
 #include "iterator.h"
+#include "simd.h"
 #include "util.h"
 
 namespace MyStl
@@ -68,6 +71,37 @@ void iter_swap(Fiter1 lhs, Fiter2 rhs)
   MyStl::swap(*lhs, *rhs);
 }
 
+/*****************************************************************************************/
+// swap_range
+// 交换 [first1, last1) 与以 first2 为起点的等长区间，通用版本在 util.h
+/*****************************************************************************************/
+// 移动构造、移动赋值和析构都是平凡的类型，用三次移动交换等价于逐字节交换
+template <class Tp>
+struct is_bitwise_swappable : m_bool_constant<
+  !std::is_const<Tp>::value && !std::is_volatile<Tp>::value &&
+  std::is_trivially_move_constructible<Tp>::value &&
+  std::is_trivially_move_assignable<Tp>::value &&
+  std::is_trivially_destructible<Tp>::value> {};
+
+// 同类型原生指针且可逐字节交换时，用 SIMD 整块交换；两段区间重叠时退回逐个交换
+template <class Tp>
+typename std::enable_if<is_bitwise_swappable<Tp>::value, Tp*>::type
+swap_range(Tp *first1, Tp *last1, Tp *first2)
+{
+  const size_t n = static_cast<size_t>(last1 - first1);
+  const auto a = reinterpret_cast<uintptr_t>(first1);
+  const auto b = reinterpret_cast<uintptr_t>(first2);
+  const size_t bytes = n * sizeof(Tp);
+  if (a < b + bytes && b < a + bytes)
+  {
+    for (; first1 != last1; ++first1, (void) ++first2)
+      MyStl::swap(*first1, *first2);
+    return first2;
+  }
+  MyStl::simd::swap_bytes(first1, first2, bytes);
+  return first2 + n;
+}
+
 /*****************************************************************************************/
 // copy
 // 把 [first, last) 区间的元素拷贝到 [result, result + (last - first)) 内
@@ -116,8 +150,7 @@ typename std::enable_if< // SFINAE 技术
 unchecked_copy(Tp *first, Tp *last, Up *result)
 {
   const auto n = static_cast<size_t>(last - first);
-  if (n != 0)
-    std::memmove(result, first, n * sizeof(Up));
+  simd::copy_bytes(result, first, n * sizeof(Up));
   return result + n;
 }
 
@@ -167,17 +200,14 @@ unchecked_copy_backward(BidrectionalIter1 first, BidrectionalIter1 last,
 // 为 trivially_copy_assignable 类型提供特化版本
 template <class Tp, class Up>
 typename std::enable_if<
-  std::is_same<typename std::remove_reference<Tp>::type, Up>::value &&
+  std::is_same<typename std::remove_const<Tp>::type, Up>::value &&
   std::is_trivially_copy_assignable<Up>::value,
   Up*>::type
 unchecked_copy_backward(Tp * first, Tp* last, Up* result)
 {
   const auto n = static_cast<size_t>(last - first);
-  if (n != 0)
-  {
-    result -= n;
-    std::memmove(result, first, sizeof(Up) * n);
-  }
+  result -= n;
+  simd::copy_bytes(result, first, sizeof(Up) * n);
   return result;
 }
 
@@ -195,7 +225,7 @@ copy_backward(BidrectionalIter1 first , BidrectionalIter1 last , BidrectionalIte
 /*****************************************************************************************/
 template <class InputIter, class OutputIter, class UnaryPredicate>
 OutputIter
-copy_if(InputIter first, InputIter last, OutputIter result, UnaryPredicate unary_pred)
+unchecked_copy_if(InputIter first, InputIter last, OutputIter result, UnaryPredicate unary_pred)
 {
   for (; first != last; ++first)
   {
@@ -205,6 +235,48 @@ copy_if(InputIter first, InputIter last, OutputIter result, UnaryPredicate unary
   return result;
 }
 
+// 同类型、4 字节、可平凡拷贝的元素在原生指针之间按标志压缩
+template <class Tp, class Up>
+struct is_compress32 : m_bool_constant<
+  std::is_same<typename std::remove_cv<Tp>::type, Up>::value &&
+  !std::is_const<Up>::value && !std::is_volatile<Tp>::value && !std::is_volatile<Up>::value &&
+  std::is_trivially_copyable<Up>::value && sizeof(Up) == 4> {};
+
+// 每批先求值的谓词个数
+constexpr size_t compress_batch = 256;
+
+// 每批先把谓词结果写成标志字节（不产生分支），再用 simd::compress32 写出
+// select_false 为 true 时写出谓词为假的元素；result 可以等于 first（原地压缩）
+template <class Tp, class Up, class UnaryPredicate>
+Up* compress_if(Tp *first, Tp *last, Up *result, UnaryPredicate &unary_pred, bool select_false)
+{
+  unsigned char flags[compress_batch];
+  while (first != last)
+  {
+    const size_t n = static_cast<size_t>(last - first) < compress_batch
+      ? static_cast<size_t>(last - first) : compress_batch;
+    for (size_t i = 0; i < n; ++i)
+      flags[i] = unary_pred(first[i]) ? 1 : 0;
+    result += simd::compress32(result, first, flags, n, select_false);
+    first += n;
+  }
+  return result;
+}
+
+template <class Tp, class Up, class UnaryPredicate>
+typename std::enable_if<is_compress32<Tp, Up>::value, Up*>::type
+unchecked_copy_if(Tp *first, Tp *last, Up *result, UnaryPredicate unary_pred)
+{
+  return MyStl::compress_if(first, last, result, unary_pred, false);
+}
+
+template <class InputIter, class OutputIter, class UnaryPredicate>
+OutputIter
+copy_if(InputIter first, InputIter last, OutputIter result, UnaryPredicate unary_pred)
+{
+  return MyStl::unchecked_copy_if(first, last, result, unary_pred);
+}
+
 /*****************************************************************************************/
 // copy_n
 // 把[first, first + n)区间上的元素拷贝到 [result, result + n) 上\
@@ -215,7 +287,7 @@ template <class InputIter, class Size, class OutputIter>
 MyStl::pair<InputIter, OutputIter>
 unchecked_copy_n(InputIter first, Size n, OutputIter result, MyStl::input_iterator_tag)
 {
-    for (;n > 0; --n)
+    for (;n > 0; --n, ++first, ++result)
     {
         *result = *first;
     }
@@ -249,7 +321,7 @@ template <class InputIter, class OutputIter>
 OutputIter
 unchecked_move_cat(InputIter first ,InputIter last, OutputIter result, MyStl::input_iterator_tag)
 {
-    for (; first != result; ++first, ++result)
+    for (; first != last; ++first, ++result)
     {
         *result = MyStl::move(*first);
     }
@@ -285,8 +357,7 @@ typename std::enable_if<
 unchecked_move(Tp *first, Tp *last, Up* result)
 {
     const size_t n = static_cast<size_t>(last - first);
-    if (n != 0)
-        std::memmove(result, first, n*sizeof(Up));
+    simd::copy_bytes(result, first, n * sizeof(Up));
     return result + n;
 }
 
@@ -318,7 +389,7 @@ RandomIter2
 unchecked_move_backward_cat(RandomIter1 first, RandomIter1 last,
                             RandomIter2 result, MyStl::random_access_iterator_tag)
 {
-    for (auto n = last - result; n > 0; --n )
+    for (auto n = last - first; n > 0; --n )
         *--result = MyStl::move(*--last);
     return result;
 }
@@ -333,17 +404,14 @@ unchecked_move_backward(BidrectionalIter1 first, BidrectionalIter1 last, Bidrect
 // 为 trivially_copy_assignable 类型提供特化版本
 template<class Tp, class Up>
 typename std::enable_if<
-    std::is_same<typename std::remove_reference<Tp>::type, Up>::value &&
+    std::is_same<typename std::remove_const<Tp>::type, Up>::value &&
     std::is_trivially_copy_assignable<Up>::value,
-    Up*>::value
+    Up*>::type
 unchecked_move_backward(Tp *first, Tp *last, Up *result)
 {
-    const size_t n = static_cast<size_t>(last- first);
-    if (n != 0)
-    {
-        result -= n;
-        std::memmove(result - n, first, sizeof(result) * n);
-    }
+    const size_t n = static_cast<size_t>(last - first);
+    result -= n;
+    simd::copy_bytes(result, first, sizeof(Up) * n);
     return result;
 }
 
@@ -358,8 +426,26 @@ move_backward(BidrectionalIter1 first, BidrectionalIter1 last, BidrectionalIter2
 // equal
 // 比较第一序列在 [first, last)区间上的元素值是否和第二序列相等
 /*****************************************************************************************/
+// 逐位相等即值相等的类型：整数、枚举、指针。浮点数有 +0/-0 和 NaN，不在此列
+template <class T>
+struct is_bitwise_comparable
+  : m_bool_constant<
+      (std::is_integral<T>::value || std::is_enum<T>::value || std::is_pointer<T>::value) &&
+      !std::is_volatile<T>::value>
+{
+};
+
+// 两个原生指针指向同一种逐位可比较的类型
+template <class Tp, class Up>
+struct is_bitwise_comparable_pair
+  : m_bool_constant<
+      std::is_same<typename std::remove_cv<Tp>::type, typename std::remove_cv<Up>::type>::value &&
+      is_bitwise_comparable<Tp>::value>
+{
+};
+
 template <class InputIter1, class InputIter2>
-bool equal(InputIter1 first, InputIter1 last, InputIter2 first2)
+bool unchecked_equal(InputIter1 first, InputIter1 last, InputIter2 first2)
 {
     for (; first != last; ++first, ++first2)
     {
@@ -369,6 +455,21 @@ bool equal(InputIter1 first, InputIter1 last, InputIter2 first2)
     return true;
 }
 
+// 为逐位可比较类型提供特化版本，直接比较内存
+template <class Tp, class Up>
+typename std::enable_if<is_bitwise_comparable_pair<Tp, Up>::value, bool>::type
+unchecked_equal(Tp *first, Tp *last, Up *first2)
+{
+    const auto n = static_cast<size_t>(last - first);
+    return n == 0 || std::memcmp(first, first2, n * sizeof(Tp)) == 0;
+}
+
+template <class InputIter1, class InputIter2>
+bool equal(InputIter1 first, InputIter1 last, InputIter2 first2)
+{
+    return MyStl::unchecked_equal(first, last, first2);
+}
+
 template <class InputIter1, class InputIter2, class Compare>
 bool equal(InputIter1 first, InputIter1 last, InputIter2 first2, Compare comp)
 {
@@ -395,22 +496,40 @@ OutputIter unchecked_fill_n(OutputIter first, Size t, const T &value)
     return first;
 }
 
-// 为one-byte类型提供特化版本
-// 问是否是整形 char
+// 可以按字节模式填充的类型：平凡可复制，长度为 1/2/4/8/16 字节，
+// 且填入的值与元素同类型，或者两者都是算术类型（先转换成元素类型）
+template <class Tp, class Up>
+struct is_fill_pattern
+  : m_bool_constant<
+      std::is_trivially_copyable<Tp>::value &&
+      std::is_trivially_copy_assignable<Tp>::value &&
+      !std::is_const<Tp>::value && !std::is_volatile<Tp>::value &&
+      (sizeof(Tp) == 1 || sizeof(Tp) == 2 || sizeof(Tp) == 4 || sizeof(Tp) == 8 || sizeof(Tp) == 16) &&
+      (std::is_same<Tp, typename std::remove_cv<Up>::type>::value ||
+       (std::is_arithmetic<Tp>::value && std::is_arithmetic<Up>::value))>
+{
+};
+
+// 为可按字节模式填充的类型提供特化版本
+// one-byte 类型直接 memset，其余交给 simd::fill_pattern 广播存储
 template <class Tp, class Size, class Up>
-typename std::enable_if<
-    std::is_integral<Tp>::value && sizeof(Tp) == 1 &&
-    !std::is_same<Tp,bool>::value &&
-    std::is_integral<Up>::value && sizeof(Up) == 1,
-    Tp*>::type
-unchecked_fill_n(Tp *first, Size t, Up value)
+typename std::enable_if<is_fill_pattern<Tp, Up>::value, Tp*>::type
+unchecked_fill_n(Tp *first, Size t, const Up &value)
 {
-    if (t > 0)
+    if (t <= 0)
+        return first;
+    const Tp tmp = static_cast<Tp>(value);
+    if (sizeof(Tp) == 1)
+    {
+        unsigned char byte;
+        std::memcpy(&byte, &tmp, 1);
+        std::memset(first, byte, static_cast<size_t>(t));
+    }
+    else
     {
-        std::memset(first, (unsigned char)value, (size_t)(t));
+        simd::fill_pattern(first, &tmp, sizeof(Tp), static_cast<size_t>(t));
     }
     return first + t;
-
 }
 
 template <class OutputIter, class Size, class T>
@@ -449,20 +568,97 @@ void fill(ForwardIter first, ForwardIter last, const T &value)
 // 两者不一定同大小，故需要两者都提供first和last
 // 如果第一序列的元素较小， 返回true， 否则返回false
 /*****************************************************************************************/
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define MYSTL_BIG_ENDIAN 1
+#endif
+
+// 按无符号字节比较即为字典序的类型，可以直接交给 memcmp
+// signed char 以及有符号的 char 不在此列：memcmp 把 0x80 看作大于 0x7f
+// 大端机器上无符号整数的内存序与数值序一致，也在此列
+// 这是一个定制点：以大端字节序存放的定长键（没有填充字节，operator< 与逐字节无符号比较一致）
+// 可以特化为 m_true_type，它们的数组就会整体交给 memcmp 比较
+template <class T>
+struct is_memcmp_ordered
+  : m_bool_constant<
+      std::is_same<T, unsigned char>::value ||
+      (std::is_same<T, char>::value && CHAR_MIN == 0)
+#if defined(__cpp_lib_byte)
+      || std::is_same<T, std::byte>::value
+#endif
+#if defined(MYSTL_BIG_ENDIAN)
+      || (std::is_unsigned<T>::value && !std::is_same<T, bool>::value)
+#endif
+      >
+{
+};
+
+// 其余整数类型：先找到第一个不同的字节，再比较它所在的元素
+template <class T>
+struct is_integral_lexico
+  : m_bool_constant<std::is_integral<T>::value && !is_memcmp_ordered<T>::value>
+{
+};
+
+template <class Tp, class Up, template <class> class Pred>
+struct is_lexico_fast_pair
+  : m_bool_constant<
+      std::is_same<typename std::remove_cv<Tp>::type, typename std::remove_cv<Up>::type>::value &&
+      !std::is_volatile<Tp>::value && !std::is_volatile<Up>::value &&
+      Pred<typename std::remove_cv<Tp>::type>::value>
+{
+};
+
 template <class InputIter1, class InputIter2>
-bool lexicographical_compare(InputIter1 first1, InputIter1 last1,
-                             InputIter2 first2, InputIter2 last2)
+bool unchecked_lexico_compare(InputIter1 first1, InputIter1 last1,
+                              InputIter2 first2, InputIter2 last2)
 {
     for (; first1 != last1 && first2 != last2; ++first1, ++first2)
     {
         if (*first1 < *first2)
             return true;
-        else if (*first1 > *first2)
+        else if (*first2 < *first1)
             return false;
     }
     return first1 == last1 && first2 != last2;
 }
 
+// 针对字节序即字典序的类型的特化版本, 通过 std::memcmp 实现
+// 第一个不同的字节落在第一个不同的元素中，该元素的字节序就是它的值序
+template <class Tp, class Up>
+typename std::enable_if<is_lexico_fast_pair<Tp, Up, is_memcmp_ordered>::value, bool>::type
+unchecked_lexico_compare(Tp *first1, Tp *last1, Up *first2, Up *last2)
+{
+    const auto len1 = static_cast<size_t>(last1 - first1);
+    const auto len2 = static_cast<size_t>(last2 - first2);
+    const auto n = MyStl::min(len1, len2);
+    // 先比较相同长度的部分
+    const auto result = n == 0 ? 0 : std::memcmp(first1, first2, n * sizeof(Tp));
+    // 若相等， 长度较长的比较大
+    return result != 0 ? result < 0 : len1 < len2;
+}
+
+// 针对多字节整数和有符号字节的特化版本
+// 小端机器上内存序与数值序不一致，不能直接 memcmp，只用向量化扫描定位第一个不同的元素
+template <class Tp, class Up>
+typename std::enable_if<is_lexico_fast_pair<Tp, Up, is_integral_lexico>::value, bool>::type
+unchecked_lexico_compare(Tp *first1, Tp *last1, Up *first2, Up *last2)
+{
+    const auto len1 = static_cast<size_t>(last1 - first1);
+    const auto len2 = static_cast<size_t>(last2 - first2);
+    const auto n = MyStl::min(len1, len2);
+    const auto index = simd::mismatch_bytes(first1, first2, n * sizeof(Tp)) / sizeof(Tp);
+    if (index < n)
+        return first1[index] < first2[index];
+    return len1 < len2;
+}
+
+template <class InputIter1, class InputIter2>
+bool lexicographical_compare(InputIter1 first1, InputIter1 last1,
+                             InputIter2 first2, InputIter2 last2)
+{
+    return MyStl::unchecked_lexico_compare(first1, last1, first2, last2);
+}
+
 template <class InputIter1, class InputIter2, class Compare>
 bool lexicographical_compare(InputIter1 first1, InputIter1 last1,
                              InputIter2 first2, InputIter2 last2, Compare comp)
@@ -477,28 +673,12 @@ bool lexicographical_compare(InputIter1 first1, InputIter1 last1,
     return first1 == last1 && first2 != last2;
 }
 
-// 针对const ungined char* 的特化版本, 通过std
-bool lexicographical_compare(const unsigned char *first1,
-                             const unsigned char *last1,
-                             const unsigned char *first2,
-                             const unsigned char *last2)
-{
-    const auto len1 = last1 - first1;
-    const auto len2 = last2 - first2;
-    // 先比较相同长度的部分
-    const auto result = std::memcmp(first1, first2, MyStl::min(len1, len2));
-    // first1 > first2 result > 0
-    // first1 < first2 result < 0
-    // 若相等， 长度较长的比较大
-    return result != 0 ? result < 0 : len1 < len2;
-    // 结果导向理解， 若结果不等于零，就期望他小于0，否则就期望他长度比较小，一种逻辑相当优雅且容易理解的方式
-}
 /*****************************************************************************************/
 // mismatch
 // 平行比较两个序列，找到第一处失配的元素， 返回一对迭代器， 分别指向两个序列中失配的元素
 template <class InputIter1, class InputIter2>
 MyStl::pair<InputIter1, InputIter2>
-mismatch(InputIter1 first1, InputIter1 last1, InputIter2 first2)
+unchecked_mismatch(InputIter1 first1, InputIter1 last1, InputIter2 first2)
 {
     while (first1 != last1 && *first1 == *first2)
     {
@@ -508,6 +688,23 @@ mismatch(InputIter1 first1, InputIter1 last1, InputIter2 first2)
     return MyStl::pair<InputIter1, InputIter2>(first1, first2);
 }
 
+// 为逐位可比较类型提供特化版本，以 32 字节为步长找第一个不同的字节
+template <class Tp, class Up>
+typename std::enable_if<is_bitwise_comparable_pair<Tp, Up>::value, MyStl::pair<Tp*, Up*>>::type
+unchecked_mismatch(Tp *first1, Tp *last1, Up *first2)
+{
+    const auto n = static_cast<size_t>(last1 - first1);
+    const auto index = simd::mismatch_bytes(first1, first2, n * sizeof(Tp)) / sizeof(Tp);
+    return MyStl::pair<Tp*, Up*>(first1 + index, first2 + index);
+}
+
+template <class InputIter1, class InputIter2>
+MyStl::pair<InputIter1, InputIter2>
+mismatch(InputIter1 first1, InputIter1 last1, InputIter2 first2)
+{
+    return MyStl::unchecked_mismatch(first1, last1, first2);
+}
+
 template <class InputIter1, class InputIter2, class Compare>
 MyStl::pair<InputIter1, InputIter2>
 mismatch(InputIter1 first1, InputIter1 last1, InputIter2 first2, Compare comp)
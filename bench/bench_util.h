@@ -0,0 +1,56 @@
+#ifndef MYSTL_BENCH_BENCH_UTIL_H_
+#define MYSTL_BENCH_BENCH_UTIL_H_
+
+// 基准程序共用的计时工具
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace bench
+{
+
+inline double seconds_since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// 重复执行 f，直到累计时间不少于 min_seconds，返回单次的最短耗时（秒）
+template <class Function>
+double best_time(Function f, double min_seconds = 0.2)
+{
+    double best = 1e300, total = 0;
+    int runs = 0;
+    while (total < min_seconds || runs < 3)
+    {
+        auto start = std::chrono::steady_clock::now();
+        f();
+        double t = seconds_since(start);
+        total += t;
+        best = t < best ? t : best;
+        ++runs;
+    }
+    return best;
+}
+
+// 处理 bytes 字节用时 seconds 秒，换算为 GB/s
+inline double gb_per_s(double bytes, double seconds)
+{
+    return bytes / seconds / 1e9;
+}
+
+// 防止结果被优化掉
+template <class T>
+inline void do_not_optimize(const T &value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void *sink;
+    sink = &value;
+#endif
+}
+
+} // namespace bench
+
+#endif
@@ -0,0 +1,71 @@
+// lower_bound 的单次查找延迟（ns），有序 uint32_t 数组从 1 KiB 到 max_bytes（默认 1 GiB，4 GiB 需要相应的内存）
+// 对比 MyStl 的无分支预取版本、带比较器走的普通二分版本和 std::lower_bound
+// 每次查找的键依赖上一次的结果，测到的是延迟而不是多个查找重叠后的吞吐量
+// g++ -std=c++14 -O2 -I.. binary_search_bench.cpp -o binary_search_bench && ./binary_search_bench [max_bytes]
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "../algo.h"
+#include "../functional.h"
+#include "bench_util.h"
+
+namespace
+{
+
+const size_t lookups = 1000000;
+
+// 依次查找 keys，把上一次结果的最低位加到下一个键上，返回每次查找的平均耗时（ns）
+template <class Search>
+double latency(const std::vector<uint32_t> &keys, Search search)
+{
+    size_t prev = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < lookups; ++i)
+        prev = search(keys[i] + static_cast<uint32_t>(prev & 1));
+    double t = bench::seconds_since(start);
+    bench::do_not_optimize(prev);
+    return t / lookups * 1e9;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const size_t max_bytes = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : (static_cast<size_t>(1) << 30);
+    const size_t max_n = max_bytes / sizeof(uint32_t);
+    std::vector<uint32_t> data(max_n);
+    for (size_t i = 0; i < max_n; ++i)
+        data[i] = static_cast<uint32_t>(2 * i);
+    std::mt19937 rng(38);
+    std::vector<uint32_t> keys(lookups);
+
+    std::printf("%12s %14s %14s %14s\n", "bytes", "branchless", "MyStl + comp", "std");
+    for (size_t bytes = 1024; bytes <= max_bytes; bytes *= 4)
+    {
+        const size_t n = bytes / sizeof(uint32_t);
+        for (auto &k : keys)
+            k = static_cast<uint32_t>(rng() % (2 * n));
+        const uint32_t *first = data.data();
+        const uint32_t *last = first + n;
+        double t0 = latency(keys, [&](uint32_t k)
+        {
+            return static_cast<size_t>(MyStl::lower_bound(first, last, k) - first);
+        });
+        double t1 = latency(keys, [&](uint32_t k)
+        {
+            return static_cast<size_t>(MyStl::lower_bound(first, last, k, MyStl::less<uint32_t>()) - first);
+        });
+        double t2 = latency(keys, [&](uint32_t k)
+        {
+            return static_cast<size_t>(std::lower_bound(first, last, k) - first);
+        });
+        std::printf("%12zu %11.1f ns %11.1f ns %11.1f ns\n", bytes, t0, t1, t2);
+    }
+    return 0;
+}
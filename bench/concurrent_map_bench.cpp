@@ -0,0 +1,134 @@
+// concurrent_map 与 std::map + std::mutex 在 1 到 64 个线程下的吞吐量对比
+// 预先插入 n 个键，每个线程在固定时长内执行 90% find / 5% insert / 5% erase 的混合操作
+// g++ -std=c++14 -O2 -pthread -I.. concurrent_map_bench.cpp -o concurrent_map_bench && ./concurrent_map_bench [n] [seconds]
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "../concurrent_map.h"
+
+namespace
+{
+
+// 累加查到的值，防止查找被优化掉
+std::atomic<uint64_t> checksum{0};
+
+// 加一把全局锁的 std::map，作为对照
+class locked_map
+{
+public:
+    bool find(uint64_t key, uint64_t &value) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = map_.find(key);
+        if (it == map_.end())
+            return false;
+        value = it -> second;
+        return true;
+    }
+    bool insert(uint64_t key, uint64_t value)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return map_.emplace(key, value).second;
+    }
+    bool erase(uint64_t key)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return map_.erase(key) == 1;
+    }
+
+private:
+    mutable std::mutex           mutex_;
+    std::map<uint64_t, uint64_t> map_;
+};
+
+// 返回每秒完成的百万次操作数
+template <class Map>
+double run(Map &map, uint64_t key_range, unsigned threads, double seconds)
+{
+    std::atomic<bool>   start{false};
+    std::atomic<bool>   stop{false};
+    std::atomic<size_t> total{0};
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; ++t)
+    {
+        pool.emplace_back([&, t]()
+        {
+            std::mt19937_64 rng(t + 1);
+            size_t ops = 0;
+            uint64_t sink = 0;
+            while (!start.load(std::memory_order_acquire))
+                std::this_thread::yield();
+            while (!stop.load(std::memory_order_relaxed))
+            {
+                // 每批 64 次操作检查一次是否结束
+                for (int i = 0; i < 64; ++i)
+                {
+                    uint64_t key = rng() % key_range;
+                    unsigned op = static_cast<unsigned>(rng() % 20);
+                    if (op == 0)
+                        map.insert(key, key);
+                    else if (op == 1)
+                        map.erase(key);
+                    else
+                    {
+                        uint64_t value;
+                        if (map.find(key, value))
+                            sink += value;
+                    }
+                }
+                ops += 64;
+            }
+            total.fetch_add(ops, std::memory_order_relaxed);
+            checksum.fetch_add(sink, std::memory_order_relaxed);
+        });
+    }
+    auto begin = std::chrono::steady_clock::now();
+    start.store(true, std::memory_order_release);
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    stop.store(true, std::memory_order_relaxed);
+    for (auto &th : pool)
+        th.join();
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    return total.load() / elapsed / 1e6;
+}
+
+template <class Map>
+void prefill(Map &map, uint64_t n)
+{
+    for (uint64_t k = 0; k < n; ++k)
+        map.insert(k * 2, k * 2);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    uint64_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    double seconds = argc > 2 ? std::atof(argv[2]) : 1.0;
+
+    // 键取自 [0, 2n)，约一半命中
+    MyStl::concurrent_map<uint64_t, uint64_t> cmap;
+    locked_map lmap;
+    prefill(cmap, n);
+    prefill(lmap, n);
+
+    std::printf("n = %llu, %.1f s per run, hardware threads = %u\n",
+                static_cast<unsigned long long>(n), seconds, std::thread::hardware_concurrency());
+    std::printf("%8s %18s %18s\n", "threads", "concurrent_map", "map + mutex");
+    for (unsigned threads = 1; threads <= 64; threads *= 2)
+    {
+        double c = run(cmap, n * 2, threads, seconds);
+        double l = run(lmap, n * 2, threads, seconds);
+        std::printf("%8u %12.2f Mop/s %12.2f Mop/s\n", threads, c, l);
+    }
+    return 0;
+}
@@ -0,0 +1,105 @@
+// IntervalTree / StaticIntervalTree 与线性扫描的对比
+// 默认 1e7 个区间，查询窗口的起点均匀随机，宽度在几档之间变化
+// g++ -std=c++14 -O2 -I.. interval_tree_bench.cpp -o interval_tree_bench && ./interval_tree_bench [n] [queries]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "../tree.hpp"
+
+namespace
+{
+
+typedef long long key_type;
+typedef Interval<key_type> interval_type;
+
+// 只计数的输出迭代器，避免把写结果的开销算进查询
+struct count_iterator
+{
+    size_t *count;
+    count_iterator& operator*() { return *this; }
+    count_iterator& operator++() { return *this; }
+    count_iterator operator++(int) { return *this; }
+    count_iterator& operator=(const interval_type &) { ++*count; return *this; }
+};
+
+double seconds_since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    const size_t queries = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1000;
+    const key_type horizon = 1000000000;   // 时间轴长度
+    const key_type max_length = 10000;     // 单个区间的最大长度
+
+    std::mt19937_64 rng(42);
+    std::vector<interval_type> intervals(n);
+    for (auto &iv : intervals)
+    {
+        iv.low = static_cast<key_type>(rng() % horizon);
+        iv.high = iv.low + 1 + static_cast<key_type>(rng() % max_length);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    StaticIntervalTree<key_type> static_tree(intervals);
+    std::printf("static build:  %zu intervals in %.2f s\n", n, seconds_since(start));
+
+    start = std::chrono::steady_clock::now();
+    IntervalTree<key_type> tree;
+    for (auto &iv : intervals)
+        tree.insert(iv);
+    std::printf("dynamic build: %zu intervals in %.2f s\n", n, seconds_since(start));
+
+    const key_type widths[] = {1, 1000, 100000, 10000000};
+    for (auto width : widths)
+    {
+        std::vector<interval_type> windows(queries);
+        for (auto &w : windows)
+        {
+            w.low = static_cast<key_type>(rng() % horizon);
+            w.high = w.low + width;
+        }
+
+        size_t hits[3] = {0, 0, 0};
+        double elapsed[3];
+        start = std::chrono::steady_clock::now();
+        for (auto &w : windows)
+            tree.overlap_query(w.low, w.high, count_iterator{&hits[0]});
+        elapsed[0] = seconds_since(start);
+
+        start = std::chrono::steady_clock::now();
+        for (auto &w : windows)
+            static_tree.overlap_query(w.low, w.high, count_iterator{&hits[1]});
+        elapsed[1] = seconds_since(start);
+
+        // 线性扫描太慢，只跑少量查询再按比例折算
+        const size_t scan_queries = queries < 20 ? queries : 20;
+        start = std::chrono::steady_clock::now();
+        for (size_t q = 0; q < scan_queries; ++q)
+            for (auto &iv : intervals)
+                hits[2] += iv.overlaps(windows[q].low, windows[q].high);
+        elapsed[2] = seconds_since(start) * queries / scan_queries;
+
+        size_t check = 0;
+        for (size_t q = 0; q < scan_queries; ++q)
+            static_tree.overlap_query(windows[q].low, windows[q].high, count_iterator{&check});
+        if (check != hits[2] || hits[0] != hits[1])
+        {
+            std::printf("result mismatch\n");
+            return 1;
+        }
+
+        std::printf("width %-9lld avg hits %-9.1f dynamic %9.2f us  static %9.2f us  scan %11.2f us\n",
+                    static_cast<long long>(width), static_cast<double>(hits[0]) / queries,
+                    elapsed[0] * 1e6 / queries, elapsed[1] * 1e6 / queries, elapsed[2] * 1e6 / queries);
+    }
+    return 0;
+}
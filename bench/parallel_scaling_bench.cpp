@@ -0,0 +1,74 @@
+// 并行算法的扩展性：n 个 uint32_t 上顺序版本（seq）与并行版本（par）的耗时和加速比
+// 线程池只能在第一次使用前配置，所以每个线程数单独运行一次，例如
+//   for t in 1 2 4 8 16 32; do ./parallel_scaling_bench 1000000000 $t; done
+// n = 1e9 时输入、输出和标志数组共需约 9 GiB 内存，默认 n = 1e8
+// g++ -std=c++14 -O2 -pthread -I.. parallel_scaling_bench.cpp -o parallel_scaling_bench && ./parallel_scaling_bench [n] [threads]
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "../parallel_algo.h"
+#include "bench_util.h"
+
+namespace
+{
+
+template <class Seq, class Par>
+void run(const char *name, Seq seq, Par par)
+{
+    double ts = bench::best_time(seq, 0.5);
+    double tp = bench::best_time(par, 0.5);
+    std::printf("%-16s %10.1f ms %10.1f ms %8.2fx\n", name, ts * 1e3, tp * 1e3, ts / tp);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000000;
+    const size_t threads = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 0;
+    if (threads != 0)
+        MyStl::thread_pool::configure(threads);
+
+    std::vector<uint32_t> in(n), out(n);
+    std::mt19937 rng(1);
+    for (auto &x : in)
+        x = rng();
+    uint32_t *first = in.data();
+    uint32_t *last = first + n;
+    uint32_t *result = out.data();
+    const uint32_t half = 0x80000000u;
+    auto keep = [half](uint32_t x) { return x < half; };
+
+    std::printf("n = %zu, threads = %zu, hardware threads = %u\n", n,
+                MyStl::thread_pool::instance().concurrency(), std::thread::hardware_concurrency());
+    std::printf("%-16s %13s %13s %9s\n", "algorithm", "seq", "par", "speedup");
+    run("for_each",
+        [&] { MyStl::for_each(MyStl::execution::seq, result, result + n, [](uint32_t &x) { x = x * 3 + 1; }); },
+        [&] { MyStl::for_each(MyStl::execution::par, result, result + n, [](uint32_t &x) { x = x * 3 + 1; }); });
+    run("reduce",
+        [&] { bench::do_not_optimize(MyStl::reduce(MyStl::execution::seq, first, last, uint64_t(0))); },
+        [&] { bench::do_not_optimize(MyStl::reduce(MyStl::execution::par, first, last, uint64_t(0))); });
+    run("find (no match)",
+        [&] { bench::do_not_optimize(MyStl::find(MyStl::execution::seq, first, last, 0u) - first); },
+        [&] { bench::do_not_optimize(MyStl::find(MyStl::execution::par, first, last, 0u) - first); });
+    run("inclusive_scan",
+        [&] { MyStl::inclusive_scan(MyStl::execution::seq, first, last, result); },
+        [&] { MyStl::inclusive_scan(MyStl::execution::par, first, last, result); });
+    run("exclusive_scan",
+        [&] { MyStl::exclusive_scan(MyStl::execution::seq, first, last, result, 0u); },
+        [&] { MyStl::exclusive_scan(MyStl::execution::par, first, last, result, 0u); });
+    run("copy_if (50%)",
+        [&] { bench::do_not_optimize(MyStl::copy_if(MyStl::execution::seq, first, last, result, keep)); },
+        [&] { bench::do_not_optimize(MyStl::copy_if(MyStl::execution::par, first, last, result, keep)); });
+    // remove_if 会改写输入，每次先从 in 拷贝到 out 再在 out 上执行，两边都包含这次拷贝
+    run("remove_if (50%)",
+        [&] { MyStl::copy(first, last, result);
+              bench::do_not_optimize(MyStl::remove_if(MyStl::execution::seq, result, result + n, keep)); },
+        [&] { MyStl::copy(MyStl::execution::par, first, last, result);
+              bench::do_not_optimize(MyStl::remove_if(MyStl::execution::par, result, result + n, keep)); });
+    return 0;
+}
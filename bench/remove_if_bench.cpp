@@ -0,0 +1,91 @@
+// 并行 remove_if 在不同保留比例（1% 到 99%）下的耗时：顺序 MyStl::remove_if、并行版本与 std::remove_if 对比
+// 每次计时前都要把输入重新拷贝到工作区，表中的时间已减去单独测得的拷贝时间
+// uint32_t 走 simd::compress32，uint64_t 走逐个移动，std::string 走只移动构造的临时缓冲区
+// 线程池只能在第一次使用前配置，每个线程数单独运行一次，例如 for t in 1 2 4 8; do ./remove_if_bench 100000000 $t; done
+// g++ -std=c++14 -O2 -pthread -I.. remove_if_bench.cpp -o remove_if_bench && ./remove_if_bench [n] [threads]
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../parallel_algo.h"
+#include "bench_util.h"
+
+namespace
+{
+
+template <class T, class Make>
+void run(const char *name, size_t n, Make make)
+{
+    std::mt19937_64 rng(44);
+    std::vector<T> in(n), work(n);
+    std::vector<uint32_t> key(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        in[i] = make(i);
+        key[i] = static_cast<uint32_t>(rng() % 100);
+    }
+    // 谓词只看元素的值：每个元素的低位决定它落在 [0, 100) 中的哪一档
+    std::printf("%s, n = %zu\n%8s %13s %13s %13s %9s\n", name, n, "kept", "seq", "par", "std", "speedup");
+    const double t_copy = bench::best_time([&] { std::copy(in.begin(), in.end(), work.begin()); }, 0.5);
+    for (unsigned keep : {1u, 10u, 50u, 90u, 99u})
+    {
+        auto pred = [&](const T &x) { return key[make.index(x) % n] >= keep; };
+        T *first = work.data();
+        T *last = first + n;
+        double ts = bench::best_time([&]
+        {
+            std::copy(in.begin(), in.end(), work.begin());
+            bench::do_not_optimize(MyStl::remove_if(first, last, pred) - first);
+        }, 0.5) - t_copy;
+        double tp = bench::best_time([&]
+        {
+            std::copy(in.begin(), in.end(), work.begin());
+            bench::do_not_optimize(MyStl::remove_if(MyStl::execution::par, first, last, pred) - first);
+        }, 0.5) - t_copy;
+        double tstd = bench::best_time([&]
+        {
+            std::copy(in.begin(), in.end(), work.begin());
+            bench::do_not_optimize(std::remove_if(first, last, pred) - first);
+        }, 0.5) - t_copy;
+        std::printf("%7u%% %10.1f ms %10.1f ms %10.1f ms %8.2fx\n", keep, ts * 1e3, tp * 1e3, tstd * 1e3, ts / tp);
+    }
+}
+
+struct make_u32
+{
+    uint32_t operator()(size_t i) const { return static_cast<uint32_t>(i); }
+    size_t index(uint32_t x) const { return x; }
+};
+
+struct make_u64
+{
+    uint64_t operator()(size_t i) const { return static_cast<uint64_t>(i) << 20; }
+    size_t index(uint64_t x) const { return static_cast<size_t>(x >> 20); }
+};
+
+struct make_string
+{
+    std::string operator()(size_t i) const { return std::to_string(i) + " padding past SSO"; }
+    size_t index(const std::string &x) const { return std::strtoull(x.c_str(), nullptr, 10); }
+};
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000000;
+    const size_t threads = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 0;
+    if (threads != 0)
+        MyStl::thread_pool::configure(threads);
+    std::printf("threads = %zu, hardware threads = %u\n", MyStl::thread_pool::instance().concurrency(),
+                std::thread::hardware_concurrency());
+    run<uint32_t>("uint32_t", n, make_u32());
+    run<uint64_t>("uint64_t", n, make_u64());
+    run<std::string>("std::string", n / 20, make_string());
+    return 0;
+}
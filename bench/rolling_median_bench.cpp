@@ -0,0 +1,69 @@
+// 滑动窗口中位数：AVL 的 select 与有序 vector（lower_bound 定位后插入、删除）的对比
+// 默认窗口 1e6，窗口填满后再滑动 steps 步，每步插入一个新值、删除最旧的值、取一次中位数
+// g++ -std=c++14 -O2 -I.. rolling_median_bench.cpp -o rolling_median_bench && ./rolling_median_bench [window] [steps]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "../tree.hpp"
+
+namespace
+{
+
+double seconds_since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const size_t window = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    const size_t steps = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 100000;
+
+    std::mt19937_64 rng(42);
+    std::vector<long long> stream(window + steps);
+    for (auto &x : stream)
+        x = static_cast<long long>(rng() % 1000000000);
+
+    // AVL：O(log w) 插入、删除和 select
+    long long avl_sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    AVL<long long> avl;
+    for (size_t i = 0; i < window; ++i)
+        avl.insert(stream[i]);
+    double avl_fill = seconds_since(start);
+    start = std::chrono::steady_clock::now();
+    for (size_t i = window; i < stream.size(); ++i)
+    {
+        avl.insert(stream[i]);
+        avl.erase(stream[i - window]);
+        avl_sum += avl.select(window / 2).first -> value;
+    }
+    double avl_slide = seconds_since(start);
+
+    // 有序 vector：O(log w) 定位，O(w) 搬移
+    long long vec_sum = 0;
+    start = std::chrono::steady_clock::now();
+    std::vector<long long> sorted(stream.begin(), stream.begin() + window);
+    std::sort(sorted.begin(), sorted.end());
+    double vec_fill = seconds_since(start);
+    start = std::chrono::steady_clock::now();
+    for (size_t i = window; i < stream.size(); ++i)
+    {
+        sorted.insert(std::lower_bound(sorted.begin(), sorted.end(), stream[i]), stream[i]);
+        sorted.erase(std::lower_bound(sorted.begin(), sorted.end(), stream[i - window]));
+        vec_sum += sorted[window / 2];
+    }
+    double vec_slide = seconds_since(start);
+
+    std::printf("window %zu, %zu steps\n", window, steps);
+    std::printf("AVL select:    fill %.2f s, %.3f us per step\n", avl_fill, avl_slide / steps * 1e6);
+    std::printf("sorted vector: fill %.2f s, %.3f us per step\n", vec_fill, vec_slide / steps * 1e6);
+    std::printf("medians %s\n", avl_sum == vec_sum ? "match" : "DIFFER");
+    return avl_sum == vec_sum ? 0 : 1;
+}
@@ -0,0 +1,61 @@
+// 把 n 个 uint64_t（默认 n = 1e8，800 MB）左旋 k 个位置，k 取跨过 256 B 栈缓冲区和 1 MiB 临时缓冲区边界的若干值：
+//   rotate        按较短一段的字节数分派：栈上缓冲区 / 临时缓冲区 / 块交换
+//   rotate_bytes  较短一段拷到缓冲区、较长一段整体 memmove，缓冲区预先申请好，不计申请和首次写入的时间
+//   rotate_blocks 块交换（Gries-Mills）
+//   rotate_cycles 按 gcd(n, k) 个置换环轮转，每个元素只移动一次，但访存跨度为 k
+//   std::rotate
+// 旋转不改变数据的性质，每次在上一次的结果上继续旋转；表中为单次耗时（毫秒）
+// 预先申请的缓冲区最多 n / 2 个元素，默认参数共约 1.2 GB 内存
+// g++ -std=c++14 -O2 -I.. rotate_bench.cpp -o rotate_bench && ./rotate_bench [n]
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "../algo.h"
+#include "bench_util.h"
+
+int main(int argc, char **argv)
+{
+    const size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000000;
+    std::vector<uint64_t> v(n);
+    for (size_t i = 0; i < n; ++i)
+        v[i] = i;
+    std::vector<unsigned char> buffer(n / 2 * sizeof(uint64_t));
+    uint64_t *first = v.data(), *last = first + n;
+
+    const size_t stack = MyStl::rotate_stack_bytes / sizeof(uint64_t);
+    const size_t heap = MyStl::rotate_buffer_bytes / sizeof(uint64_t);
+    const size_t amounts[] = {1, stack, stack + 1, 1000, heap, heap + 1, 1000000, n / 10, n / 3, n / 2};
+
+    std::printf("n = %zu uint64_t, time per rotation in ms\n", n);
+    std::printf("%12s %10s %13s %13s %13s %11s\n", "k", "rotate", "rotate_bytes", "rotate_blocks",
+                "rotate_cycles", "std::rotate");
+    for (size_t k : amounts)
+    {
+        if (k == 0 || k >= n)
+            continue;
+        uint64_t *middle = first + k;
+        const double t = bench::best_time([&] { bench::do_not_optimize(MyStl::rotate(first, middle, last)); }, 0);
+        const double t_bytes = bench::best_time([&]
+        {
+            MyStl::rotate_bytes(reinterpret_cast<unsigned char*>(first), k * sizeof(uint64_t),
+                                (n - k) * sizeof(uint64_t), buffer.data());
+            bench::do_not_optimize(first[0]);
+        }, 0);
+        const double t_blocks = bench::best_time([&]
+        {
+            bench::do_not_optimize(MyStl::rotate_blocks(first, middle, last));
+        }, 0);
+        const double t_cycles = bench::best_time([&]
+        {
+            bench::do_not_optimize(MyStl::rotate_cycles(first, middle, last));
+        }, 0);
+        const double t_std = bench::best_time([&] { bench::do_not_optimize(std::rotate(first, middle, last)); }, 0);
+        std::printf("%12zu %10.1f %13.1f %13.1f %13.1f %11.1f\n", k, t * 1e3, t_bytes * 1e3, t_blocks * 1e3,
+                    t_cycles * 1e3, t_std * 1e3);
+    }
+    return 0;
+}
@@ -0,0 +1,86 @@
+// search_n 与 adjacent_find 在稀疏匹配下的吞吐量（GB/s）：MyStl 的 SIMD 版本与 std 对比
+// search_n：查找值在数据中以给定密度零散出现（不成段），长度为 count 的段只放在末尾
+// adjacent_find：相邻元素都不相等，只有末尾一对相等
+// g++ -std=c++14 -O2 -I.. search_n_bench.cpp -o search_n_bench && ./search_n_bench [bytes]
+// 用 -DMYSTL_NO_AVX2 / -DMYSTL_NO_SIMD 构建可以比较 SSE2 和标量路径
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "../algo.h"
+#include "bench_util.h"
+
+namespace
+{
+
+std::mt19937_64 rng(41);
+
+// 查找值 1 以 1 / period 的密度出现且彼此不相邻，其余元素取 2..max，末尾放 count 个 1
+template <class T>
+void fill_sparse(std::vector<T> &v, size_t period, size_t count, uint64_t max)
+{
+    for (size_t i = 0; i < v.size(); ++i)
+        v[i] = static_cast<T>(2 + rng() % (max - 1));
+    for (size_t i = 0; i + count < v.size(); i += period)
+        v[i + rng() % (period / 2 + 1)] = 1;
+    std::fill(v.end() - count, v.end(), T(1));
+    for (size_t i = 1; i + count < v.size(); ++i)
+        if (v[i] == 1 && v[i - 1] == 1)
+            v[i] = 2;
+}
+
+template <class T>
+void run_search_n(const char *name, size_t bytes, uint64_t max)
+{
+    std::vector<T> v(bytes / sizeof(T));
+    std::printf("search_n, %s\n%10s %8s %14s %14s\n", name, "density", "count", "MyStl", "std");
+    for (size_t period : {10000u, 100u, 10u})
+    {
+        for (size_t count : {4u, 16u, 64u})
+        {
+            fill_sparse(v, period, count, max);
+            const T *first = v.data();
+            const T *last = first + v.size();
+            double t0 = bench::best_time([&] { bench::do_not_optimize(MyStl::search_n(first, last, count, T(1))); });
+            double t1 = bench::best_time([&] { bench::do_not_optimize(std::search_n(first, last, count, T(1))); });
+            std::printf("%8s%zu %8zu %9.2f GB/s %9.2f GB/s\n", "1/", period, count,
+                        bench::gb_per_s(static_cast<double>(bytes), t0),
+                        bench::gb_per_s(static_cast<double>(bytes), t1));
+        }
+    }
+}
+
+template <class T>
+void run_adjacent(const char *name, size_t bytes)
+{
+    std::vector<T> v(bytes / sizeof(T));
+    for (size_t i = 0; i < v.size(); ++i)
+        v[i] = static_cast<T>(i % 2 == 0 ? 1 + rng() % 100 : 101 + rng() % 100);
+    v[v.size() - 1] = v[v.size() - 2];
+    const T *first = v.data();
+    const T *last = first + v.size();
+    double t0 = bench::best_time([&] { bench::do_not_optimize(MyStl::adjacent_find(first, last)); });
+    double t1 = bench::best_time([&] { bench::do_not_optimize(std::adjacent_find(first, last)); });
+    std::printf("adjacent_find, %-9s %9.2f GB/s %9.2f GB/s\n", name,
+                bench::gb_per_s(static_cast<double>(bytes), t0), bench::gb_per_s(static_cast<double>(bytes), t1));
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const size_t bytes = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : (static_cast<size_t>(64) << 20);
+    std::printf("path: %s, %zu bytes\n", MyStl::simd::has_avx2() ? "avx2" : "sse2 or scalar", bytes);
+    run_search_n<uint8_t>("uint8_t", bytes, 255);
+    run_search_n<uint32_t>("uint32_t", bytes, 1000000);
+    std::printf("%-24s %14s %14s\n", "", "MyStl", "std");
+    run_adjacent<uint8_t>("uint8_t", bytes);
+    run_adjacent<uint16_t>("uint16_t", bytes);
+    run_adjacent<uint32_t>("uint32_t", bytes);
+    run_adjacent<double>("double", bytes);
+    return 0;
+}
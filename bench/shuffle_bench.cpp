@@ -0,0 +1,75 @@
+// 洗牌 n 个 uint64_t 的耗时（每个元素的纳秒数）：
+//   shuffle + xoshiro256ss / pcg32 / std::mt19937_64   原生指针版本，提前抽出交换位置并预取
+//   shuffle_dispatch（通用版本）+ xoshiro256ss          逐步抽取、不预取
+//   std::shuffle + std::mt19937_64
+//   shuffle(par) + xoshiro256ss                         MergeShuffle：分块并行洗牌再逐层合并
+// 需求中的规模是 n = 1e9（8 GB），这台机器只有 5 GB 内存，默认 n = 1e8（800 MB）；内存足够时可以传入 1000000000
+// 区间远大于缓存时每次交换都是一次随机访存，耗时主要取决于访存延迟能否重叠
+// 线程池只能在第一次使用前配置，每个线程数单独运行一次，例如 for t in 1 2 4 8; do ./shuffle_bench 100000000 $t; done
+// g++ -std=c++14 -O2 -pthread -I.. shuffle_bench.cpp -o shuffle_bench && ./shuffle_bench [n] [threads]
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "../parallel_algo.h"
+#include "../random.h"
+#include "bench_util.h"
+
+int main(int argc, char **argv)
+{
+    const size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000000;
+    const size_t threads = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 0;
+    if (threads != 0)
+        MyStl::thread_pool::configure(threads);
+    std::printf("n = %zu uint64_t, threads = %zu, hardware threads = %u\n", n,
+                MyStl::thread_pool::instance().concurrency(), std::thread::hardware_concurrency());
+    std::vector<uint64_t> v(n);
+    for (size_t i = 0; i < n; ++i)
+        v[i] = i;
+    uint64_t *first = v.data(), *last = first + n;
+    MyStl::xoshiro256ss xo(49);
+    MyStl::pcg32 pcg(49);
+    std::mt19937_64 mt(49);
+
+    // 洗牌的结果仍是一个排列，每次在上一次的结果上继续洗
+    auto report = [&](const char *name, double t)
+    {
+        std::printf("%-36s %10.1f ms %8.2f ns/elem\n", name, t * 1e3, t * 1e9 / static_cast<double>(n));
+    };
+    report("shuffle xoshiro256ss", bench::best_time([&]
+    {
+        MyStl::shuffle(first, last, xo);
+        bench::do_not_optimize(first[0]);
+    }, 0));
+    report("shuffle pcg32", bench::best_time([&]
+    {
+        MyStl::shuffle(first, last, pcg);
+        bench::do_not_optimize(first[0]);
+    }, 0));
+    report("shuffle mt19937_64", bench::best_time([&]
+    {
+        MyStl::shuffle(first, last, mt);
+        bench::do_not_optimize(first[0]);
+    }, 0));
+    report("shuffle_dispatch (no prefetch)", bench::best_time([&]
+    {
+        MyStl::shuffle_dispatch<uint64_t*>(first, last, xo);
+        bench::do_not_optimize(first[0]);
+    }, 0));
+    report("std::shuffle mt19937_64", bench::best_time([&]
+    {
+        std::shuffle(first, last, mt);
+        bench::do_not_optimize(first[0]);
+    }, 0));
+    report("shuffle(par) xoshiro256ss", bench::best_time([&]
+    {
+        MyStl::shuffle(MyStl::execution::par, first, last, xo);
+        bench::do_not_optimize(first[0]);
+    }, 0));
+    return 0;
+}
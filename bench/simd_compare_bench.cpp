@@ -0,0 +1,93 @@
+// equal / mismatch 的吞吐量（GB/s，按单个缓冲区的字节数计）：与 std::equal / std::mismatch 对比
+// 两个缓冲区内容相同，必须比较到结尾；区间大小从 4 KiB 到 max_bytes（默认 1 GiB）
+// lexicographical_compare：大量定长短键两两比较的耗时，键的前半部分相同，与 std::lexicographical_compare 对比
+// g++ -std=c++14 -O2 -I.. simd_compare_bench.cpp -o simd_compare_bench && ./simd_compare_bench [max_bytes]
+// 用 -DMYSTL_NO_AVX2 / -DMYSTL_NO_SIMD 构建可以比较 SSE2 和标量路径
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include "../algobase.h"
+#include "bench_util.h"
+
+namespace
+{
+
+template <class T>
+void run_equal_mismatch(const char *name, size_t max_bytes)
+{
+    std::printf("%s\n%12s %14s %14s %14s %14s\n", name, "bytes",
+                "MyStl equal", "std::equal", "MyStl mismatch", "std::mismatch");
+    for (size_t bytes = 4096; bytes <= max_bytes; bytes *= 4)
+    {
+        const size_t n = bytes / sizeof(T);
+        std::vector<T> a(n);
+        for (size_t i = 0; i < n; ++i)
+            a[i] = static_cast<T>(i * 2654435761u);
+        std::vector<T> b(a);
+        const T *pa = a.data(), *pb = b.data();
+        double t[4];
+        t[0] = bench::best_time([&] { bench::do_not_optimize(MyStl::equal(pa, pa + n, pb)); });
+        t[1] = bench::best_time([&] { bench::do_not_optimize(std::equal(pa, pa + n, pb)); });
+        t[2] = bench::best_time([&] { bench::do_not_optimize(MyStl::mismatch(pa, pa + n, pb).first); });
+        t[3] = bench::best_time([&] { bench::do_not_optimize(std::mismatch(pa, pa + n, pb).first); });
+        std::printf("%12zu", bytes);
+        for (double x : t)
+            std::printf(" %9.2f GB/s", bench::gb_per_s(static_cast<double>(bytes), x));
+        std::printf("\n");
+    }
+}
+
+// keys 个长度为 key_bytes 字节的键，前一半字节全部相同；相邻两个键比较一次，返回 ns / 次
+template <class T>
+void run_lexico(const char *name, size_t key_bytes)
+{
+    const size_t keys = 1 << 16;
+    const size_t len = key_bytes / sizeof(T);
+    std::vector<T> data(keys * len);
+    std::mt19937_64 rng(33);
+    for (size_t k = 0; k < keys; ++k)
+        for (size_t i = 0; i < len; ++i)
+            data[k * len + i] = static_cast<T>(i < len / 2 ? i : rng());
+    const T *p = data.data();
+    auto mystl = [&]
+    {
+        size_t less = 0;
+        for (size_t k = 0; k + 1 < keys; ++k)
+            less += MyStl::lexicographical_compare(p + k * len, p + (k + 1) * len, p + (k + 1) * len, p + (k + 2) * len);
+        bench::do_not_optimize(less);
+    };
+    auto standard = [&]
+    {
+        size_t less = 0;
+        for (size_t k = 0; k + 1 < keys; ++k)
+            less += std::lexicographical_compare(p + k * len, p + (k + 1) * len, p + (k + 1) * len, p + (k + 2) * len);
+        bench::do_not_optimize(less);
+    };
+    double t0 = bench::best_time(mystl) / (keys - 1) * 1e9;
+    double t1 = bench::best_time(standard) / (keys - 1) * 1e9;
+    std::printf("%-14s %6zu B %10.2f ns %10.2f ns\n", name, key_bytes, t0, t1);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    size_t max_bytes = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : (static_cast<size_t>(1) << 30);
+    std::printf("path: %s\n", MyStl::simd::has_avx2() ? "avx2" : "sse2 or scalar");
+    run_equal_mismatch<unsigned char>("uint8_t", max_bytes);
+    run_equal_mismatch<uint64_t>("uint64_t", max_bytes);
+
+    std::printf("\nlexicographical_compare per key pair\n%-14s %8s %13s %13s\n", "element", "key", "MyStl", "std");
+    for (size_t key_bytes : {16, 64, 256, 1024})
+    {
+        run_lexico<unsigned char>("unsigned char", key_bytes);
+        run_lexico<signed char>("signed char", key_bytes);
+        run_lexico<uint32_t>("uint32_t", key_bytes);
+    }
+    return 0;
+}
@@ -0,0 +1,36 @@
+// 按大小分档的拷贝带宽（GB/s）：MyStl::copy 与 memcpy、std::copy 对比，拷贝大小从 4 KiB 到 max_bytes（默认 1 GiB）
+// 带宽按读加写计，即每拷贝一个字节算两个字节的内存流量；超过 simd::nt_store_threshold() 的行使用非临时存储，用 * 标出
+// g++ -std=c++14 -O2 -I.. simd_copy_bench.cpp -o simd_copy_bench && ./simd_copy_bench [max_bytes]
+// 用 -DMYSTL_NT_STORE_THRESHOLD=<bytes> 构建可以比较不同阈值，-DMYSTL_NO_SIMD 则始终交给 memmove
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "../algobase.h"
+#include "bench_util.h"
+
+int main(int argc, char **argv)
+{
+    size_t max_bytes = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : (static_cast<size_t>(1) << 30);
+    std::vector<uint64_t> src(max_bytes / 8, 1), dst(max_bytes / 8, 0);
+    std::printf("path: %s, non-temporal threshold: %zu bytes\n",
+                MyStl::simd::has_avx2() ? "avx2" : "sse2 or scalar", MyStl::simd::nt_store_threshold());
+    std::printf("%12s %14s %14s %14s\n", "bytes", "MyStl::copy", "memcpy", "std::copy");
+    for (size_t bytes = 4096; bytes <= max_bytes; bytes *= 4)
+    {
+        const size_t n = bytes / 8;
+        const uint64_t *s = src.data();
+        uint64_t *d = dst.data();
+        double t0 = bench::best_time([&] { MyStl::copy(s, s + n, d); bench::do_not_optimize(d[n / 2]); });
+        double t1 = bench::best_time([&] { std::memcpy(d, s, bytes); bench::do_not_optimize(d[n / 2]); });
+        double t2 = bench::best_time([&] { std::copy(s, s + n, d); bench::do_not_optimize(d[n / 2]); });
+        const double traffic = 2.0 * static_cast<double>(bytes);
+        std::printf("%12zu%s %9.2f GB/s %9.2f GB/s %9.2f GB/s\n", bytes, MyStl::simd::use_nt_store(bytes) ? "*" : " ",
+                    bench::gb_per_s(traffic, t0), bench::gb_per_s(traffic, t1), bench::gb_per_s(traffic, t2));
+    }
+    return 0;
+}
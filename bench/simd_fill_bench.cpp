@@ -0,0 +1,50 @@
+// fill_n 的吞吐量（GB/s）：MyStl 的广播存储与 std::fill_n 对比，填充大小从 4 KiB 到 max_bytes（默认 1 GiB）
+// 超过 simd::nt_store_threshold() 的行使用非临时存储，用 * 标出
+// g++ -std=c++14 -O2 -I.. simd_fill_bench.cpp -o simd_fill_bench && ./simd_fill_bench [max_bytes]
+// 用 -DMYSTL_NO_AVX2 / -DMYSTL_NO_SIMD 构建可以比较 SSE2 和标量路径
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "../algobase.h"
+#include "bench_util.h"
+
+namespace
+{
+
+struct pod16
+{
+    uint32_t a, b, c, d;
+};
+
+template <class T>
+void run(const char *name, std::vector<unsigned char> &buffer, size_t max_bytes, const T &value)
+{
+    std::printf("%s\n%12s %14s %14s\n", name, "bytes", "MyStl fill_n", "std::fill_n");
+    T *p = reinterpret_cast<T*>(buffer.data());
+    for (size_t bytes = 4096; bytes <= max_bytes; bytes *= 4)
+    {
+        const size_t n = bytes / sizeof(T);
+        double t0 = bench::best_time([&] { MyStl::fill_n(p, n, value); bench::do_not_optimize(p[n / 2]); });
+        double t1 = bench::best_time([&] { std::fill_n(p, n, value); bench::do_not_optimize(p[n / 2]); });
+        std::printf("%12zu%s %9.2f GB/s %9.2f GB/s\n", bytes, MyStl::simd::use_nt_store(bytes) ? "*" : " ",
+                    bench::gb_per_s(static_cast<double>(bytes), t0), bench::gb_per_s(static_cast<double>(bytes), t1));
+    }
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    size_t max_bytes = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : (static_cast<size_t>(1) << 30);
+    std::vector<unsigned char> buffer(max_bytes);
+    std::printf("path: %s\n", MyStl::simd::has_avx2() ? "avx2" : "sse2 or scalar");
+    run<uint16_t>("uint16_t", buffer, max_bytes, 0x1234);
+    run<uint32_t>("uint32_t", buffer, max_bytes, 0xdeadbeefu);
+    run<double>("double", buffer, max_bytes, 1.5);
+    run<pod16>("16-byte struct", buffer, max_bytes, pod16{1, 2, 3, 4});
+    return 0;
+}
@@ -0,0 +1,52 @@
+// find / count 的吞吐量（GB/s）：MyStl 的 SIMD 路径与 std::find / std::count 对比
+// 查找值不在区间中，find 扫描整个区间；区间大小从 4 KiB 到 256 MiB，覆盖各级缓存和内存
+// g++ -std=c++14 -O2 -I.. simd_find_bench.cpp -o simd_find_bench && ./simd_find_bench [max_bytes]
+// 用 -DMYSTL_NO_AVX2 / -DMYSTL_NO_SIMD 构建可以比较 SSE2 和标量路径
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "../algo.h"
+#include "bench_util.h"
+
+namespace
+{
+
+template <class T>
+void run(const char *name, size_t max_bytes)
+{
+    std::printf("%s\n%12s %12s %12s %12s %12s\n", name, "bytes", "MyStl find", "std::find", "MyStl count", "std::count");
+    for (size_t bytes = 4096; bytes <= max_bytes; bytes *= 4)
+    {
+        const size_t n = bytes / sizeof(T);
+        std::vector<T> v(n);
+        for (size_t i = 0; i < n; ++i)
+            v[i] = static_cast<T>(i % 100);
+        const T *first = v.data(), *last = first + n;
+        const T miss = static_cast<T>(101);
+        const T hit = static_cast<T>(7);
+        double t[4];
+        t[0] = bench::best_time([&] { bench::do_not_optimize(MyStl::find(first, last, miss)); });
+        t[1] = bench::best_time([&] { bench::do_not_optimize(std::find(first, last, miss)); });
+        t[2] = bench::best_time([&] { bench::do_not_optimize(MyStl::count(first, last, hit)); });
+        t[3] = bench::best_time([&] { bench::do_not_optimize(std::count(first, last, hit)); });
+        std::printf("%12zu", bytes);
+        for (double x : t)
+            std::printf(" %7.2f GB/s", bench::gb_per_s(static_cast<double>(bytes), x));
+        std::printf("\n");
+    }
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    size_t max_bytes = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : (static_cast<size_t>(256) << 20);
+    std::printf("path: %s\n", MyStl::simd::has_avx2() ? "avx2" : "sse2 or scalar");
+    run<unsigned char>("uint8_t", max_bytes);
+    run<uint32_t>("uint32_t", max_bytes);
+    run<double>("double", max_bytes);
+    return 0;
+}
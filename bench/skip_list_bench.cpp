@@ -0,0 +1,234 @@
+// skip_list 的两组对比
+//   单线程：与 tree.hpp 的 AVL 和 std::map 比较插入、查找、删除 n 个随机键的耗时
+//   多线程：与 std::map + std::mutex 比较 1 到 64 个线程下 90% find / 5% insert / 5% erase 的吞吐量
+// g++ -std=c++14 -O2 -pthread -I.. skip_list_bench.cpp -o skip_list_bench && ./skip_list_bench [n] [seconds]
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "../skip_list.h"
+#include "../tree.hpp"
+
+namespace
+{
+
+// 累加查到的值，防止查找被优化掉
+std::atomic<uint64_t> checksum{0};
+
+double seconds_since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// 加一把全局锁的 std::map，作为对照
+class locked_map
+{
+public:
+    bool find(uint64_t key, uint64_t &value) const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = map_.find(key);
+        if (it == map_.end())
+            return false;
+        value = it -> second;
+        return true;
+    }
+    bool insert(uint64_t key, uint64_t value)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return map_.emplace(key, value).second;
+    }
+    bool erase(uint64_t key)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return map_.erase(key) == 1;
+    }
+
+private:
+    mutable std::mutex           mutex_;
+    std::map<uint64_t, uint64_t> map_;
+};
+
+// 单线程的三段耗时：插入、查找、删除，单位 ns / 次
+struct phase_times
+{
+    double insert, find, erase;
+};
+
+phase_times run_skip_list(const std::vector<uint64_t> &keys)
+{
+    phase_times t;
+    MyStl::skip_list<uint64_t, uint64_t> list;
+    auto start = std::chrono::steady_clock::now();
+    for (auto k : keys)
+        list.insert(k, k);
+    t.insert = seconds_since(start);
+    uint64_t sum = 0;
+    start = std::chrono::steady_clock::now();
+    for (auto k : keys)
+    {
+        uint64_t value;
+        if (list.find(k, value))
+            sum += value;
+    }
+    t.find = seconds_since(start);
+    start = std::chrono::steady_clock::now();
+    for (auto k : keys)
+        list.erase(k);
+    t.erase = seconds_since(start);
+    checksum += sum;
+    return t;
+}
+
+// AVL 没有 find，用 rank + select 定位
+phase_times run_avl(const std::vector<uint64_t> &keys)
+{
+    phase_times t;
+    AVL<uint64_t> avl;
+    auto start = std::chrono::steady_clock::now();
+    for (auto k : keys)
+        avl.insert(k);
+    t.insert = seconds_since(start);
+    uint64_t sum = 0;
+    start = std::chrono::steady_clock::now();
+    for (auto k : keys)
+    {
+        auto r = avl.select(avl.rank(k));
+        if (r.second && r.first -> value == k)
+            sum += k;
+    }
+    t.find = seconds_since(start);
+    start = std::chrono::steady_clock::now();
+    for (auto k : keys)
+        avl.erase(k);
+    t.erase = seconds_since(start);
+    checksum += sum;
+    return t;
+}
+
+phase_times run_std_map(const std::vector<uint64_t> &keys)
+{
+    phase_times t;
+    std::map<uint64_t, uint64_t> map;
+    auto start = std::chrono::steady_clock::now();
+    for (auto k : keys)
+        map.emplace(k, k);
+    t.insert = seconds_since(start);
+    uint64_t sum = 0;
+    start = std::chrono::steady_clock::now();
+    for (auto k : keys)
+    {
+        auto it = map.find(k);
+        if (it != map.end())
+            sum += it -> second;
+    }
+    t.find = seconds_since(start);
+    start = std::chrono::steady_clock::now();
+    for (auto k : keys)
+        map.erase(k);
+    t.erase = seconds_since(start);
+    checksum += sum;
+    return t;
+}
+
+void print_phase(const char *name, const phase_times &t, size_t n)
+{
+    std::printf("%-12s %10.1f %10.1f %10.1f\n", name,
+                t.insert / n * 1e9, t.find / n * 1e9, t.erase / n * 1e9);
+}
+
+// 返回每秒完成的百万次操作数
+template <class Map>
+double run_threads(Map &map, uint64_t key_range, unsigned threads, double seconds)
+{
+    std::atomic<bool>   start{false};
+    std::atomic<bool>   stop{false};
+    std::atomic<size_t> total{0};
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; ++t)
+    {
+        pool.emplace_back([&, t]()
+        {
+            std::mt19937_64 rng(t + 1);
+            size_t ops = 0;
+            uint64_t sink = 0;
+            while (!start.load(std::memory_order_acquire))
+                std::this_thread::yield();
+            while (!stop.load(std::memory_order_relaxed))
+            {
+                // 每批 64 次操作检查一次是否结束
+                for (int i = 0; i < 64; ++i)
+                {
+                    uint64_t key = rng() % key_range;
+                    unsigned op = static_cast<unsigned>(rng() % 20);
+                    if (op == 0)
+                        map.insert(key, key);
+                    else if (op == 1)
+                        map.erase(key);
+                    else
+                    {
+                        uint64_t value;
+                        if (map.find(key, value))
+                            sink += value;
+                    }
+                }
+                ops += 64;
+            }
+            total.fetch_add(ops, std::memory_order_relaxed);
+            checksum.fetch_add(sink, std::memory_order_relaxed);
+        });
+    }
+    auto begin = std::chrono::steady_clock::now();
+    start.store(true, std::memory_order_release);
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    stop.store(true, std::memory_order_relaxed);
+    for (auto &th : pool)
+        th.join();
+    return total.load() / seconds_since(begin) / 1e6;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    uint64_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+    double seconds = argc > 2 ? std::atof(argv[2]) : 1.0;
+
+    std::mt19937_64 rng(42);
+    std::vector<uint64_t> keys(n);
+    for (auto &k : keys)
+        k = rng();
+
+    std::printf("single thread, n = %llu, ns per operation\n", static_cast<unsigned long long>(n));
+    std::printf("%-12s %10s %10s %10s\n", "", "insert", "find", "erase");
+    print_phase("skip_list", run_skip_list(keys), n);
+    print_phase("AVL", run_avl(keys), n);
+    print_phase("std::map", run_std_map(keys), n);
+
+    // 键取自 [0, 2n)，预先插入其中的偶数，约一半命中
+    MyStl::skip_list<uint64_t, uint64_t> list;
+    locked_map lmap;
+    for (uint64_t k = 0; k < n; ++k)
+    {
+        list.insert(k * 2, k * 2);
+        lmap.insert(k * 2, k * 2);
+    }
+    std::printf("\nmixed 90/5/5, %.1f s per run, hardware threads = %u\n",
+                seconds, std::thread::hardware_concurrency());
+    std::printf("%8s %18s %18s\n", "threads", "skip_list", "map + mutex");
+    for (unsigned threads = 1; threads <= 64; threads *= 2)
+    {
+        double s = run_threads(list, n * 2, threads, seconds);
+        double l = run_threads(lmap, n * 2, threads, seconds);
+        std::printf("%8u %12.2f Mop/s %12.2f Mop/s\n", threads, s, l);
+    }
+    return 0;
+}
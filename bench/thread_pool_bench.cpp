@@ -0,0 +1,163 @@
+// thread_pool 的两组测量
+//   分叉-合并开销：单个空任务 spawn + sync、递归 fib 每个任务的开销、grain = 1 的 parallel_for 每个下标的开销
+//   负载均衡：用 parallel_invoke 递归的快速排序处理随机、有序、大量重复、风琴管四种输入，
+//            统计每个线程处理的元素数，报告最多的线程与平均值之比（1.00 为完全均衡）
+// 线程池只能在第一次使用前配置，可以用不同的 threads 多次运行
+// g++ -std=c++14 -O2 -pthread -I.. thread_pool_bench.cpp -o thread_pool_bench && ./thread_pool_bench [threads] [n]
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "../thread_pool.h"
+#include "bench_util.h"
+
+namespace
+{
+
+uint64_t fib_serial(unsigned n)
+{
+    return n < 2 ? n : fib_serial(n - 1) + fib_serial(n - 2);
+}
+
+// 每次递归都派生一个任务，返回派生的任务数
+uint64_t fib_tasks(unsigned n, uint64_t &result)
+{
+    if (n < 2)
+    {
+        result = n;
+        return 0;
+    }
+    uint64_t a = 0, b = 0;
+    std::atomic<uint64_t> spawned{1};
+    MyStl::task_group group;
+    group.spawn([&] { spawned.fetch_add(fib_tasks(n - 1, a), std::memory_order_relaxed); });
+    const uint64_t mine = fib_tasks(n - 2, b);
+    group.sync();
+    result = a + b;
+    return spawned.load(std::memory_order_relaxed) + mine;
+}
+
+// 每个线程处理的元素数，线程第一次记账时领取一个槽位
+const size_t max_slots = 256;
+std::atomic<uint64_t> work[max_slots];
+std::atomic<size_t> next_slot{0};
+
+void account(size_t n)
+{
+    static thread_local size_t slot = next_slot.fetch_add(1) % max_slots;
+    work[slot].fetch_add(n, std::memory_order_relaxed);
+}
+
+const size_t sort_cutoff = 4096;
+
+// 三点中值 + Hoare 划分，两半用 parallel_invoke 并行递归，小区间交给 std::sort
+void quicksort(uint32_t *first, uint32_t *last)
+{
+    const size_t n = static_cast<size_t>(last - first);
+    account(n);
+    if (n <= sort_cutoff)
+    {
+        std::sort(first, last);
+        return;
+    }
+    uint32_t a = first[0], b = first[n / 2], c = last[-1];
+    const uint32_t pivot = std::max(std::min(a, b), std::min(std::max(a, b), c));
+    uint32_t *i = first - 1, *j = last;
+    for (;;)
+    {
+        do ++i; while (*i < pivot);
+        do --j; while (pivot < *j);
+        if (i >= j)
+            break;
+        std::swap(*i, *j);
+    }
+    uint32_t *mid = j + 1;
+    MyStl::thread_pool::instance().parallel_invoke([=] { quicksort(first, mid); },
+                                                   [=] { quicksort(mid, last); });
+}
+
+void run_sort(const char *name, const std::vector<uint32_t> &input)
+{
+    std::vector<uint32_t> v;
+    double serial = bench::best_time([&] { v = input; std::sort(v.begin(), v.end()); }, 0.5);
+    for (auto &w : work)
+        w.store(0);
+    double parallel = bench::best_time([&] { v = input; quicksort(v.data(), v.data() + v.size()); }, 0.5);
+    if (!std::is_sorted(v.begin(), v.end()))
+        std::printf("%s: not sorted\n", name);
+    uint64_t total = 0, most = 0;
+    size_t threads = 0;
+    for (auto &w : work)
+    {
+        const uint64_t x = w.load();
+        total += x;
+        most = std::max(most, x);
+        threads += x != 0;
+    }
+    const double mean = threads == 0 ? 1.0 : static_cast<double>(total) / threads;
+    std::printf("%-12s %10.1f ms %10.1f ms %8.2fx %8zu %10.2f\n", name, serial * 1e3, parallel * 1e3,
+                serial / parallel, threads, most / mean);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const size_t threads = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 0;
+    const size_t n = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 10000000;
+    if (threads != 0)
+        MyStl::thread_pool::configure(threads);
+    auto &pool = MyStl::thread_pool::instance();
+    std::printf("threads = %zu, hardware threads = %u\n", pool.concurrency(), std::thread::hardware_concurrency());
+
+    // 分叉-合并开销
+    const int reps = 100000;
+    double t = bench::best_time([&]
+    {
+        for (int i = 0; i < reps; ++i)
+        {
+            MyStl::task_group group;
+            group.spawn([] {});
+            group.sync();
+        }
+    });
+    std::printf("spawn + sync of an empty task: %8.1f ns\n", t / reps * 1e9);
+
+    const unsigned fib_n = 25;
+    uint64_t result = 0, tasks = 0;
+    double ts = bench::best_time([&] { bench::do_not_optimize(fib_serial(fib_n)); });
+    double tp = bench::best_time([&] { tasks = fib_tasks(fib_n, result); });
+    std::printf("fib(%u) with a task per call:  %8.1f ns per task (%llu tasks, serial %.2f ms, tasks %.2f ms)\n",
+                fib_n, (tp - ts) / tasks * 1e9, static_cast<unsigned long long>(tasks), ts * 1e3, tp * 1e3);
+
+    const size_t indices = 1000000;
+    t = bench::best_time([&]
+    {
+        pool.parallel_for(indices, 1, [](size_t b, size_t e) { bench::do_not_optimize(e - b); });
+    });
+    std::printf("parallel_for, grain 1:          %8.1f ns per index\n", t / indices * 1e9);
+
+    // 负载均衡
+    std::printf("\nquicksort of %zu uint32_t\n%-12s %13s %13s %9s %8s %10s\n", n, "input", "std::sort",
+                "parallel", "speedup", "threads", "max/mean");
+    std::vector<uint32_t> input(n);
+    std::mt19937 rng(7);
+    for (auto &x : input)
+        x = rng();
+    run_sort("random", input);
+    std::sort(input.begin(), input.end());
+    run_sort("sorted", input);
+    for (auto &x : input)
+        x = rng() % 16;
+    run_sort("16 distinct", input);
+    for (size_t i = 0; i < n; ++i)
+        input[i] = static_cast<uint32_t>(i < n / 2 ? i : n - i);
+    run_sort("organ pipe", input);
+    return 0;
+}
@@ -0,0 +1,74 @@
+// 从 n 个随机 uint32_t 中取最大的 k 个（默认 k = 100，n = 1e8）并按递减顺序排好：
+//   top_k（有界 min-heap，输入只读一遍，额外空间 O(k)）
+//   nth_element + partial_sort（原地重排整个数组）
+//   partial_sort（前 k 个位置维护堆）
+//   std::partial_sort、std::nth_element + std::sort
+// 原地重排的方法每次都要先把输入拷贝到工作区，表中的时间已减去单独测得的拷贝时间
+// n = 1e9 时输入和工作区共需约 8 GiB 内存
+// g++ -std=c++14 -O2 -I.. top_k_bench.cpp -o top_k_bench && ./top_k_bench [n] [k]
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "../algo.h"
+#include "../functional.h"
+#include "bench_util.h"
+
+int main(int argc, char **argv)
+{
+    const size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100000000;
+    const size_t k = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 100;
+    std::vector<uint32_t> in(n), work(n), out(k);
+    std::mt19937 rng(45);
+    for (auto &x : in)
+        x = rng();
+    const uint32_t *first = in.data();
+    uint32_t *w = work.data();
+    MyStl::greater<uint32_t> greater;
+
+    std::printf("n = %zu, k = %zu\n", n, k);
+    const double t_copy = bench::best_time([&] { std::copy(in.begin(), in.end(), work.begin()); }, 0.5);
+    double t = bench::best_time([&]
+    {
+        MyStl::top_k(first, first + n, out.data(), out.data() + k);
+        bench::do_not_optimize(out[0]);
+    }, 0.5);
+    std::printf("%-32s %10.1f ms\n", "top_k", t * 1e3);
+    t = bench::best_time([&]
+    {
+        std::copy(in.begin(), in.end(), work.begin());
+        MyStl::nth_element(w, w + k, w + n, greater);
+        MyStl::partial_sort(w, w + k, w + k, greater);
+        bench::do_not_optimize(w[0]);
+    }, 0.5) - t_copy;
+    std::printf("%-32s %10.1f ms\n", "nth_element + partial_sort", t * 1e3);
+    t = bench::best_time([&]
+    {
+        std::copy(in.begin(), in.end(), work.begin());
+        MyStl::partial_sort(w, w + k, w + n, greater);
+        bench::do_not_optimize(w[0]);
+    }, 0.5) - t_copy;
+    std::printf("%-32s %10.1f ms\n", "partial_sort", t * 1e3);
+    t = bench::best_time([&]
+    {
+        std::copy(in.begin(), in.end(), work.begin());
+        std::partial_sort(w, w + k, w + n, std::greater<uint32_t>());
+        bench::do_not_optimize(w[0]);
+    }, 0.5) - t_copy;
+    std::printf("%-32s %10.1f ms\n", "std::partial_sort", t * 1e3);
+    t = bench::best_time([&]
+    {
+        std::copy(in.begin(), in.end(), work.begin());
+        std::nth_element(w, w + k, w + n, std::greater<uint32_t>());
+        std::sort(w, w + k, std::greater<uint32_t>());
+        bench::do_not_optimize(w[0]);
+    }, 0.5) - t_copy;
+    std::printf("%-32s %10.1f ms\n", "std::nth_element + std::sort", t * 1e3);
+    std::printf("%-32s %10.1f ms\n", "(input copy, subtracted)", t_copy * 1e3);
+    return 0;
+}
@@ -0,0 +1,816 @@
+#ifndef MYSTL_CONCURRENT_MAP_H_
+#define MYSTL_CONCURRENT_MAP_H_
+
+// 这个头文件包含一个模板类 concurrent_map
+// concurrent_map : 支持多线程并发读写的有序映射，底层为采用乐观锁耦合（optimistic lock coupling）的 B+ 树
+
+// notes:
+//
+// 并发协议：
+//   * 每个结点带一个版本号，最低位表示已废弃，次低位表示已加写锁，其余位为计数
+//   * 读者不加锁，下降时先记下结点版本，读完再校验版本；版本变化说明期间有写者，整体重试
+//   * 写者同样乐观下降，只在需要修改的结点（及其父结点）上把读版本升级为写锁
+//   * 插入时对沿途已满的结点提前分裂，保证修改最多涉及父子两层
+//   * 删除使叶子变空时把叶子从父结点中摘下；父结点因此只剩一个孩子时，再沿同一条路径下降一次，
+//     把只剩一个孩子的内部结点收缩掉：让它的父结点（或 root）直接指向剩下的孩子
+//   * 摘下的叶子和收缩掉的内部结点都标记为废弃，经 epoch_domain 延迟释放
+// 因此除根以外没有空叶子，内部结点至少有两个孩子，结点总数不超过当前元素个数的两倍；
+// 未满的叶子不与兄弟合并，大量删除之后每个叶子可能只剩很少的元素
+// find / insert / insert_or_assign / erase 均可线性化
+// scan 在每个叶子内是一致快照，跨叶子不保证整体快照
+//
+// 读者会与写者同时读取结点内容：会被并发修改的字段（计数、键、值、孩子指针）都用 relaxed 原子操作读写，
+// 键和值按字拆开存放在 relaxed_cell 中，校验版本之前有一个 acquire 栅栏。读到的可能是撕裂的值，
+// 由版本校验丢弃。所以 Key 和 Value 必须是可平凡复制、可默认构造的类型，
+// Compare 不能有副作用，并且要能接受撕裂的键
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <atomic>
+#include <thread>
+#include <type_traits>
+
+#include "epoch.h"
+#include "functional.h"
+#include "util.h"
+
+namespace MyStl
+{
+
+// --------------------------------------------------------------------------------------
+// 类 : relaxed_cell
+// 以若干个原子字存放一个可平凡复制的 T，整体按 relaxed 原子操作逐字读写
+// 与写者并发时 load 可能得到新旧混杂的值，但不构成数据竞争，由调用者用版本号判断是否可用
+template <class T>
+class relaxed_cell
+{
+    typedef typename std::conditional<sizeof(T) % 8 == 0, uint64_t,
+            typename std::conditional<sizeof(T) % 4 == 0, uint32_t,
+            typename std::conditional<sizeof(T) % 2 == 0, uint16_t, unsigned char>::type>::type>::type word;
+
+    static constexpr size_t words = sizeof(T) / sizeof(word);
+
+    std::atomic<word> data[words];
+
+public:
+    T load() const
+    {
+        word buf[words];
+        for (size_t i = 0; i < words; ++i)
+            buf[i] = data[i].load(std::memory_order_relaxed);
+        T value;
+        std::memcpy(&value, buf, sizeof(T));
+        return value;
+    }
+
+    void store(const T &value)
+    {
+        word buf[words];
+        std::memcpy(buf, &value, sizeof(T));
+        for (size_t i = 0; i < words; ++i)
+            data[i].store(buf[i], std::memory_order_relaxed);
+    }
+};
+
+template <class Key, class Value, class Compare = MyStl::less<Key>>
+class concurrent_map
+{
+    static_assert(std::is_trivially_copyable<Key>::value,
+                  "concurrent_map requires a trivially copyable Key");
+    static_assert(std::is_trivially_copyable<Value>::value,
+                  "concurrent_map requires a trivially copyable Value");
+public:
+    typedef Key           key_type;
+    typedef Value         mapped_type;
+    typedef Compare       key_compare;
+    typedef size_t        size_type;
+
+private:
+    static constexpr size_t page_size = 4096;
+
+    struct node_base
+    {
+        std::atomic<uint64_t> version{0b100};
+        const bool            is_leaf;
+        std::atomic<uint16_t> count{0};
+
+        explicit node_base(bool leaf) : is_leaf(leaf) {}
+
+        static bool is_locked(uint64_t v)   { return (v & 0b10) == 0b10; }
+        static bool is_obsolete(uint64_t v) { return (v & 1) == 1; }
+
+        // 乐观读时可能是脏值，持有写锁时是准确值
+        size_t load_count() const     { return count.load(std::memory_order_relaxed); }
+        void   store_count(size_t n)  { count.store(static_cast<uint16_t>(n), std::memory_order_relaxed); }
+
+        uint64_t read_lock_or_restart(bool &need_restart) const
+        {
+            uint64_t v = version.load(std::memory_order_acquire);
+            if (is_locked(v) || is_obsolete(v))
+            {
+                std::this_thread::yield();
+                need_restart = true;
+            }
+            return v;
+        }
+
+        // 校验读期间结点没有被修改：栅栏保证之前的 relaxed 读取都先于版本号的读取完成
+        void read_unlock_or_restart(uint64_t v, bool &need_restart) const
+        {
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (v != version.load(std::memory_order_relaxed))
+                need_restart = true;
+        }
+
+        // 加锁成功后的释放栅栏保证读者一旦读到之后写入的内容，校验时必然看到版本变化
+        void upgrade_to_write_lock_or_restart(uint64_t &v, bool &need_restart)
+        {
+            if (version.compare_exchange_strong(v, v + 0b10, std::memory_order_acquire))
+            {
+                v += 0b10;
+                std::atomic_thread_fence(std::memory_order_release);
+            }
+            else
+            {
+                need_restart = true;
+            }
+        }
+
+        void write_unlock()          { version.fetch_add(0b10, std::memory_order_release); }
+        void write_unlock_obsolete() { version.fetch_add(0b11, std::memory_order_release); }
+    };
+
+    struct leaf_node;
+    struct inner_node;
+
+    static constexpr size_t leaf_capacity_calc =
+        (page_size - sizeof(node_base)) / (sizeof(Key) + sizeof(Value));
+    static constexpr size_t inner_capacity_calc =
+        (page_size - sizeof(node_base) - sizeof(void*)) / (sizeof(Key) + sizeof(void*));
+
+public:
+    static constexpr size_t leaf_capacity  = leaf_capacity_calc < 4 ? 4 : leaf_capacity_calc;
+    static constexpr size_t inner_capacity = inner_capacity_calc < 4 ? 4 : inner_capacity_calc;
+
+private:
+    // 叶子结点：有序存放 count 个键值对
+    struct leaf_node : public node_base
+    {
+        relaxed_cell<Key>   keys[leaf_capacity];
+        relaxed_cell<Value> values[leaf_capacity];
+
+        leaf_node() : node_base(true) {}
+
+        bool is_full() const { return this -> load_count() == leaf_capacity; }
+
+        // 乐观读时 count 可能是脏值，先截断到容量以内，结果由版本校验兜底
+        size_t safe_count() const
+        {
+            size_t n = this -> load_count();
+            return n < leaf_capacity ? n : leaf_capacity;
+        }
+
+        // 第一个不小于 key 的位置
+        size_t lower_bound(const Key &key, const Compare &comp) const
+        {
+            size_t lo = 0, hi = safe_count();
+            while (lo < hi)
+            {
+                size_t mid = (lo + hi) >> 1;
+                if (comp(keys[mid].load(), key)) lo = mid + 1;
+                else                             hi = mid;
+            }
+            return lo;
+        }
+
+        void insert_at(size_t pos, const Key &key, const Value &value)
+        {
+            size_t n = this -> load_count();
+            for (size_t i = n; i > pos; --i)
+            {
+                keys[i].store(keys[i - 1].load());
+                values[i].store(values[i - 1].load());
+            }
+            keys[pos].store(key);
+            values[pos].store(value);
+            this -> store_count(n + 1);
+        }
+
+        void erase_at(size_t pos)
+        {
+            size_t n = this -> load_count();
+            for (size_t i = pos + 1; i < n; ++i)
+            {
+                keys[i - 1].store(keys[i].load());
+                values[i - 1].store(values[i].load());
+            }
+            this -> store_count(n - 1);
+        }
+
+        // 上半部分移到新叶子，sep 为留在左侧的最大键
+        leaf_node* split(Key &sep)
+        {
+            auto right = new leaf_node();
+            size_t n = this -> load_count();
+            size_t half = n / 2;
+            for (size_t i = 0; i < n - half; ++i)
+            {
+                right -> keys[i].store(keys[half + i].load());
+                right -> values[i].store(values[half + i].load());
+            }
+            right -> store_count(n - half);
+            this -> store_count(half);
+            sep = keys[half - 1].load();
+            return right;
+        }
+    };
+
+    // 内部结点：count 个分隔键，count + 1 个孩子；children[i] 中的键都不大于 keys[i]
+    struct inner_node : public node_base
+    {
+        relaxed_cell<Key>       keys[inner_capacity];
+        std::atomic<node_base*> children[inner_capacity + 1];
+
+        inner_node() : node_base(false) {}
+
+        bool is_full() const { return this -> load_count() == inner_capacity; }
+
+        size_t safe_count() const
+        {
+            size_t n = this -> load_count();
+            return n < inner_capacity ? n : inner_capacity;
+        }
+
+        node_base* child(size_t i) const { return children[i].load(std::memory_order_relaxed); }
+        void set_child(size_t i, node_base *node) { children[i].store(node, std::memory_order_relaxed); }
+
+        size_t lower_bound(const Key &key, const Compare &comp) const
+        {
+            size_t lo = 0, hi = safe_count();
+            while (lo < hi)
+            {
+                size_t mid = (lo + hi) >> 1;
+                if (comp(keys[mid].load(), key)) lo = mid + 1;
+                else                             hi = mid;
+            }
+            return lo;
+        }
+
+        // 第一个大于 key 的位置
+        size_t upper_bound(const Key &key, const Compare &comp) const
+        {
+            size_t lo = 0, hi = safe_count();
+            while (lo < hi)
+            {
+                size_t mid = (lo + hi) >> 1;
+                if (comp(key, keys[mid].load())) hi = mid;
+                else                             lo = mid + 1;
+            }
+            return lo;
+        }
+
+        // 插入分裂产生的分隔键和右半结点
+        void insert_child(const Key &sep, node_base *right, const Compare &comp)
+        {
+            size_t pos = lower_bound(sep, comp);
+            size_t n = this -> load_count();
+            for (size_t i = n; i > pos; --i)
+            {
+                keys[i].store(keys[i - 1].load());
+                set_child(i + 1, child(i));
+            }
+            keys[pos].store(sep);
+            set_child(pos + 1, right);
+            this -> store_count(n + 1);
+        }
+
+        // 摘下第 pos 个孩子，其键区间并入相邻孩子
+        void erase_child(size_t pos)
+        {
+            size_t n = this -> load_count();
+            size_t key_pos = pos < n ? pos : pos - 1;
+            for (size_t i = key_pos + 1; i < n; ++i)
+                keys[i - 1].store(keys[i].load());
+            for (size_t i = pos + 1; i <= n; ++i)
+                set_child(i - 1, child(i));
+            this -> store_count(n - 1);
+        }
+
+        inner_node* split(Key &sep)
+        {
+            auto right = new inner_node();
+            size_t n = this -> load_count();
+            size_t half = n / 2;
+            size_t right_count = n - half - 1;
+            for (size_t i = 0; i < right_count; ++i)
+                right -> keys[i].store(keys[half + 1 + i].load());
+            for (size_t i = 0; i <= right_count; ++i)
+                right -> set_child(i, child(half + 1 + i));
+            right -> store_count(right_count);
+            sep = keys[half].load();
+            this -> store_count(half);
+            return right;
+        }
+    };
+
+private:
+    std::atomic<node_base*> root;
+    std::atomic<size_t>     count_;
+    Compare                 comp;
+
+public:
+    // 构造、析构函数
+    concurrent_map() : root(new leaf_node()), count_(0), comp() {}
+    explicit concurrent_map(const Compare &c) : root(new leaf_node()), count_(0), comp(c) {}
+
+    // 析构时不能再有其他线程访问
+    ~concurrent_map()
+    {
+        free_node(root.load(std::memory_order_relaxed));
+    }
+
+public:
+    // 元素个数，并发修改时只是一个近似值
+    size_type size()  const noexcept { return count_.load(std::memory_order_relaxed); }
+    bool      empty() const noexcept { return size() == 0; }
+
+    // 树中的结点个数，用于观察内存占用；只能在没有并发修改时调用
+    size_type node_count() const { return count_nodes(root.load(std::memory_order_acquire)); }
+
+    // 查找 key，存在时把值写入 value 并返回 true
+    bool find(const Key &key, Value &value) const;
+    bool contains(const Key &key) const
+    {
+        Value value;
+        return find(key, value);
+    }
+
+    // key 不存在时插入并返回 true，已存在时不修改并返回 false
+    bool insert(const Key &key, const Value &value) { return insert_impl(key, value, false); }
+    // key 不存在时插入并返回 true，已存在时覆盖旧值并返回 false
+    bool insert_or_assign(const Key &key, const Value &value) { return insert_impl(key, value, true); }
+
+    // 删除 key，存在时返回 true
+    bool erase(const Key &key);
+
+    // 按键升序对 [low, high) 内的每个元素调用 f(key, value)，返回访问的元素个数
+    // f 在不持有任何结点的情况下被调用，可以放心做耗时操作
+    template <class Function>
+    size_t scan(const Key &low, const Key &high, Function f) const;
+
+private:
+    bool insert_impl(const Key &key, const Value &value, bool assign);
+
+    // 结点分裂：调用者已持有 node 与 parent（可能为空）的写锁
+    void split_node(node_base *node, inner_node *parent)
+    {
+        Key sep;
+        node_base *right;
+        if (node -> is_leaf)
+            right = static_cast<leaf_node*>(node) -> split(sep);
+        else
+            right = static_cast<inner_node*>(node) -> split(sep);
+        if (parent != nullptr)
+        {
+            parent -> insert_child(sep, right, comp);
+        }
+        else
+        {
+            // 根结点分裂，树长高一层
+            auto new_root = new inner_node();
+            new_root -> keys[0].store(sep);
+            new_root -> set_child(0, node);
+            new_root -> set_child(1, right);
+            new_root -> store_count(1);
+            root.store(new_root, std::memory_order_release);
+        }
+    }
+
+    // 收缩只剩一个孩子的内部结点 node：让 parent 的第 child_pos 个孩子（node 为根时为 root）
+    // 直接指向 node 唯一的孩子，node 标记废弃后延迟释放
+    // node 与 parent 的内容是以版本 v、parent_v 乐观读到的，加锁成功即说明读到的内容有效
+    // 成功与否调用者都要从根重新下降，失败时 need_restart 为 true
+    void collapse_node(inner_node *node, uint64_t v, inner_node *parent, uint64_t parent_v,
+                       size_t child_pos, bool &need_restart)
+    {
+        if (parent != nullptr)
+        {
+            parent -> upgrade_to_write_lock_or_restart(parent_v, need_restart);
+            if (need_restart) return;
+        }
+        node -> upgrade_to_write_lock_or_restart(v, need_restart);
+        if (need_restart)
+        {
+            if (parent != nullptr) parent -> write_unlock();
+            return;
+        }
+        if (parent != nullptr)
+        {
+            parent -> set_child(child_pos, node -> child(0));
+        }
+        else if (root.load(std::memory_order_relaxed) == node)
+        {
+            // 只有持有当前根结点写锁的线程才会修改 root，所以这里的判断在解锁前一直成立
+            root.store(node -> child(0), std::memory_order_release);
+        }
+        else
+        {
+            node -> write_unlock();
+            need_restart = true;
+            return;
+        }
+        node -> write_unlock_obsolete();
+        if (parent != nullptr) parent -> write_unlock();
+        epoch_domain::instance().retire(node);
+    }
+
+    static size_t count_nodes(node_base *node)
+    {
+        if (node -> is_leaf)
+            return 1;
+        auto inner = static_cast<inner_node*>(node);
+        size_t n = 1;
+        for (size_t i = 0; i <= inner -> load_count(); ++i)
+            n += count_nodes(inner -> child(i));
+        return n;
+    }
+
+    static void free_node(node_base *node)
+    {
+        if (node -> is_leaf)
+        {
+            delete static_cast<leaf_node*>(node);
+            return;
+        }
+        auto inner = static_cast<inner_node*>(node);
+        for (size_t i = 0; i <= inner -> load_count(); ++i)
+            free_node(inner -> child(i));
+        delete inner;
+    }
+};
+
+template <class Key, class Value, class Compare>
+constexpr size_t concurrent_map<Key, Value, Compare>::leaf_capacity;
+
+template <class Key, class Value, class Compare>
+constexpr size_t concurrent_map<Key, Value, Compare>::inner_capacity;
+
+/*****************************************************************************************/
+// find
+/*****************************************************************************************/
+template <class Key, class Value, class Compare>
+bool concurrent_map<Key, Value, Compare>::find(const Key &key, Value &value) const
+{
+    epoch_guard guard;
+    while (true)
+    {
+        bool need_restart = false;
+        node_base *node = root.load(std::memory_order_acquire);
+        uint64_t v = node -> read_lock_or_restart(need_restart);
+        if (need_restart || node != root.load(std::memory_order_acquire))
+            continue;
+
+        inner_node *parent = nullptr;
+        uint64_t parent_v = 0;
+        while (!node -> is_leaf)
+        {
+            auto inner = static_cast<inner_node*>(node);
+            if (parent != nullptr)
+            {
+                parent -> read_unlock_or_restart(parent_v, need_restart);
+                if (need_restart) break;
+            }
+            parent = inner;
+            parent_v = v;
+            node = inner -> child(inner -> lower_bound(key, comp));
+            inner -> read_unlock_or_restart(v, need_restart);
+            if (need_restart) break;
+            v = node -> read_lock_or_restart(need_restart);
+            if (need_restart) break;
+        }
+        if (need_restart)
+            continue;
+
+        auto leaf = static_cast<leaf_node*>(node);
+        size_t pos = leaf -> lower_bound(key, comp);
+        bool found = pos < leaf -> safe_count() && !comp(key, leaf -> keys[pos].load());
+        Value result = Value();
+        if (found)
+            result = leaf -> values[pos].load();
+        if (parent != nullptr)
+            parent -> read_unlock_or_restart(parent_v, need_restart);
+        node -> read_unlock_or_restart(v, need_restart);
+        if (need_restart)
+            continue;
+        if (found)
+            value = result;
+        return found;
+    }
+}
+
+/*****************************************************************************************/
+// insert
+/*****************************************************************************************/
+template <class Key, class Value, class Compare>
+bool concurrent_map<Key, Value, Compare>::
+insert_impl(const Key &key, const Value &value, bool assign)
+{
+    epoch_guard guard;
+    while (true)
+    {
+        bool need_restart = false;
+        node_base *node = root.load(std::memory_order_acquire);
+        uint64_t v = node -> read_lock_or_restart(need_restart);
+        if (need_restart || node != root.load(std::memory_order_acquire))
+            continue;
+
+        inner_node *parent = nullptr;
+        uint64_t parent_v = 0;
+        bool restart_from_root = false;
+        while (true)
+        {
+            bool full = node -> is_leaf ? static_cast<leaf_node*>(node) -> is_full()
+                                        : static_cast<inner_node*>(node) -> is_full();
+            if (full)
+            {
+                // 提前分裂：锁住父结点和当前结点，分裂后从根重新下降
+                if (parent != nullptr)
+                {
+                    parent -> upgrade_to_write_lock_or_restart(parent_v, need_restart);
+                    if (need_restart) break;
+                }
+                node -> upgrade_to_write_lock_or_restart(v, need_restart);
+                if (need_restart)
+                {
+                    if (parent != nullptr) parent -> write_unlock();
+                    break;
+                }
+                if (parent == nullptr && node != root.load(std::memory_order_acquire))
+                {
+                    node -> write_unlock();
+                    restart_from_root = true;
+                    break;
+                }
+                split_node(node, parent);
+                node -> write_unlock();
+                if (parent != nullptr) parent -> write_unlock();
+                restart_from_root = true;
+                break;
+            }
+            if (node -> is_leaf)
+                break;
+
+            auto inner = static_cast<inner_node*>(node);
+            if (parent != nullptr)
+            {
+                parent -> read_unlock_or_restart(parent_v, need_restart);
+                if (need_restart) break;
+            }
+            parent = inner;
+            parent_v = v;
+            node = inner -> child(inner -> lower_bound(key, comp));
+            inner -> read_unlock_or_restart(v, need_restart);
+            if (need_restart) break;
+            v = node -> read_lock_or_restart(need_restart);
+            if (need_restart) break;
+        }
+        if (need_restart || restart_from_root)
+            continue;
+
+        auto leaf = static_cast<leaf_node*>(node);
+        node -> upgrade_to_write_lock_or_restart(v, need_restart);
+        if (need_restart)
+            continue;
+        if (parent != nullptr)
+        {
+            parent -> read_unlock_or_restart(parent_v, need_restart);
+            if (need_restart)
+            {
+                node -> write_unlock();
+                continue;
+            }
+        }
+        size_t pos = leaf -> lower_bound(key, comp);
+        bool exists = pos < leaf -> load_count() && !comp(key, leaf -> keys[pos].load());
+        if (exists)
+        {
+            if (assign)
+                leaf -> values[pos].store(value);
+        }
+        else
+        {
+            leaf -> insert_at(pos, key, value);
+        }
+        node -> write_unlock();
+        if (!exists)
+            count_.fetch_add(1, std::memory_order_relaxed);
+        return !exists;
+    }
+}
+
+/*****************************************************************************************/
+// erase
+// 下降途中遇到只剩一个孩子的内部结点先把它收缩掉，再从根重新下降
+// 叶子被删空时从父结点摘下；若父结点因此只剩一个孩子，元素已删除，
+// 再沿 key 的路径下降一次完成收缩，到达叶子即结束
+/*****************************************************************************************/
+template <class Key, class Value, class Compare>
+bool concurrent_map<Key, Value, Compare>::erase(const Key &key)
+{
+    epoch_guard guard;
+    bool erased = false;
+    while (true)
+    {
+        bool need_restart = false;
+        node_base *node = root.load(std::memory_order_acquire);
+        uint64_t v = node -> read_lock_or_restart(need_restart);
+        if (need_restart || node != root.load(std::memory_order_acquire))
+            continue;
+
+        inner_node *parent = nullptr;
+        uint64_t parent_v = 0;
+        size_t child_pos = 0;
+        bool restart_from_root = false;
+        while (!node -> is_leaf)
+        {
+            auto inner = static_cast<inner_node*>(node);
+            if (inner -> load_count() == 0)
+            {
+                collapse_node(inner, v, parent, parent_v, child_pos, need_restart);
+                restart_from_root = true;
+                break;
+            }
+            if (parent != nullptr)
+            {
+                parent -> read_unlock_or_restart(parent_v, need_restart);
+                if (need_restart) break;
+            }
+            parent = inner;
+            parent_v = v;
+            child_pos = inner -> lower_bound(key, comp);
+            node = inner -> child(child_pos);
+            inner -> read_unlock_or_restart(v, need_restart);
+            if (need_restart) break;
+            v = node -> read_lock_or_restart(need_restart);
+            if (need_restart) break;
+        }
+        if (need_restart || restart_from_root)
+            continue;
+        // 收缩已完成，路径上不再有只剩一个孩子的内部结点
+        if (erased)
+            return true;
+
+        auto leaf = static_cast<leaf_node*>(node);
+        size_t pos = leaf -> lower_bound(key, comp);
+        bool found = pos < leaf -> safe_count() && !comp(key, leaf -> keys[pos].load());
+        if (!found)
+        {
+            if (parent != nullptr)
+                parent -> read_unlock_or_restart(parent_v, need_restart);
+            node -> read_unlock_or_restart(v, need_restart);
+            if (need_restart)
+                continue;
+            return false;
+        }
+
+        if (leaf -> load_count() == 1 && parent != nullptr)
+        {
+            // 叶子将被删空：从父结点摘下并废弃，等读者离开后再释放
+            // 下降时已收缩掉只剩一个孩子的结点，加锁成功说明 parent 至少还有两个孩子
+            parent -> upgrade_to_write_lock_or_restart(parent_v, need_restart);
+            if (need_restart)
+                continue;
+            node -> upgrade_to_write_lock_or_restart(v, need_restart);
+            if (need_restart)
+            {
+                parent -> write_unlock();
+                continue;
+            }
+            parent -> erase_child(child_pos);
+            bool single_child = parent -> load_count() == 0;
+            node -> write_unlock_obsolete();
+            parent -> write_unlock();
+            epoch_domain::instance().retire(leaf);
+            count_.fetch_sub(1, std::memory_order_relaxed);
+            if (!single_child)
+                return true;
+            erased = true;
+            continue;
+        }
+
+        node -> upgrade_to_write_lock_or_restart(v, need_restart);
+        if (need_restart)
+            continue;
+        if (parent != nullptr)
+        {
+            parent -> read_unlock_or_restart(parent_v, need_restart);
+            if (need_restart)
+            {
+                node -> write_unlock();
+                continue;
+            }
+        }
+        leaf -> erase_at(pos);
+        node -> write_unlock();
+        count_.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+}
+
+/*****************************************************************************************/
+// scan
+// 逐个叶子拷贝出 [low, high) 内的元素，校验通过后再交给 f
+// 下降时记录当前叶子的上界（最近一个右侧分隔键），下一轮从该上界之后继续
+/*****************************************************************************************/
+template <class Key, class Value, class Compare>
+template <class Function>
+size_t concurrent_map<Key, Value, Compare>::
+scan(const Key &low, const Key &high, Function f) const
+{
+    Key    cursor = low;
+    bool   exclusive = false;   // 第二个叶子起只要严格大于 cursor 的键
+    size_t visited = 0;
+    Key    buf_keys[leaf_capacity];
+    Value  buf_values[leaf_capacity];
+
+    while (true)
+    {
+        size_t buffered = 0;
+        bool   has_fence = false;
+        Key    fence;
+        {
+            epoch_guard guard;
+            while (true)
+            {
+                bool need_restart = false;
+                buffered = 0;
+                has_fence = false;
+                node_base *node = root.load(std::memory_order_acquire);
+                uint64_t v = node -> read_lock_or_restart(need_restart);
+                if (need_restart || node != root.load(std::memory_order_acquire))
+                    continue;
+
+                inner_node *parent = nullptr;
+                uint64_t parent_v = 0;
+                while (!node -> is_leaf)
+                {
+                    auto inner = static_cast<inner_node*>(node);
+                    if (parent != nullptr)
+                    {
+                        parent -> read_unlock_or_restart(parent_v, need_restart);
+                        if (need_restart) break;
+                    }
+                    parent = inner;
+                    parent_v = v;
+                    size_t pos = exclusive ? inner -> upper_bound(cursor, comp)
+                                           : inner -> lower_bound(cursor, comp);
+                    if (pos < inner -> safe_count())
+                    {
+                        has_fence = true;
+                        fence = inner -> keys[pos].load();
+                    }
+                    node = inner -> child(pos);
+                    inner -> read_unlock_or_restart(v, need_restart);
+                    if (need_restart) break;
+                    v = node -> read_lock_or_restart(need_restart);
+                    if (need_restart) break;
+                }
+                if (need_restart)
+                    continue;
+
+                auto leaf = static_cast<leaf_node*>(node);
+                size_t count = leaf -> safe_count();
+                for (size_t i = leaf -> lower_bound(cursor, comp); i < count; ++i)
+                {
+                    Key k = leaf -> keys[i].load();
+                    if (!comp(k, high))
+                        break;
+                    if (exclusive && !comp(cursor, k))
+                        continue;
+                    buf_keys[buffered] = k;
+                    buf_values[buffered] = leaf -> values[i].load();
+                    ++buffered;
+                }
+                if (parent != nullptr)
+                    parent -> read_unlock_or_restart(parent_v, need_restart);
+                node -> read_unlock_or_restart(v, need_restart);
+                if (!need_restart)
+                    break;
+            }
+        }
+
+        for (size_t i = 0; i < buffered; ++i)
+            f(buf_keys[i], buf_values[i]);
+        visited += buffered;
+
+        if (!has_fence || !comp(fence, high))
+            return visited;
+        cursor = fence;
+        exclusive = true;
+    }
+}
+
+} // namespace MyStl
+
+#endif
@@ -56,6 +56,12 @@ namespace MyStl
     }
   }
 
+  template <class Ty>
+  void destroy(Ty* pointer)
+  {
+    destroy_one(pointer, std::is_trivially_destructible<Ty>{});
+  }
+
   template <class ForwardIter>
   void destroy_cat(ForwardIter, ForwardIter , std::true_type) {}
 
@@ -67,12 +73,6 @@ namespace MyStl
       destroy(&*first);
   }
 
-  template <class Ty>
-  void destroy(Ty* pointer)
-  {
-    destroy_one(pointer, std::is_trivially_destructible<Ty>{});
-  }
-
   template <class ForwardIter>
   void destroy(ForwardIter first, ForwardIter last)
   {
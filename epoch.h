@@ -0,0 +1,222 @@
+#ifndef MYSTL_EPOCH_H_
+#define MYSTL_EPOCH_H_
+
+// 这个头文件包含基于 epoch 的内存回收（epoch-based reclamation）
+// 并发容器中被摘下的结点可能仍被无锁读者访问，不能立即释放，
+// 先挂到线程本地的待回收链表上，等所有可能看到它的读者都离开之后再释放
+//
+// notes:
+//
+// 用法：
+//   * 访问并发容器前构造一个 epoch_guard，离开作用域时自动退出
+//   * 写者把结点从容器中摘下之后调用 epoch_domain::instance().retire(ptr)
+// 全局 epoch 只在所有活跃线程都已进入当前 epoch 时前进，
+// 在 epoch e 退休的对象在全局 epoch 到达 e + 2 后一定不再被任何读者引用
+
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+#include "exceptdef.h"
+
+namespace MyStl
+{
+
+class epoch_domain
+{
+public:
+    static constexpr size_t   max_threads     = 256;  // 同时参与回收的线程上限
+    static constexpr size_t   collect_batch   = 64;   // 本地待回收对象达到该数量时尝试回收
+    static constexpr uint64_t inactive        = ~static_cast<uint64_t>(0);
+
+    typedef void (*deleter_type)(void*);
+
+private:
+    struct retired
+    {
+        void         *ptr;
+        deleter_type deleter;
+        uint64_t     epoch;
+    };
+
+    // 每个线程独占一个槽，按缓存行对齐避免伪共享
+    struct alignas(64) thread_slot
+    {
+        std::atomic<uint64_t> epoch{inactive};
+        std::atomic<bool>     in_use{false};
+        size_t                nesting = 0;
+        std::vector<retired>  limbo;
+    };
+
+    // 线程退出时归还槽位，残留的待回收对象转交给 orphans
+    struct thread_handle
+    {
+        thread_slot *slot = nullptr;
+        ~thread_handle()
+        {
+            if (slot != nullptr)
+                epoch_domain::instance().release_slot(slot);
+        }
+    };
+
+private:
+    std::atomic<uint64_t> global_epoch{2};
+    thread_slot           slots[max_threads];
+    std::mutex            orphan_mutex;
+    std::vector<retired>  orphans;
+
+public:
+    static epoch_domain& instance()
+    {
+        static epoch_domain domain;
+        return domain;
+    }
+
+    ~epoch_domain()
+    {
+        // 程序结束时不再有读者，全部释放
+        for (auto &slot : slots)
+            free_all(slot.limbo);
+        free_all(orphans);
+    }
+
+public:
+    // 进入临界区，可嵌套
+    void enter()
+    {
+        auto slot = local_slot();
+        if (slot -> nesting++ == 0)
+        {
+            slot -> epoch.store(global_epoch.load(std::memory_order_relaxed), std::memory_order_release);
+            // 必须先公布自己所在的 epoch，之后再读取共享结点
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+    }
+
+    void leave()
+    {
+        auto slot = local_slot();
+        if (--slot -> nesting == 0)
+            slot -> epoch.store(inactive, std::memory_order_release);
+    }
+
+    // 对象已从共享结构中摘下，延迟到安全时再用 deleter 释放
+    void retire(void *ptr, deleter_type deleter)
+    {
+        auto slot = local_slot();
+        slot -> limbo.push_back(retired{ptr, deleter, global_epoch.load(std::memory_order_seq_cst)});
+        if (slot -> limbo.size() >= collect_batch)
+        {
+            try_advance();
+            collect(slot -> limbo);
+            collect_orphans();
+        }
+    }
+
+    template <class T>
+    void retire(T *ptr)
+    {
+        retire(ptr, [](void *p) { delete static_cast<T*>(p); });
+    }
+
+private:
+    epoch_domain() = default;
+    epoch_domain(const epoch_domain&) = delete;
+    epoch_domain& operator=(const epoch_domain&) = delete;
+
+    thread_slot* local_slot()
+    {
+        static thread_local thread_handle handle;
+        if (handle.slot == nullptr)
+            handle.slot = acquire_slot();
+        return handle.slot;
+    }
+
+    thread_slot* acquire_slot()
+    {
+        for (auto &slot : slots)
+        {
+            bool expected = false;
+            if (!slot.in_use.load(std::memory_order_relaxed) &&
+                slot.in_use.compare_exchange_strong(expected, true, std::memory_order_acquire))
+                return &slot;
+        }
+        THROW_RUNTIME_ERROR_IF(true, "epoch_domain: too many threads");
+        return nullptr;
+    }
+
+    void release_slot(thread_slot *slot)
+    {
+        {
+            std::lock_guard<std::mutex> lock(orphan_mutex);
+            orphans.insert(orphans.end(), slot -> limbo.begin(), slot -> limbo.end());
+        }
+        slot -> limbo.clear();
+        slot -> nesting = 0;
+        slot -> epoch.store(inactive, std::memory_order_release);
+        slot -> in_use.store(false, std::memory_order_release);
+    }
+
+    // 所有活跃线程都已观察到当前 epoch 时才能前进一步
+    void try_advance()
+    {
+        auto epoch = global_epoch.load(std::memory_order_seq_cst);
+        for (auto &slot : slots)
+        {
+            if (!slot.in_use.load(std::memory_order_acquire))
+                continue;
+            auto local = slot.epoch.load(std::memory_order_seq_cst);
+            if (local != inactive && local != epoch)
+                return;
+        }
+        global_epoch.compare_exchange_strong(epoch, epoch + 1, std::memory_order_seq_cst);
+    }
+
+    void collect(std::vector<retired> &list)
+    {
+        auto epoch = global_epoch.load(std::memory_order_seq_cst);
+        size_t kept = 0;
+        for (size_t i = 0; i < list.size(); ++i)
+        {
+            if (list[i].epoch + 2 <= epoch)
+                list[i].deleter(list[i].ptr);
+            else
+                list[kept++] = list[i];
+        }
+        list.resize(kept);
+    }
+
+    void collect_orphans()
+    {
+        std::unique_lock<std::mutex> lock(orphan_mutex, std::try_to_lock);
+        if (lock.owns_lock() && !orphans.empty())
+            collect(orphans);
+    }
+
+    static void free_all(std::vector<retired> &list)
+    {
+        for (auto &item : list)
+            item.deleter(item.ptr);
+        list.clear();
+    }
+};
+
+// --------------------------------------------------------------------------------------
+// 类 : epoch_guard
+// 在作用域内保护当前线程读到的并发结点不被回收
+class epoch_guard
+{
+public:
+    epoch_guard()  { epoch_domain::instance().enter(); }
+    ~epoch_guard() { epoch_domain::instance().leave(); }
+
+private:
+    epoch_guard(const epoch_guard&);
+    void operator=(const epoch_guard&);
+};
+
+} // namespace MyStl
+
+#endif
@@ -0,0 +1,59 @@
+#ifndef MYSTL_EXECUTION_H_
+#define MYSTL_EXECUTION_H_
+
+// 这个头文件包含执行策略，作为并行算法重载的第一个参数
+// seq 表示顺序执行；par 允许在多个线程上执行；par_unseq 还允许在同一线程内交错（向量化）执行
+
+#include <type_traits>
+
+#include "type_traits.h"
+
+namespace MyStl
+{
+namespace execution
+{
+
+struct sequenced_policy {};
+struct parallel_policy {};
+struct parallel_unsequenced_policy {};
+
+constexpr sequenced_policy            seq{};
+constexpr parallel_policy             par{};
+constexpr parallel_unsequenced_policy par_unseq{};
+
+} // namespace execution
+
+/*****************************************************************************************/
+// is_execution_policy
+// 判断类型是否为执行策略，用于在重载决议中区分并行版本和顺序版本
+/*****************************************************************************************/
+template <class T>
+struct is_execution_policy : m_false_type {};
+
+template <>
+struct is_execution_policy<execution::sequenced_policy> : m_true_type {};
+
+template <>
+struct is_execution_policy<execution::parallel_policy> : m_true_type {};
+
+template <>
+struct is_execution_policy<execution::parallel_unsequenced_policy> : m_true_type {};
+
+// 允许多线程执行的策略
+template <class T>
+struct is_parallel_policy : m_false_type {};
+
+template <>
+struct is_parallel_policy<execution::parallel_policy> : m_true_type {};
+
+template <>
+struct is_parallel_policy<execution::parallel_unsequenced_policy> : m_true_type {};
+
+// 仅当 ExecutionPolicy 去掉引用和 cv 限定后是执行策略时才参与重载
+template <class ExecutionPolicy, class T>
+using enable_if_execution_policy = typename std::enable_if<
+    is_execution_policy<typename std::decay<ExecutionPolicy>::type>::value, T>::type;
+
+} // namespace MyStl
+
+#endif
@@ -0,0 +1,352 @@
+#ifndef MYSTL_HASH_H_
+#define MYSTL_HASH_H_
+
+// 这个头文件包含哈希函数：hash_mix64, hash_combine, hash_bytes, hash 的各个特化, hash_batch
+
+// notes:
+//
+// 整数、浮点数和指针都先经过 64 位混合函数（MurmurHash3 的 fmix64），不是恒等映射：
+// 哈希表用 2 的幂取低位作为桶号时，连续的键或步长相同的键也能均匀地落在各个桶中
+// 字节串不超过 hash_short_max 字节时沿用 wyhash 的结构，每 48 字节只需三次 64 x 64 -> 128 位乘法；
+// 更长时沿用 XXH3 的结构，8 个 64 位累加器按 64 字节的条带累加，内层循环由 simd.h 的 SSE2 / AVX2 内核完成
+// 各个内核的结果逐位相同，但不保证与 wyhash / XXH3 原版的输出一致；结果与字节序有关，不宜持久化
+// 这些都不是密码学哈希，也不抵抗刻意构造的碰撞，需要时由调用者传入随机的 seed
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "iterator.h"
+#include "simd.h"
+#include "type_traits.h"
+#include "util.h"
+#include "vector.h"
+
+namespace MyStl
+{
+
+/*****************************************************************************************/
+// hash_mix64 / hash_mum / hash_combine
+/*****************************************************************************************/
+// 64 位整数的混合函数：双射，0 映射为 0，输入的每一位都会影响输出的每一位
+inline uint64_t hash_mix64(uint64_t x)
+{
+    return simd::mix64_scalar(x);
+}
+
+// a * b 的 128 位乘积高低两半异或，wyhash 的基本混合步骤
+inline uint64_t hash_mum(uint64_t a, uint64_t b)
+{
+    uint64_t lo;
+    const uint64_t hi = simd::mul_hi_lo(a, b, lo);
+    return hi ^ lo;
+}
+
+// 把新的哈希值 value 合并到已有的哈希值 seed 上，不满足交换律：(a, b) 与 (b, a) 的结果一般不同
+inline size_t hash_combine(size_t seed, size_t value)
+{
+    return static_cast<size_t>(hash_mum(static_cast<uint64_t>(seed) ^ 0x2D358DCCAA6C78A5ull,
+                                         static_cast<uint64_t>(value) ^ 0x8BB84B93962EACC9ull));
+}
+
+/*****************************************************************************************/
+// hash_bytes
+// 返回 [p, p + n) 这段内存的 64 位哈希值
+/*****************************************************************************************/
+constexpr size_t hash_short_max = 256;          // 不超过该长度时使用 wyhash 结构
+constexpr size_t hash_secret_size = 192;        // 长输入使用的密钥字节数
+constexpr size_t hash_stripe_bytes = 64;
+constexpr size_t hash_block_stripes = (hash_secret_size - hash_stripe_bytes) / 8;
+constexpr size_t hash_block_bytes = hash_block_stripes * hash_stripe_bytes;
+
+// 长输入的密钥：splitmix64(0) 的前 24 个输出
+inline const uint64_t* hash_secret()
+{
+    static const uint64_t secret[hash_secret_size / 8] = {
+        0xE220A8397B1DCDAFull, 0x6E789E6AA1B965F4ull, 0x06C45D188009454Full,
+        0xF88BB8A8724C81ECull, 0x1B39896A51A8749Bull, 0x53CB9F0C747EA2EAull,
+        0x2C829ABE1F4532E1ull, 0xC584133AC916AB3Cull, 0x3EE5789041C98AC3ull,
+        0xF3B8488C368CB0A6ull, 0x657EECDD3CB13D09ull, 0xC2D326E0055BDEF6ull,
+        0x8621A03FE0BBDB7Bull, 0x8E1F7555983AA92Full, 0xB54E0F1600CC4D19ull,
+        0x84BB3F97971D80ABull, 0x7D29825C75521255ull, 0xC3CF17102B7F7F86ull,
+        0x3466E9A083914F64ull, 0xD81A8D2B5A4485ACull, 0xDB01602B100B9ED7ull,
+        0xA9038A921825F10Dull, 0xEDF5F1D90DCA2F6Aull, 0x54496AD67BD2634Cull,
+    };
+    return secret;
+}
+
+inline uint64_t hash_read64(const unsigned char *p)
+{
+    uint64_t v;
+    std::memcpy(&v, p, 8);
+    return v;
+}
+
+inline uint64_t hash_read32(const unsigned char *p)
+{
+    uint32_t v;
+    std::memcpy(&v, p, 4);
+    return v;
+}
+
+// n <= hash_short_max：4 ~ 16 字节用两次可能重叠的 4 字节读取拼出两个 64 位数，
+// 更长时每 48 字节三路并行混合，最后 16 字节从末尾往回读
+inline uint64_t hash_bytes_short(const unsigned char *p, size_t n, uint64_t seed)
+{
+    const uint64_t k0 = 0x2D358DCCAA6C78A5ull;
+    const uint64_t k1 = 0x8BB84B93962EACC9ull;
+    const uint64_t k2 = 0x4B33A62ED433D4A3ull;
+    const uint64_t k3 = 0x4D5A2DA51DE1AA47ull;
+    seed ^= hash_mum(seed ^ k0, k1);
+    uint64_t a, b;
+    if (n <= 16)
+    {
+        if (n >= 4)
+        {
+            const size_t shift = (n >> 3) << 2;
+            a = (hash_read32(p) << 32) | hash_read32(p + shift);
+            b = (hash_read32(p + n - 4) << 32) | hash_read32(p + n - 4 - shift);
+        }
+        else if (n > 0)
+        {
+            a = (static_cast<uint64_t>(p[0]) << 16) | (static_cast<uint64_t>(p[n >> 1]) << 8) | p[n - 1];
+            b = 0;
+        }
+        else
+        {
+            a = b = 0;
+        }
+    }
+    else
+    {
+        size_t i = n;
+        if (i > 48)
+        {
+            uint64_t see1 = seed, see2 = seed;
+            do
+            {
+                seed = hash_mum(hash_read64(p) ^ k1, hash_read64(p + 8) ^ seed);
+                see1 = hash_mum(hash_read64(p + 16) ^ k2, hash_read64(p + 24) ^ see1);
+                see2 = hash_mum(hash_read64(p + 32) ^ k3, hash_read64(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16)
+        {
+            seed = hash_mum(hash_read64(p) ^ k1, hash_read64(p + 8) ^ seed);
+            p += 16;
+            i -= 16;
+        }
+        a = hash_read64(p + i - 16);
+        b = hash_read64(p + i - 8);
+    }
+    a ^= k1;
+    b ^= seed;
+    uint64_t lo;
+    const uint64_t hi = simd::mul_hi_lo(a, b, lo);
+    return hash_mum(lo ^ k0 ^ static_cast<uint64_t>(n), hi ^ k1);
+}
+
+// n > hash_short_max：每个 1 KiB 的块累加 16 个条带后扰乱一次累加器，
+// 最后一个不完整的块按整条带累加，再把末尾 64 字节作为一个条带收尾
+inline uint64_t hash_bytes_long(const unsigned char *p, size_t n, const unsigned char *secret)
+{
+    uint64_t acc[8] = {
+        0x00000000C2B2AE3Dull, 0x9E3779B185EBCA87ull, 0xC2B2AE3D27D4EB4Full, 0x165667B19E3779F9ull,
+        0x85EBCA77C2B2AE63ull, 0x0000000085EBCA77ull, 0x27D4EB2F165667C5ull, 0x000000009E3779B1ull,
+    };
+    const size_t blocks = (n - 1) / hash_block_bytes;
+    const unsigned char *scramble_key = secret + hash_secret_size - hash_stripe_bytes;
+    for (size_t k = 0; k < blocks; ++k)
+    {
+        simd::hash_stripes(acc, p + k * hash_block_bytes, hash_block_stripes, secret);
+        for (size_t i = 0; i < 8; ++i)
+        {
+            const uint64_t x = acc[i] ^ (acc[i] >> 47) ^ hash_read64(scramble_key + 8 * i);
+            acc[i] = x * 0x9E3779B1u;
+        }
+    }
+    const size_t stripes = ((n - 1) - blocks * hash_block_bytes) / hash_stripe_bytes;
+    simd::hash_stripes(acc, p + blocks * hash_block_bytes, stripes, secret);
+    simd::hash_stripes(acc, p + n - hash_stripe_bytes, 1, scramble_key - 7);
+
+    uint64_t h = static_cast<uint64_t>(n) * 0x9E3779B185EBCA87ull;
+    for (size_t i = 0; i < 4; ++i)
+        h += hash_mum(acc[2 * i] ^ hash_read64(secret + 11 + 16 * i),
+                      acc[2 * i + 1] ^ hash_read64(secret + 19 + 16 * i));
+    h ^= h >> 37;
+    h *= 0x165667919E3779F9ull;
+    return h ^ (h >> 32);
+}
+
+inline uint64_t hash_bytes(const void *data, size_t n, uint64_t seed = 0)
+{
+    auto p = static_cast<const unsigned char*>(data);
+    if (n <= hash_short_max)
+        return MyStl::hash_bytes_short(p, n, seed);
+    if (seed == 0)
+        return MyStl::hash_bytes_long(p, n, reinterpret_cast<const unsigned char*>(hash_secret()));
+    // 非零 seed 派生出一份新的密钥：偶数字加上 seed，奇数字减去 seed
+    uint64_t secret[hash_secret_size / 8];
+    for (size_t i = 0; i < hash_secret_size / 8; ++i)
+        secret[i] = (i & 1) ? hash_secret()[i] - seed : hash_secret()[i] + seed;
+    return MyStl::hash_bytes_long(p, n, reinterpret_cast<const unsigned char*>(secret));
+}
+
+/*****************************************************************************************/
+// hash
+// 未特化的类型没有默认的哈希函数
+/*****************************************************************************************/
+template <class Key>
+struct hash {};
+
+// 针对指针的偏特化版本：按地址哈希
+template <class T>
+struct hash<T*>
+{
+    size_t operator()(T* p) const noexcept
+    { return static_cast<size_t>(hash_mix64(static_cast<uint64_t>(reinterpret_cast<uintptr_t>(p)))); }
+};
+
+// 对于整型类型，按无符号数零扩展到 64 位后混合
+#define MYSTL_INTEGER_HASH_FCN(Type)                                                         \
+template <> struct hash<Type>                                                                \
+{                                                                                            \
+  size_t operator()(Type val) const noexcept                                                 \
+  {                                                                                          \
+    return static_cast<size_t>(hash_mix64(                                                   \
+        static_cast<uint64_t>(static_cast<std::make_unsigned<Type>::type>(val))));           \
+  }                                                                                          \
+};
+
+MYSTL_INTEGER_HASH_FCN(char)
+MYSTL_INTEGER_HASH_FCN(signed char)
+MYSTL_INTEGER_HASH_FCN(unsigned char)
+MYSTL_INTEGER_HASH_FCN(wchar_t)
+MYSTL_INTEGER_HASH_FCN(char16_t)
+MYSTL_INTEGER_HASH_FCN(char32_t)
+MYSTL_INTEGER_HASH_FCN(short)
+MYSTL_INTEGER_HASH_FCN(unsigned short)
+MYSTL_INTEGER_HASH_FCN(int)
+MYSTL_INTEGER_HASH_FCN(unsigned int)
+MYSTL_INTEGER_HASH_FCN(long)
+MYSTL_INTEGER_HASH_FCN(unsigned long)
+MYSTL_INTEGER_HASH_FCN(long long)
+MYSTL_INTEGER_HASH_FCN(unsigned long long)
+
+#undef MYSTL_INTEGER_HASH_FCN
+
+template <>
+struct hash<bool>
+{
+  size_t operator()(bool val) const noexcept
+  { return static_cast<size_t>(hash_mix64(val ? 1 : 0)); }
+};
+
+// 对于浮点数，按位哈希；0.0 与 -0.0 相等，统一按 0 处理
+template <>
+struct hash<float>
+{
+  size_t operator()(const float& val) const noexcept
+  {
+    uint32_t bits = 0;
+    if (val != 0.0f)
+      std::memcpy(&bits, &val, sizeof(bits));
+    return static_cast<size_t>(hash_mix64(bits));
+  }
+};
+
+template <>
+struct hash<double>
+{
+  size_t operator()(const double& val) const noexcept
+  {
+    uint64_t bits = 0;
+    if (val != 0.0)
+      std::memcpy(&bits, &val, sizeof(bits));
+    return static_cast<size_t>(hash_mix64(bits));
+  }
+};
+
+// long double 的存储可能含有未初始化的填充字节，转换为 double 后哈希：相等的值哈希值一定相同
+template <>
+struct hash<long double>
+{
+  size_t operator()(const long double& val) const noexcept
+  { return hash<double>()(static_cast<double>(val)); }
+};
+
+// pair 依次合并两个成员的哈希值
+template <class Ty1, class Ty2>
+struct hash<pair<Ty1, Ty2>>
+{
+  size_t operator()(const pair<Ty1, Ty2>& p) const
+  { return MyStl::hash_combine(hash<Ty1>()(p.first), hash<Ty2>()(p.second)); }
+};
+
+// 字节类型的 vector 当作字节串哈希
+template <class Vector>
+struct byte_vector_hash
+{
+  size_t operator()(const Vector& v) const noexcept
+  { return static_cast<size_t>(MyStl::hash_bytes(v.data(), v.size())); }
+};
+
+template <> struct hash<vector<char>> : byte_vector_hash<vector<char>> {};
+template <> struct hash<vector<signed char>> : byte_vector_hash<vector<signed char>> {};
+template <> struct hash<vector<unsigned char>> : byte_vector_hash<vector<unsigned char>> {};
+
+/*****************************************************************************************/
+// hash_batch
+// 对 [first, last) 中的每个元素计算哈希值，依次写到以 result 起始的位置，返回写出的末尾
+// 哈希表批量插入或查找时可以先一次算出全部哈希值，再统一预取桶，把计算与访存分开
+/*****************************************************************************************/
+// 4 / 8 字节整数的原生指针区间使用默认 hash、输出为 64 位 size_t 时，每次混合 4 个元素
+template <class InputIter, class OutputIter, class Hash>
+struct is_hash_batch_mixable : m_false_type {};
+
+template <class Tp, class Hash>
+struct is_hash_batch_mixable<Tp*, size_t*, Hash>
+  : m_bool_constant<
+      std::is_integral<Tp>::value && !std::is_same<typename std::remove_cv<Tp>::type, bool>::value &&
+      (sizeof(Tp) == 4 || sizeof(Tp) == 8) && sizeof(size_t) == 8 &&
+      std::is_same<Hash, hash<typename std::remove_cv<Tp>::type>>::value>
+{
+};
+
+template <class InputIter, class OutputIter, class Hash>
+OutputIter hash_batch_dispatch(InputIter first, InputIter last, OutputIter result, Hash hasher, m_false_type)
+{
+    for (; first != last; ++first, ++result)
+        *result = hasher(*first);
+    return result;
+}
+
+template <class Tp, class Hash>
+size_t* hash_batch_dispatch(Tp *first, Tp *last, size_t *result, Hash, m_true_type)
+{
+    const size_t n = static_cast<size_t>(last - first);
+    simd::mix64_batch(first, n, result);
+    return result + n;
+}
+
+template <class InputIter, class OutputIter, class Hash>
+OutputIter hash_batch(InputIter first, InputIter last, OutputIter result, Hash hasher)
+{
+    return MyStl::hash_batch_dispatch(first, last, result, hasher,
+                                      is_hash_batch_mixable<InputIter, OutputIter, Hash>());
+}
+
+template <class InputIter, class OutputIter>
+OutputIter hash_batch(InputIter first, InputIter last, OutputIter result)
+{
+    typedef typename iterator_traits<InputIter>::value_type value_type;
+    return MyStl::hash_batch(first, last, result, hash<value_type>());
+}
+
+} // namespace MyStl
+
+#endif
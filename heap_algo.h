@@ -1,4 +1,149 @@
 #ifndef MYSTL_HEAP_ALGO_H
 #define MYSTL_HEAP_ALGO_H
 
+// 这个头文件包含 heap 的四个算法 : push_heap, pop_heap, sort_heap, make_heap
+// 默认为 max-heap：根节点不小于其子节点；传入 comp 时根节点为 comp 意义下的最大值
+
+#include <cstddef>
+
+#include "functional.h"
+#include "iterator.h"
+#include "util.h"
+
+namespace MyStl
+{
+
+/*****************************************************************************************/
+// push_heap
+// 该函数接受两个迭代器，表示一个 heap 容器的首尾，并且新元素已经插入到底部容器的最尾端，调整 heap
+/*****************************************************************************************/
+// 把 value 从 hole_index 处向上调整，直到父节点不小于它或到达 top_index
+template <class RandomIter, class Distance, class T, class Compared>
+void push_heap_aux(RandomIter first, Distance hole_index, Distance top_index, T value, Compared comp)
+{
+    auto parent = (hole_index - 1) / 2;
+    while (hole_index > top_index && comp(*(first + parent), value))
+    {
+        *(first + hole_index) = MyStl::move(*(first + parent));
+        hole_index = parent;
+        parent = (hole_index - 1) / 2;
+    }
+    *(first + hole_index) = MyStl::move(value);
+}
+
+template <class RandomIter, class Compared>
+void push_heap(RandomIter first, RandomIter last, Compared comp)
+{
+    typedef typename iterator_traits<RandomIter>::difference_type Distance;
+    if (last - first < 2)
+        return;
+    auto value = MyStl::move(*(last - 1));
+    MyStl::push_heap_aux(first, static_cast<Distance>((last - first) - 1), static_cast<Distance>(0),
+                         MyStl::move(value), comp);
+}
+
+template <class RandomIter>
+void push_heap(RandomIter first, RandomIter last)
+{
+    MyStl::push_heap(first, last, MyStl::less<typename iterator_traits<RandomIter>::value_type>());
+}
+
+/*****************************************************************************************/
+// pop_heap
+// 该函数接受两个迭代器，表示 heap 容器的首尾，将 heap 的根节点取出放到容器尾部，调整 heap
+/*****************************************************************************************/
+// 在长度为 len 的 heap 中，hole_index 处的值已被取走，填入 value 并恢复 heap
+// 先沿较大的子节点一路下沉到叶子，再把 value 向上调整：下沉阶段每层只比较一次
+template <class RandomIter, class Distance, class T, class Compared>
+void adjust_heap(RandomIter first, Distance hole_index, Distance len, T value, Compared comp)
+{
+    const auto top_index = hole_index;
+    auto rchild = 2 * hole_index + 2;
+    while (rchild < len)
+    {
+        if (comp(*(first + rchild), *(first + (rchild - 1))))
+            --rchild;
+        *(first + hole_index) = MyStl::move(*(first + rchild));
+        hole_index = rchild;
+        rchild = 2 * (rchild + 1);
+    }
+    if (rchild == len)
+    {
+        // 只有左子节点
+        *(first + hole_index) = MyStl::move(*(first + (rchild - 1)));
+        hole_index = rchild - 1;
+    }
+    MyStl::push_heap_aux(first, hole_index, top_index, MyStl::move(value), comp);
+}
+
+// 把根节点移到 result，value 重新放入 [first, last) 的 heap
+template <class RandomIter, class T, class Compared>
+void pop_heap_aux(RandomIter first, RandomIter last, RandomIter result, T value, Compared comp)
+{
+    typedef typename iterator_traits<RandomIter>::difference_type Distance;
+    *result = MyStl::move(*first);
+    MyStl::adjust_heap(first, static_cast<Distance>(0), static_cast<Distance>(last - first),
+                       MyStl::move(value), comp);
+}
+
+template <class RandomIter, class Compared>
+void pop_heap(RandomIter first, RandomIter last, Compared comp)
+{
+    if (last - first < 2)
+        return;
+    auto value = MyStl::move(*(last - 1));
+    MyStl::pop_heap_aux(first, last - 1, last - 1, MyStl::move(value), comp);
+}
+
+template <class RandomIter>
+void pop_heap(RandomIter first, RandomIter last)
+{
+    MyStl::pop_heap(first, last, MyStl::less<typename iterator_traits<RandomIter>::value_type>());
+}
+
+/*****************************************************************************************/
+// sort_heap
+// 该函数接受两个迭代器，表示 heap 容器的首尾，不断执行 pop_heap 操作，直到首尾最多相差1
+/*****************************************************************************************/
+template <class RandomIter, class Compared>
+void sort_heap(RandomIter first, RandomIter last, Compared comp)
+{
+    while (last - first > 1)
+        MyStl::pop_heap(first, last--, comp);
+}
+
+template <class RandomIter>
+void sort_heap(RandomIter first, RandomIter last)
+{
+    MyStl::sort_heap(first, last, MyStl::less<typename iterator_traits<RandomIter>::value_type>());
+}
+
+/*****************************************************************************************/
+// make_heap
+// 该函数接受两个迭代器，表示 heap 容器的首尾，把容器内的数据变为一个 heap
+/*****************************************************************************************/
+template <class RandomIter, class Compared>
+void make_heap(RandomIter first, RandomIter last, Compared comp)
+{
+    typedef typename iterator_traits<RandomIter>::difference_type Distance;
+    const Distance len = last - first;
+    if (len < 2)
+        return;
+    for (Distance hole_index = (len - 2) / 2; ; --hole_index)
+    {
+        auto value = MyStl::move(*(first + hole_index));
+        MyStl::adjust_heap(first, hole_index, len, MyStl::move(value), comp);
+        if (hole_index == 0)
+            return;
+    }
+}
+
+template <class RandomIter>
+void make_heap(RandomIter first, RandomIter last)
+{
+    MyStl::make_heap(first, last, MyStl::less<typename iterator_traits<RandomIter>::value_type>());
+}
+
+} // namespace MyStl
+
 #endif
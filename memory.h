@@ -104,6 +104,7 @@ private:
 template <class ForwardIterator, class T>
 temporary_buffer<ForwardIterator, T>::
 temporary_buffer(ForwardIterator first, ForwardIterator last)
+    : original_len(0), len(0), buffer(nullptr)
 {
     try
     {
@@ -138,6 +139,93 @@ void temporary_buffer<ForwardIterator, T>::allocate_buffer()
     }
 }
 
+// --------------------------------------------------------------------------------------
+// 类模板 : move_buffer
+// 只申请未初始化的临时空间，不构造任何元素，析构时只释放空间
+// 使用者用 move_into_buffer / construct 把元素移动构造进来，再用 move_out_of_buffer 移回原处并销毁
+// temporary_buffer 会用 *first 拷贝构造每个位置，既多一趟拷贝，也不能用于只能移动的类型
+template <class T>
+class move_buffer
+{
+private:
+    ptrdiff_t   original_len; // 缓冲区申请的大小
+    ptrdiff_t   len;          // 缓冲区实际的大小
+    T*          buffer;       // 指向缓冲区的指针
+
+public:
+    explicit move_buffer(ptrdiff_t n)
+        : original_len(n), len(0), buffer(nullptr)
+    {
+        auto p = MyStl::get_temporary_buffer<T>(n);
+        buffer = p.first;
+        len = p.second;
+    }
+
+    ~move_buffer()
+    {
+        MyStl::release_temporary_buffer(buffer);
+    }
+
+public:
+    ptrdiff_t size()            const noexcept { return len; }
+    ptrdiff_t requested_size()  const noexcept { return original_len; }
+    T*        begin()                 noexcept { return buffer; }
+    T*        end()                   noexcept { return buffer + len; }
+
+private:
+    move_buffer(const move_buffer&);
+    void operator=(const move_buffer&);
+};
+
+// 把缓冲区中已构造的 [first, last) 移动赋值到以 result 为起始的区间，随后销毁它们，返回结束位置
+template <class T, class ForwardIter>
+ForwardIter move_out_of_buffer(T *first, T *last, ForwardIter result)
+{
+    result = MyStl::move(first, last, result);
+    MyStl::destroy(first, last);
+    return result;
+}
+
+// 与 move_out_of_buffer 相同，但移到以 result 为结尾的区间，返回起始位置
+template <class T, class BidirectionalIter>
+BidirectionalIter move_out_of_buffer_backward(T *first, T *last, BidirectionalIter result)
+{
+    result = MyStl::move_backward(first, last, result);
+    MyStl::destroy(first, last);
+    return result;
+}
+
+// 把 [first, last) 移动构造到未初始化的缓冲区 buffer，返回缓冲区中的结束位置
+// 移动构造可能抛出异常时逐个构造，失败则把已移入的元素移回原处并销毁，再重新抛出
+template <class ForwardIter, class T>
+T* move_into_buffer_cat(ForwardIter first, ForwardIter last, T *buffer, std::true_type)
+{
+    return MyStl::uninitialized_move(first, last, buffer);
+}
+
+template <class ForwardIter, class T>
+T* move_into_buffer_cat(ForwardIter first, ForwardIter last, T *buffer, std::false_type)
+{
+    T *buffer_end = buffer;
+    try
+    {
+        for (auto cur = first; cur != last; ++cur, ++buffer_end)
+            MyStl::construct(buffer_end, MyStl::move(*cur));
+    }
+    catch (...)
+    {
+        MyStl::move_out_of_buffer(buffer, buffer_end, first);
+        throw;
+    }
+    return buffer_end;
+}
+
+template <class ForwardIter, class T>
+T* move_into_buffer(ForwardIter first, ForwardIter last, T *buffer)
+{
+    return MyStl::move_into_buffer_cat(first, last, buffer, std::is_nothrow_move_constructible<T>{});
+}
+
 
 // --------------------------------------------------------------------------------------
 // 模板类: auto_ptr
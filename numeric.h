@@ -0,0 +1,409 @@
+#ifndef MYSTL_NUMERIC_H_
+#define MYSTL_NUMERIC_H_
+
+// 这个头文件包含 MyStl 的数值算法：accumulate, reduce, transform_reduce, inner_product,
+// partial_sum, inclusive_scan, exclusive_scan, adjacent_difference
+
+// notes:
+//
+// accumulate / inner_product / 各种 scan 按从左到右的顺序计算，与逐个累加的结果完全一致
+// reduce / transform_reduce 允许任意结合和交换，要求运算满足结合律和交换律
+// 快速路径：
+//   * reduce 在算术类型的原生指针上求和时使用 simd::reduce_sum（多个向量累加器）
+//   * transform_reduce 在 float / double 的原生指针上求内积时使用 simd::dot
+//   * 其余随机访问迭代器上的 reduce / transform_reduce 使用四个独立累加器展开，缩短依赖链
+//   * accumulate / inner_product 只在整数上使用上述路径：整数按无符号回绕计算，改变顺序结果不变
+// 并行版本（接受执行策略）位于 parallel_algo.h
+
+#include <cstddef>
+#include <type_traits>
+
+#include "functional.h"
+#include "iterator.h"
+#include "simd.h"
+#include "util.h"
+
+namespace MyStl
+{
+
+// 各算法的默认运算，与 operator+ / operator- / operator* 相同，两个参数的类型可以不同
+struct plus_op
+{
+    template <class T, class U>
+    auto operator()(const T &lhs, const U &rhs) const -> decltype(lhs + rhs) { return lhs + rhs; }
+};
+
+struct minus_op
+{
+    template <class T, class U>
+    auto operator()(const T &lhs, const U &rhs) const -> decltype(lhs - rhs) { return lhs - rhs; }
+};
+
+struct multiplies_op
+{
+    template <class T, class U>
+    auto operator()(const T &lhs, const U &rhs) const -> decltype(lhs * rhs) { return lhs * rhs; }
+};
+
+/*****************************************************************************************/
+// 快速路径的类型判断
+/*****************************************************************************************/
+// 运算是 T 上的加法
+template <class Op, class T>
+struct is_plus_op
+  : m_bool_constant<std::is_same<Op, plus_op>::value || std::is_same<Op, plus<T>>::value> {};
+
+// 运算是 T 上的乘法
+template <class Op, class T>
+struct is_multiplies_op
+  : m_bool_constant<std::is_same<Op, multiplies_op>::value || std::is_same<Op, multiplies<T>>::value> {};
+
+// 元素类型 Tp 与累加类型 T 相同，且可以按 SIMD 通道处理
+template <class Tp, class T>
+struct is_simd_reduce_value
+  : m_bool_constant<simd::is_vectorizable<Tp>::value &&
+                    std::is_same<typename std::remove_cv<Tp>::type, T>::value> {};
+
+// 整数的回绕累加类型：乘法至少在 unsigned int 上进行，避免小整数提升为 int 后溢出
+template <class T>
+struct numeric_wrap
+{
+    typedef typename std::common_type<typename simd::wrap_of<T>::type, unsigned>::type type;
+};
+
+/*****************************************************************************************/
+// reduce_indexed
+// 对 get(0) ... get(n - 1) 用 op 归约，四个累加器交替累加，相互之间没有数据依赖
+// 要求 op 满足结合律和交换律
+/*****************************************************************************************/
+template <class T, class BinaryOp, class Get>
+T reduce_indexed(size_t n, T init, BinaryOp op, Get get)
+{
+    if (n < 8)
+    {
+        for (size_t i = 0; i < n; ++i)
+            init = op(init, get(i));
+        return init;
+    }
+    T a0 = op(init, get(0));
+    T a1 = op(get(1), get(2));
+    T a2 = op(get(3), get(4));
+    T a3 = op(get(5), get(6));
+    size_t i = 7;
+    for (; i + 4 <= n; i += 4)
+    {
+        a0 = op(a0, get(i));
+        a1 = op(a1, get(i + 1));
+        a2 = op(a2, get(i + 2));
+        a3 = op(a3, get(i + 3));
+    }
+    for (; i < n; ++i)
+        a0 = op(a0, get(i));
+    return op(op(a0, a1), op(a2, a3));
+}
+
+/*****************************************************************************************/
+// accumulate
+// 版本1：以初值 init 对每个元素进行累加
+// 版本2：以初值 init 对每个元素进行二元操作
+/*****************************************************************************************/
+template <class InputIter, class T, class BinaryOp>
+T unchecked_accumulate(InputIter first, InputIter last, T init, BinaryOp op)
+{
+    for (; first != last; ++first)
+        init = op(init, *first);
+    return init;
+}
+
+// 整数的加法和乘法在回绕类型上计算，与顺序累加的结果相同
+template <class Tp, class T, class BinaryOp>
+typename std::enable_if<is_simd_reduce_value<Tp, T>::value && std::is_integral<T>::value &&
+                        (is_plus_op<BinaryOp, T>::value || is_multiplies_op<BinaryOp, T>::value), T>::type
+unchecked_accumulate(Tp *first, Tp *last, T init, BinaryOp)
+{
+    typedef typename numeric_wrap<T>::type W;
+    const size_t n = static_cast<size_t>(last - first);
+    if (is_plus_op<BinaryOp, T>::value)
+        return static_cast<T>(static_cast<W>(init) + static_cast<W>(simd::reduce_sum(first, last)));
+    return static_cast<T>(MyStl::reduce_indexed(n, static_cast<W>(init), multiplies<W>(),
+                                                [first](size_t i) { return static_cast<W>(first[i]); }));
+}
+
+template <class InputIter, class T>
+T accumulate(InputIter first, InputIter last, T init)
+{
+    return MyStl::unchecked_accumulate(first, last, init, plus_op());
+}
+
+template <class InputIter, class T, class BinaryOp>
+T accumulate(InputIter first, InputIter last, T init, BinaryOp binary_op)
+{
+    return MyStl::unchecked_accumulate(first, last, init, binary_op);
+}
+
+/*****************************************************************************************/
+// reduce
+// 与 accumulate 相同，但允许以任意顺序结合，默认初值为值类型的值初始化
+/*****************************************************************************************/
+template <class InputIter, class T, class BinaryOp>
+T reduce_dispatch(InputIter first, InputIter last, T init, BinaryOp op, input_iterator_tag)
+{
+    for (; first != last; ++first)
+        init = op(init, *first);
+    return init;
+}
+
+template <class RandomIter, class T, class BinaryOp>
+T reduce_dispatch(RandomIter first, RandomIter last, T init, BinaryOp op, random_access_iterator_tag)
+{
+    return MyStl::reduce_indexed(static_cast<size_t>(last - first), init, op,
+                                 [first](size_t i) -> decltype(*first) { return first[i]; });
+}
+
+// 算术类型的原生指针求和使用 SIMD 内核；整数与初值的相加同样在回绕类型上进行，避免有符号溢出
+template <class Tp, class T, class BinaryOp>
+typename std::enable_if<is_simd_reduce_value<Tp, T>::value && is_plus_op<BinaryOp, T>::value, T>::type
+reduce_dispatch(Tp *first, Tp *last, T init, BinaryOp, random_access_iterator_tag)
+{
+    typedef typename simd::wrap_of<T>::type W;
+    if (first == last)
+        return init;
+    return static_cast<T>(static_cast<W>(init) + static_cast<W>(simd::reduce_sum(first, last)));
+}
+
+template <class InputIter, class T, class BinaryOp>
+T reduce(InputIter first, InputIter last, T init, BinaryOp binary_op)
+{
+    return MyStl::reduce_dispatch(first, last, init, binary_op, iterator_category(first));
+}
+
+template <class InputIter, class T>
+T reduce(InputIter first, InputIter last, T init)
+{
+    return MyStl::reduce(first, last, init, plus_op());
+}
+
+template <class InputIter>
+typename iterator_traits<InputIter>::value_type
+reduce(InputIter first, InputIter last)
+{
+    return MyStl::reduce(first, last, typename iterator_traits<InputIter>::value_type{}, plus_op());
+}
+
+/*****************************************************************************************/
+// transform_reduce
+// 版本1：两个区间对应元素用 transform_op 结合，再用 reduce_op 归约，默认为内积
+// 版本2：对一个区间的每个元素用 unary_op 变换，再用 reduce_op 归约
+// 与 reduce 相同，允许以任意顺序结合
+/*****************************************************************************************/
+template <class InputIter1, class InputIter2, class T, class BinaryOp1, class BinaryOp2>
+T transform_reduce_dispatch(InputIter1 first1, InputIter1 last1, InputIter2 first2, T init,
+                            BinaryOp1 reduce_op, BinaryOp2 transform_op, m_false_type)
+{
+    for (; first1 != last1; ++first1, (void) ++first2)
+        init = reduce_op(init, transform_op(*first1, *first2));
+    return init;
+}
+
+template <class RandomIter1, class RandomIter2, class T, class BinaryOp1, class BinaryOp2>
+T transform_reduce_dispatch(RandomIter1 first1, RandomIter1 last1, RandomIter2 first2, T init,
+                            BinaryOp1 reduce_op, BinaryOp2 transform_op, m_true_type)
+{
+    return MyStl::reduce_indexed(static_cast<size_t>(last1 - first1), init, reduce_op,
+                                 [&](size_t i) { return transform_op(first1[i], first2[i]); });
+}
+
+// float / double 的原生指针求内积使用 SIMD 内核
+template <class Tp, class Up, class T, class BinaryOp1, class BinaryOp2>
+typename std::enable_if<std::is_floating_point<T>::value && is_simd_reduce_value<Tp, T>::value &&
+                        is_simd_reduce_value<Up, T>::value && is_plus_op<BinaryOp1, T>::value &&
+                        is_multiplies_op<BinaryOp2, T>::value, T>::type
+transform_reduce_dispatch(Tp *first1, Tp *last1, Up *first2, T init,
+                          BinaryOp1, BinaryOp2, m_true_type)
+{
+    if (first1 == last1)
+        return init;
+    return init + simd::dot<T>(first1, first2, static_cast<size_t>(last1 - first1));
+}
+
+template <class InputIter1, class InputIter2, class T, class BinaryOp1, class BinaryOp2>
+T transform_reduce(InputIter1 first1, InputIter1 last1, InputIter2 first2, T init,
+                   BinaryOp1 reduce_op, BinaryOp2 transform_op)
+{
+    return MyStl::transform_reduce_dispatch(first1, last1, first2, init, reduce_op, transform_op,
+        m_bool_constant<is_random_access_iterator<InputIter1>::value &&
+                        is_random_access_iterator<InputIter2>::value>{});
+}
+
+template <class InputIter1, class InputIter2, class T>
+T transform_reduce(InputIter1 first1, InputIter1 last1, InputIter2 first2, T init)
+{
+    return MyStl::transform_reduce(first1, last1, first2, init, plus_op(), multiplies_op());
+}
+
+template <class InputIter, class T, class BinaryOp, class UnaryOp>
+T transform_reduce_dispatch(InputIter first, InputIter last, T init,
+                            BinaryOp reduce_op, UnaryOp unary_op, input_iterator_tag)
+{
+    for (; first != last; ++first)
+        init = reduce_op(init, unary_op(*first));
+    return init;
+}
+
+template <class RandomIter, class T, class BinaryOp, class UnaryOp>
+T transform_reduce_dispatch(RandomIter first, RandomIter last, T init,
+                            BinaryOp reduce_op, UnaryOp unary_op, random_access_iterator_tag)
+{
+    return MyStl::reduce_indexed(static_cast<size_t>(last - first), init, reduce_op,
+                                 [&](size_t i) { return unary_op(first[i]); });
+}
+
+template <class InputIter, class T, class BinaryOp, class UnaryOp>
+T transform_reduce(InputIter first, InputIter last, T init, BinaryOp reduce_op, UnaryOp unary_op)
+{
+    return MyStl::transform_reduce_dispatch(first, last, init, reduce_op, unary_op,
+                                            iterator_category(first));
+}
+
+/*****************************************************************************************/
+// inner_product
+// 版本1：以 init 为初值，计算两个区间的内积
+// 版本2：自定义 operator+ 和 operator*
+/*****************************************************************************************/
+template <class InputIter1, class InputIter2, class T>
+T unchecked_inner_product(InputIter1 first1, InputIter1 last1, InputIter2 first2, T init)
+{
+    for (; first1 != last1; ++first1, (void) ++first2)
+        init = init + (*first1 * *first2);
+    return init;
+}
+
+// 同一整数类型的原生指针在回绕类型上用多个累加器计算，与顺序累加的结果相同
+template <class Tp, class Up, class T>
+typename std::enable_if<std::is_integral<T>::value && is_simd_reduce_value<Tp, T>::value &&
+                        is_simd_reduce_value<Up, T>::value, T>::type
+unchecked_inner_product(Tp *first1, Tp *last1, Up *first2, T init)
+{
+    typedef typename numeric_wrap<T>::type W;
+    return static_cast<T>(MyStl::reduce_indexed(static_cast<size_t>(last1 - first1), static_cast<W>(init),
+        plus<W>(), [=](size_t i) { return static_cast<W>(static_cast<W>(first1[i]) * static_cast<W>(first2[i])); }));
+}
+
+template <class InputIter1, class InputIter2, class T>
+T inner_product(InputIter1 first1, InputIter1 last1, InputIter2 first2, T init)
+{
+    return MyStl::unchecked_inner_product(first1, last1, first2, init);
+}
+
+template <class InputIter1, class InputIter2, class T, class BinaryOp1, class BinaryOp2>
+T inner_product(InputIter1 first1, InputIter1 last1, InputIter2 first2, T init,
+                BinaryOp1 binary_op1, BinaryOp2 binary_op2)
+{
+    for (; first1 != last1; ++first1, (void) ++first2)
+        init = binary_op1(init, binary_op2(*first1, *first2));
+    return init;
+}
+
+/*****************************************************************************************/
+// partial_sum / inclusive_scan
+// 计算前缀和（或前缀的二元运算结果），第 i 个结果包含第 i 个元素，结果保存到以 result 为起始的位置上
+// inclusive_scan 可以额外指定初值 init
+/*****************************************************************************************/
+template <class InputIter, class OutputIter, class BinaryOp>
+OutputIter partial_sum(InputIter first, InputIter last, OutputIter result, BinaryOp binary_op)
+{
+    if (first == last)
+        return result;
+    typename iterator_traits<InputIter>::value_type value = *first;
+    *result = value;
+    while (++first != last)
+    {
+        value = binary_op(value, *first);
+        *++result = value;
+    }
+    return ++result;
+}
+
+template <class InputIter, class OutputIter>
+OutputIter partial_sum(InputIter first, InputIter last, OutputIter result)
+{
+    return MyStl::partial_sum(first, last, result, plus_op());
+}
+
+template <class InputIter, class OutputIter>
+OutputIter inclusive_scan(InputIter first, InputIter last, OutputIter result)
+{
+    return MyStl::partial_sum(first, last, result, plus_op());
+}
+
+template <class InputIter, class OutputIter, class BinaryOp>
+OutputIter inclusive_scan(InputIter first, InputIter last, OutputIter result, BinaryOp binary_op)
+{
+    return MyStl::partial_sum(first, last, result, binary_op);
+}
+
+template <class InputIter, class OutputIter, class BinaryOp, class T>
+OutputIter inclusive_scan(InputIter first, InputIter last, OutputIter result, BinaryOp binary_op, T init)
+{
+    for (; first != last; ++first, (void) ++result)
+    {
+        init = binary_op(init, *first);
+        *result = init;
+    }
+    return result;
+}
+
+/*****************************************************************************************/
+// exclusive_scan
+// 第 i 个结果为 init 与前 i 个元素（不含第 i 个）的运算结果
+/*****************************************************************************************/
+template <class InputIter, class OutputIter, class T, class BinaryOp>
+OutputIter exclusive_scan(InputIter first, InputIter last, OutputIter result, T init, BinaryOp binary_op)
+{
+    for (; first != last; ++first, (void) ++result)
+    {
+        // 先读出当前元素再写结果，允许 result 与 first 相同
+        T next = binary_op(init, *first);
+        *result = init;
+        init = MyStl::move(next);
+    }
+    return result;
+}
+
+template <class InputIter, class OutputIter, class T>
+OutputIter exclusive_scan(InputIter first, InputIter last, OutputIter result, T init)
+{
+    return MyStl::exclusive_scan(first, last, result, init, plus_op());
+}
+
+/*****************************************************************************************/
+// adjacent_difference
+// 版本1：计算相邻元素的差值，结果保存到以 result 为起始的区间上
+// 版本2：自定义相邻元素的二元操作
+/*****************************************************************************************/
+template <class InputIter, class OutputIter, class BinaryOp>
+OutputIter adjacent_difference(InputIter first, InputIter last, OutputIter result, BinaryOp binary_op)
+{
+    if (first == last)
+        return result;
+    typedef typename iterator_traits<InputIter>::value_type value_type;
+    value_type prev = *first;
+    *result = prev;
+    while (++first != last)
+    {
+        value_type value = *first;
+        *++result = binary_op(value, prev);
+        prev = MyStl::move(value);
+    }
+    return ++result;
+}
+
+template <class InputIter, class OutputIter>
+OutputIter adjacent_difference(InputIter first, InputIter last, OutputIter result)
+{
+    return MyStl::adjacent_difference(first, last, result, minus_op());
+}
+
+} // namespace MyStl
+
+#endif
@@ -0,0 +1,1096 @@
+#ifndef MYSTL_PARALLEL_ALGO_H_
+#define MYSTL_PARALLEL_ALGO_H_
+
+// 这个头文件包含 MyStl 算法接受执行策略的并行版本
+//
+// notes:
+//
+// 用法与顺序版本相同，只是多了第一个参数 MyStl::execution::seq / par / par_unseq
+// 只有策略允许并行、迭代器为随机访问迭代器且区间足够大时才会分块交给 thread_pool，否则退化为顺序版本
+// 每块内部调用顺序版本，因此指针区间上的 SIMD 快速路径在块内依然有效
+// 查找类算法记录已找到的最小下标，位于其后的块和子块直接跳过，实现提前取消
+// 归约类算法各块独立归约后按块的顺序合并；扫描类算法分两趟：先求各块的总和及各块之前的前缀，
+// 再以该前缀为初值并行扫描各块
+
+#include <cstddef>
+#include <atomic>
+
+#include "algo.h"
+#include "algobase.h"
+#include "execution.h"
+#include "iterator.h"
+#include "memory.h"
+#include "numeric.h"
+#include "random.h"
+#include "thread_pool.h"
+#include "util.h"
+#include "vector.h"
+
+// 每块至少包含的元素个数，小于两块的区间直接顺序执行
+#ifndef MYSTL_PAR_MIN_GRAIN
+#define MYSTL_PAR_MIN_GRAIN 4096
+#endif
+
+// 每个线程平均分到的块数，块数多于线程数以便工作窃取平衡负载
+#ifndef MYSTL_PAR_CHUNKS_PER_THREAD
+#define MYSTL_PAR_CHUNKS_PER_THREAD 8
+#endif
+
+namespace MyStl
+{
+
+/*****************************************************************************************/
+// 并行分派的辅助工具
+/*****************************************************************************************/
+// 策略允许并行且所有迭代器都是随机访问迭代器时才并行执行
+template <class ExecutionPolicy, class... Iters>
+struct is_parallel_dispatch;
+
+template <class ExecutionPolicy>
+struct is_parallel_dispatch<ExecutionPolicy>
+  : m_bool_constant<is_parallel_policy<typename std::decay<ExecutionPolicy>::type>::value>
+{
+};
+
+template <class ExecutionPolicy, class Iter, class... Iters>
+struct is_parallel_dispatch<ExecutionPolicy, Iter, Iters...>
+  : m_bool_constant<is_random_access_iterator<Iter>::value &&
+                    is_parallel_dispatch<ExecutionPolicy, Iters...>::value>
+{
+};
+
+// 按区间长度和线程数选择块大小
+inline size_t parallel_grain(size_t n)
+{
+    const size_t chunks = thread_pool::instance().concurrency() * MYSTL_PAR_CHUNKS_PER_THREAD;
+    const size_t grain = n / chunks;
+    return grain < MYSTL_PAR_MIN_GRAIN ? MYSTL_PAR_MIN_GRAIN : grain;
+}
+
+inline bool parallel_worthwhile(size_t n)
+{
+    return n >= 2 * MYSTL_PAR_MIN_GRAIN && thread_pool::instance().concurrency() > 1;
+}
+
+// 在 [0, n) 上找第一个满足 pred(i) 的下标，找不到返回 n
+// 块内按 MYSTL_PAR_MIN_GRAIN 分成子块，发现更小的下标已被找到时停止
+template <class IndexPredicate>
+size_t parallel_find_index(size_t n, IndexPredicate pred)
+{
+    std::atomic<size_t> found(n);
+    thread_pool::instance().parallel_for(n, parallel_grain(n), [&](size_t begin, size_t end)
+    {
+        for (size_t b = begin; b < end; b += MYSTL_PAR_MIN_GRAIN)
+        {
+            if (found.load(std::memory_order_relaxed) <= b)
+                return;
+            const size_t e = end - b < MYSTL_PAR_MIN_GRAIN ? end : b + MYSTL_PAR_MIN_GRAIN;
+            const size_t i = pred(b, e);
+            if (i != e)
+            {
+                auto cur = found.load(std::memory_order_relaxed);
+                while (i < cur && !found.compare_exchange_weak(cur, i, std::memory_order_relaxed))
+                {
+                }
+                return;
+            }
+        }
+    });
+    return found.load(std::memory_order_relaxed);
+}
+
+// 把 [0, n) 均分成块，每块至少 parallel_grain(n) 个元素；与 parallel_for 不同，块的边界固定，
+// 可以在多趟计算之间对应起来
+inline size_t parallel_chunk_count(size_t n)
+{
+    return n / parallel_grain(n);
+}
+
+// 第 c 块的起点，即 c * n / chunks，分开计算以免溢出
+inline size_t parallel_chunk_begin(size_t c, size_t n, size_t chunks)
+{
+    return n / chunks * c + n % chunks * c / chunks;
+}
+
+// 对每个固定的块 c = [b, e) 并行调用 f(c, b, e)
+template <class Function>
+void parallel_for_chunks(size_t n, size_t chunks, Function f)
+{
+    thread_pool::instance().parallel_for(chunks, 1, [&](size_t cb, size_t ce)
+    {
+        for (; cb != ce; ++cb)
+            f(cb, parallel_chunk_begin(cb, n, chunks), parallel_chunk_begin(cb + 1, n, chunks));
+    });
+}
+
+// 分块并行归约：chunk(b, e) 返回块 [b, e) 的归约结果（块长至少为 2），最后按块的顺序依次与 init 结合
+template <class T, class BinaryOp, class ChunkReduce>
+T parallel_reduce_chunks(size_t n, T init, BinaryOp op, ChunkReduce chunk)
+{
+    const size_t chunks = parallel_chunk_count(n);
+    MyStl::vector<T> partial(chunks, init);
+    parallel_for_chunks(n, chunks, [&](size_t c, size_t b, size_t e)
+    {
+        partial[c] = chunk(b, e);
+    });
+    for (size_t c = 0; c != chunks; ++c)
+        init = op(init, partial[c]);
+    return init;
+}
+
+// 两趟扫描的第一趟：并行求出前 chunks - 1 块各自的总和（从左到右结合），
+// 再顺序求出每块之前所有元素与 init 结合的结果，第 0 块为 init
+template <class RandomIter, class T, class BinaryOp>
+MyStl::vector<T> parallel_scan_offsets(RandomIter first, size_t n, size_t chunks, T init, BinaryOp op)
+{
+    MyStl::vector<T> offsets(chunks, init);
+    parallel_for_chunks(n, chunks, [&](size_t c, size_t b, size_t e)
+    {
+        if (c + 1 == chunks)
+            return;
+        T acc = op(first[b], first[b + 1]);
+        for (size_t i = b + 2; i != e; ++i)
+            acc = op(acc, first[i]);
+        offsets[c + 1] = MyStl::move(acc);
+    });
+    for (size_t c = 1; c != chunks; ++c)
+        offsets[c] = op(offsets[c - 1], offsets[c]);
+    return offsets;
+}
+
+/*****************************************************************************************/
+// for_each
+/*****************************************************************************************/
+template <class InputIter, class Function>
+void for_each_par(InputIter first, InputIter last, Function f, m_false_type)
+{
+    MyStl::for_each(first, last, f);
+}
+
+template <class RandomIter, class Function>
+void for_each_par(RandomIter first, RandomIter last, Function f, m_true_type)
+{
+    const size_t n = static_cast<size_t>(last - first);
+    if (!parallel_worthwhile(n))
+    {
+        MyStl::for_each(first, last, f);
+        return;
+    }
+    thread_pool::instance().parallel_for(n, parallel_grain(n), [&](size_t b, size_t e)
+    {
+        MyStl::for_each(first + b, first + e, f);
+    });
+}
+
+template <class ExecutionPolicy, class InputIter, class Function>
+enable_if_execution_policy<ExecutionPolicy, void>
+for_each(ExecutionPolicy&&, InputIter first, InputIter last, Function f)
+{
+    MyStl::for_each_par(first, last, f, is_parallel_dispatch<ExecutionPolicy, InputIter>{});
+}
+
+/*****************************************************************************************/
+// count / count_if
+/*****************************************************************************************/
+template <class InputIter, class T>
+size_t count_par(InputIter first, InputIter last, const T &value, m_false_type)
+{
+    return MyStl::count(first, last, value);
+}
+
+template <class RandomIter, class T>
+size_t count_par(RandomIter first, RandomIter last, const T &value, m_true_type)
+{
+    const size_t n = static_cast<size_t>(last - first);
+    if (!parallel_worthwhile(n))
+        return MyStl::count(first, last, value);
+    std::atomic<size_t> total(0);
+    thread_pool::instance().parallel_for(n, parallel_grain(n), [&](size_t b, size_t e)
+    {
+        total.fetch_add(MyStl::count(first + b, first + e, value), std::memory_order_relaxed);
+    });
+    return total.load(std::memory_order_relaxed);
+}
+
+template <class ExecutionPolicy, class InputIter, class T>
+enable_if_execution_policy<ExecutionPolicy, size_t>
+count(ExecutionPolicy&&, InputIter first, InputIter last, const T &value)
+{
+    return MyStl::count_par(first, last, value, is_parallel_dispatch<ExecutionPolicy, InputIter>{});
+}
+
+template <class InputIter, class T, class UnaryPredicate>
+size_t count_if_par(InputIter first, InputIter last, const T &value, UnaryPredicate unary_pred, m_false_type)
+{
+    return MyStl::count_if(first, last, value, unary_pred);
+}
+
+template <class RandomIter, class T, class UnaryPredicate>
+size_t count_if_par(RandomIter first, RandomIter last, const T &value, UnaryPredicate unary_pred, m_true_type)
+{
+    const size_t n = static_cast<size_t>(last - first);
+    if (!parallel_worthwhile(n))
+        return MyStl::count_if(first, last, value, unary_pred);
+    std::atomic<size_t> total(0);
+    thread_pool::instance().parallel_for(n, parallel_grain(n), [&](size_t b, size_t e)
+    {
+        total.fetch_add(MyStl::count_if(first + b, first + e, value, unary_pred), std::memory_order_relaxed);
+    });
+    return total.load(std::memory_order_relaxed);
+}
+
+template <class ExecutionPolicy, class InputIter, class T, class UnaryPredicate>
+enable_if_execution_policy<ExecutionPolicy, size_t>
+count_if(ExecutionPolicy&&, InputIter first, InputIter last, const T &value, UnaryPredicate unary_pred)
+{
+    return MyStl::count_if_par(first, last, value, unary_pred,
+                               is_parallel_dispatch<ExecutionPolicy, InputIter>{});
+}
+
+/*****************************************************************************************/
+// find / find_if
+/*****************************************************************************************/
+template <class InputIter, class T>
+InputIter find_par(InputIter first, InputIter last, const T &value, m_false_type)
+{
+    return MyStl::find(first, last, value);
+}
+
+template <class RandomIter, class T>
+RandomIter find_par(RandomIter first, RandomIter last, const T &value, m_true_type)
+{
+    const size_t n = static_cast<size_t>(last - first);
+    if (!parallel_worthwhile(n))
+        return MyStl::find(first, last, value);
+    return first + parallel_find_index(n, [&](size_t b, size_t e)
+    {
+        return static_cast<size_t>(MyStl::find(first + b, first + e, value) - first);
+    });
+}
+
+template <class ExecutionPolicy, class InputIter, class T>
+enable_if_execution_policy<ExecutionPolicy, InputIter>
+find(ExecutionPolicy&&, InputIter first, InputIter last, const T &value)
+{
+    return MyStl::find_par(first, last, value, is_parallel_dispatch<ExecutionPolicy, InputIter>{});
+}
+
+template <class InputIter, class T, class UnaryPredicate>
+InputIter find_if_par(InputIter first, InputIter last, const T &value, UnaryPredicate unary_pred, m_false_type)
+{
+    return MyStl::find_if(first, last, value, unary_pred);
+}
+
+template <class RandomIter, class T, class UnaryPredicate>
+RandomIter find_if_par(RandomIter first, RandomIter last, const T &value, UnaryPredicate unary_pred, m_true_type)
+{
+    const size_t n = static_cast<size_t>(last - first);
+    if (!parallel_worthwhile(n))
+        return MyStl::find_if(first, last, value, unary_pred);
+    return first + parallel_find_index(n, [&](size_t b, size_t e)
+    {
+        return static_cast<size_t>(MyStl::find_if(first + b, first + e, value, unary_pred) - first);
+    });
+}
+
+template <class ExecutionPolicy, class InputIter, class T, class UnaryPredicate>
+enable_if_execution_policy<ExecutionPolicy, InputIter>
+find_if(ExecutionPolicy&&, InputIter first, InputIter last, const T &value, UnaryPredicate unary_pred)
+{
+    return MyStl::find_if_par(first, last, value, unary_pred,
+                              is_parallel_dispatch<ExecutionPolicy, InputIter>{});
+}
+
+/*****************************************************************************************/
+// all_of / any_of / none_of
+// 都归结为查找第一个满足（或不满足）条件的元素
+/*****************************************************************************************/
+template <class InputIter, class UnaryPredicate>
+bool any_of_par(InputIter first, InputIter last, UnaryPredicate unary_pred, bool expect, m_false_type)
+{
+    for (; first != last; ++first)
+    {
+        if (static_cast<bool>(unary_pred(*first)) == expect)
+            return true;
+    }
+    return false;
+}
+
+template <class RandomIter, class UnaryPredicate>
+bool any_of_par(RandomIter first, RandomIter last, UnaryPredicate unary_pred, bool expect, m_true_type)
+{
+    const size_t n = static_cast<size_t>(last - first);
+    if (!parallel_worthwhile(n))
+        return MyStl::any_of_par(first, last, unary_pred, expect, m_false_type{});
+    return parallel_find_index(n, [&](size_t b, size_t e)
+    {
+        for (; b != e; ++b)
+        {
+            if (static_cast<bool>(unary_pred(first[b])) == expect)
+                break;
+        }
+        return b;
+    }) != n;
+}
+
+template <class ExecutionPolicy, class InputIter, class UnaryPredicate>
+enable_if_execution_policy<ExecutionPolicy, bool>
+all_of(ExecutionPolicy&&, InputIter first, InputIter last, UnaryPredicate unary_pred)
+{
+    return !MyStl::any_of_par(first, last, unary_pred, false,
+                              is_parallel_dispatch<ExecutionPolicy, InputIter>{});
+}
+
+template <class ExecutionPolicy, class InputIter, class UnaryPredicate>
+enable_if_execution_policy<ExecutionPolicy, bool>
+any_of(ExecutionPolicy&&, InputIter first, InputIter last, UnaryPredicate unary_pred)
+{
+    return MyStl::any_of_par(first, last, unary_pred, true,
+                             is_parallel_dispatch<ExecutionPolicy, InputIter>{});
+}
+
+template <class ExecutionPolicy, class InputIter, class UnaryPredicate>
+enable_if_execution_policy<ExecutionPolicy, bool>
+none_of(ExecutionPolicy&&, InputIter first, InputIter last, UnaryPredicate unary_pred)
+{
+    return !MyStl::any_of_par(first, last, unary_pred, true,
+                              is_parallel_dispatch<ExecutionPolicy, InputIter>{});
+}
+
+/*****************************************************************************************/
+// fill
+/*****************************************************************************************/
+template <class ForwardIter, class T>
+void fill_par(ForwardIter first, ForwardIter last, const T &value, m_false_type)
+{
+    MyStl::fill(first, last, value);
+}
+
+template <class RandomIter, class T>
+void fill_par(RandomIter first, RandomIter last, const T &value, m_true_type)
+{
+    const size_t n = static_cast<size_t>(last - first);
+    if (!parallel_worthwhile(n))
+    {
+        MyStl::fill(first, last, value);
+        return;
+    }
+    thread_pool::instance().parallel_for(n, parallel_grain(n), [&](size_t b, size_t e)
+    {
+        MyStl::fill_n(first + b, e - b, value);
+    });
+}
+
+template <class ExecutionPolicy, class ForwardIter, class T>
+enable_if_execution_policy<ExecutionPolicy, void>
+fill(ExecutionPolicy&&, ForwardIter first, ForwardIter last, const T &value)
+{
+    MyStl::fill_par(first, last, value, is_parallel_dispatch<ExecutionPolicy, ForwardIter>{});
+}
+
+/*****************************************************************************************/
+// copy
+/*****************************************************************************************/
+template <class InputIter, class OutputIter>
+OutputIter copy_par(InputIter first, InputIter last, OutputIter result, m_false_type)
+{
+    return MyStl::copy(first, last, result);
+}
+
+template <class RandomIter1, class RandomIter2>
+RandomIter2 copy_par(RandomIter1 first, RandomIter1 last, RandomIter2 result, m_true_type)
+{
+    const size_t n = static_cast<size_t>(last - first);
+    if (!parallel_worthwhile(n))
+        return MyStl::copy(first, last, result);
+    thread_pool::instance().parallel_for(n, parallel_grain(n), [&](size_t b, size_t e)
+    {
+        MyStl::copy(first + b, first + e, result + b);
+    });
+    return result + n;
+}
+
+template <class ExecutionPolicy, class InputIter, class OutputIter>
+enable_if_execution_policy<ExecutionPolicy, OutputIter>
+copy(ExecutionPolicy&&, InputIter first, InputIter last, OutputIter result)
+{
+    return MyStl::copy_par(first, last, result,
+                           is_parallel_dispatch<ExecutionPolicy, InputIter, OutputIter>{});
+}
+
+/*****************************************************************************************/
+// transform
+/*****************************************************************************************/
+template <class InputIter, class OutputIter, class UnaryOperation>
+OutputIter transform_par(InputIter first, InputIter last, OutputIter result,
+                         UnaryOperation unary_op, m_false_type)
+{
+    return MyStl::transform(first, last, result, unary_op);
+}
+
+template <class RandomIter1, class RandomIter2, class UnaryOperation>
+RandomIter2 transform_par(RandomIter1 first, RandomIter1 last, RandomIter2 result,
+                          UnaryOperation unary_op, m_true_type)
+{
+    const size_t n = static_cast<size_t>(last - first);
+    if (!parallel_worthwhile(n))
+        return MyStl::transform(first, last, result, unary_op);
+    thread_pool::instance().parallel_for(n, parallel_grain(n), [&](size_t b, size_t e)
+    {
+        MyStl::transform(first + b, first + e, result + b, unary_op);
+    });
+    return result + n;
+}
+
+template <class ExecutionPolicy, class InputIter, class OutputIter, class UnaryOperation>
+enable_if_execution_policy<ExecutionPolicy, OutputIter>
+transform(ExecutionPolicy&&, InputIter first, InputIter last, OutputIter result, UnaryOperation unary_op)
+{
+    return MyStl::transform_par(first, last, result, unary_op,
+                                is_parallel_dispatch<ExecutionPolicy, InputIter, OutputIter>{});
+}
+
+template <class InputIter1, class InputIter2, class OutputIter, class BinaryOperation>
+OutputIter transform_par(InputIter1 first1, InputIter1 last1, InputIter2 first2,
+                         OutputIter result, BinaryOperation binary_op, m_false_type)
+{
+    return MyStl::transform(first1, last1, first2, result, binary_op);
+}
+
+template <class RandomIter1, class RandomIter2, class RandomIter3, class BinaryOperation>
+RandomIter3 transform_par(RandomIter1 first1, RandomIter1 last1, RandomIter2 first2,
+                          RandomIter3 result, BinaryOperation binary_op, m_true_type)
+{
+    const size_t n = static_cast<size_t>(last1 - first1);
+    if (!parallel_worthwhile(n))
+        return MyStl::transform(first1, last1, first2, result, binary_op);
+    thread_pool::instance().parallel_for(n, parallel_grain(n), [&](size_t b, size_t e)
+    {
+        MyStl::transform(first1 + b, first1 + e, first2 + b, result + b, binary_op);
+    });
+    return result + n;
+}
+
+template <class ExecutionPolicy, class InputIter1, class InputIter2, class OutputIter, class BinaryOperation>
+enable_if_execution_policy<ExecutionPolicy, OutputIter>
+transform(ExecutionPolicy&&, InputIter1 first1, InputIter1 last1, InputIter2 first2,
+          OutputIter result, BinaryOperation binary_op)
+{
+    return MyStl::transform_par(first1, last1, first2, result, binary_op,
+                                is_parallel_dispatch<ExecutionPolicy, InputIter1, InputIter2, OutputIter>{});
+}
+
+/*****************************************************************************************/
+// generate
+// 并行执行时 gen 会被多个线程同时调用，调用者需保证 gen 线程安全
+/*****************************************************************************************/
+template <class ForwardIter, class Generator>
+void generate_par(ForwardIter first, ForwardIter last, Generator gen, m_false_type)
+{
+    MyStl::generate(first, last, gen);
+}
+
+template <class RandomIter, class Generator>
+void generate_par(RandomIter first, RandomIter last, Generator gen, m_true_type)
+{
+    const size_t n = static_cast<size_t>(last - first);
+    if (!parallel_worthwhile(n))
+    {
+        MyStl::generate(first, last, gen);
+        return;
+    }
+    thread_pool::instance().parallel_for(n, parallel_grain(n), [&](size_t b, size_t e)
+    {
+        for (; b != e; ++b)
+            first[b] = gen();
+    });
+}
+
+template <class ExecutionPolicy, class ForwardIter, class Generator>
+enable_if_execution_policy<ExecutionPolicy, void>
+generate(ExecutionPolicy&&, ForwardIter first, ForwardIter last, Generator gen)
+{
+    MyStl::generate_par(first, last, gen, is_parallel_dispatch<ExecutionPolicy, ForwardIter>{});
+}
+
+/*****************************************************************************************/
+// is_sorted
+// 检查每一对相邻元素，发现逆序即取消其余的块
+/*****************************************************************************************/
+template <class ForwardIter, class Compared>
+bool is_sorted_par(ForwardIter first, ForwardIter last, Compared comp, m_false_type)
+{
+    return MyStl::is_sorted(first, last, comp);
+}
+
+template <class RandomIter, class Compared>
+bool is_sorted_par(RandomIter first, RandomIter last, Compared comp, m_true_type)
+{
+    const size_t n = static_cast<size_t>(last - first);
+    if (!parallel_worthwhile(n))
+        return MyStl::is_sorted(first, last, comp);
+    // 检查下标 i 与 i + 1 的相邻对，i 属于 [0, n - 1)
+    return parallel_find_index(n - 1, [&](size_t b, size_t e)
+    {
+        for (; b != e; ++b)
+        {
+            if (comp(first[b + 1], first[b]))
+                break;
+        }
+        return b;
+    }) == n - 1;
+}
+
+template <class ExecutionPolicy, class ForwardIter>
+enable_if_execution_policy<ExecutionPolicy, bool>
+is_sorted(ExecutionPolicy&&, ForwardIter first, ForwardIter last)
+{
+    return MyStl::is_sorted_par(first, last, MyStl::less<typename iterator_traits<ForwardIter>::value_type>(),
+                                is_parallel_dispatch<ExecutionPolicy, ForwardIter>{});
+}
+
+template <class ExecutionPolicy, class ForwardIter, class Compared>
+enable_if_execution_policy<ExecutionPolicy, bool>
+is_sorted(ExecutionPolicy&&, ForwardIter first, ForwardIter last, Compared comp)
+{
+    return MyStl::is_sorted_par(first, last, comp, is_parallel_dispatch<ExecutionPolicy, ForwardIter>{});
+}
+
+/*****************************************************************************************/
+// reverse
+// 把前半段的第 i 个元素与后半段对称位置的元素交换，各块互不相交
+/*****************************************************************************************/
+template <class BidirectionalIter>
+void reverse_par(BidirectionalIter first, BidirectionalIter last, m_false_type)
+{
+    MyStl::reverse(first, last);
+}
+
+template <class RandomIter>
+void reverse_par(RandomIter first, RandomIter last, m_true_type)
+{
+    const size_t n = static_cast<size_t>(last - first);
+    if (!parallel_worthwhile(n))
+    {
+        MyStl::reverse(first, last);
+        return;
+    }
+    const size_t half = n / 2;
+    thread_pool::instance().parallel_for(half, parallel_grain(half), [&](size_t b, size_t e)
+    {
+        for (; b != e; ++b)
+            MyStl::iter_swap(first + b, first + (n - 1 - b));
+    });
+}
+
+template <class ExecutionPolicy, class BidirectionalIter>
+enable_if_execution_policy<ExecutionPolicy, void>
+reverse(ExecutionPolicy&&, BidirectionalIter first, BidirectionalIter last)
+{
+    MyStl::reverse_par(first, last, is_parallel_dispatch<ExecutionPolicy, BidirectionalIter>{});
+}
+
+/*****************************************************************************************/
+// reduce
+/*****************************************************************************************/
+template <class InputIter, class T, class BinaryOp>
+T reduce_par(InputIter first, InputIter last, T init, BinaryOp op, m_false_type)
+{
+    return MyStl::reduce(first, last, init, op);
+}
+
+template <class RandomIter, class T, class BinaryOp>
+T reduce_par(RandomIter first, RandomIter last, T init, BinaryOp op, m_true_type)
+{
+    const size_t n = static_cast<size_t>(last - first);
+    if (!parallel_worthwhile(n))
+        return MyStl::reduce(first, last, init, op);
+    return parallel_reduce_chunks(n, init, op, [&](size_t b, size_t e) -> T
+    {
+        return MyStl::reduce(first + b + 2, first + e, static_cast<T>(op(first[b], first[b + 1])), op);
+    });
+}
+
+template <class ExecutionPolicy, class InputIter, class T, class BinaryOp>
+enable_if_execution_policy<ExecutionPolicy, T>
+reduce(ExecutionPolicy&&, InputIter first, InputIter last, T init, BinaryOp binary_op)
+{
+    return MyStl::reduce_par(first, last, init, binary_op, is_parallel_dispatch<ExecutionPolicy, InputIter>{});
+}
+
+template <class ExecutionPolicy, class InputIter, class T>
+enable_if_execution_policy<ExecutionPolicy, T>
+reduce(ExecutionPolicy&&, InputIter first, InputIter last, T init)
+{
+    return MyStl::reduce_par(first, last, init, plus_op(), is_parallel_dispatch<ExecutionPolicy, InputIter>{});
+}
+
+template <class ExecutionPolicy, class InputIter>
+enable_if_execution_policy<ExecutionPolicy, typename iterator_traits<InputIter>::value_type>
+reduce(ExecutionPolicy&&, InputIter first, InputIter last)
+{
+    return MyStl::reduce_par(first, last, typename iterator_traits<InputIter>::value_type{}, plus_op(),
+                             is_parallel_dispatch<ExecutionPolicy, InputIter>{});
+}
+
+/*****************************************************************************************/
+// transform_reduce
+/*****************************************************************************************/
+template <class InputIter1, class InputIter2, class T, class BinaryOp1, class BinaryOp2>
+T transform_reduce_par(InputIter1 first1, InputIter1 last1, InputIter2 first2, T init,
+                       BinaryOp1 reduce_op, BinaryOp2 transform_op, m_false_type)
+{
+    return MyStl::transform_reduce(first1, last1, first2, init, reduce_op, transform_op);
+}
+
+template <class RandomIter1, class RandomIter2, class T, class BinaryOp1, class BinaryOp2>
+T transform_reduce_par(RandomIter1 first1, RandomIter1 last1, RandomIter2 first2, T init,
+                       BinaryOp1 reduce_op, BinaryOp2 transform_op, m_true_type)
+{
+    const size_t n = static_cast<size_t>(last1 - first1);
+    if (!parallel_worthwhile(n))
+        return MyStl::transform_reduce(first1, last1, first2, init, reduce_op, transform_op);
+    return parallel_reduce_chunks(n, init, reduce_op, [&](size_t b, size_t e) -> T
+    {
+        return MyStl::transform_reduce(first1 + b + 1, first1 + e, first2 + b + 1,
+                                       static_cast<T>(transform_op(first1[b], first2[b])),
+                                       reduce_op, transform_op);
+    });
+}
+
+template <class ExecutionPolicy, class InputIter1, class InputIter2, class T, class BinaryOp1, class BinaryOp2>
+enable_if_execution_policy<ExecutionPolicy, T>
+transform_reduce(ExecutionPolicy&&, InputIter1 first1, InputIter1 last1, InputIter2 first2, T init,
+                 BinaryOp1 reduce_op, BinaryOp2 transform_op)
+{
+    return MyStl::transform_reduce_par(first1, last1, first2, init, reduce_op, transform_op,
+                                       is_parallel_dispatch<ExecutionPolicy, InputIter1, InputIter2>{});
+}
+
+template <class ExecutionPolicy, class InputIter1, class InputIter2, class T>
+enable_if_execution_policy<ExecutionPolicy, T>
+transform_reduce(ExecutionPolicy&&, InputIter1 first1, InputIter1 last1, InputIter2 first2, T init)
+{
+    return MyStl::transform_reduce_par(first1, last1, first2, init, plus_op(), multiplies_op(),
+                                       is_parallel_dispatch<ExecutionPolicy, InputIter1, InputIter2>{});
+}
+
+template <class InputIter, class T, class BinaryOp, class UnaryOp>
+T transform_reduce_par(InputIter first, InputIter last, T init,
+                       BinaryOp reduce_op, UnaryOp unary_op, m_false_type)
+{
+    return MyStl::transform_reduce(first, last, init, reduce_op, unary_op);
+}
+
+template <class RandomIter, class T, class BinaryOp, class UnaryOp>
+T transform_reduce_par(RandomIter first, RandomIter last, T init,
+                       BinaryOp reduce_op, UnaryOp unary_op, m_true_type)
+{
+    const size_t n = static_cast<size_t>(last - first);
+    if (!parallel_worthwhile(n))
+        return MyStl::transform_reduce(first, last, init, reduce_op, unary_op);
+    return parallel_reduce_chunks(n, init, reduce_op, [&](size_t b, size_t e) -> T
+    {
+        return MyStl::transform_reduce(first + b + 1, first + e, static_cast<T>(unary_op(first[b])),
+                                       reduce_op, unary_op);
+    });
+}
+
+template <class ExecutionPolicy, class InputIter, class T, class BinaryOp, class UnaryOp>
+enable_if_execution_policy<ExecutionPolicy, T>
+transform_reduce(ExecutionPolicy&&, InputIter first, InputIter last, T init,
+                 BinaryOp reduce_op, UnaryOp unary_op)
+{
+    return MyStl::transform_reduce_par(first, last, init, reduce_op, unary_op,
+                                       is_parallel_dispatch<ExecutionPolicy, InputIter>{});
+}
+
+/*****************************************************************************************/
+// inclusive_scan
+// 只要求 op 满足结合律，块内和块间都保持从左到右的顺序
+/*****************************************************************************************/
+template <class InputIter, class OutputIter, class BinaryOp, class T>
+OutputIter inclusive_scan_par(InputIter first, InputIter last, OutputIter result,
+                              BinaryOp op, T init, m_false_type)
+{
+    return MyStl::inclusive_scan(first, last, result, op, init);
+}
+
+template <class RandomIter1, class RandomIter2, class BinaryOp, class T>
+RandomIter2 inclusive_scan_par(RandomIter1 first, RandomIter1 last, RandomIter2 result,
+                               BinaryOp op, T init, m_true_type)
+{
+    const size_t n = static_cast<size_t>(last - first);
+    if (!parallel_worthwhile(n))
+        return MyStl::inclusive_scan(first, last, result, op, init);
+    const size_t chunks = parallel_chunk_count(n);
+    const MyStl::vector<T> offsets = MyStl::parallel_scan_offsets(first, n, chunks, init, op);
+    parallel_for_chunks(n, chunks, [&](size_t c, size_t b, size_t e)
+    {
+        MyStl::inclusive_scan(first + b, first + e, result + b, op, offsets[c]);
+    });
+    return result + n;
+}
+
+template <class ExecutionPolicy, class InputIter, class OutputIter, class BinaryOp, class T>
+enable_if_execution_policy<ExecutionPolicy, OutputIter>
+inclusive_scan(ExecutionPolicy&&, InputIter first, InputIter last, OutputIter result,
+               BinaryOp binary_op, T init)
+{
+    return MyStl::inclusive_scan_par(first, last, result, binary_op, init,
+                                     is_parallel_dispatch<ExecutionPolicy, InputIter, OutputIter>{});
+}
+
+// 没有初值时第一个元素原样输出，并作为其余元素的初值
+template <class ExecutionPolicy, class InputIter, class OutputIter, class BinaryOp>
+enable_if_execution_policy<ExecutionPolicy, OutputIter>
+inclusive_scan(ExecutionPolicy&&, InputIter first, InputIter last, OutputIter result, BinaryOp binary_op)
+{
+    if (first == last)
+        return result;
+    typename iterator_traits<InputIter>::value_type init = *first;
+    *result = init;
+    return MyStl::inclusive_scan_par(++first, last, ++result, binary_op, init,
+                                     is_parallel_dispatch<ExecutionPolicy, InputIter, OutputIter>{});
+}
+
+template <class ExecutionPolicy, class InputIter, class OutputIter>
+enable_if_execution_policy<ExecutionPolicy, OutputIter>
+inclusive_scan(ExecutionPolicy&& policy, InputIter first, InputIter last, OutputIter result)
+{
+    return MyStl::inclusive_scan(policy, first, last, result, plus_op());
+}
+
+/*****************************************************************************************/
+// exclusive_scan
+/*****************************************************************************************/
+template <class InputIter, class OutputIter, class T, class BinaryOp>
+OutputIter exclusive_scan_par(InputIter first, InputIter last, OutputIter result,
+                              T init, BinaryOp op, m_false_type)
+{
+    return MyStl::exclusive_scan(first, last, result, init, op);
+}
+
+template <class RandomIter1, class RandomIter2, class T, class BinaryOp>
+RandomIter2 exclusive_scan_par(RandomIter1 first, RandomIter1 last, RandomIter2 result,
+                               T init, BinaryOp op, m_true_type)
+{
+    const size_t n = static_cast<size_t>(last - first);
+    if (!parallel_worthwhile(n))
+        return MyStl::exclusive_scan(first, last, result, init, op);
+    const size_t chunks = parallel_chunk_count(n);
+    const MyStl::vector<T> offsets = MyStl::parallel_scan_offsets(first, n, chunks, init, op);
+    parallel_for_chunks(n, chunks, [&](size_t c, size_t b, size_t e)
+    {
+        MyStl::exclusive_scan(first + b, first + e, result + b, offsets[c], op);
+    });
+    return result + n;
+}
+
+template <class ExecutionPolicy, class InputIter, class OutputIter, class T, class BinaryOp>
+enable_if_execution_policy<ExecutionPolicy, OutputIter>
+exclusive_scan(ExecutionPolicy&&, InputIter first, InputIter last, OutputIter result,
+               T init, BinaryOp binary_op)
+{
+    return MyStl::exclusive_scan_par(first, last, result, init, binary_op,
+                                     is_parallel_dispatch<ExecutionPolicy, InputIter, OutputIter>{});
+}
+
+template <class ExecutionPolicy, class InputIter, class OutputIter, class T>
+enable_if_execution_policy<ExecutionPolicy, OutputIter>
+exclusive_scan(ExecutionPolicy&&, InputIter first, InputIter last, OutputIter result, T init)
+{
+    return MyStl::exclusive_scan_par(first, last, result, init, plus_op(),
+                                     is_parallel_dispatch<ExecutionPolicy, InputIter, OutputIter>{});
+}
+
+/*****************************************************************************************/
+// copy_if / remove_if / partition_copy
+// 第一趟并行求出每个元素的谓词标志和每块满足谓词的个数，对块计数做前缀和得到每块结果的起点，
+// 第二趟各块把选中的元素直接写到最终位置；4 字节可平凡拷贝的元素用 simd::compress32 写出
+// 并行执行时谓词会被多个线程同时调用，调用者需保证谓词线程安全
+/*****************************************************************************************/
+// 求谓词标志，counts[c] 为第 c 块中谓词为真的个数
+template <class RandomIter, class UnaryPredicate>
+void parallel_flag_chunks(RandomIter first, size_t n, size_t chunks, UnaryPredicate &unary_pred,
+                          unsigned char *flags, size_t *counts)
+{
+    parallel_for_chunks(n, chunks, [&](size_t c, size_t b, size_t e)
+    {
+        size_t k = 0;
+        for (size_t i = b; i != e; ++i)
+        {
+            const unsigned char f = unary_pred(first[i]) ? 1 : 0;
+            flags[i] = f;
+            k += f;
+        }
+        counts[c] = k;
+    });
+}
+
+// 把 first[0, n) 中标志非零（select_false 为 true 时为零）的元素依次拷贝到 result
+template <class RandomIter, class OutputIter>
+void copy_flagged(RandomIter first, size_t n, const unsigned char *flags, bool select_false, OutputIter result)
+{
+    for (size_t i = 0; i != n; ++i)
+    {
+        if ((flags[i] != 0) != select_false)
+            *result++ = first[i];
+    }
+}
+
+template <class Tp, class Up>
+typename std::enable_if<is_compress32<Tp, Up>::value>::type
+copy_flagged(Tp *first, size_t n, const unsigned char *flags, bool select_false, Up *result)
+{
+    simd::compress32(result, first, flags, n, select_false);
+}
+
+// 与 copy_flagged 相同，但移动元素
+template <class RandomIter, class OutputIter>
+void move_flagged(RandomIter first, size_t n, const unsigned char *flags, bool select_false, OutputIter result)
+{
+    for (size_t i = 0; i != n; ++i)
+    {
+        if ((flags[i] != 0) != select_false)
+            *result++ = MyStl::move(first[i]);
+    }
+}
+
+template <class Tp, class Up>
+typename std::enable_if<is_compress32<Tp, Up>::value>::type
+move_flagged(Tp *first, size_t n, const unsigned char *flags, bool select_false, Up *result)
+{
+    simd::compress32(result, first, flags, n, select_false);
+}
+
+// 与 move_flagged 相同，但 result 指向未初始化的空间，元素用移动构造写出
+template <class RandomIter, class T>
+void uninitialized_move_flagged(RandomIter first, size_t n, const unsigned char *flags, bool select_false,
+                                T *result, m_false_type)
+{
+    for (size_t i = 0; i != n; ++i)
+    {
+        if ((flags[i] != 0) != select_false)
+            MyStl::construct(result++, MyStl::move(first[i]));
+    }
+}
+
+// 可平凡拷贝的元素不需要构造，直接写出
+template <class RandomIter, class T>
+void uninitialized_move_flagged(RandomIter first, size_t n, const unsigned char *flags, bool select_false,
+                                T *result, m_true_type)
+{
+    MyStl::move_flagged(first, n, flags, select_false, result);
+}
+
+// copy_if
+template <class InputIter, class OutputIter, class UnaryPredicate>
+OutputIter copy_if_par(InputIter first, InputIter last, OutputIter result,
+                       UnaryPredicate unary_pred, m_false_type)
+{
+    return MyStl::copy_if(first, last, result, unary_pred);
+}
+
+template <class RandomIter1, class RandomIter2, class UnaryPredicate>
+RandomIter2 copy_if_par(RandomIter1 first, RandomIter1 last, RandomIter2 result,
+                        UnaryPredicate unary_pred, m_true_type)
+{
+    const size_t n = static_cast<size_t>(last - first);
+    if (!parallel_worthwhile(n))
+        return MyStl::copy_if(first, last, result, unary_pred);
+    const size_t chunks = parallel_chunk_count(n);
+    MyStl::vector<unsigned char> flags(n);
+    MyStl::vector<size_t> counts(chunks);
+    MyStl::vector<size_t> offsets(chunks);
+    parallel_flag_chunks(first, n, chunks, unary_pred, flags.data(), counts.data());
+    MyStl::exclusive_scan(counts.begin(), counts.end(), offsets.begin(), size_t(0));
+    parallel_for_chunks(n, chunks, [&](size_t c, size_t b, size_t e)
+    {
+        MyStl::copy_flagged(first + b, e - b, flags.data() + b, false, result + offsets[c]);
+    });
+    return result + (offsets[chunks - 1] + counts[chunks - 1]);
+}
+
+template <class ExecutionPolicy, class InputIter, class OutputIter, class UnaryPredicate>
+enable_if_execution_policy<ExecutionPolicy, OutputIter>
+copy_if(ExecutionPolicy&&, InputIter first, InputIter last, OutputIter result, UnaryPredicate unary_pred)
+{
+    return MyStl::copy_if_par(first, last, result, unary_pred,
+                              is_parallel_dispatch<ExecutionPolicy, InputIter, OutputIter>{});
+}
+
+// remove_if
+// 保留的元素先并行移动构造到未初始化的临时缓冲区，再并行移回区间开头并销毁缓冲区中的元素
+// 缓冲区申请不足，或移动构造可能抛出异常（某一块失败时其他块已构造的元素无从回收）时，按标志顺序原地压缩
+template <class ForwardIter, class UnaryPredicate>
+ForwardIter remove_if_par(ForwardIter first, ForwardIter last, UnaryPredicate unary_pred, m_false_type)
+{
+    return MyStl::remove_if(first, last, unary_pred);
+}
+
+template <class RandomIter, class UnaryPredicate>
+RandomIter remove_if_par(RandomIter first, RandomIter last, UnaryPredicate unary_pred, m_true_type)
+{
+    typedef typename iterator_traits<RandomIter>::value_type value_type;
+    const size_t n = static_cast<size_t>(last - first);
+    if (!parallel_worthwhile(n))
+        return MyStl::remove_if(first, last, unary_pred);
+    const size_t chunks = parallel_chunk_count(n);
+    MyStl::vector<unsigned char> flags(n);
+    MyStl::vector<size_t> counts(chunks);
+    MyStl::vector<size_t> offsets(chunks);
+    parallel_flag_chunks(first, n, chunks, unary_pred, flags.data(), counts.data());
+    size_t kept = 0;
+    for (size_t c = 0; c != chunks; ++c)
+    {
+        offsets[c] = kept;
+        kept += parallel_chunk_begin(c + 1, n, chunks) - parallel_chunk_begin(c, n, chunks) - counts[c];
+    }
+    if (kept == n)
+        return last;
+    if (kept == 0)
+        return first;
+    move_buffer<value_type> buf(std::is_nothrow_move_constructible<value_type>::value
+                                ? static_cast<ptrdiff_t>(kept) : 0);
+    if (buf.size() != static_cast<ptrdiff_t>(kept))
+    {
+        MyStl::move_flagged(first, n, flags.data(), true, first);
+        return first + kept;
+    }
+    value_type *tmp = buf.begin();
+    parallel_for_chunks(n, chunks, [&](size_t c, size_t b, size_t e)
+    {
+        MyStl::uninitialized_move_flagged(first + b, e - b, flags.data() + b, true, tmp + offsets[c],
+                                          m_bool_constant<std::is_trivially_copyable<value_type>::value>{});
+    });
+    thread_pool::instance().parallel_for(kept, parallel_grain(kept), [&](size_t b, size_t e)
+    {
+        MyStl::move_out_of_buffer(tmp + b, tmp + e, first + b);
+    });
+    return first + kept;
+}
+
+template <class ExecutionPolicy, class ForwardIter, class UnaryPredicate>
+enable_if_execution_policy<ExecutionPolicy, ForwardIter>
+remove_if(ExecutionPolicy&&, ForwardIter first, ForwardIter last, UnaryPredicate unary_pred)
+{
+    return MyStl::remove_if_par(first, last, unary_pred, is_parallel_dispatch<ExecutionPolicy, ForwardIter>{});
+}
+
+// partition_copy
+template <class InputIter, class OutputIter1, class OutputIter2, class UnaryPredicate>
+MyStl::pair<OutputIter1, OutputIter2>
+partition_copy_par(InputIter first, InputIter last, OutputIter1 result_true, OutputIter2 result_false,
+                   UnaryPredicate unary_pred, m_false_type)
+{
+    return MyStl::partition_copy(first, last, result_true, result_false, unary_pred);
+}
+
+template <class RandomIter1, class RandomIter2, class RandomIter3, class UnaryPredicate>
+MyStl::pair<RandomIter2, RandomIter3>
+partition_copy_par(RandomIter1 first, RandomIter1 last, RandomIter2 result_true, RandomIter3 result_false,
+                   UnaryPredicate unary_pred, m_true_type)
+{
+    const size_t n = static_cast<size_t>(last - first);
+    if (!parallel_worthwhile(n))
+        return MyStl::partition_copy(first, last, result_true, result_false, unary_pred);
+    const size_t chunks = parallel_chunk_count(n);
+    MyStl::vector<unsigned char> flags(n);
+    MyStl::vector<size_t> counts(chunks);
+    MyStl::vector<size_t> true_offsets(chunks);
+    MyStl::vector<size_t> false_offsets(chunks);
+    parallel_flag_chunks(first, n, chunks, unary_pred, flags.data(), counts.data());
+    size_t ntrue = 0, nfalse = 0;
+    for (size_t c = 0; c != chunks; ++c)
+    {
+        true_offsets[c] = ntrue;
+        false_offsets[c] = nfalse;
+        ntrue += counts[c];
+        nfalse += parallel_chunk_begin(c + 1, n, chunks) - parallel_chunk_begin(c, n, chunks) - counts[c];
+    }
+    parallel_for_chunks(n, chunks, [&](size_t c, size_t b, size_t e)
+    {
+        MyStl::copy_flagged(first + b, e - b, flags.data() + b, false, result_true + true_offsets[c]);
+        MyStl::copy_flagged(first + b, e - b, flags.data() + b, true, result_false + false_offsets[c]);
+    });
+    return MyStl::pair<RandomIter2, RandomIter3>(result_true + ntrue, result_false + nfalse);
+}
+
+template <class ExecutionPolicy, class InputIter, class OutputIter1, class OutputIter2, class UnaryPredicate>
+enable_if_execution_policy<ExecutionPolicy, MyStl::pair<OutputIter1, OutputIter2>>
+partition_copy(ExecutionPolicy&&, InputIter first, InputIter last, OutputIter1 result_true,
+               OutputIter2 result_false, UnaryPredicate unary_pred)
+{
+    return MyStl::partition_copy_par(first, last, result_true, result_false, unary_pred,
+        is_parallel_dispatch<ExecutionPolicy, InputIter, OutputIter1, OutputIter2>{});
+}
+
+/*****************************************************************************************/
+// shuffle
+// MergeShuffle：各块用独立的生成器并行做 Fisher-Yates，再逐层用 shuffle_merge 合并相邻的两块，
+// 同一层的各次合并互不相交，可以并行；g 只用来为各块和各次合并产生种子
+// 结果同样服从均匀分布，但与用同一个 g 调用顺序版本得到的排列不同
+/*****************************************************************************************/
+template <class RandomIter, class URBG>
+void shuffle_par(RandomIter first, RandomIter last, URBG &g, m_false_type)
+{
+    MyStl::shuffle(first, last, g);
+}
+
+template <class RandomIter, class URBG>
+void shuffle_par(RandomIter first, RandomIter last, URBG &g, m_true_type)
+{
+    const size_t n = static_cast<size_t>(last - first);
+    if (!parallel_worthwhile(n))
+    {
+        MyStl::shuffle(first, last, g);
+        return;
+    }
+    const size_t chunks = parallel_chunk_count(n);
+    MyStl::vector<uint64_t> seeds(chunks);
+    for (size_t c = 0; c != chunks; ++c)
+        seeds[c] = MyStl::random_bits64(g);
+    parallel_for_chunks(n, chunks, [&](size_t c, size_t b, size_t e)
+    {
+        xoshiro256ss rng(seeds[c]);
+        MyStl::shuffle(first + b, first + e, rng);
+    });
+    // 当前第 i 块为 [bounds[i], bounds[i + 1])
+    MyStl::vector<size_t> bounds(chunks + 1);
+    for (size_t c = 0; c <= chunks; ++c)
+        bounds[c] = parallel_chunk_begin(c, n, chunks);
+    for (size_t blocks = chunks; blocks > 1;)
+    {
+        const size_t pairs = blocks / 2;
+        for (size_t p = 0; p != pairs; ++p)
+            seeds[p] = MyStl::random_bits64(g);
+        thread_pool::instance().parallel_for(pairs, 1, [&](size_t pb, size_t pe)
+        {
+            for (; pb != pe; ++pb)
+            {
+                xoshiro256ss rng(seeds[pb]);
+                const size_t b = bounds[2 * pb];
+                const size_t m = bounds[2 * pb + 1];
+                MyStl::shuffle_merge(first + b, m - b, bounds[2 * pb + 2] - m, rng);
+            }
+        });
+        // 第 p 对合并为新的第 p 块，块数为奇数时最后一块原样保留
+        const size_t next = blocks - pairs;
+        for (size_t i = 1; i < next; ++i)
+            bounds[i] = bounds[2 * i];
+        bounds[next] = n;
+        blocks = next;
+    }
+}
+
+template <class ExecutionPolicy, class RandomIter, class URBG>
+enable_if_execution_policy<ExecutionPolicy, void>
+shuffle(ExecutionPolicy&&, RandomIter first, RandomIter last, URBG &&g)
+{
+    MyStl::shuffle_par(first, last, g, is_parallel_dispatch<ExecutionPolicy, RandomIter>{});
+}
+
+} // namespace MyStl
+
+#endif
@@ -0,0 +1,391 @@
+#ifndef MYSTL_RANDOM_H_
+#define MYSTL_RANDOM_H_
+
+// 这个头文件包含伪随机数生成器和随机算法：splitmix64, xoshiro256ss, pcg32,
+// uniform_index, shuffle, shuffle_merge, sample
+
+// notes:
+//
+// 生成器都满足 UniformRandomBitGenerator 的要求，可以与 <random> 中的分布一起使用，
+// 算法也接受 std::mt19937 等标准生成器
+// 有界随机整数使用 Lemire 的乘法取高位法：一次乘法得到 [0, n) 中的值，
+// 只有低位落在长度为 2^64 mod n 的拒绝区间时才需要一次取模并重新抽样，绝大多数情况下没有除法
+// 并行版本的 shuffle 位于 parallel_algo.h
+
+#include <cstddef>
+#include <cstdint>
+#include <cmath>
+#include <type_traits>
+
+#include "algobase.h"
+#include "iterator.h"
+#include "simd.h"
+#include "util.h"
+
+namespace MyStl
+{
+
+/*****************************************************************************************/
+// splitmix64
+// 每次把状态加上黄金分割常数再做一次混合，输出质量足以用来为其他生成器播种
+/*****************************************************************************************/
+class splitmix64
+{
+public:
+    typedef uint64_t result_type;
+
+    explicit splitmix64(uint64_t seed = 0) : state(seed) {}
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT64_MAX; }
+
+    result_type operator()()
+    {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+private:
+    uint64_t state;
+};
+
+/*****************************************************************************************/
+// xoshiro256ss
+// xoshiro256**（Blackman & Vigna）：256 位状态，周期 2^256 - 1，每次输出只需几次移位、异或和两次乘法
+// jump() 相当于调用 2^128 次，可以从同一个种子派生出互不重叠的子序列供多个线程使用
+/*****************************************************************************************/
+class xoshiro256ss
+{
+public:
+    typedef uint64_t result_type;
+
+    explicit xoshiro256ss(uint64_t seed = 0x853C49E6748FEA9Bull) { this->seed(seed); }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT64_MAX; }
+
+    // 用 splitmix64 把 64 位种子展开成 256 位状态，保证状态不全为零
+    void seed(uint64_t value)
+    {
+        splitmix64 sm(value);
+        for (auto &word : s)
+            word = sm();
+    }
+
+    result_type operator()()
+    {
+        const uint64_t result = rotl(s[1] * 5, 7) * 9;
+        const uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = rotl(s[3], 45);
+        return result;
+    }
+
+    void jump()
+    {
+        static const uint64_t poly[4] = { 0x180EC6D33CFD0ABAull, 0xD5A61266F0C9392Cull,
+                                          0xA9582618E03FC9AAull, 0x39ABDC4529B1661Cull };
+        uint64_t t[4] = { 0, 0, 0, 0 };
+        for (auto word : poly)
+        {
+            for (int b = 0; b < 64; ++b)
+            {
+                if (word & (static_cast<uint64_t>(1) << b))
+                {
+                    for (int i = 0; i < 4; ++i)
+                        t[i] ^= s[i];
+                }
+                (*this)();
+            }
+        }
+        for (int i = 0; i < 4; ++i)
+            s[i] = t[i];
+    }
+
+private:
+    static uint64_t rotl(uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }
+
+private:
+    uint64_t s[4];
+};
+
+/*****************************************************************************************/
+// pcg32
+// PCG-XSH-RR（O'Neill）：64 位线性同余状态，输出时对高位做异或移位和随机旋转，得到 32 位结果
+// stream 选择增量，不同 stream 的序列互相独立
+/*****************************************************************************************/
+class pcg32
+{
+public:
+    typedef uint32_t result_type;
+
+    explicit pcg32(uint64_t seed = 0x853C49E6748FEA9Bull, uint64_t stream = 0xDA3E39CB94B95BDBull)
+    {
+        this->seed(seed, stream);
+    }
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return UINT32_MAX; }
+
+    void seed(uint64_t value, uint64_t stream = 0xDA3E39CB94B95BDBull)
+    {
+        state = 0;
+        inc = (stream << 1) | 1u;
+        (*this)();
+        state += value;
+        (*this)();
+    }
+
+    result_type operator()()
+    {
+        const uint64_t old = state;
+        state = old * 6364136223846793005ull + inc;
+        const uint32_t xorshifted = static_cast<uint32_t>(((old >> 18) ^ old) >> 27);
+        const uint32_t rot = static_cast<uint32_t>(old >> 59);
+        return (xorshifted >> rot) | (xorshifted << ((0u - rot) & 31));
+    }
+
+private:
+    uint64_t state;
+    uint64_t inc;
+};
+
+/*****************************************************************************************/
+// random_bits64
+// 从任意 UniformRandomBitGenerator 取 64 个均匀的随机位
+// 输出恰为 64 位或 32 位的生成器调用一次或两次，其余的每次取 floor(log2(max - min + 1)) 位，超出的值丢弃
+/*****************************************************************************************/
+constexpr unsigned random_floor_log2(uint64_t x)
+{
+    return x <= 1 ? 0 : 1 + random_floor_log2(x >> 1);
+}
+
+template <class URBG>
+uint64_t random_bits64(URBG &g)
+{
+    typedef typename std::decay<URBG>::type generator;
+    constexpr uint64_t low = static_cast<uint64_t>(generator::min());
+    constexpr uint64_t range = static_cast<uint64_t>(generator::max()) - low;
+    if (range == UINT64_MAX)
+        return static_cast<uint64_t>(g()) - low;
+    if (range == UINT32_MAX)
+    {
+        const uint64_t hi = static_cast<uint64_t>(g()) - low;
+        return (hi << 32) | (static_cast<uint64_t>(g()) - low);
+    }
+    constexpr unsigned bits = random_floor_log2(range == UINT64_MAX ? 1 : range + 1);
+    constexpr uint64_t mask = (static_cast<uint64_t>(1) << bits) - 1;
+    uint64_t result = 0;
+    for (unsigned have = 0; have < 64;)
+    {
+        const uint64_t r = static_cast<uint64_t>(g()) - low;
+        if (r > mask)
+            continue;
+        result = (result << bits) | r;
+        have += bits;
+    }
+    return result;
+}
+
+/*****************************************************************************************/
+// uniform_index
+// 返回 [0, n) 中均匀分布的整数，n 不能为 0
+// Lemire 的方法：x 为 64 位随机数，x * n 的高 64 位即结果；低 64 位小于 2^64 mod n 时结果有偏，重新抽样
+// 先用 lo < n 这个必要条件过滤，只有极少数情况才真正计算 2^64 mod n
+/*****************************************************************************************/
+template <class URBG>
+uint64_t uniform_index(URBG &g, uint64_t n)
+{
+    typedef typename std::decay<URBG>::type generator;
+    constexpr uint64_t range = static_cast<uint64_t>(generator::max()) - static_cast<uint64_t>(generator::min());
+    if (range == UINT32_MAX && n <= UINT32_MAX)
+    {
+        // 32 位生成器配合 32 位的界，只调用一次生成器
+        const uint32_t bound = static_cast<uint32_t>(n);
+        uint64_t m = static_cast<uint64_t>(static_cast<uint32_t>(g() - generator::min())) * bound;
+        if (static_cast<uint32_t>(m) < bound)
+        {
+            const uint32_t threshold = (0u - bound) % bound;
+            while (static_cast<uint32_t>(m) < threshold)
+                m = static_cast<uint64_t>(static_cast<uint32_t>(g() - generator::min())) * bound;
+        }
+        return m >> 32;
+    }
+    uint64_t lo;
+    uint64_t hi = simd::mul_hi_lo(MyStl::random_bits64(g), n, lo);
+    if (lo < n)
+    {
+        const uint64_t threshold = (0 - n) % n;
+        while (lo < threshold)
+            hi = simd::mul_hi_lo(MyStl::random_bits64(g), n, lo);
+    }
+    return hi;
+}
+
+// (0, 1) 中均匀分布的 double，取 53 位随机数并偏移半个单位，不会得到 0 或 1
+template <class URBG>
+double uniform_open01(URBG &g)
+{
+    return (static_cast<double>(MyStl::random_bits64(g) >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+}
+
+/*****************************************************************************************/
+// shuffle
+// 将[first, last)内的元素次序随机重排（Fisher-Yates），每种排列的概率相同
+/*****************************************************************************************/
+template <class RandomIter, class URBG>
+void shuffle_dispatch(RandomIter first, RandomIter last, URBG &g)
+{
+    for (auto i = last - first - 1; i > 0; --i)
+        MyStl::iter_swap(first + i, first + static_cast<decltype(i)>(MyStl::uniform_index(g, static_cast<uint64_t>(i) + 1)));
+}
+
+// 提前抽出多少步的交换位置
+constexpr size_t shuffle_prefetch_distance = 16;
+
+// 原生指针：交换位置只取决于随机数，与数据无关，提前 shuffle_prefetch_distance 步抽出并预取，
+// 区间远大于缓存时，多次随机访存的延迟可以重叠；随机数的抽取顺序与逐步抽取相同，结果不变
+template <class Tp, class URBG>
+void shuffle_dispatch(Tp *first, Tp *last, URBG &g)
+{
+    const size_t n = static_cast<size_t>(last - first);
+    if (n < 2)
+        return;
+    constexpr size_t mask = shuffle_prefetch_distance - 1;
+    size_t pending[shuffle_prefetch_distance];
+    for (size_t k = n - 1; k > 0 && k + shuffle_prefetch_distance > n - 1; --k)
+    {
+        pending[k & mask] = static_cast<size_t>(MyStl::uniform_index(g, k + 1));
+        simd::prefetch(first + pending[k & mask]);
+    }
+    for (size_t i = n - 1; i > 0; --i)
+    {
+        const size_t j = pending[i & mask];
+        if (i > shuffle_prefetch_distance)
+        {
+            const size_t k = i - shuffle_prefetch_distance;
+            pending[k & mask] = static_cast<size_t>(MyStl::uniform_index(g, k + 1));
+            simd::prefetch(first + pending[k & mask]);
+        }
+        MyStl::swap(first[i], first[j]);
+    }
+}
+
+template <class RandomIter, class URBG>
+void shuffle(RandomIter first, RandomIter last, URBG &&g)
+{
+    MyStl::shuffle_dispatch(first, last, g);
+}
+
+/*****************************************************************************************/
+// shuffle_merge
+// MergeShuffle（Bacher, Bodini, Hollender & Lumbroso）的合并步骤：
+// [first, first + n1) 与 [first + n1, first + n1 + n2) 各自均匀随机时，合并后整个区间均匀随机
+// 每一步抛硬币决定从哪一段取下一个元素，某一段先取完后，其余元素逐个随机插入已合并的前缀
+// 硬币每次从 64 位随机数中取一位；除了收尾部分，访存都是顺序的
+/*****************************************************************************************/
+template <class RandomIter, class URBG>
+void shuffle_merge(RandomIter first, size_t n1, size_t n2, URBG &&g)
+{
+    const size_t n = n1 + n2;
+    size_t i = 0;
+    size_t j = n1;
+    uint64_t coins = 0;
+    unsigned left = 0;
+    for (;; ++i)
+    {
+        if (left == 0)
+        {
+            coins = MyStl::random_bits64(g);
+            left = 64;
+        }
+        const bool take_right = (coins & 1) != 0;
+        coins >>= 1;
+        --left;
+        if (take_right)
+        {
+            if (j == n)
+                break;
+            MyStl::iter_swap(first + i, first + j);
+            ++j;
+        }
+        else if (i == j)
+        {
+            break;
+        }
+    }
+    for (; i < n; ++i)
+        MyStl::iter_swap(first + i, first + MyStl::uniform_index(g, i + 1));
+}
+
+/*****************************************************************************************/
+// sample
+// 从[first, last)中不重复地随机选出 n 个元素（不足 n 个时全部选出）写到 out，返回输出结果的尾部
+// 前向迭代器使用选择抽样（Knuth 算法 S），保持元素的原始相对顺序；
+// 输入迭代器只能遍历一次，使用蓄水池抽样（Li 的算法 L），结果的顺序是随机的，out 须为随机访问迭代器
+/*****************************************************************************************/
+// 算法 L：蓄水池填满后，按几何分布直接算出下一个被选中的元素之前要跳过多少个，
+// 每个被选中的元素只需常数次随机数，总共 O(k (1 + log(N / k))) 次
+template <class InputIter, class RandomIter, class URBG>
+RandomIter
+sample_dispatch(InputIter first, InputIter last, RandomIter out, size_t n, URBG &g, input_iterator_tag)
+{
+    size_t k = 0;
+    for (; first != last && k < n; ++first, ++k)
+        out[k] = *first;
+    if (first == last)
+        return out + k;
+    const double inv_n = 1.0 / static_cast<double>(n);
+    double w = std::exp(std::log(MyStl::uniform_open01(g)) * inv_n);
+    for (;;)
+    {
+        const double skip = std::floor(std::log(MyStl::uniform_open01(g)) / std::log1p(-w));
+        uint64_t count = skip < 1.8e19 ? static_cast<uint64_t>(skip) : UINT64_MAX;
+        for (; count != 0 && first != last; --count)
+            ++first;
+        if (first == last)
+            break;
+        out[MyStl::uniform_index(g, n)] = *first;
+        ++first;
+        w *= std::exp(std::log(MyStl::uniform_open01(g)) * inv_n);
+    }
+    return out + n;
+}
+
+// 算法 S：还需选 k 个、还剩 rest 个时，当前元素以 k / rest 的概率被选中
+template <class ForwardIter, class OutputIter, class URBG>
+OutputIter
+sample_dispatch(ForwardIter first, ForwardIter last, OutputIter out, size_t n, URBG &g, forward_iterator_tag)
+{
+    uint64_t rest = static_cast<uint64_t>(MyStl::distance(first, last));
+    uint64_t k = n < rest ? n : rest;
+    for (; k != 0; ++first, --rest)
+    {
+        if (MyStl::uniform_index(g, rest) < k)
+        {
+            *out = *first;
+            ++out;
+            --k;
+        }
+    }
+    return out;
+}
+
+template <class InputIter, class OutputIter, class URBG>
+OutputIter
+sample(InputIter first, InputIter last, OutputIter out, size_t n, URBG &&g)
+{
+    if (n == 0)
+        return out;
+    return MyStl::sample_dispatch(first, last, out, n, g, iterator_category(first));
+}
+
+} // namespace MyStl
+
+#endif
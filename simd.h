@@ -0,0 +1,1612 @@
+#ifndef MYSTL_SIMD_H_
+#define MYSTL_SIMD_H_
+
+// 只依赖标准库、编译器内建函数和 POSIX 的 sysconf，不依赖 MyStl 的其他头文件，以便被最底层的头文件包含
+
+// notes:
+//
+// 分派规则：
+//   * x86 上 SSE2 作为基线总是可用，AVX2 在运行时检测 CPU 后启用
+//   * AVX2 内核通过 target 属性单独编译，整个程序不需要打开 -mavx2
+//   * 非 x86 平台或定义了 MYSTL_NO_SIMD 时全部退化为标量循环
+//   * 定义了 MYSTL_NO_AVX2 时即使 CPU 支持也只用 SSE2，便于在同一台机器上测试两条路径
+// 内核只处理算术类型的原生指针区间，调用者负责检查类型和值的合法性
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if !defined(MYSTL_NO_SIMD) && \
+    (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define MYSTL_SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(_MSC_VER) && !defined(__clang__) && defined(_M_X64) && !defined(MYSTL_SIMD_X86)
+#include <intrin.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define MYSTL_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define MYSTL_TARGET_AVX2
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h>
+#endif
+
+// 填充或拷贝的字节数超过最后一级缓存的大小时使用非临时存储（绕过缓存直接写内存），避免大块写入冲掉缓存
+// 缓存大小在运行时查询，查不到时取 MYSTL_NT_STORE_FALLBACK；定义 MYSTL_NT_STORE_THRESHOLD 可以固定阈值
+#ifndef MYSTL_NT_STORE_FALLBACK
+#define MYSTL_NT_STORE_FALLBACK (static_cast<size_t>(4) << 20)
+#endif
+
+// 大块拷贝时提前预取源数据的距离（字节）
+#ifndef MYSTL_PREFETCH_DISTANCE
+#define MYSTL_PREFETCH_DISTANCE 512
+#endif
+
+namespace MyStl
+{
+namespace simd
+{
+
+/*****************************************************************************************/
+// CPU 特性检测
+/*****************************************************************************************/
+inline bool detect_avx2()
+{
+#if !defined(MYSTL_SIMD_X86) || defined(MYSTL_NO_AVX2)
+    return false;
+#elif defined(__AVX2__)
+    return true;
+#elif defined(__GNUC__) || defined(__clang__)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+    __cpuid(info, 1);
+    // 需要 OSXSAVE 且操作系统保存了 YMM 寄存器
+    if ((info[2] & (1 << 27)) == 0 || (_xgetbv(0) & 0x6) != 0x6)
+        return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return false;
+#endif
+}
+
+inline bool has_avx2()
+{
+    static const bool value = detect_avx2();
+    return value;
+}
+
+/*****************************************************************************************/
+// 位操作工具
+/*****************************************************************************************/
+inline unsigned count_trailing_zeros(uint32_t mask)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#elif defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    unsigned n = 0;
+    while ((mask & 1) == 0) { mask >>= 1; ++n; }
+    return n;
+#endif
+}
+
+inline unsigned popcount(uint32_t mask)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_popcount(mask));
+#else
+    mask = mask - ((mask >> 1) & 0x55555555u);
+    mask = (mask & 0x33333333u) + ((mask >> 2) & 0x33333333u);
+    return (((mask + (mask >> 4)) & 0x0F0F0F0Fu) * 0x01010101u) >> 24;
+#endif
+}
+
+// 返回 a * b 的高 64 位，低 64 位写到 lo
+inline uint64_t mul_hi_lo(uint64_t a, uint64_t b, uint64_t &lo)
+{
+#if defined(__SIZEOF_INT128__)
+    const unsigned __int128 p = static_cast<unsigned __int128>(a) * b;
+    lo = static_cast<uint64_t>(p);
+    return static_cast<uint64_t>(p >> 64);
+#elif defined(_MSC_VER) && !defined(__clang__) && defined(_M_X64)
+    uint64_t hi;
+    lo = _umul128(a, b, &hi);
+    return hi;
+#else
+    const uint64_t a_lo = a & 0xFFFFFFFFu, a_hi = a >> 32;
+    const uint64_t b_lo = b & 0xFFFFFFFFu, b_hi = b >> 32;
+    const uint64_t p0 = a_lo * b_lo;
+    const uint64_t p1 = a_lo * b_hi;
+    const uint64_t p2 = a_hi * b_lo;
+    const uint64_t p3 = a_hi * b_hi;
+    const uint64_t mid = (p0 >> 32) + (p1 & 0xFFFFFFFFu) + (p2 & 0xFFFFFFFFu);
+    lo = (mid << 32) | (p0 & 0xFFFFFFFFu);
+    return p3 + (p1 >> 32) + (p2 >> 32) + (mid >> 32);
+#endif
+}
+
+// 最后一级缓存的字节数，查不到返回 0
+inline size_t detect_llc_size()
+{
+#if defined(_SC_LEVEL3_CACHE_SIZE) && defined(_SC_LEVEL2_CACHE_SIZE)
+    // glibc 从 CPUID 读出各级缓存大小；没有 L3 的机器上 L2 就是最后一级
+    long size = sysconf(_SC_LEVEL3_CACHE_SIZE);
+    if (size <= 0)
+        size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+    return size > 0 ? static_cast<size_t>(size) : 0;
+#else
+    return 0;
+#endif
+}
+
+// 非临时存储的阈值（字节）
+inline size_t nt_store_threshold()
+{
+#if defined(MYSTL_NT_STORE_THRESHOLD)
+    return MYSTL_NT_STORE_THRESHOLD;
+#else
+    static const size_t llc = detect_llc_size();
+    return llc != 0 ? llc : MYSTL_NT_STORE_FALLBACK;
+#endif
+}
+
+// 写入 n 字节时是否改用非临时存储
+inline bool use_nt_store(size_t n)
+{
+    return n >= nt_store_threshold();
+}
+
+// 把 p 所在的缓存行预取到各级缓存，不改变程序语义
+inline void prefetch(const void *p)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(p);
+#elif defined(MYSTL_SIMD_X86)
+    _mm_prefetch(static_cast<const char*>(p), _MM_HINT_T0);
+#else
+    (void)p;
+#endif
+}
+
+/*****************************************************************************************/
+// 标量收尾
+// 向量内核处理完整块后剩余的不足一块的部分，也是非 x86 平台的实现
+/*****************************************************************************************/
+// 把 [lo, hi) 中大小为 Size 字节的元素逆序
+template <size_t Size>
+inline void reverse_elems_scalar(unsigned char *lo, unsigned char *hi)
+{
+    unsigned char tmp[Size];
+    while (hi - lo >= static_cast<ptrdiff_t>(2 * Size))
+    {
+        hi -= Size;
+        std::memcpy(tmp, lo, Size);
+        std::memcpy(lo, hi, Size);
+        std::memcpy(hi, tmp, Size);
+        lo += Size;
+    }
+}
+
+// 交换 a[i, n) 和 b[i, n)，按 8 字节一组交换，最后逐字节
+inline void swap_bytes_scalar(unsigned char *a, unsigned char *b, size_t i, size_t n)
+{
+    for (; i + 8 <= n; i += 8)
+    {
+        uint64_t x, y;
+        std::memcpy(&x, a + i, 8);
+        std::memcpy(&y, b + i, 8);
+        std::memcpy(a + i, &y, 8);
+        std::memcpy(b + i, &x, 8);
+    }
+    for (; i < n; ++i)
+    {
+        const unsigned char t = a[i];
+        a[i] = b[i];
+        b[i] = t;
+    }
+}
+
+// 把 src[0, n) 中 flags 非零（select_zero 为 true 时为零）的 4 字节元素依次写到 dst，返回写出的个数
+// 每个元素先读出再写入，允许 dst 不在 src 之后的原地压缩
+inline size_t compress32_scalar(unsigned char *dst, const unsigned char *src, const unsigned char *flags,
+                                size_t n, bool select_zero)
+{
+    size_t w = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        if ((flags[i] != 0) != select_zero)
+        {
+            uint32_t x;
+            std::memcpy(&x, src + 4 * i, 4);
+            std::memcpy(dst + 4 * w, &x, 4);
+            ++w;
+        }
+    }
+    return w;
+}
+
+// 严格递增的 a[i, na) 与 b[j, nb) 求交，共有的元素依次写到 out，返回写出的个数
+template <class T>
+inline size_t intersect32_scalar(const T *a, size_t i, size_t na, const T *b, size_t j, size_t nb, T *out)
+{
+    size_t k = 0;
+    while (i < na && j < nb)
+    {
+        const T x = a[i];
+        const T y = b[j];
+        if (x == y)
+            out[k++] = x;
+        i += x <= y;
+        j += y <= x;
+    }
+    return k;
+}
+
+// 64 位整数的混合函数（MurmurHash3 的 fmix64）：双射，输入的每一位都会影响输出的每一位
+inline uint64_t mix64_scalar(uint64_t x)
+{
+    x ^= x >> 33;
+    x *= 0xFF51AFD7ED558CCDull;
+    x ^= x >> 33;
+    x *= 0xC4CEB9FE1A85EC53ull;
+    return x ^ (x >> 33);
+}
+
+// out[i] = mix64_scalar(src[i])，i 属于 [i, n)，src 按无符号数零扩展到 64 位
+template <class T, class U>
+inline void mix64_batch_scalar(const T *src, size_t i, size_t n, U *out)
+{
+    typedef typename std::make_unsigned<T>::type unsigned_type;
+    for (; i < n; ++i)
+        out[i] = static_cast<U>(mix64_scalar(static_cast<uint64_t>(static_cast<unsigned_type>(src[i]))));
+}
+
+// 把 stripes 个 64 字节的条带累加到 8 个 64 位累加器，第 s 个条带使用从 secret + 8 * s 开始的 64 字节密钥
+// 通道 i 的数据加到 acc[i ^ 1]，数据与密钥异或后高低 32 位之积加到 acc[i]
+inline void hash_stripes_scalar(uint64_t *acc, const unsigned char *p, size_t stripes, const unsigned char *secret)
+{
+    for (size_t s = 0; s < stripes; ++s, p += 64, secret += 8)
+    {
+        for (size_t i = 0; i < 8; ++i)
+        {
+            uint64_t data, key;
+            std::memcpy(&data, p + 8 * i, 8);
+            std::memcpy(&key, secret + 8 * i, 8);
+            const uint64_t mixed = data ^ key;
+            acc[i ^ 1] += data;
+            acc[i] += (mixed & 0xFFFFFFFFu) * (mixed >> 32);
+        }
+    }
+}
+
+/*****************************************************************************************/
+// wrap_of
+// 求和类内核使用的累加类型：整数换成对应的无符号类型，按模 2^n 回绕，改变求和顺序不会引入有符号溢出
+/*****************************************************************************************/
+template <class T, bool = std::is_integral<T>::value>
+struct wrap_of
+{
+    typedef T type;
+};
+
+template <class T>
+struct wrap_of<T, true>
+{
+    typedef typename std::make_unsigned<T>::type type;
+};
+
+// 四个独立累加器的标量求和，作为向量内核的收尾和非 x86 平台的实现
+template <class T>
+typename wrap_of<T>::type sum_scalar(const T *first, const T *last)
+{
+    typedef typename wrap_of<T>::type W;
+    W s0 = W(), s1 = W(), s2 = W(), s3 = W();
+    for (; last - first >= 4; first += 4)
+    {
+        s0 = static_cast<W>(s0 + static_cast<W>(first[0]));
+        s1 = static_cast<W>(s1 + static_cast<W>(first[1]));
+        s2 = static_cast<W>(s2 + static_cast<W>(first[2]));
+        s3 = static_cast<W>(s3 + static_cast<W>(first[3]));
+    }
+    for (; first != last; ++first)
+        s0 = static_cast<W>(s0 + static_cast<W>(*first));
+    return static_cast<W>((s0 + s1) + (s2 + s3));
+}
+
+template <class T>
+T dot_scalar(const T *a, const T *b, size_t n)
+{
+    T s0 = T(), s1 = T(), s2 = T(), s3 = T();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        s0 += a[i] * b[i];
+        s1 += a[i + 1] * b[i + 1];
+        s2 += a[i + 2] * b[i + 2];
+        s3 += a[i + 3] * b[i + 3];
+    }
+    for (; i < n; ++i)
+        s0 += a[i] * b[i];
+    return (s0 + s1) + (s2 + s3);
+}
+
+/*****************************************************************************************/
+// is_vectorizable
+// 可以按 1/2/4/8 字节通道处理的算术类型（不含 bool 和 long double）
+/*****************************************************************************************/
+template <class T>
+struct is_vectorizable
+  : std::integral_constant<bool,
+      std::is_arithmetic<T>::value &&
+      !std::is_volatile<T>::value &&
+      !std::is_same<typename std::remove_cv<T>::type, bool>::value &&
+      !std::is_same<typename std::remove_cv<T>::type, long double>::value &&
+      (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8)>
+{
+};
+
+#if defined(MYSTL_SIMD_X86)
+
+/*****************************************************************************************/
+// lanes
+// 按元素宽度和是否为浮点数选择比较指令，比较结果统一为逐字节掩码
+// 整数按位比较；浮点数使用 IEEE 相等，与 operator== 语义一致（NaN 不等于自身，+0 等于 -0）
+/*****************************************************************************************/
+template <size_t Size, bool Float>
+struct lanes;
+
+template <>
+struct lanes<1, false>
+{
+    template <class T> static __m128i set1(T v) { return _mm_set1_epi8(static_cast<char>(v)); }
+    static __m128i eq(__m128i a, __m128i b) { return _mm_cmpeq_epi8(a, b); }
+    template <class T> MYSTL_TARGET_AVX2 static __m256i set1_256(T v) { return _mm256_set1_epi8(static_cast<char>(v)); }
+    MYSTL_TARGET_AVX2 static __m256i eq256(__m256i a, __m256i b) { return _mm256_cmpeq_epi8(a, b); }
+};
+
+template <>
+struct lanes<2, false>
+{
+    template <class T> static __m128i set1(T v) { return _mm_set1_epi16(static_cast<short>(v)); }
+    static __m128i eq(__m128i a, __m128i b) { return _mm_cmpeq_epi16(a, b); }
+    template <class T> MYSTL_TARGET_AVX2 static __m256i set1_256(T v) { return _mm256_set1_epi16(static_cast<short>(v)); }
+    MYSTL_TARGET_AVX2 static __m256i eq256(__m256i a, __m256i b) { return _mm256_cmpeq_epi16(a, b); }
+};
+
+template <>
+struct lanes<4, false>
+{
+    template <class T> static __m128i set1(T v) { return _mm_set1_epi32(static_cast<int>(v)); }
+    static __m128i eq(__m128i a, __m128i b) { return _mm_cmpeq_epi32(a, b); }
+    template <class T> MYSTL_TARGET_AVX2 static __m256i set1_256(T v) { return _mm256_set1_epi32(static_cast<int>(v)); }
+    MYSTL_TARGET_AVX2 static __m256i eq256(__m256i a, __m256i b) { return _mm256_cmpeq_epi32(a, b); }
+};
+
+template <>
+struct lanes<8, false>
+{
+    template <class T> static __m128i set1(T v) { return _mm_set1_epi64x(static_cast<long long>(v)); }
+    static __m128i eq(__m128i a, __m128i b)
+    {
+        // SSE2 没有 64 位比较：两半 32 位都相等才算相等
+        __m128i e = _mm_cmpeq_epi32(a, b);
+        return _mm_and_si128(e, _mm_shuffle_epi32(e, _MM_SHUFFLE(2, 3, 0, 1)));
+    }
+    template <class T> MYSTL_TARGET_AVX2 static __m256i set1_256(T v) { return _mm256_set1_epi64x(static_cast<long long>(v)); }
+    MYSTL_TARGET_AVX2 static __m256i eq256(__m256i a, __m256i b) { return _mm256_cmpeq_epi64(a, b); }
+};
+
+template <>
+struct lanes<4, true>
+{
+    template <class T> static __m128i set1(T v) { return _mm_castps_si128(_mm_set1_ps(static_cast<float>(v))); }
+    static __m128i eq(__m128i a, __m128i b)
+    {
+        return _mm_castps_si128(_mm_cmpeq_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b)));
+    }
+    template <class T> MYSTL_TARGET_AVX2 static __m256i set1_256(T v) { return _mm256_castps_si256(_mm256_set1_ps(static_cast<float>(v))); }
+    MYSTL_TARGET_AVX2 static __m256i eq256(__m256i a, __m256i b)
+    {
+        return _mm256_castps_si256(_mm256_cmp_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b), _CMP_EQ_OQ));
+    }
+};
+
+template <>
+struct lanes<8, true>
+{
+    template <class T> static __m128i set1(T v) { return _mm_castpd_si128(_mm_set1_pd(static_cast<double>(v))); }
+    static __m128i eq(__m128i a, __m128i b)
+    {
+        return _mm_castpd_si128(_mm_cmpeq_pd(_mm_castsi128_pd(a), _mm_castsi128_pd(b)));
+    }
+    template <class T> MYSTL_TARGET_AVX2 static __m256i set1_256(T v) { return _mm256_castpd_si256(_mm256_set1_pd(static_cast<double>(v))); }
+    MYSTL_TARGET_AVX2 static __m256i eq256(__m256i a, __m256i b)
+    {
+        return _mm256_castpd_si256(_mm256_cmp_pd(_mm256_castsi256_pd(a), _mm256_castsi256_pd(b), _CMP_EQ_OQ));
+    }
+};
+
+template <class T>
+struct lanes_of : lanes<sizeof(T), std::is_floating_point<T>::value> {};
+
+/*****************************************************************************************/
+// arith_lanes
+// 按元素宽度和是否为浮点数选择加法、乘法指令，寄存器统一按 __m128i / __m256i 传递
+// 整数只提供加法（SSE2 / AVX2 没有完整的逐通道整数乘法）
+/*****************************************************************************************/
+template <size_t Size, bool Float>
+struct arith_lanes;
+
+template <>
+struct arith_lanes<1, false>
+{
+    static __m128i add(__m128i a, __m128i b) { return _mm_add_epi8(a, b); }
+    MYSTL_TARGET_AVX2 static __m256i add256(__m256i a, __m256i b) { return _mm256_add_epi8(a, b); }
+};
+
+template <>
+struct arith_lanes<2, false>
+{
+    static __m128i add(__m128i a, __m128i b) { return _mm_add_epi16(a, b); }
+    MYSTL_TARGET_AVX2 static __m256i add256(__m256i a, __m256i b) { return _mm256_add_epi16(a, b); }
+};
+
+template <>
+struct arith_lanes<4, false>
+{
+    static __m128i add(__m128i a, __m128i b) { return _mm_add_epi32(a, b); }
+    MYSTL_TARGET_AVX2 static __m256i add256(__m256i a, __m256i b) { return _mm256_add_epi32(a, b); }
+};
+
+template <>
+struct arith_lanes<8, false>
+{
+    static __m128i add(__m128i a, __m128i b) { return _mm_add_epi64(a, b); }
+    MYSTL_TARGET_AVX2 static __m256i add256(__m256i a, __m256i b) { return _mm256_add_epi64(a, b); }
+};
+
+template <>
+struct arith_lanes<4, true>
+{
+    static __m128i add(__m128i a, __m128i b)
+    {
+        return _mm_castps_si128(_mm_add_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b)));
+    }
+    static __m128i mul(__m128i a, __m128i b)
+    {
+        return _mm_castps_si128(_mm_mul_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b)));
+    }
+    MYSTL_TARGET_AVX2 static __m256i add256(__m256i a, __m256i b)
+    {
+        return _mm256_castps_si256(_mm256_add_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b)));
+    }
+    MYSTL_TARGET_AVX2 static __m256i mul256(__m256i a, __m256i b)
+    {
+        return _mm256_castps_si256(_mm256_mul_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b)));
+    }
+};
+
+template <>
+struct arith_lanes<8, true>
+{
+    static __m128i add(__m128i a, __m128i b)
+    {
+        return _mm_castpd_si128(_mm_add_pd(_mm_castsi128_pd(a), _mm_castsi128_pd(b)));
+    }
+    static __m128i mul(__m128i a, __m128i b)
+    {
+        return _mm_castpd_si128(_mm_mul_pd(_mm_castsi128_pd(a), _mm_castsi128_pd(b)));
+    }
+    MYSTL_TARGET_AVX2 static __m256i add256(__m256i a, __m256i b)
+    {
+        return _mm256_castpd_si256(_mm256_add_pd(_mm256_castsi256_pd(a), _mm256_castsi256_pd(b)));
+    }
+    MYSTL_TARGET_AVX2 static __m256i mul256(__m256i a, __m256i b)
+    {
+        return _mm256_castpd_si256(_mm256_mul_pd(_mm256_castsi256_pd(a), _mm256_castsi256_pd(b)));
+    }
+};
+
+template <class T>
+struct arith_lanes_of : arith_lanes<sizeof(T), std::is_floating_point<T>::value> {};
+
+inline __m128i load128(const void *p) { return _mm_loadu_si128(static_cast<const __m128i*>(p)); }
+MYSTL_TARGET_AVX2 inline __m256i load256(const void *p) { return _mm256_loadu_si256(static_cast<const __m256i*>(p)); }
+
+/*****************************************************************************************/
+// find_eq
+// 在 [first, last) 中找第一个等于 value 的元素，每次比较 16 / 32 字节，用 movemask 定位命中
+/*****************************************************************************************/
+template <class T>
+const T* find_eq_sse2(const T *first, const T *last, T value)
+{
+    typedef lanes_of<T> L;
+    const size_t step = 16 / sizeof(T);
+    const __m128i needle = L::set1(value);
+    for (; static_cast<size_t>(last - first) >= step; first += step)
+    {
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(L::eq(load128(first), needle)));
+        if (mask != 0)
+            return first + count_trailing_zeros(mask) / sizeof(T);
+    }
+    for (; first != last; ++first)
+        if (*first == value)
+            return first;
+    return last;
+}
+
+template <class T>
+MYSTL_TARGET_AVX2 const T* find_eq_avx2(const T *first, const T *last, T value)
+{
+    typedef lanes_of<T> L;
+    const size_t step = 32 / sizeof(T);
+    const __m256i needle = L::template set1_256<T>(value);
+    // 每轮检查 64 字节，两个掩码合并后只做一次分支
+    for (; static_cast<size_t>(last - first) >= 2 * step; first += 2 * step)
+    {
+        __m256i e0 = L::eq256(load256(first), needle);
+        __m256i e1 = L::eq256(load256(first + step), needle);
+        if (!_mm256_testz_si256(_mm256_or_si256(e0, e1), _mm256_or_si256(e0, e1)))
+        {
+            uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(e0));
+            if (mask != 0)
+                return first + count_trailing_zeros(mask) / sizeof(T);
+            mask = static_cast<uint32_t>(_mm256_movemask_epi8(e1));
+            return first + step + count_trailing_zeros(mask) / sizeof(T);
+        }
+    }
+    for (; static_cast<size_t>(last - first) >= step; first += step)
+    {
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(L::eq256(load256(first), needle)));
+        if (mask != 0)
+            return first + count_trailing_zeros(mask) / sizeof(T);
+    }
+    for (; first != last; ++first)
+        if (*first == value)
+            return first;
+    return last;
+}
+
+/*****************************************************************************************/
+// adjacent_eq
+// 找第一个满足 first[i] == first[i + 1] 的位置：把错开一个元素的两次装载逐通道比较，找不到返回 last
+/*****************************************************************************************/
+template <class T>
+const T* adjacent_eq_sse2(const T *first, const T *last)
+{
+    typedef lanes_of<T> L;
+    const size_t step = 16 / sizeof(T);
+    for (; static_cast<size_t>(last - first) > step; first += step)
+    {
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(L::eq(load128(first), load128(first + 1))));
+        if (mask != 0)
+            return first + count_trailing_zeros(mask) / sizeof(T);
+    }
+    for (; static_cast<size_t>(last - first) > 1; ++first)
+        if (first[0] == first[1])
+            return first;
+    return last;
+}
+
+template <class T>
+MYSTL_TARGET_AVX2 const T* adjacent_eq_avx2(const T *first, const T *last)
+{
+    typedef lanes_of<T> L;
+    const size_t step = 32 / sizeof(T);
+    for (; static_cast<size_t>(last - first) > step; first += step)
+    {
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(L::eq256(load256(first), load256(first + 1))));
+        if (mask != 0)
+            return first + count_trailing_zeros(mask) / sizeof(T);
+    }
+    for (; static_cast<size_t>(last - first) > 1; ++first)
+        if (first[0] == first[1])
+            return first;
+    return last;
+}
+
+/*****************************************************************************************/
+// count_eq
+// 统计 [first, last) 中等于 value 的元素个数：逐字节掩码的 popcount 之和除以元素宽度
+/*****************************************************************************************/
+template <class T>
+size_t count_eq_sse2(const T *first, const T *last, T value)
+{
+    typedef lanes_of<T> L;
+    const size_t step = 16 / sizeof(T);
+    const __m128i needle = L::set1(value);
+    size_t bits = 0;
+    for (; static_cast<size_t>(last - first) >= step; first += step)
+        bits += popcount(static_cast<uint32_t>(_mm_movemask_epi8(L::eq(load128(first), needle))));
+    size_t n = bits / sizeof(T);
+    for (; first != last; ++first)
+        if (*first == value)
+            ++n;
+    return n;
+}
+
+template <class T>
+MYSTL_TARGET_AVX2 size_t count_eq_avx2(const T *first, const T *last, T value)
+{
+    typedef lanes_of<T> L;
+    const size_t step = 32 / sizeof(T);
+    const __m256i needle = L::template set1_256<T>(value);
+    size_t bits = 0;
+    for (; static_cast<size_t>(last - first) >= step; first += step)
+        bits += popcount(static_cast<uint32_t>(_mm256_movemask_epi8(L::eq256(load256(first), needle))));
+    size_t n = bits / sizeof(T);
+    for (; first != last; ++first)
+        if (*first == value)
+            ++n;
+    return n;
+}
+
+/*****************************************************************************************/
+// mismatch_bytes
+// 返回 a、b 两段内存第一个不同字节的下标，完全相同返回 n
+/*****************************************************************************************/
+inline size_t mismatch_bytes_sse2(const unsigned char *a, const unsigned char *b, size_t n)
+{
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(load128(a + i), load128(b + i))));
+        if (mask != 0xFFFFu)
+            return i + count_trailing_zeros(~mask);
+    }
+    for (; i < n; ++i)
+        if (a[i] != b[i])
+            return i;
+    return n;
+}
+
+MYSTL_TARGET_AVX2 inline size_t mismatch_bytes_avx2(const unsigned char *a, const unsigned char *b, size_t n)
+{
+    size_t i = 0;
+    // 每轮比较 64 字节，两个比较结果相与后只做一次分支
+    for (; i + 64 <= n; i += 64)
+    {
+        __m256i e0 = _mm256_cmpeq_epi8(load256(a + i), load256(b + i));
+        __m256i e1 = _mm256_cmpeq_epi8(load256(a + i + 32), load256(b + i + 32));
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(e0, e1)));
+        if (mask != 0xFFFFFFFFu)
+        {
+            mask = static_cast<uint32_t>(_mm256_movemask_epi8(e0));
+            if (mask != 0xFFFFFFFFu)
+                return i + count_trailing_zeros(~mask);
+            mask = static_cast<uint32_t>(_mm256_movemask_epi8(e1));
+            return i + 32 + count_trailing_zeros(~mask);
+        }
+    }
+    for (; i + 32 <= n; i += 32)
+    {
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(load256(a + i), load256(b + i))));
+        if (mask != 0xFFFFFFFFu)
+            return i + count_trailing_zeros(~mask);
+    }
+    return i + mismatch_bytes_sse2(a + i, b + i, n - i);
+}
+
+/*****************************************************************************************/
+// fill_pattern
+// pattern 是 64 字节的缓冲区，由长度为 pattern_size 的值重复而成，dst 第 k 个字节应为 pattern[k % pattern_size]
+// 先用一次非对齐存储写开头，然后从对齐地址开始整块写，最后用一次非对齐存储收尾
+// 对齐地址相对 dst 的偏移不一定是 pattern_size 的倍数，从 pattern 中错开相应字节装载即可保持相位
+/*****************************************************************************************/
+inline void fill_pattern_sse2(unsigned char *dst, size_t n, const unsigned char *pattern, size_t pattern_size)
+{
+    if (n < 16)
+    {
+        std::memcpy(dst, pattern, n);
+        return;
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst), load128(pattern));
+    size_t i = 16 - (reinterpret_cast<uintptr_t>(dst) & 15);
+    const __m128i v = load128(pattern + i % pattern_size);
+    if (use_nt_store(n))
+    {
+        for (; i + 16 <= n; i += 16)
+            _mm_stream_si128(reinterpret_cast<__m128i*>(dst + i), v);
+        _mm_sfence();
+    }
+    else
+    {
+        for (; i + 16 <= n; i += 16)
+            _mm_store_si128(reinterpret_cast<__m128i*>(dst + i), v);
+    }
+    if (i < n)
+    {
+        const size_t j = n - 16;
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + j), load128(pattern + j % pattern_size));
+    }
+}
+
+MYSTL_TARGET_AVX2 inline void fill_pattern_avx2(unsigned char *dst, size_t n, const unsigned char *pattern, size_t pattern_size)
+{
+    if (n < 32)
+    {
+        fill_pattern_sse2(dst, n, pattern, pattern_size);
+        return;
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), load256(pattern));
+    size_t i = 32 - (reinterpret_cast<uintptr_t>(dst) & 31);
+    const __m256i v = load256(pattern + i % pattern_size);
+    if (use_nt_store(n))
+    {
+        for (; i + 64 <= n; i += 64)
+        {
+            _mm256_stream_si256(reinterpret_cast<__m256i*>(dst + i), v);
+            _mm256_stream_si256(reinterpret_cast<__m256i*>(dst + i + 32), v);
+        }
+        for (; i + 32 <= n; i += 32)
+            _mm256_stream_si256(reinterpret_cast<__m256i*>(dst + i), v);
+        _mm_sfence();
+    }
+    else
+    {
+        for (; i + 64 <= n; i += 64)
+        {
+            _mm256_store_si256(reinterpret_cast<__m256i*>(dst + i), v);
+            _mm256_store_si256(reinterpret_cast<__m256i*>(dst + i + 32), v);
+        }
+        for (; i + 32 <= n; i += 32)
+            _mm256_store_si256(reinterpret_cast<__m256i*>(dst + i), v);
+    }
+    if (i < n)
+    {
+        const size_t j = n - 32;
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + j), load256(pattern + j % pattern_size));
+    }
+}
+
+/*****************************************************************************************/
+// stream_copy
+// 不重叠的大块拷贝：先用 memcpy 把目的地址对齐，再按 64 字节一轮预取、装载并以非临时存储写出
+/*****************************************************************************************/
+inline void stream_copy_sse2(unsigned char *dst, const unsigned char *src, size_t n)
+{
+    const size_t head = (16 - (reinterpret_cast<uintptr_t>(dst) & 15)) & 15;
+    std::memcpy(dst, src, head);
+    size_t i = head;
+    for (; i + 64 <= n; i += 64)
+    {
+        _mm_prefetch(reinterpret_cast<const char*>(src + i + MYSTL_PREFETCH_DISTANCE), _MM_HINT_NTA);
+        __m128i v0 = load128(src + i);
+        __m128i v1 = load128(src + i + 16);
+        __m128i v2 = load128(src + i + 32);
+        __m128i v3 = load128(src + i + 48);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dst + i), v0);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dst + i + 16), v1);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dst + i + 32), v2);
+        _mm_stream_si128(reinterpret_cast<__m128i*>(dst + i + 48), v3);
+    }
+    _mm_sfence();
+    std::memcpy(dst + i, src + i, n - i);
+}
+
+MYSTL_TARGET_AVX2 inline void stream_copy_avx2(unsigned char *dst, const unsigned char *src, size_t n)
+{
+    const size_t head = (32 - (reinterpret_cast<uintptr_t>(dst) & 31)) & 31;
+    std::memcpy(dst, src, head);
+    size_t i = head;
+    for (; i + 128 <= n; i += 128)
+    {
+        _mm_prefetch(reinterpret_cast<const char*>(src + i + MYSTL_PREFETCH_DISTANCE), _MM_HINT_NTA);
+        _mm_prefetch(reinterpret_cast<const char*>(src + i + MYSTL_PREFETCH_DISTANCE + 64), _MM_HINT_NTA);
+        __m256i v0 = load256(src + i);
+        __m256i v1 = load256(src + i + 32);
+        __m256i v2 = load256(src + i + 64);
+        __m256i v3 = load256(src + i + 96);
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(dst + i), v0);
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(dst + i + 32), v1);
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(dst + i + 64), v2);
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(dst + i + 96), v3);
+    }
+    _mm_sfence();
+    std::memcpy(dst + i, src + i, n - i);
+}
+
+/*****************************************************************************************/
+// search_bytes
+// 在长度为 n 的 h 中查找长度为 m（m >= 2）的 needle，返回首次出现的下标，找不到返回 n
+// 同时比较每个候选位置的首字节和尾字节，两者都命中的位置才用 memcmp 验证中间部分
+/*****************************************************************************************/
+inline size_t search_bytes_tail(const unsigned char *h, size_t n, const unsigned char *needle,
+                                size_t m, size_t i)
+{
+    for (; i + m <= n; ++i)
+    {
+        if (h[i] == needle[0] && h[i + m - 1] == needle[m - 1] &&
+            std::memcmp(h + i + 1, needle + 1, m - 2) == 0)
+            return i;
+    }
+    return n;
+}
+
+inline size_t search_bytes_sse2(const unsigned char *h, size_t n, const unsigned char *needle, size_t m)
+{
+    const __m128i first = _mm_set1_epi8(static_cast<char>(needle[0]));
+    const __m128i last = _mm_set1_epi8(static_cast<char>(needle[m - 1]));
+    size_t i = 0;
+    for (; i + m - 1 + 16 <= n; i += 16)
+    {
+        const __m128i eq_first = _mm_cmpeq_epi8(load128(h + i), first);
+        const __m128i eq_last = _mm_cmpeq_epi8(load128(h + i + m - 1), last);
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_and_si128(eq_first, eq_last)));
+        while (mask != 0)
+        {
+            const size_t pos = i + count_trailing_zeros(mask);
+            if (std::memcmp(h + pos + 1, needle + 1, m - 2) == 0)
+                return pos;
+            mask &= mask - 1;
+        }
+    }
+    return search_bytes_tail(h, n, needle, m, i);
+}
+
+MYSTL_TARGET_AVX2 inline size_t search_bytes_avx2(const unsigned char *h, size_t n, const unsigned char *needle, size_t m)
+{
+    const __m256i first = _mm256_set1_epi8(static_cast<char>(needle[0]));
+    const __m256i last = _mm256_set1_epi8(static_cast<char>(needle[m - 1]));
+    size_t i = 0;
+    for (; i + m - 1 + 32 <= n; i += 32)
+    {
+        const __m256i eq_first = _mm256_cmpeq_epi8(load256(h + i), first);
+        const __m256i eq_last = _mm256_cmpeq_epi8(load256(h + i + m - 1), last);
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(eq_first, eq_last)));
+        while (mask != 0)
+        {
+            const size_t pos = i + count_trailing_zeros(mask);
+            if (std::memcmp(h + pos + 1, needle + 1, m - 2) == 0)
+                return pos;
+            mask &= mask - 1;
+        }
+    }
+    return search_bytes_tail(h, n, needle, m, i);
+}
+
+/*****************************************************************************************/
+// reverse_elems
+// 从两端各取一个寄存器，在寄存器内把 Size 字节宽的通道逆序后交叉写回，两端向中间推进
+// SSE2 没有 pshufb，字节逆序先交换 16 位内的两个字节，再按 16 位通道逆序
+/*****************************************************************************************/
+template <size_t Size>
+struct reverse_lanes;
+
+template <>
+struct reverse_lanes<1>
+{
+    static __m128i rev(__m128i v)
+    {
+        v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+        v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+        v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+        return _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+    }
+    MYSTL_TARGET_AVX2 static __m256i rev256(__m256i v)
+    {
+        const __m256i idx = _mm256_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0,
+                                             15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1, 0);
+        return _mm256_permute4x64_epi64(_mm256_shuffle_epi8(v, idx), _MM_SHUFFLE(1, 0, 3, 2));
+    }
+};
+
+template <>
+struct reverse_lanes<2>
+{
+    static __m128i rev(__m128i v)
+    {
+        v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+        v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+        return _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+    }
+    MYSTL_TARGET_AVX2 static __m256i rev256(__m256i v)
+    {
+        const __m256i idx = _mm256_setr_epi8(14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1,
+                                             14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1);
+        return _mm256_permute4x64_epi64(_mm256_shuffle_epi8(v, idx), _MM_SHUFFLE(1, 0, 3, 2));
+    }
+};
+
+template <>
+struct reverse_lanes<4>
+{
+    static __m128i rev(__m128i v) { return _mm_shuffle_epi32(v, _MM_SHUFFLE(0, 1, 2, 3)); }
+    MYSTL_TARGET_AVX2 static __m256i rev256(__m256i v)
+    {
+        return _mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+    }
+};
+
+template <>
+struct reverse_lanes<8>
+{
+    static __m128i rev(__m128i v) { return _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)); }
+    MYSTL_TARGET_AVX2 static __m256i rev256(__m256i v)
+    {
+        return _mm256_permute4x64_epi64(v, _MM_SHUFFLE(0, 1, 2, 3));
+    }
+};
+
+template <size_t Size>
+void reverse_elems_sse2(unsigned char *lo, unsigned char *hi)
+{
+    typedef reverse_lanes<Size> R;
+    while (hi - lo >= 32)
+    {
+        hi -= 16;
+        const __m128i a = load128(lo);
+        const __m128i b = load128(hi);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(lo), R::rev(b));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(hi), R::rev(a));
+        lo += 16;
+    }
+    reverse_elems_scalar<Size>(lo, hi);
+}
+
+template <size_t Size>
+MYSTL_TARGET_AVX2 void reverse_elems_avx2(unsigned char *lo, unsigned char *hi)
+{
+    typedef reverse_lanes<Size> R;
+    while (hi - lo >= 64)
+    {
+        hi -= 32;
+        const __m256i a = load256(lo);
+        const __m256i b = load256(hi);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(lo), R::rev256(b));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(hi), R::rev256(a));
+        lo += 32;
+    }
+    reverse_elems_sse2<Size>(lo, hi);
+}
+
+/*****************************************************************************************/
+// swap_bytes
+// 交换两段不重叠的内存，每轮各装载两个寄存器再交叉写回
+/*****************************************************************************************/
+inline void swap_bytes_sse2(unsigned char *a, unsigned char *b, size_t n)
+{
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32)
+    {
+        const __m128i a0 = load128(a + i);
+        const __m128i a1 = load128(a + i + 16);
+        const __m128i b0 = load128(b + i);
+        const __m128i b1 = load128(b + i + 16);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(a + i), b0);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(a + i + 16), b1);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(b + i), a0);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(b + i + 16), a1);
+    }
+    swap_bytes_scalar(a, b, i, n);
+}
+
+MYSTL_TARGET_AVX2 inline void swap_bytes_avx2(unsigned char *a, unsigned char *b, size_t n)
+{
+    size_t i = 0;
+    for (; i + 64 <= n; i += 64)
+    {
+        const __m256i a0 = load256(a + i);
+        const __m256i a1 = load256(a + i + 32);
+        const __m256i b0 = load256(b + i);
+        const __m256i b1 = load256(b + i + 32);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(a + i), b0);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(a + i + 32), b1);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(b + i), a0);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(b + i + 32), a1);
+    }
+    swap_bytes_scalar(a, b, i, n);
+}
+
+/*****************************************************************************************/
+// reduce_sum / dot
+// 四个向量累加器交替累加以隐藏加法延迟，最后把寄存器内各通道相加，再加上标量收尾部分
+// 浮点数的求和顺序与逐个累加不同，只用于允许重新结合的 reduce / transform_reduce
+/*****************************************************************************************/
+// 把寄存器中的 Bytes / sizeof(T) 个通道按累加类型相加
+template <class T, size_t Bytes>
+typename wrap_of<T>::type sum_lanes(const void *v)
+{
+    typedef typename wrap_of<T>::type W;
+    T buf[Bytes / sizeof(T)];
+    std::memcpy(buf, v, Bytes);
+    W s = W();
+    for (size_t i = 0; i < Bytes / sizeof(T); ++i)
+        s = static_cast<W>(s + static_cast<W>(buf[i]));
+    return s;
+}
+
+template <class T>
+typename wrap_of<T>::type sum_sse2(const T *first, const T *last)
+{
+    typedef arith_lanes_of<T> A;
+    typedef typename wrap_of<T>::type W;
+    const size_t step = 16 / sizeof(T);
+    __m128i s0 = _mm_setzero_si128(), s1 = s0, s2 = s0, s3 = s0;
+    for (; static_cast<size_t>(last - first) >= 4 * step; first += 4 * step)
+    {
+        s0 = A::add(s0, load128(first));
+        s1 = A::add(s1, load128(first + step));
+        s2 = A::add(s2, load128(first + 2 * step));
+        s3 = A::add(s3, load128(first + 3 * step));
+    }
+    for (; static_cast<size_t>(last - first) >= step; first += step)
+        s0 = A::add(s0, load128(first));
+    s0 = A::add(A::add(s0, s1), A::add(s2, s3));
+    return static_cast<W>(sum_lanes<T, 16>(&s0) + sum_scalar(first, last));
+}
+
+template <class T>
+MYSTL_TARGET_AVX2 typename wrap_of<T>::type sum_avx2(const T *first, const T *last)
+{
+    typedef arith_lanes_of<T> A;
+    typedef typename wrap_of<T>::type W;
+    const size_t step = 32 / sizeof(T);
+    __m256i s0 = _mm256_setzero_si256(), s1 = s0, s2 = s0, s3 = s0;
+    for (; static_cast<size_t>(last - first) >= 4 * step; first += 4 * step)
+    {
+        s0 = A::add256(s0, load256(first));
+        s1 = A::add256(s1, load256(first + step));
+        s2 = A::add256(s2, load256(first + 2 * step));
+        s3 = A::add256(s3, load256(first + 3 * step));
+    }
+    for (; static_cast<size_t>(last - first) >= step; first += step)
+        s0 = A::add256(s0, load256(first));
+    s0 = A::add256(A::add256(s0, s1), A::add256(s2, s3));
+    return static_cast<W>(sum_lanes<T, 32>(&s0) + sum_scalar(first, last));
+}
+
+template <class T>
+T dot_sse2(const T *a, const T *b, size_t n)
+{
+    typedef arith_lanes_of<T> A;
+    const size_t step = 16 / sizeof(T);
+    __m128i s0 = _mm_setzero_si128(), s1 = s0, s2 = s0, s3 = s0;
+    size_t i = 0;
+    for (; i + 4 * step <= n; i += 4 * step)
+    {
+        s0 = A::add(s0, A::mul(load128(a + i), load128(b + i)));
+        s1 = A::add(s1, A::mul(load128(a + i + step), load128(b + i + step)));
+        s2 = A::add(s2, A::mul(load128(a + i + 2 * step), load128(b + i + 2 * step)));
+        s3 = A::add(s3, A::mul(load128(a + i + 3 * step), load128(b + i + 3 * step)));
+    }
+    for (; i + step <= n; i += step)
+        s0 = A::add(s0, A::mul(load128(a + i), load128(b + i)));
+    s0 = A::add(A::add(s0, s1), A::add(s2, s3));
+    return sum_lanes<T, 16>(&s0) + dot_scalar(a + i, b + i, n - i);
+}
+
+template <class T>
+MYSTL_TARGET_AVX2 T dot_avx2(const T *a, const T *b, size_t n)
+{
+    typedef arith_lanes_of<T> A;
+    const size_t step = 32 / sizeof(T);
+    __m256i s0 = _mm256_setzero_si256(), s1 = s0, s2 = s0, s3 = s0;
+    size_t i = 0;
+    for (; i + 4 * step <= n; i += 4 * step)
+    {
+        s0 = A::add256(s0, A::mul256(load256(a + i), load256(b + i)));
+        s1 = A::add256(s1, A::mul256(load256(a + i + step), load256(b + i + step)));
+        s2 = A::add256(s2, A::mul256(load256(a + i + 2 * step), load256(b + i + 2 * step)));
+        s3 = A::add256(s3, A::mul256(load256(a + i + 3 * step), load256(b + i + 3 * step)));
+    }
+    for (; i + step <= n; i += step)
+        s0 = A::add256(s0, A::mul256(load256(a + i), load256(b + i)));
+    s0 = A::add256(A::add256(s0, s1), A::add256(s2, s3));
+    return sum_lanes<T, 32>(&s0) + dot_scalar(a + i, b + i, n - i);
+}
+
+/*****************************************************************************************/
+// compress32
+// 每次处理 8 个 4 字节元素：把 8 个标志字节转成 8 位掩码，查表得到保留通道的下标，
+// 用 vpermd 把保留的元素移到寄存器前部，再用 vpmaskmovd 只写出前 k 个通道，不会写出界
+// SSE2 没有按变量下标重排 32 位通道的指令，只提供 AVX2 版本
+/*****************************************************************************************/
+struct compress_table
+{
+    uint64_t index[256];   // 第 m 项的第 j 个字节为掩码 m 中第 j 个置位的位置
+
+    compress_table()
+    {
+        for (unsigned m = 0; m < 256; ++m)
+        {
+            uint64_t packed = 0;
+            unsigned k = 0;
+            for (unsigned bit = 0; bit < 8; ++bit)
+                if (m & (1u << bit))
+                    packed |= static_cast<uint64_t>(bit) << (8 * k++);
+            index[m] = packed;
+        }
+    }
+};
+
+inline const compress_table& compress_indices()
+{
+    static const compress_table table;
+    return table;
+}
+
+MYSTL_TARGET_AVX2 inline size_t compress32_avx2(unsigned char *dst, const unsigned char *src,
+                                                const unsigned char *flags, size_t n, bool select_zero)
+{
+    const uint64_t *table = compress_indices().index;
+    const __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const unsigned flip = select_zero ? 0u : 0xFFu;
+    size_t w = 0;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        const __m128i f = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(flags + i));
+        const unsigned zero = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(f, _mm_setzero_si128()))) & 0xFFu;
+        const unsigned m = zero ^ flip;
+        const __m256i idx = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(table + m)));
+        const __m256i packed = _mm256_permutevar8x32_epi32(load256(src + 4 * i), idx);
+        const int k = static_cast<int>(popcount(m));
+        _mm256_maskstore_epi32(reinterpret_cast<int*>(dst + 4 * w), _mm256_cmpgt_epi32(_mm256_set1_epi32(k), lane), packed);
+        w += static_cast<size_t>(k);
+    }
+    return w + compress32_scalar(dst + 4 * w, src + 4 * i, flags + i, n - i, select_zero);
+}
+
+/*****************************************************************************************/
+// intersect32
+// 两个严格递增的 4 字节整数序列求交：各取一块（SSE2 为 4 个，AVX2 为 8 个），
+// 把 b 块循环移位逐次与 a 块比较，得到 a 块中出现在 b 块里的元素；之后最大值较小的一块前进，
+// 相等时两块一起前进。比较全部在寄存器内完成，没有依赖数据的分支
+// AVX2 版本用 compress32 的下标表把命中的元素移到前部，再用 vpmaskmovd 只写出命中的个数
+/*****************************************************************************************/
+template <class T>
+inline size_t intersect32_sse2(const T *a, size_t na, const T *b, size_t nb, T *out)
+{
+    size_t i = 0;
+    size_t j = 0;
+    size_t k = 0;
+    while (i + 4 <= na && j + 4 <= nb)
+    {
+        const __m128i va = load128(a + i);
+        __m128i vb = load128(b + j);
+        __m128i m = _mm_cmpeq_epi32(va, vb);
+        vb = _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1));
+        m = _mm_or_si128(m, _mm_cmpeq_epi32(va, vb));
+        vb = _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1));
+        m = _mm_or_si128(m, _mm_cmpeq_epi32(va, vb));
+        vb = _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1));
+        m = _mm_or_si128(m, _mm_cmpeq_epi32(va, vb));
+        for (uint32_t mask = static_cast<uint32_t>(_mm_movemask_ps(_mm_castsi128_ps(m))); mask != 0; mask &= mask - 1)
+            out[k++] = a[i + count_trailing_zeros(mask)];
+        const T amax = a[i + 3];
+        const T bmax = b[j + 3];
+        i += amax <= bmax ? 4 : 0;
+        j += bmax <= amax ? 4 : 0;
+    }
+    return k + intersect32_scalar(a, i, na, b, j, nb, out + k);
+}
+
+template <class T>
+MYSTL_TARGET_AVX2 size_t intersect32_avx2(const T *a, size_t na, const T *b, size_t nb, T *out)
+{
+    const uint64_t *table = compress_indices().index;
+    const __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i rotate = _mm256_setr_epi32(1, 2, 3, 4, 5, 6, 7, 0);
+    size_t i = 0;
+    size_t j = 0;
+    size_t k = 0;
+    while (i + 8 <= na && j + 8 <= nb)
+    {
+        const __m256i va = load256(a + i);
+        __m256i vb = load256(b + j);
+        __m256i m = _mm256_cmpeq_epi32(va, vb);
+        for (int r = 1; r < 8; ++r)
+        {
+            vb = _mm256_permutevar8x32_epi32(vb, rotate);
+            m = _mm256_or_si256(m, _mm256_cmpeq_epi32(va, vb));
+        }
+        const unsigned mask = static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(m)));
+        const __m256i idx = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(table + mask)));
+        const int hits = static_cast<int>(popcount(mask));
+        _mm256_maskstore_epi32(reinterpret_cast<int*>(out + k), _mm256_cmpgt_epi32(_mm256_set1_epi32(hits), lane),
+                               _mm256_permutevar8x32_epi32(va, idx));
+        k += static_cast<size_t>(hits);
+        const T amax = a[i + 7];
+        const T bmax = b[j + 7];
+        i += amax <= bmax ? 8 : 0;
+        j += bmax <= amax ? 8 : 0;
+    }
+    return k + intersect32_scalar(a, i, na, b, j, nb, out + k);
+}
+
+/*****************************************************************************************/
+// hash_stripes
+// 每个 64 字节的条带分成 8 个 64 位通道，寄存器内用 pmuludq 求 (数据 ^ 密钥) 高低 32 位之积，
+// 再用 pshufd 交换相邻通道的数据一起累加；结果与标量版本逐位相同
+/*****************************************************************************************/
+inline void hash_stripes_sse2(uint64_t *acc, const unsigned char *p, size_t stripes, const unsigned char *secret)
+{
+    __m128i a[4];
+    for (int k = 0; k < 4; ++k)
+        a[k] = load128(acc + 2 * k);
+    for (size_t s = 0; s < stripes; ++s, p += 64, secret += 8)
+    {
+        for (int k = 0; k < 4; ++k)
+        {
+            const __m128i data = load128(p + 16 * k);
+            const __m128i mixed = _mm_xor_si128(data, load128(secret + 16 * k));
+            const __m128i product = _mm_mul_epu32(mixed, _mm_shuffle_epi32(mixed, _MM_SHUFFLE(0, 3, 0, 1)));
+            a[k] = _mm_add_epi64(a[k], _mm_add_epi64(product, _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2))));
+        }
+    }
+    for (int k = 0; k < 4; ++k)
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(acc + 2 * k), a[k]);
+}
+
+MYSTL_TARGET_AVX2 inline void hash_stripes_avx2(uint64_t *acc, const unsigned char *p, size_t stripes,
+                                                const unsigned char *secret)
+{
+    __m256i a0 = load256(acc);
+    __m256i a1 = load256(acc + 4);
+    for (size_t s = 0; s < stripes; ++s, p += 64, secret += 8)
+    {
+        const __m256i d0 = load256(p);
+        const __m256i d1 = load256(p + 32);
+        const __m256i m0 = _mm256_xor_si256(d0, load256(secret));
+        const __m256i m1 = _mm256_xor_si256(d1, load256(secret + 32));
+        const __m256i p0 = _mm256_mul_epu32(m0, _mm256_shuffle_epi32(m0, _MM_SHUFFLE(0, 3, 0, 1)));
+        const __m256i p1 = _mm256_mul_epu32(m1, _mm256_shuffle_epi32(m1, _MM_SHUFFLE(0, 3, 0, 1)));
+        a0 = _mm256_add_epi64(a0, _mm256_add_epi64(p0, _mm256_shuffle_epi32(d0, _MM_SHUFFLE(1, 0, 3, 2))));
+        a1 = _mm256_add_epi64(a1, _mm256_add_epi64(p1, _mm256_shuffle_epi32(d1, _MM_SHUFFLE(1, 0, 3, 2))));
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc), a0);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(acc + 4), a1);
+}
+
+/*****************************************************************************************/
+// mix64_batch
+// 每次对 4 个 64 位通道做 fmix64；AVX2 没有 64 位乘法，乘以常数拆成三次 32 x 32 -> 64 位乘法
+// 4 字节的输入用 vpmovzxdq 零扩展。SSE2 每次只有 2 个通道，不比标量的 imul 快，只提供 AVX2 版本
+/*****************************************************************************************/
+// x * c 的低 64 位
+MYSTL_TARGET_AVX2 inline __m256i mul64_avx2(__m256i x, uint64_t c)
+{
+    const __m256i c_lo = _mm256_set1_epi64x(static_cast<long long>(c & 0xFFFFFFFFu));
+    const __m256i c_hi = _mm256_set1_epi64x(static_cast<long long>(c >> 32));
+    const __m256i cross = _mm256_add_epi64(_mm256_mul_epu32(x, c_hi),
+                                           _mm256_mul_epu32(_mm256_srli_epi64(x, 32), c_lo));
+    return _mm256_add_epi64(_mm256_mul_epu32(x, c_lo), _mm256_slli_epi64(cross, 32));
+}
+
+MYSTL_TARGET_AVX2 inline __m256i mix64_avx2(__m256i x)
+{
+    x = _mm256_xor_si256(x, _mm256_srli_epi64(x, 33));
+    x = mul64_avx2(x, 0xFF51AFD7ED558CCDull);
+    x = _mm256_xor_si256(x, _mm256_srli_epi64(x, 33));
+    x = mul64_avx2(x, 0xC4CEB9FE1A85EC53ull);
+    return _mm256_xor_si256(x, _mm256_srli_epi64(x, 33));
+}
+
+// 装载 4 个 Size 字节的整数并零扩展为 64 位
+template <size_t Size>
+struct mix64_load;
+
+template <>
+struct mix64_load<4>
+{
+    MYSTL_TARGET_AVX2 static __m256i load(const void *p) { return _mm256_cvtepu32_epi64(load128(p)); }
+};
+
+template <>
+struct mix64_load<8>
+{
+    MYSTL_TARGET_AVX2 static __m256i load(const void *p) { return load256(p); }
+};
+
+template <class T, class U>
+MYSTL_TARGET_AVX2 inline void mix64_batch_avx2(const T *src, size_t n, U *out)
+{
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+    {
+        const __m256i h0 = mix64_avx2(mix64_load<sizeof(T)>::load(src + i));
+        const __m256i h1 = mix64_avx2(mix64_load<sizeof(T)>::load(src + i + 4));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), h0);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i + 4), h1);
+    }
+    mix64_batch_scalar(src, i, n, out);
+}
+
+#endif // MYSTL_SIMD_X86
+
+/*****************************************************************************************/
+// 对外接口：按 CPU 特性选择内核
+/*****************************************************************************************/
+template <class T>
+const T* find_eq(const T *first, const T *last, T value)
+{
+    static_assert(is_vectorizable<T>::value, "find_eq requires an arithmetic lane type");
+#if defined(MYSTL_SIMD_X86)
+    if (has_avx2())
+        return find_eq_avx2(first, last, value);
+    return find_eq_sse2(first, last, value);
+#else
+    for (; first != last; ++first)
+        if (*first == value)
+            return first;
+    return last;
+#endif
+}
+
+template <class T>
+const T* adjacent_eq(const T *first, const T *last)
+{
+    static_assert(is_vectorizable<T>::value, "adjacent_eq requires an arithmetic lane type");
+#if defined(MYSTL_SIMD_X86)
+    if (has_avx2())
+        return adjacent_eq_avx2(first, last);
+    return adjacent_eq_sse2(first, last);
+#else
+    for (; last - first > 1; ++first)
+        if (first[0] == first[1])
+            return first;
+    return last;
+#endif
+}
+
+template <class T>
+size_t count_eq(const T *first, const T *last, T value)
+{
+    static_assert(is_vectorizable<T>::value, "count_eq requires an arithmetic lane type");
+#if defined(MYSTL_SIMD_X86)
+    if (has_avx2())
+        return count_eq_avx2(first, last, value);
+    return count_eq_sse2(first, last, value);
+#else
+    size_t n = 0;
+    for (; first != last; ++first)
+        if (*first == value)
+            ++n;
+    return n;
+#endif
+}
+
+inline size_t mismatch_bytes(const void *a, const void *b, size_t n)
+{
+    auto pa = static_cast<const unsigned char*>(a);
+    auto pb = static_cast<const unsigned char*>(b);
+#if defined(MYSTL_SIMD_X86)
+    if (has_avx2())
+        return mismatch_bytes_avx2(pa, pb, n);
+    return mismatch_bytes_sse2(pa, pb, n);
+#else
+    size_t i = 0;
+    for (; i < n; ++i)
+        if (pa[i] != pb[i])
+            break;
+    return i;
+#endif
+}
+
+// 把 value 指向的 value_size 字节（1/2/4/8/16）在 dst 处连续写 count 份
+inline void fill_pattern(void *dst, const void *value, size_t value_size, size_t count)
+{
+    unsigned char pattern[64];
+    for (size_t k = 0; k < sizeof(pattern); k += value_size)
+        std::memcpy(pattern + k, value, value_size);
+    auto p = static_cast<unsigned char*>(dst);
+    const size_t n = count * value_size;
+#if defined(MYSTL_SIMD_X86)
+    if (has_avx2())
+        fill_pattern_avx2(p, n, pattern, value_size);
+    else
+        fill_pattern_sse2(p, n, pattern, value_size);
+#else
+    // 已写好的前缀成倍复制，log(n) 次 memcpy 完成
+    size_t filled = n < sizeof(pattern) ? n : sizeof(pattern);
+    std::memcpy(p, pattern, filled);
+    while (filled < n)
+    {
+        const size_t len = filled < n - filled ? filled : n - filled;
+        std::memcpy(p + filled, p, len);
+        filled += len;
+    }
+#endif
+}
+
+// 按大小选择拷贝方式：小块或区间重叠时交给 memmove，
+// 超过 nt_store_threshold() 且不重叠时使用带预取的非临时存储，不污染缓存
+inline void copy_bytes(void *dst, const void *src, size_t n)
+{
+#if defined(MYSTL_SIMD_X86)
+    auto d = static_cast<unsigned char*>(dst);
+    auto s = static_cast<const unsigned char*>(src);
+    const auto di = reinterpret_cast<uintptr_t>(d);
+    const auto si = reinterpret_cast<uintptr_t>(s);
+    const bool overlap = di < si + n && si < di + n;
+    if (!overlap && use_nt_store(n))
+    {
+        if (has_avx2())
+            stream_copy_avx2(d, s, n);
+        else
+            stream_copy_sse2(d, s, n);
+        return;
+    }
+#endif
+    if (n != 0)
+        std::memmove(dst, src, n);
+}
+
+// 把 first 开始的 count 个大小为 Size（1/2/4/8）字节的元素原地逆序
+template <size_t Size>
+void reverse_elems(void *first, size_t count)
+{
+    static_assert(Size == 1 || Size == 2 || Size == 4 || Size == 8, "reverse_elems requires a lane-sized element");
+    auto lo = static_cast<unsigned char*>(first);
+    auto hi = lo + count * Size;
+#if defined(MYSTL_SIMD_X86)
+    if (has_avx2())
+        reverse_elems_avx2<Size>(lo, hi);
+    else
+        reverse_elems_sse2<Size>(lo, hi);
+#else
+    reverse_elems_scalar<Size>(lo, hi);
+#endif
+}
+
+// 交换 a[0, n) 和 b[0, n)，两段内存不能重叠
+inline void swap_bytes(void *a, void *b, size_t n)
+{
+    auto x = static_cast<unsigned char*>(a);
+    auto y = static_cast<unsigned char*>(b);
+#if defined(MYSTL_SIMD_X86)
+    if (has_avx2())
+        swap_bytes_avx2(x, y, n);
+    else
+        swap_bytes_sse2(x, y, n);
+#else
+    swap_bytes_scalar(x, y, 0, n);
+#endif
+}
+
+// 把 src 处 n 个 4 字节元素中 flags[i] 非零（select_zero 为 true 时为零）的元素依次写到 dst，返回写出的个数
+// 只写出被选中的元素；dst 可以与 src 相同或位于其前面（原地压缩），但不能位于其后并重叠
+inline size_t compress32(void *dst, const void *src, const unsigned char *flags, size_t n,
+                         bool select_zero = false)
+{
+    auto d = static_cast<unsigned char*>(dst);
+    auto s = static_cast<const unsigned char*>(src);
+#if defined(MYSTL_SIMD_X86)
+    if (has_avx2())
+        return compress32_avx2(d, s, flags, n, select_zero);
+#endif
+    return compress32_scalar(d, s, flags, n, select_zero);
+}
+
+// a[0, na) 与 b[0, nb) 都严格递增（同一序列内没有重复元素），把共有的元素按升序写到 out，返回写出的个数
+template <class T>
+size_t intersect32(const T *a, size_t na, const T *b, size_t nb, T *out)
+{
+    static_assert(std::is_integral<T>::value && sizeof(T) == 4, "intersect32 requires a 4-byte integer type");
+#if defined(MYSTL_SIMD_X86)
+    if (has_avx2())
+        return intersect32_avx2(a, na, b, nb, out);
+    return intersect32_sse2(a, na, b, nb, out);
+#else
+    return intersect32_scalar(a, 0, na, b, 0, nb, out);
+#endif
+}
+
+// [first, last) 的和，整数按无符号回绕累加后转回 T，浮点数的结合顺序不确定
+template <class T>
+T reduce_sum(const T *first, const T *last)
+{
+    static_assert(is_vectorizable<T>::value, "reduce_sum requires an arithmetic lane type");
+#if defined(MYSTL_SIMD_X86)
+    if (has_avx2())
+        return static_cast<T>(sum_avx2(first, last));
+    return static_cast<T>(sum_sse2(first, last));
+#else
+    return static_cast<T>(sum_scalar(first, last));
+#endif
+}
+
+// a[0, n) 与 b[0, n) 的内积，只接受 float / double，结合顺序不确定
+template <class T>
+T dot(const T *a, const T *b, size_t n)
+{
+    static_assert(std::is_floating_point<T>::value && is_vectorizable<T>::value,
+                  "dot requires float or double");
+#if defined(MYSTL_SIMD_X86)
+    if (has_avx2())
+        return dot_avx2(a, b, n);
+    return dot_sse2(a, b, n);
+#else
+    return dot_scalar(a, b, n);
+#endif
+}
+
+// 在 h[0, n) 中查找 needle[0, m)，返回首次出现的下标，找不到返回 n
+inline size_t search_bytes(const void *haystack, size_t n, const void *pattern, size_t m)
+{
+    auto h = static_cast<const unsigned char*>(haystack);
+    auto needle = static_cast<const unsigned char*>(pattern);
+    if (m == 0)
+        return 0;
+    if (m > n)
+        return n;
+    if (m == 1)
+    {
+        auto p = static_cast<const unsigned char*>(std::memchr(h, needle[0], n));
+        return p == nullptr ? n : static_cast<size_t>(p - h);
+    }
+#if defined(MYSTL_SIMD_X86)
+    if (has_avx2())
+        return search_bytes_avx2(h, n, needle, m);
+    return search_bytes_sse2(h, n, needle, m);
+#else
+    size_t i = 0;
+    while (i + m <= n)
+    {
+        auto p = static_cast<const unsigned char*>(std::memchr(h + i, needle[0], n - m + 1 - i));
+        if (p == nullptr)
+            return n;
+        i = static_cast<size_t>(p - h);
+        if (h[i + m - 1] == needle[m - 1] && std::memcmp(h + i + 1, needle + 1, m - 2) == 0)
+            return i;
+        ++i;
+    }
+    return n;
+#endif
+}
+
+// out[i] = mix64_scalar(src[i])，src 为 4 / 8 字节整数（按无符号数零扩展），out 为 8 字节无符号整数
+template <class T, class U>
+void mix64_batch(const T *src, size_t n, U *out)
+{
+    static_assert(std::is_integral<T>::value && (sizeof(T) == 4 || sizeof(T) == 8),
+                  "mix64_batch requires a 4-byte or 8-byte integer source");
+    static_assert(std::is_unsigned<U>::value && sizeof(U) == 8, "mix64_batch requires an 8-byte unsigned output");
+#if defined(MYSTL_SIMD_X86)
+    if (has_avx2())
+    {
+        mix64_batch_avx2(src, n, out);
+        return;
+    }
+#endif
+    mix64_batch_scalar(src, 0, n, out);
+}
+
+// 把 p 开始的 stripes 个 64 字节条带累加到 acc[0, 8)，secret 至少有 56 + 8 * stripes 字节
+inline void hash_stripes(uint64_t *acc, const void *p, size_t stripes, const void *secret)
+{
+    auto data = static_cast<const unsigned char*>(p);
+    auto key = static_cast<const unsigned char*>(secret);
+#if defined(MYSTL_SIMD_X86)
+    if (has_avx2())
+        hash_stripes_avx2(acc, data, stripes, key);
+    else
+        hash_stripes_sse2(acc, data, stripes, key);
+#else
+    hash_stripes_scalar(acc, data, stripes, key);
+#endif
+}
+
+} // namespace simd
+} // namespace MyStl
+
+#endif
@@ -0,0 +1,539 @@
+#ifndef MYSTL_SKIP_LIST_H_
+#define MYSTL_SKIP_LIST_H_
+
+// 这个头文件包含一个模板类 skip_list
+// skip_list : 支持并发访问的有序跳表（lazy skip list）
+
+// notes:
+//
+// 并发协议：
+//   * find / contains / scan 完全不加锁，只沿 next 指针前进
+//   * insert / erase 先无锁定位每层的前驱，再只锁住这些前驱（和被删结点）并校验后修改
+//   * 结点先被标记为 marked（逻辑删除）再从各层摘下（物理删除），
+//     fully_linked 为 true 之后才对读者可见，因此 find 是线性化的
+//   * 摘下的结点经 epoch_domain 延迟回收，回收后的塔块归还给按层数分级的内存池
+//
+// 每个结点的 key、value 和 next 指针塔在同一块内存中，
+// 塔的高度由线程本地随机数按 p = 1/4 的几何分布生成
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+
+#include "epoch.h"
+#include "functional.h"
+#include "util.h"
+
+namespace MyStl
+{
+
+// --------------------------------------------------------------------------------------
+// 类 : size_class_pool
+// 为固定的若干种块大小各维护一条空闲链表，按块批量向系统申请，释放时只挂回链表
+template <size_t Classes>
+class size_class_pool
+{
+private:
+    static constexpr size_t blocks_per_chunk = 64;
+
+    struct free_block { free_block *next; };
+
+    struct alignas(64) size_class
+    {
+        std::mutex            mutex;
+        size_t                block_size = 0;
+        free_block           *free_list = nullptr;
+        std::vector<void*>    chunks;
+    };
+
+    size_class classes[Classes];
+
+public:
+    // sizes[i] 为第 i 级的块大小
+    explicit size_class_pool(const size_t (&sizes)[Classes])
+    {
+        for (size_t i = 0; i < Classes; ++i)
+        {
+            // 块至少能放下一个空闲链表指针，并按指针对齐
+            size_t size = sizes[i] < sizeof(free_block) ? sizeof(free_block) : sizes[i];
+            classes[i].block_size = (size + alignof(max_align_t) - 1) / alignof(max_align_t) * alignof(max_align_t);
+        }
+    }
+
+    ~size_class_pool()
+    {
+        for (auto &c : classes)
+            for (auto chunk : c.chunks)
+                std::free(chunk);
+    }
+
+    void* allocate(size_t cls)
+    {
+        auto &c = classes[cls];
+        std::lock_guard<std::mutex> lock(c.mutex);
+        if (c.free_list == nullptr)
+            refill(c);
+        auto block = c.free_list;
+        c.free_list = block -> next;
+        return block;
+    }
+
+    void deallocate(void *ptr, size_t cls)
+    {
+        auto &c = classes[cls];
+        auto block = static_cast<free_block*>(ptr);
+        std::lock_guard<std::mutex> lock(c.mutex);
+        block -> next = c.free_list;
+        c.free_list = block;
+    }
+
+private:
+    static void refill(size_class &c)
+    {
+        auto chunk = static_cast<char*>(std::malloc(c.block_size * blocks_per_chunk));
+        if (chunk == nullptr)
+            throw std::bad_alloc();
+        c.chunks.push_back(chunk);
+        for (size_t i = 0; i < blocks_per_chunk; ++i)
+        {
+            auto block = reinterpret_cast<free_block*>(chunk + i * c.block_size);
+            block -> next = c.free_list;
+            c.free_list = block;
+        }
+    }
+};
+
+// --------------------------------------------------------------------------------------
+// 模板类 : skip_list
+template <class Key, class Value, class Compare = MyStl::less<Key>>
+class skip_list
+{
+public:
+    typedef Key           key_type;
+    typedef Value         mapped_type;
+    typedef Compare       key_compare;
+    typedef size_t        size_type;
+
+    static constexpr int max_level = 24;   // 4^24 个元素以内塔高足够
+
+private:
+    struct node_base
+    {
+        std::atomic<node_base*> *next;
+        int                      level;
+        std::atomic<bool>        marked{false};
+        std::atomic<bool>        fully_linked{false};
+        std::atomic<bool>        locked{false};
+
+        explicit node_base(int lv) : next(nullptr), level(lv) {}
+
+        void lock()
+        {
+            while (locked.exchange(true, std::memory_order_acquire))
+            {
+                while (locked.load(std::memory_order_relaxed))
+                    std::this_thread::yield();
+            }
+        }
+        void unlock() { locked.store(false, std::memory_order_release); }
+    };
+
+    struct node : public node_base
+    {
+        Key   key;
+        Value value;
+
+        node(int lv, const Key &k, const Value &v) : node_base(lv), key(k), value(v) {}
+    };
+
+    // 塔紧跟在结点对象之后
+    template <class Node>
+    static constexpr size_t tower_offset()
+    {
+        return (sizeof(Node) + alignof(std::atomic<node_base*>) - 1) /
+               alignof(std::atomic<node_base*>) * alignof(std::atomic<node_base*>);
+    }
+
+    typedef size_class_pool<max_level> pool_type;
+
+    // 结点可能在 skip_list 析构之后、甚至在静态对象析构阶段才被 epoch_domain 回收，
+    // 所以池永不析构，内存在进程结束时交还给操作系统
+    // size_class 按缓存行对齐，C++17 之前的 new 不保证这种对齐，所以构造在对齐的静态存储上
+    static pool_type& pool()
+    {
+        alignas(pool_type) static unsigned char storage[sizeof(pool_type)];
+        static pool_type *instance = ::new (static_cast<void*>(storage)) pool_type(block_sizes());
+        return *instance;
+    }
+
+    static const size_t (&block_sizes())[max_level]
+    {
+        static size_t sizes[max_level];
+        for (int i = 0; i < max_level; ++i)
+            sizes[i] = tower_offset<node>() + (i + 1) * sizeof(std::atomic<node_base*>);
+        return sizes;
+    }
+
+private:
+    node_base           *head;
+    Compare              comp;
+    std::atomic<size_t>  count_;
+
+public:
+    // 构造、析构函数
+    skip_list() : head(nullptr), comp(), count_(0) { init_head(); }
+    explicit skip_list(const Compare &c) : head(nullptr), comp(c), count_(0) { init_head(); }
+
+    // 析构时不能再有其他线程访问
+    ~skip_list()
+    {
+        auto curr = head -> next[0].load(std::memory_order_relaxed);
+        while (curr != nullptr)
+        {
+            auto next = curr -> next[0].load(std::memory_order_relaxed);
+            destroy_node(static_cast<void*>(curr));
+            curr = next;
+        }
+        for (int i = 0; i < max_level; ++i)
+            head -> next[i].~atomic();
+        head -> ~node_base();
+        pool().deallocate(head, max_level - 1);
+    }
+
+private:
+    skip_list(const skip_list&);
+    void operator=(const skip_list&);
+
+public:
+    size_type size()  const noexcept { return count_.load(std::memory_order_relaxed); }
+    bool      empty() const noexcept { return size() == 0; }
+
+    // 无锁查找，存在时把值拷贝到 value 并返回 true
+    bool find(const Key &key, Value &value) const;
+    bool contains(const Key &key) const;
+
+    // key 不存在时插入并返回 true，已存在时返回 false
+    bool insert(const Key &key, const Value &value);
+
+    // 删除 key，存在时返回 true
+    bool erase(const Key &key);
+
+    // 按键升序对 [low, high) 内未被删除的元素调用 f(key, value)，返回访问的元素个数
+    template <class Function>
+    size_t scan(const Key &low, const Key &high, Function f) const;
+
+private:
+    void init_head()
+    {
+        void *block = pool().allocate(max_level - 1);
+        head = ::new (block) node_base(max_level);
+        head -> next = tower_of<node_base>(block);
+        for (int i = 0; i < max_level; ++i)
+            ::new (&head -> next[i]) std::atomic<node_base*>(nullptr);
+    }
+
+    template <class Node>
+    static std::atomic<node_base*>* tower_of(void *block)
+    {
+        return reinterpret_cast<std::atomic<node_base*>*>(static_cast<char*>(block) + tower_offset<Node>());
+    }
+
+    static node* create_node(int level, const Key &key, const Value &value)
+    {
+        void *block = pool().allocate(level - 1);
+        node *n;
+        try
+        {
+            n = ::new (block) node(level, key, value);
+        }
+        catch (...)
+        {
+            pool().deallocate(block, level - 1);
+            throw;
+        }
+        n -> next = tower_of<node>(block);
+        for (int i = 0; i < level; ++i)
+            ::new (&n -> next[i]) std::atomic<node_base*>(nullptr);
+        return n;
+    }
+
+    static void destroy_node(void *ptr)
+    {
+        auto n = static_cast<node*>(static_cast<node_base*>(ptr));
+        int level = n -> level;
+        for (int i = 0; i < level; ++i)
+            n -> next[i].~atomic();
+        n -> ~node();
+        pool().deallocate(static_cast<void*>(n), level - 1);
+    }
+
+    // 线程本地的 xorshift64* 随机数，按 p = 1/4 生成塔高
+    static int random_level()
+    {
+        static thread_local uint64_t state = 0;
+        if (state == 0)
+        {
+            state = static_cast<uint64_t>(std::hash<std::thread::id>()(std::this_thread::get_id()));
+            state ^= reinterpret_cast<uintptr_t>(&state);
+            state |= 1;
+        }
+        state ^= state >> 12;
+        state ^= state << 25;
+        state ^= state >> 27;
+        uint64_t r = state * 0x2545F4914F6CDD1DULL;
+        int level = 1;
+        while ((r & 3) == 0 && level < max_level)
+        {
+            ++level;
+            r >>= 2;
+        }
+        return level;
+    }
+
+    static const Key& key_of(node_base *n) { return static_cast<node*>(n) -> key; }
+
+    // 在每一层找出 key 的前驱和后继，返回 key 所在的最高层，不存在返回 -1
+    int locate(const Key &key, node_base **preds, node_base **succs) const
+    {
+        int found = -1;
+        node_base *pred = head;
+        for (int l = max_level - 1; l >= 0; --l)
+        {
+            node_base *curr = pred -> next[l].load(std::memory_order_acquire);
+            while (curr != nullptr && comp(key_of(curr), key))
+            {
+                pred = curr;
+                curr = pred -> next[l].load(std::memory_order_acquire);
+            }
+            if (found == -1 && curr != nullptr && !comp(key, key_of(curr)))
+                found = l;
+            preds[l] = pred;
+            succs[l] = curr;
+        }
+        return found;
+    }
+
+    // 解锁 preds[0, highest] 中不重复的前驱
+    static void unlock_preds(node_base **preds, int highest)
+    {
+        node_base *prev = nullptr;
+        for (int l = 0; l <= highest; ++l)
+        {
+            if (preds[l] != prev)
+            {
+                preds[l] -> unlock();
+                prev = preds[l];
+            }
+        }
+    }
+};
+
+template <class Key, class Value, class Compare>
+constexpr int skip_list<Key, Value, Compare>::max_level;
+
+/*****************************************************************************************/
+// find / contains
+/*****************************************************************************************/
+template <class Key, class Value, class Compare>
+bool skip_list<Key, Value, Compare>::find(const Key &key, Value &value) const
+{
+    epoch_guard guard;
+    node_base *preds[max_level];
+    node_base *succs[max_level];
+    int found = locate(key, preds, succs);
+    if (found == -1)
+        return false;
+    auto n = succs[found];
+    if (!n -> fully_linked.load(std::memory_order_acquire) || n -> marked.load(std::memory_order_acquire))
+        return false;
+    value = static_cast<node*>(n) -> value;
+    return true;
+}
+
+template <class Key, class Value, class Compare>
+bool skip_list<Key, Value, Compare>::contains(const Key &key) const
+{
+    epoch_guard guard;
+    node_base *preds[max_level];
+    node_base *succs[max_level];
+    int found = locate(key, preds, succs);
+    return found != -1 &&
+           succs[found] -> fully_linked.load(std::memory_order_acquire) &&
+           !succs[found] -> marked.load(std::memory_order_acquire);
+}
+
+/*****************************************************************************************/
+// insert
+/*****************************************************************************************/
+template <class Key, class Value, class Compare>
+bool skip_list<Key, Value, Compare>::insert(const Key &key, const Value &value)
+{
+    epoch_guard guard;
+    const int top = random_level();
+    node_base *preds[max_level];
+    node_base *succs[max_level];
+    while (true)
+    {
+        int found = locate(key, preds, succs);
+        if (found != -1)
+        {
+            auto n = succs[found];
+            if (!n -> marked.load(std::memory_order_acquire))
+            {
+                // 另一个线程正在插入同一个键，等它链接完成以保证线性化
+                while (!n -> fully_linked.load(std::memory_order_acquire))
+                    std::this_thread::yield();
+                return false;
+            }
+            // 已被逻辑删除，等它被摘下后重试
+            continue;
+        }
+
+        // 自底向上锁住前驱并校验它们仍然相邻
+        int highest = -1;
+        bool valid = true;
+        node_base *prev = nullptr;
+        for (int l = 0; valid && l < top; ++l)
+        {
+            auto pred = preds[l];
+            auto succ = succs[l];
+            if (pred != prev)
+            {
+                pred -> lock();
+                prev = pred;
+            }
+            highest = l;
+            valid = !pred -> marked.load(std::memory_order_acquire) &&
+                    (succ == nullptr || !succ -> marked.load(std::memory_order_acquire)) &&
+                    pred -> next[l].load(std::memory_order_acquire) == succ;
+        }
+        if (!valid)
+        {
+            unlock_preds(preds, highest);
+            continue;
+        }
+
+        node *n;
+        try
+        {
+            n = create_node(top, key, value);
+        }
+        catch (...)
+        {
+            unlock_preds(preds, highest);
+            throw;
+        }
+        for (int l = 0; l < top; ++l)
+            n -> next[l].store(succs[l], std::memory_order_relaxed);
+        for (int l = 0; l < top; ++l)
+            preds[l] -> next[l].store(n, std::memory_order_release);
+        n -> fully_linked.store(true, std::memory_order_release);
+        unlock_preds(preds, highest);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+}
+
+/*****************************************************************************************/
+// erase
+/*****************************************************************************************/
+template <class Key, class Value, class Compare>
+bool skip_list<Key, Value, Compare>::erase(const Key &key)
+{
+    epoch_guard guard;
+    node_base *preds[max_level];
+    node_base *succs[max_level];
+    node_base *victim = nullptr;
+    bool is_marked = false;
+    int top = -1;
+    while (true)
+    {
+        int found = locate(key, preds, succs);
+        if (!is_marked)
+        {
+            // 只删除完整链接、未被标记且在自己最高层被找到的结点
+            if (found == -1)
+                return false;
+            victim = succs[found];
+            if (!victim -> fully_linked.load(std::memory_order_acquire) ||
+                victim -> level - 1 != found ||
+                victim -> marked.load(std::memory_order_acquire))
+                return false;
+            top = victim -> level;
+            victim -> lock();
+            if (victim -> marked.load(std::memory_order_relaxed))
+            {
+                victim -> unlock();
+                return false;
+            }
+            victim -> marked.store(true, std::memory_order_release);
+            is_marked = true;
+        }
+
+        int highest = -1;
+        bool valid = true;
+        node_base *prev = nullptr;
+        for (int l = 0; valid && l < top; ++l)
+        {
+            auto pred = preds[l];
+            if (pred != prev)
+            {
+                pred -> lock();
+                prev = pred;
+            }
+            highest = l;
+            valid = !pred -> marked.load(std::memory_order_acquire) &&
+                    pred -> next[l].load(std::memory_order_acquire) == victim;
+        }
+        if (!valid)
+        {
+            unlock_preds(preds, highest);
+            continue;
+        }
+
+        for (int l = top - 1; l >= 0; --l)
+            preds[l] -> next[l].store(victim -> next[l].load(std::memory_order_relaxed),
+                                      std::memory_order_release);
+        victim -> unlock();
+        unlock_preds(preds, highest);
+        count_.fetch_sub(1, std::memory_order_relaxed);
+        epoch_domain::instance().retire(victim, &skip_list::destroy_node);
+        return true;
+    }
+}
+
+/*****************************************************************************************/
+// scan
+/*****************************************************************************************/
+template <class Key, class Value, class Compare>
+template <class Function>
+size_t skip_list<Key, Value, Compare>::scan(const Key &low, const Key &high, Function f) const
+{
+    epoch_guard guard;
+    node_base *preds[max_level];
+    node_base *succs[max_level];
+    locate(low, preds, succs);
+    size_t visited = 0;
+    for (auto curr = succs[0]; curr != nullptr; curr = curr -> next[0].load(std::memory_order_acquire))
+    {
+        auto n = static_cast<node*>(curr);
+        if (!comp(n -> key, high))
+            break;
+        if (n -> fully_linked.load(std::memory_order_acquire) && !n -> marked.load(std::memory_order_acquire))
+        {
+            f(n -> key, n -> value);
+            ++visited;
+        }
+    }
+    return visited;
+}
+
+} // namespace MyStl
+
+#endif
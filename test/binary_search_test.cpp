@@ -0,0 +1,238 @@
+// lower_bound / upper_bound / equal_range / lower_bound_batch 的测试，结果与 std::lower_bound / std::upper_bound 对照
+// 覆盖算术类型原生指针的无分支版本（包括元素与键类型不同）、MyStl::vector 的随机访问版本、
+// MyStl::list 的前向版本，以及各自带比较器的版本；长度 0 到 64 的有重复序列上查找每个可能的键
+// lower_bound_batch 覆盖有序查询的线性扫描和倍增两条路径、无序查询的分组路径，查询个数不是组长的整数倍
+// 同时是原有 upper_bound 缺陷的回归测试：
+//   * 区间收缩写成 len - half，某些长度下不收敛
+//   * 默认版本用 <= 比较，只定义了 operator< 的类型无法编译
+//   * 前向迭代器的比较器版本用了 middle + 1，list 上无法编译
+// g++ -std=c++14 -O2 -I.. binary_search_test.cpp -o binary_search_test && ./binary_search_test
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <random>
+#include <vector>
+
+#include "../algo.h"
+#include "../functional.h"
+#include "../list.h"
+#include "../vector.h"
+
+namespace
+{
+
+std::mt19937 rng(38);
+
+// 只定义了 operator< 的键
+struct only_less
+{
+    int v;
+};
+
+bool operator<(const only_less &a, const only_less &b) { return a.v < b.v; }
+
+// 逆序比较器，序列按降序排列
+struct greater_int
+{
+    bool operator()(int a, int b) const { return a > b; }
+};
+
+// 长度为 n、值域为 [0, range) 的有序序列，range 越小重复越多
+std::vector<int> sorted_values(size_t n, int range)
+{
+    std::vector<int> v(n);
+    for (auto &x : v)
+        x = static_cast<int>(rng() % range);
+    std::sort(v.begin(), v.end());
+    return v;
+}
+
+// 原生指针：同类型键，以及 double、long long 键查 int 序列，int 键查 unsigned char 序列
+void test_pointer()
+{
+    for (size_t n = 0; n <= 64; ++n)
+    {
+        for (int range : {1, 3, 100})
+        {
+            const std::vector<int> v = sorted_values(n, range);
+            const int *p = v.data();
+            for (int key = -2; key <= range + 1; ++key)
+            {
+                assert(MyStl::lower_bound(p, p + n, key) - p == std::lower_bound(v.begin(), v.end(), key) - v.begin());
+                assert(MyStl::upper_bound(p, p + n, key) - p == std::upper_bound(v.begin(), v.end(), key) - v.begin());
+                auto r = MyStl::equal_range(p, p + n, key);
+                auto e = std::equal_range(v.begin(), v.end(), key);
+                assert(r.first - p == e.first - v.begin() && r.second - p == e.second - v.begin());
+                const double half = key + 0.5;
+                assert(MyStl::lower_bound(p, p + n, half) - p ==
+                       std::lower_bound(v.begin(), v.end(), half) - v.begin());
+                assert(MyStl::upper_bound(p, p + n, half) - p ==
+                       std::upper_bound(v.begin(), v.end(), half) - v.begin());
+                const long long wide = key;
+                assert(MyStl::upper_bound(p, p + n, wide) - p ==
+                       std::upper_bound(v.begin(), v.end(), wide) - v.begin());
+            }
+
+            std::vector<unsigned char> bytes(v.begin(), v.end());
+            const unsigned char *b = bytes.data();
+            for (int key : {-1, 0, 1, 50, 255, 256, 1000})
+            {
+                assert(MyStl::lower_bound(b, b + n, key) - b ==
+                       std::lower_bound(bytes.begin(), bytes.end(), key) - bytes.begin());
+                assert(MyStl::upper_bound(b, b + n, key) - b ==
+                       std::upper_bound(bytes.begin(), bytes.end(), key) - bytes.begin());
+            }
+        }
+    }
+}
+
+// 非指针迭代器和比较器版本，键类型只定义了 operator<
+void test_generic()
+{
+    for (size_t n = 0; n <= 64; ++n)
+    {
+        const std::vector<int> v = sorted_values(n, 7);
+        MyStl::vector<int> mv(v.data(), v.data() + n);
+        MyStl::list<int> ml(v.data(), v.data() + n);
+        std::vector<int> desc(v.rbegin(), v.rend());
+        MyStl::list<int> mdesc(desc.data(), desc.data() + n);
+        std::vector<only_less> keys(n);
+        for (size_t i = 0; i < n; ++i)
+            keys[i].v = v[i];
+        const only_less *kp = keys.data();
+
+        for (int key = -1; key <= 8; ++key)
+        {
+            const auto lo = std::lower_bound(v.begin(), v.end(), key) - v.begin();
+            const auto hi = std::upper_bound(v.begin(), v.end(), key) - v.begin();
+            assert(MyStl::lower_bound(mv.begin(), mv.end(), key) - mv.begin() == lo);
+            assert(MyStl::upper_bound(mv.begin(), mv.end(), key) - mv.begin() == hi);
+            assert(MyStl::lower_bound(mv.begin(), mv.end(), key, MyStl::less<int>()) - mv.begin() == lo);
+            assert(MyStl::upper_bound(mv.begin(), mv.end(), key, MyStl::less<int>()) - mv.begin() == hi);
+
+            assert(MyStl::distance(ml.begin(), MyStl::lower_bound(ml.begin(), ml.end(), key)) == lo);
+            assert(MyStl::distance(ml.begin(), MyStl::upper_bound(ml.begin(), ml.end(), key)) == hi);
+            assert(MyStl::distance(ml.begin(), MyStl::lower_bound(ml.begin(), ml.end(), key, MyStl::less<int>())) == lo);
+            assert(MyStl::distance(ml.begin(), MyStl::upper_bound(ml.begin(), ml.end(), key, MyStl::less<int>())) == hi);
+            auto lr = MyStl::equal_range(ml.begin(), ml.end(), key);
+            assert(MyStl::distance(ml.begin(), lr.first) == lo);
+            assert(MyStl::distance(ml.begin(), lr.second) == hi);
+
+            const auto dlo = std::lower_bound(desc.begin(), desc.end(), key, greater_int()) - desc.begin();
+            const auto dhi = std::upper_bound(desc.begin(), desc.end(), key, greater_int()) - desc.begin();
+            assert(MyStl::lower_bound(desc.data(), desc.data() + n, key, greater_int()) - desc.data() == dlo);
+            assert(MyStl::upper_bound(desc.data(), desc.data() + n, key, greater_int()) - desc.data() == dhi);
+            assert(MyStl::distance(mdesc.begin(), MyStl::upper_bound(mdesc.begin(), mdesc.end(), key, greater_int()))
+                   == dhi);
+
+            const only_less k{key};
+            assert(MyStl::lower_bound(kp, kp + n, k) - kp == lo);
+            assert(MyStl::upper_bound(kp, kp + n, k) - kp == hi);
+            (void)lo; (void)hi; (void)dlo; (void)dhi; (void)lr;
+        }
+    }
+}
+
+// 较长的随机序列，只抽查部分键
+void test_large()
+{
+    for (size_t n : {1000u, 4097u, 65536u, 1000003u})
+    {
+        const std::vector<int> v = sorted_values(n, static_cast<int>(n / 3 + 1));
+        const int *p = v.data();
+        for (int i = 0; i < 2000; ++i)
+        {
+            const int key = static_cast<int>(rng() % (n / 3 + 3)) - 1;
+            assert(MyStl::lower_bound(p, p + n, key) - p == std::lower_bound(v.begin(), v.end(), key) - v.begin());
+            assert(MyStl::upper_bound(p, p + n, key) - p == std::upper_bound(v.begin(), v.end(), key) - v.begin());
+        }
+    }
+}
+
+// 逐个 std::lower_bound 得到的期望结果（下标）
+template <class Compare>
+std::vector<long> expected_bounds(const std::vector<int> &v, const std::vector<int> &queries, Compare comp)
+{
+    std::vector<long> r;
+    for (auto q : queries)
+        r.push_back(std::lower_bound(v.begin(), v.end(), q, comp) - v.begin());
+    return r;
+}
+
+template <class Iter>
+std::vector<long> batch_indices(Iter first, const std::vector<Iter> &out, size_t m)
+{
+    std::vector<long> r;
+    for (size_t i = 0; i < m; ++i)
+        r.push_back(out[i] - first);
+    return r;
+}
+
+// n 为有序区间长度，m 为查询个数；sorted 为 true 时查询有序，m 与 n 的比例决定走线性扫描还是倍增
+void check_batch(size_t n, size_t m, bool sorted)
+{
+    const int range = static_cast<int>(n + 10);
+    const std::vector<int> v = sorted_values(n, range);
+    std::vector<int> queries(m);
+    for (auto &q : queries)
+        q = static_cast<int>(rng() % (range + 20)) - 10;   // 包括小于最小值和大于最大值的键
+    if (sorted)
+        std::sort(queries.begin(), queries.end());
+    const std::vector<long> expected = expected_bounds(v, queries, std::less<int>());
+
+    const int *p = v.data();
+    std::vector<const int*> out(m + 1);
+    auto end = MyStl::lower_bound_batch(p, p + n, queries.data(), queries.data() + m, out.begin());
+    assert(end == out.begin() + m);
+    assert(batch_indices(p, out, m) == expected);
+
+    // 非指针的随机访问区间，查询来自 list（前向迭代器）
+    MyStl::vector<int> mv(p, p + n);
+    MyStl::list<int> ml(queries.data(), queries.data() + m);
+    std::vector<MyStl::vector<int>::iterator> mout(m);
+    MyStl::lower_bound_batch(mv.begin(), mv.end(), ml.begin(), ml.end(), mout.begin());
+    assert(batch_indices(mv.begin(), mout, m) == expected);
+
+    // 降序区间和比较器
+    std::vector<int> desc(v.rbegin(), v.rend());
+    std::vector<int> dq(queries.rbegin(), queries.rend());
+    const std::vector<long> dexp = expected_bounds(desc, dq, greater_int());
+    MyStl::lower_bound_batch(desc.data(), desc.data() + n, dq.data(), dq.data() + m, out.begin(), greater_int());
+    assert(batch_indices(static_cast<const int*>(desc.data()), out, m) == dexp);
+    (void)end;
+}
+
+void test_batch()
+{
+    for (size_t m : {0u, 1u, 15u, 16u, 17u, 33u, 100u})
+    {
+        for (size_t n : {0u, 1u, 5u, 100u, 1000u, 100000u})
+        {
+            check_batch(n, m, true);    // m 小、n 大时走倍增，n <= 8m 时走线性扫描
+            check_batch(n, m, false);
+        }
+    }
+    // 有序查询中大量重复，以及全部相同
+    const std::vector<int> v = sorted_values(5000, 50);
+    std::vector<int> queries(3000, 25);
+    std::vector<const int*> out(queries.size());
+    MyStl::lower_bound_batch(v.data(), v.data() + v.size(), queries.data(), queries.data() + queries.size(),
+                             out.begin());
+    for (auto r : out)
+        assert(r == std::lower_bound(v.data(), v.data() + v.size(), 25));
+}
+
+} // namespace
+
+int main()
+{
+    test_pointer();
+    test_generic();
+    test_large();
+    test_batch();
+    std::puts("binary_search_test: ok");
+    return 0;
+}
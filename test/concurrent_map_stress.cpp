@@ -0,0 +1,195 @@
+// concurrent_map 的多线程压力测试
+// 每个线程只修改属于自己的键（key % threads == id），并用 std::set 记录这些键的预期状态，
+// 同时查找、扫描所有线程的键；最后检查删空之后内部结点全部被收缩、回收
+// g++ -std=c++14 -O2 -pthread -I.. concurrent_map_stress.cpp -o concurrent_map_stress && ./concurrent_map_stress [threads] [ops]
+// 也应在 -fsanitize=thread 与 -fsanitize=address 下运行
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "../concurrent_map.h"
+
+namespace
+{
+
+// 键和值都做得比较大，让叶子和内部结点的容量变小，树更高，分裂和收缩更频繁
+struct big_key
+{
+    uint64_t k;
+    uint64_t pad[15];
+};
+
+struct big_key_less
+{
+    bool operator()(const big_key &a, const big_key &b) const { return a.k < b.k; }
+};
+
+struct big_value
+{
+    uint64_t words[32];
+};
+
+typedef MyStl::concurrent_map<big_key, big_value, big_key_less> map_type;
+
+const uint64_t key_range = 8192;
+
+big_key make_key(uint64_t k)
+{
+    big_key key;
+    key.k = k;
+    for (auto &p : key.pad) p = k;
+    return key;
+}
+
+big_value make_value(uint64_t k, uint64_t tag)
+{
+    big_value value;
+    for (auto &w : value.words) w = k * 7 + tag;
+    return value;
+}
+
+// 读到的值必须是某一次完整写入的结果，不能新旧混杂
+void check_value(uint64_t k, const big_value &value)
+{
+    uint64_t first = value.words[0];
+    assert(first >= k * 7 && first < k * 7 + 2);
+    for (auto w : value.words)
+        assert(w == first);
+    (void)first;
+}
+
+void worker(map_type &map, unsigned id, unsigned threads, size_t ops)
+{
+    std::mt19937_64 rng(id * 7919 + 1);
+    std::set<uint64_t> own;
+    auto own_key = [&]() { return (rng() % (key_range / threads)) * threads + id; };
+
+    for (size_t i = 0; i < ops; ++i)
+    {
+        unsigned op = static_cast<unsigned>(rng() % 100);
+        if (op < 30)
+        {
+            uint64_t k = own_key();
+            bool inserted = map.insert(make_key(k), make_value(k, 0));
+            assert(inserted == own.insert(k).second);
+            (void)inserted;
+        }
+        else if (op < 35)
+        {
+            uint64_t k = own_key();
+            bool inserted = map.insert_or_assign(make_key(k), make_value(k, 1));
+            assert(inserted == own.insert(k).second);
+            (void)inserted;
+        }
+        else if (op < 65)
+        {
+            uint64_t k = own_key();
+            bool erased = map.erase(make_key(k));
+            assert(erased == (own.erase(k) == 1));
+            (void)erased;
+        }
+        else if (op < 90)
+        {
+            // 查任意线程的键，自己的键必须与预期一致
+            uint64_t k = rng() % key_range;
+            big_value value;
+            bool found = map.find(make_key(k), value);
+            if (found)
+                check_value(k, value);
+            if (k % threads == id)
+                assert(found == (own.count(k) == 1));
+        }
+        else
+        {
+            uint64_t low = rng() % key_range;
+            uint64_t high = low + rng() % 512;
+            std::vector<uint64_t> seen;
+            size_t visited = map.scan(make_key(low), make_key(high),
+                                      [&](const big_key &key, const big_value &value)
+            {
+                assert(key.k >= low && key.k < high);
+                assert(seen.empty() || seen.back() < key.k);
+                for (auto p : key.pad)
+                    assert(p == key.k);
+                check_value(key.k, value);
+                seen.push_back(key.k);
+            });
+            assert(visited == seen.size());
+            (void)visited;
+            std::vector<uint64_t> mine, expected;
+            for (auto k : seen)
+                if (k % threads == id) mine.push_back(k);
+            for (auto it = own.lower_bound(low); it != own.end() && *it < high; ++it)
+                expected.push_back(*it);
+            assert(mine == expected);
+        }
+    }
+
+    // 删除自己剩下的键
+    for (auto k : own)
+    {
+        bool erased = map.erase(make_key(k));
+        assert(erased);
+        (void)erased;
+    }
+}
+
+void test_concurrent(unsigned threads, size_t ops)
+{
+    map_type map;
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; ++t)
+        pool.emplace_back(worker, std::ref(map), t, threads, ops);
+    for (auto &th : pool)
+        th.join();
+    assert(map.size() == 0);
+    assert(map.node_count() == 1);
+}
+
+// 单线程大量插入再全部删除：结点数随元素个数减少，删空后只剩根叶子
+void test_shrink()
+{
+    const uint64_t n = 100000;
+    map_type map;
+    std::vector<uint64_t> keys(n);
+    for (uint64_t i = 0; i < n; ++i)
+        keys[i] = i;
+    std::shuffle(keys.begin(), keys.end(), std::mt19937_64(42));
+    for (auto k : keys)
+        map.insert(make_key(k), make_value(k, 0));
+    assert(map.size() == n);
+    size_t peak = map.node_count();
+    std::shuffle(keys.begin(), keys.end(), std::mt19937_64(43));
+    for (uint64_t i = 0; i < n; ++i)
+    {
+        bool erased = map.erase(make_key(keys[i]));
+        assert(erased);
+        (void)erased;
+        if ((i + 1) % 10000 == 0)
+        {
+            size_t remaining = n - i - 1;
+            assert(map.node_count() <= (remaining == 0 ? 1 : 2 * remaining - 1));
+        }
+    }
+    assert(map.node_count() == 1);
+    std::printf("test_shrink: %zu nodes at peak, 1 after erasing all\n", peak);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    unsigned threads = argc > 1 ? static_cast<unsigned>(std::atoi(argv[1])) : 8;
+    size_t ops = argc > 2 ? static_cast<size_t>(std::atoll(argv[2])) : 200000;
+    test_shrink();
+    test_concurrent(threads, ops);
+    std::puts("concurrent_map_stress: ok");
+    return 0;
+}
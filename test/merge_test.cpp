@@ -0,0 +1,324 @@
+// merge / inplace_merge 的测试，结果与 std::merge / std::stable_sort 对照
+// 覆盖：无分支归并的算术类型、带来源标记的记录检查稳定性、list（双向迭代器）、
+// 缓冲区容纳较短一段时的前向与后向归并、缓冲区不足时的 SymMerge 与双向迭代器分割（直接调用 merge_adaptive 限定缓冲区大小）；
+// 只能移动的类型，以及计数类型：归并过程中不拷贝元素、比较或移动抛出异常后所有元素仍在区间内且没有泄漏
+// g++ -std=c++14 -O2 -I.. merge_test.cpp -o merge_test && ./merge_test
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "../algo.h"
+#include "../list.h"
+#include "../memory.h"
+#include "simd_test_util.h"
+
+namespace
+{
+
+std::mt19937_64 rng(47);
+
+struct tagged
+{
+    int key;
+    int id; // 在原区间中的位置，稳定的归并结果中相等键的 id 递增
+};
+
+bool operator==(const tagged &a, const tagged &b)
+{
+    return a.key == b.key && a.id == b.id;
+}
+
+struct key_less
+{
+    bool operator()(const tagged &a, const tagged &b) const { return a.key < b.key; }
+};
+
+// 两段各自有序、键取自 [0, range) 的记录
+std::vector<tagged> two_runs(size_t len1, size_t len2, int range)
+{
+    std::vector<tagged> v(len1 + len2);
+    for (auto &x : v)
+        x.key = static_cast<int>(rng() % range);
+    std::sort(v.begin(), v.begin() + len1, key_less());
+    std::sort(v.begin() + len1, v.end(), key_less());
+    for (size_t i = 0; i < v.size(); ++i)
+        v[i].id = static_cast<int>(i);
+    return v;
+}
+
+template <class T>
+std::vector<T> to_vector(const MyStl::list<T> &l)
+{
+    std::vector<T> v;
+    for (auto it = l.begin(); it != l.end(); ++it)
+        v.push_back(*it);
+    return v;
+}
+
+void test_merge()
+{
+    for (size_t n1 : {0u, 1u, 2u, 15u, 100u})
+    {
+        for (size_t n2 : {0u, 1u, 3u, 16u, 257u})
+        {
+            std::vector<int> a(n1), b(n2);
+            for (auto &x : a)
+                x = static_cast<int>(rng() % 50) - 25;
+            for (auto &x : b)
+                x = static_cast<int>(rng() % 50) - 25;
+            std::sort(a.begin(), a.end());
+            std::sort(b.begin(), b.end());
+            std::vector<int> out(n1 + n2 + 1, 999), expected(n1 + n2);
+            std::merge(a.begin(), a.end(), b.begin(), b.end(), expected.begin());
+            int *end = MyStl::merge(a.data(), a.data() + n1, b.data(), b.data() + n2, out.data());
+            assert(end == out.data() + n1 + n2 && out[n1 + n2] == 999);
+            assert(std::equal(expected.begin(), expected.end(), out.begin()));
+            (void)end;
+
+            // 相等的键先取区间一
+            auto v = two_runs(n1, n2, 7);
+            std::vector<tagged> t(n1 + n2), e(n1 + n2);
+            std::merge(v.begin(), v.begin() + n1, v.begin() + n1, v.end(), e.begin(), key_less());
+            MyStl::merge(v.data(), v.data() + n1, v.data() + n1, v.data() + v.size(), t.data(), key_less());
+            assert(t == e);
+        }
+    }
+}
+
+// 公开接口：缓冲区足够，较短一段在前走前向归并，在后走后向归并
+void test_inplace_merge()
+{
+    for (size_t n1 : {0u, 1u, 2u, 5u, 64u, 300u})
+    {
+        for (size_t n2 : {0u, 1u, 3u, 64u, 301u})
+        {
+            for (int range : {2, 10, 1000})
+            {
+                auto v = two_runs(n1, n2, range);
+                auto e = v;
+                std::stable_sort(e.begin(), e.end(), key_less());
+                MyStl::inplace_merge(v.data(), v.data() + n1, v.data() + v.size(), key_less());
+                assert(v == e);
+
+                std::vector<int> keys(v.size());
+                auto w = two_runs(n1, n2, range);
+                for (size_t i = 0; i < w.size(); ++i)
+                    keys[i] = w[i].key;
+                MyStl::list<int> l(keys.data(), keys.data() + keys.size());
+                auto mid = l.begin();
+                MyStl::advance(mid, n1);
+                MyStl::inplace_merge(l.begin(), mid, l.end());
+                std::sort(keys.begin(), keys.end());
+                assert(to_vector(l) == keys);
+            }
+        }
+    }
+}
+
+// 限定缓冲区大小，走递归分割；buffer_size 为 0 时完全不用缓冲区
+template <class Tag>
+void check_adaptive(size_t n1, size_t n2, ptrdiff_t buffer_size, int range)
+{
+    auto v = two_runs(n1, n2, range);
+    auto e = v;
+    std::stable_sort(e.begin(), e.end(), key_less());
+    MyStl::move_buffer<tagged> buf(buffer_size);
+    key_less comp;
+    MyStl::merge_adaptive(v.data(), v.data() + n1, v.data() + v.size(), static_cast<ptrdiff_t>(n1),
+                          static_cast<ptrdiff_t>(n2), buf.begin(), buf.size(), comp, Tag());
+    assert(v == e);
+}
+
+void test_merge_adaptive()
+{
+    for (size_t n1 : {1u, 2u, 7u, 100u, 513u})
+    {
+        for (size_t n2 : {1u, 2u, 9u, 100u, 512u})
+        {
+            for (ptrdiff_t buffer_size : {0, 1, 4, 33})
+            {
+                for (int range : {3, 1000})
+                {
+                    check_adaptive<MyStl::random_access_iterator_tag>(n1, n2, buffer_size, range);
+                    check_adaptive<MyStl::bidirectional_iterator_tag>(n1, n2, buffer_size, range);
+                }
+            }
+        }
+    }
+}
+
+// 只能移动的类型：temporary_buffer 需要拷贝构造，编译不过
+void test_move_only()
+{
+    typedef std::unique_ptr<int> ptr;
+    auto by_value = [](const ptr &a, const ptr &b) { return *a < *b; };
+    for (size_t n1 : {1u, 10u, 200u})
+    {
+        for (size_t n2 : {1u, 7u, 300u})
+        {
+            std::vector<int> keys(n1 + n2);
+            for (auto &x : keys)
+                x = static_cast<int>(rng() % 100);
+            std::sort(keys.begin(), keys.begin() + n1);
+            std::sort(keys.begin() + n1, keys.end());
+            std::vector<ptr> v;
+            for (int k : keys)
+                v.push_back(ptr(new int(k)));
+            MyStl::inplace_merge(v.data(), v.data() + n1, v.data() + v.size(), by_value);
+            std::sort(keys.begin(), keys.end());
+            for (size_t i = 0; i < keys.size(); ++i)
+                assert(v[i] && *v[i] == keys[i]);
+        }
+    }
+}
+
+/*****************************************************************************************/
+// 计数类型：统计存活对象和拷贝次数，可以在第 n 次移动或比较时抛出异常
+/*****************************************************************************************/
+struct counted
+{
+    static long live;
+    static long copies;
+    static long moves_until_throw; // 小于 0 时不抛出
+    int key;
+
+    explicit counted(int k) : key(k) { ++live; }
+    counted(const counted &rhs) : key(rhs.key)
+    {
+        ++live;
+        ++copies;
+    }
+    counted(counted &&rhs) : key(rhs.key)
+    {
+        tick();
+        ++live;
+    }
+    counted &operator=(const counted &rhs)
+    {
+        key = rhs.key;
+        ++copies;
+        return *this;
+    }
+    counted &operator=(counted &&rhs)
+    {
+        tick();
+        key = rhs.key;
+        return *this;
+    }
+    ~counted() { --live; }
+
+    static void tick()
+    {
+        if (moves_until_throw >= 0 && moves_until_throw-- == 0)
+            throw std::runtime_error("move");
+    }
+};
+
+long counted::live = 0;
+long counted::copies = 0;
+long counted::moves_until_throw = -1;
+
+struct throwing_less
+{
+    long *until_throw;
+    bool operator()(const counted &a, const counted &b) const
+    {
+        if (*until_throw >= 0 && (*until_throw)-- == 0)
+            throw std::runtime_error("compare");
+        return a.key < b.key;
+    }
+};
+
+std::vector<int> keys_of(const std::vector<counted> &v)
+{
+    std::vector<int> k;
+    for (const auto &x : v)
+        k.push_back(x.key);
+    std::sort(k.begin(), k.end());
+    return k;
+}
+
+void test_counted()
+{
+    size_t throws = 0;
+    for (size_t n1 : {3u, 40u, 200u})
+    {
+        for (size_t n2 : {5u, 41u, 150u})
+        {
+            std::vector<int> keys(n1 + n2);
+            for (size_t i = 0; i < keys.size(); ++i)
+                keys[i] = static_cast<int>(i); // 键互不相同，可以检查是否丢失或重复
+            std::shuffle(keys.begin(), keys.end(), rng);
+            std::sort(keys.begin(), keys.begin() + n1);
+            std::sort(keys.begin() + n1, keys.end());
+            std::vector<int> sorted_keys(keys);
+            std::sort(sorted_keys.begin(), sorted_keys.end());
+
+            // 正常归并：不拷贝
+            {
+                std::vector<counted> v;
+                v.reserve(keys.size());
+                for (int k : keys)
+                    v.emplace_back(k);
+                const long live = counted::live;
+                counted::copies = 0;
+                long never = -1;
+                MyStl::inplace_merge(v.data(), v.data() + n1, v.data() + v.size(), throwing_less{&never});
+                assert(counted::copies == 0 && counted::live == live);
+                for (size_t i = 0; i < v.size(); ++i)
+                    assert(v[i].key == sorted_keys[i]);
+                (void)live;
+            }
+
+            // 第 t 次比较或移动时抛出：异常传出，没有元素丢失或重复，缓冲区中的对象都已销毁
+            for (long t = 0; t < 60; t += 1 + t / 8)
+            {
+                for (int which = 0; which < 2; ++which)
+                {
+                    std::vector<counted> v;
+                    v.reserve(keys.size());
+                    for (int k : keys)
+                        v.emplace_back(k);
+                    const long live = counted::live;
+                    long compare_until = which == 0 ? t : -1;
+                    counted::moves_until_throw = which == 1 ? t : -1;
+                    bool thrown = false;
+                    try
+                    {
+                        MyStl::inplace_merge(v.data(), v.data() + n1, v.data() + v.size(),
+                                             throwing_less{&compare_until});
+                    }
+                    catch (const std::runtime_error &)
+                    {
+                        thrown = true;
+                    }
+                    counted::moves_until_throw = -1;
+                    throws += thrown;
+                    assert(counted::live == live);
+                    assert(keys_of(v) == sorted_keys);
+                    (void)live;
+                }
+            }
+        }
+    }
+    assert(throws > 0 && counted::live == 0);
+    (void)throws;
+}
+
+} // namespace
+
+int main()
+{
+    test_merge();
+    test_inplace_merge();
+    test_merge_adaptive();
+    test_move_only();
+    test_counted();
+    simd_test::report("merge_test");
+    return 0;
+}
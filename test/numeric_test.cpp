@@ -0,0 +1,259 @@
+// numeric.h 的测试：reduce / accumulate / inner_product / transform_reduce 的 SIMD 与多累加器路径，结果与逐个累加的朴素循环对照；
+// 以及 partial_sum / inclusive_scan / exclusive_scan / adjacent_difference 的顺序语义
+// 覆盖所有可向量化的元素类型、0 到 300 的长度、起点不对齐的区间、整数回绕、浮点数的特殊值和非指针迭代器
+// 浮点数用小整数取值，任意结合顺序下的和都是精确的，可以直接比较
+// g++ -std=c++14 -O2 -I.. numeric_test.cpp -o numeric_test && ./numeric_test
+// 另外用 -DMYSTL_NO_AVX2 和 -DMYSTL_NO_SIMD 各构建一次
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../functional.h"
+#include "../list.h"
+#include "../numeric.h"
+#include "../vector.h"
+#include "simd_test_util.h"
+
+namespace
+{
+
+std::mt19937_64 rng(43);
+
+// 整数取满值域，浮点数取 [-64, 64] 内的整数
+template <class T>
+typename std::enable_if<std::is_integral<T>::value, T>::type random_value()
+{
+    return static_cast<T>(rng());
+}
+
+template <class T>
+typename std::enable_if<std::is_floating_point<T>::value, T>::type random_value()
+{
+    return static_cast<T>(static_cast<int>(rng() % 129) - 64);
+}
+
+template <class T>
+T naive_sum(const T *first, const T *last, T init)
+{
+    typedef typename MyStl::simd::wrap_of<T>::type W;
+    W s = static_cast<W>(init);
+    for (; first != last; ++first)
+        s = static_cast<W>(s + static_cast<W>(*first));
+    return static_cast<T>(s);
+}
+
+template <class T>
+T naive_product(const T *first, const T *last, T init)
+{
+    typedef typename MyStl::numeric_wrap<T>::type W;
+    W s = static_cast<W>(init);
+    for (; first != last; ++first)
+        s = static_cast<W>(s * static_cast<W>(*first));
+    return static_cast<T>(s);
+}
+
+template <class T>
+T naive_dot(const T *a, const T *last, const T *b, T init)
+{
+    typedef typename MyStl::numeric_wrap<T>::type W;
+    W s = static_cast<W>(init);
+    for (; a != last; ++a, ++b)
+        s = static_cast<W>(s + static_cast<W>(static_cast<W>(*a) * static_cast<W>(*b)));
+    return static_cast<T>(s);
+}
+
+// 求和：reduce 走 simd::reduce_sum，accumulate 只在整数上走
+template <class T>
+void check_sum()
+{
+    std::vector<T> a(300 + 40), b(300 + 40);
+    for (size_t round = 0; round < 3; ++round)
+    {
+        for (auto &x : a)
+            x = random_value<T>();
+        for (auto &x : b)
+            x = random_value<T>();
+        for (size_t len = 0; len <= 300; ++len)
+        {
+            const size_t offset = rng() % 33;
+            const T *first = a.data() + offset;
+            const T *last = first + len;
+            const T *second = b.data() + offset;
+            const T init = random_value<T>();
+            assert(MyStl::reduce(first, last) == naive_sum(first, last, T()));
+            assert(MyStl::reduce(first, last, init) == naive_sum(first, last, init));
+            assert(MyStl::reduce(first, last, init, MyStl::plus<T>()) == naive_sum(first, last, init));
+            assert(MyStl::accumulate(first, last, init) == naive_sum(first, last, init));
+            if (std::is_integral<T>::value)
+            {
+                assert(MyStl::accumulate(first, last, init, MyStl::multiplies<T>()) ==
+                       naive_product(first, last, init));
+                assert(MyStl::inner_product(first, last, second, init) == naive_dot(first, last, second, init));
+            }
+            else
+            {
+                assert(MyStl::transform_reduce(first, last, second, init) == naive_dot(first, last, second, init));
+            }
+            (void)init; (void)second;
+        }
+    }
+}
+
+// 有符号整数的和溢出时按补码回绕，与逐个累加后截断的结果相同
+void test_integer_wrap()
+{
+    std::vector<int8_t> v(1000, 127);
+    assert(MyStl::reduce(v.data(), v.data() + v.size()) == naive_sum(v.data(), v.data() + v.size(), int8_t()));
+    std::vector<int32_t> w(1000, INT32_MAX);
+    assert(MyStl::reduce(w.data(), w.data() + w.size(), 5) == naive_sum(w.data(), w.data() + w.size(), 5));
+    assert(MyStl::accumulate(w.data(), w.data() + w.size(), 5) == naive_sum(w.data(), w.data() + w.size(), 5));
+    std::vector<int16_t> m(50, 3);
+    assert(MyStl::accumulate(m.data(), m.data() + m.size(), int16_t(1), MyStl::multiplies<int16_t>()) ==
+           naive_product(m.data(), m.data() + m.size(), int16_t(1)));
+}
+
+// NaN 和无穷在任意结合顺序下都会传播
+template <class T>
+void test_float_specials()
+{
+    const T nan = std::numeric_limits<T>::quiet_NaN();
+    const T inf = std::numeric_limits<T>::infinity();
+    for (size_t len : {1u, 7u, 31u, 64u, 129u})
+    {
+        for (size_t pos : {size_t(0), len / 2, len - 1})
+        {
+            std::vector<T> v(len, T(1));
+            v[pos] = nan;
+            assert(std::isnan(MyStl::reduce(v.data(), v.data() + len)));
+            assert(std::isnan(MyStl::transform_reduce(v.data(), v.data() + len, v.data(), T())));
+            v[pos] = inf;
+            assert(MyStl::reduce(v.data(), v.data() + len) == inf);
+            v[len - 1 - pos] = -inf;
+            if (len - 1 - pos != pos)
+                assert(std::isnan(MyStl::reduce(v.data(), v.data() + len)));
+        }
+    }
+    (void)nan; (void)inf;
+}
+
+// 非指针的随机访问迭代器走 reduce_indexed，前向迭代器逐个累加；非交换的运算只用在保持顺序的算法上
+void test_generic()
+{
+    for (size_t len : {0u, 1u, 5u, 7u, 8u, 9u, 11u, 100u})
+    {
+        std::vector<int> src(len);
+        for (auto &x : src)
+            x = static_cast<int>(rng() % 1000);
+        const int *p = src.data();
+        const long expected = naive_sum(p, p + len, 0);
+        MyStl::vector<int> mv(p, p + len);
+        MyStl::list<int> ml(p, p + len);
+        assert(MyStl::reduce(mv.begin(), mv.end()) == expected);
+        assert(MyStl::reduce(ml.begin(), ml.end()) == expected);
+        assert(MyStl::reduce(mv.begin(), mv.end(), 0L, MyStl::plus<long>()) == expected);
+        assert(MyStl::transform_reduce(mv.begin(), mv.end(), 0L, MyStl::plus<long>(),
+                                       [](int x) { return 2L * x; }) == 2 * expected);
+        assert(MyStl::transform_reduce(ml.begin(), ml.end(), 0L, MyStl::plus<long>(),
+                                       [](int x) { return 2L * x; }) == 2 * expected);
+        assert(MyStl::transform_reduce(mv.begin(), mv.end(), ml.begin(), 0L) == naive_dot(p, p + len, p, 0));
+        // 字符串拼接不满足交换律，accumulate 必须保持顺序
+        std::string joined;
+        for (size_t i = 0; i < len; ++i)
+            joined += std::to_string(src[i]) + ",";
+        assert(MyStl::accumulate(mv.begin(), mv.end(), std::string(),
+                                 [](const std::string &s, int x) { return s + std::to_string(x) + ","; }) == joined);
+        (void)expected;
+    }
+}
+
+// 扫描按从左到右的顺序计算；用非交换的仿射变换复合检查顺序
+void test_scans()
+{
+    // 系数按无符号回绕，长序列复合不会溢出
+    struct affine
+    {
+        unsigned long a, b;
+    };
+    auto compose = [](affine f, affine g) { return affine{f.a * g.a, f.b * g.a + g.b}; };
+    for (size_t len : {0u, 1u, 2u, 17u, 100u})
+    {
+        std::vector<int> v(len);
+        for (auto &x : v)
+            x = static_cast<int>(rng() % 100) - 50;
+        std::vector<int> out(len + 1, -1);
+        const int *p = v.data();
+
+        int *r = MyStl::partial_sum(p, p + len, out.data());
+        assert(r == out.data() + len);
+        int run = 0;
+        for (size_t i = 0; i < len; ++i)
+        {
+            run += v[i];
+            assert(out[i] == run);
+        }
+        assert(out[len] == -1);
+
+        MyStl::inclusive_scan(p, p + len, out.data(), MyStl::plus<int>(), 10);
+        run = 10;
+        for (size_t i = 0; i < len; ++i)
+        {
+            run += v[i];
+            assert(out[i] == run);
+        }
+
+        // 原地 exclusive_scan
+        std::vector<int> in_place(v);
+        r = MyStl::exclusive_scan(in_place.data(), in_place.data() + len, in_place.data(), 3);
+        assert(r == in_place.data() + len);
+        run = 3;
+        for (size_t i = 0; i < len; ++i)
+        {
+            assert(in_place[i] == run);
+            run += v[i];
+        }
+
+        MyStl::adjacent_difference(p, p + len, out.data());
+        for (size_t i = 0; i < len; ++i)
+            assert(out[i] == (i == 0 ? v[0] : v[i] - v[i - 1]));
+
+        std::vector<affine> fs(len), scanned(len);
+        for (size_t i = 0; i < len; ++i)
+            fs[i] = affine{1 + rng() % 3, rng() % 5};
+        MyStl::inclusive_scan(fs.data(), fs.data() + len, scanned.data(), compose);
+        affine acc{1, 0};
+        for (size_t i = 0; i < len; ++i)
+        {
+            acc = compose(acc, fs[i]);
+            assert(scanned[i].a == acc.a && scanned[i].b == acc.b);
+        }
+        (void)r;
+    }
+}
+
+} // namespace
+
+int main()
+{
+    check_sum<int8_t>();
+    check_sum<uint8_t>();
+    check_sum<int16_t>();
+    check_sum<uint16_t>();
+    check_sum<int32_t>();
+    check_sum<uint32_t>();
+    check_sum<int64_t>();
+    check_sum<uint64_t>();
+    check_sum<float>();
+    check_sum<double>();
+    test_integer_wrap();
+    test_float_specials<float>();
+    test_float_specials<double>();
+    test_generic();
+    test_scans();
+    simd_test::report("numeric_test");
+    return 0;
+}
@@ -0,0 +1,346 @@
+// parallel_algo.h 的测试：并行版本的结果与顺序计算对照
+// 覆盖 inclusive_scan / exclusive_scan（包括不满足交换律的运算）、reduce、copy_if / remove_if / partition_copy、
+// remove_if 对只能移动的元素不拷贝、不泄漏，
+// find / find_if / any_of 的提前取消，以及任务中抛出的异常在调用线程上重新抛出
+// 线程池固定为 4 个线程，单核机器上同样会走分块并行的路径
+// g++ -std=c++14 -O2 -pthread -I.. parallel_algo_test.cpp -o parallel_algo_test && ./parallel_algo_test
+// 也应在 -fsanitize=thread 与 -fsanitize=address 下运行
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../parallel_algo.h"
+
+namespace
+{
+
+std::mt19937_64 rng(2024);
+
+// 长度覆盖顺序退化、恰好两块以及块数不能整除的情况
+const size_t sizes[] = {0, 1, 100, 2 * MYSTL_PAR_MIN_GRAIN - 1, 2 * MYSTL_PAR_MIN_GRAIN,
+                        2 * MYSTL_PAR_MIN_GRAIN + 1, 100003, 1000000};
+
+// 仿射变换 x -> a * x + b（模 2^64），复合满足结合律但不满足交换律，用来检查扫描的结合顺序
+struct affine
+{
+    uint64_t a, b;
+    bool operator==(const affine &rhs) const { return a == rhs.a && b == rhs.b; }
+};
+
+// 先做 f 再做 g
+struct compose
+{
+    affine operator()(const affine &f, const affine &g) const
+    {
+        return affine{g.a * f.a, g.a * f.b + g.b};
+    }
+};
+
+std::vector<uint64_t> random_values(size_t n)
+{
+    std::vector<uint64_t> v(n);
+    for (auto &x : v)
+        x = rng() % 1000;
+    return v;
+}
+
+void test_scan()
+{
+    for (auto n : sizes)
+    {
+        const std::vector<uint64_t> in = random_values(n);
+        std::vector<uint64_t> out(n), expected(n);
+
+        uint64_t acc = 5;
+        for (size_t i = 0; i < n; ++i)
+            expected[i] = acc += in[i];
+        MyStl::vector<uint64_t> min(in.data(), in.data() + n), mout(n);
+        assert(MyStl::inclusive_scan(MyStl::execution::par, min.begin(), min.end(), mout.begin(),
+                                     MyStl::plus_op(), uint64_t(5)) == mout.end());
+        assert(std::equal(expected.begin(), expected.end(), mout.data()));
+        if (n > 0)
+        {
+            MyStl::inclusive_scan(MyStl::execution::par, in.data(), in.data() + n, out.data());
+            for (size_t i = 0; i < n; ++i)
+                assert(out[i] == expected[i] - 5);
+        }
+
+        acc = 7;
+        for (size_t i = 0; i < n; ++i)
+        {
+            expected[i] = acc;
+            acc += in[i];
+        }
+        assert(MyStl::exclusive_scan(MyStl::execution::par, in.data(), in.data() + n, out.data(), uint64_t(7))
+               == out.data() + n);
+        assert(out == expected);
+
+        std::vector<affine> fs(n), fout(n), fexp(n);
+        for (auto &f : fs)
+            f = affine{rng() | 1, rng()};
+        affine facc{3, 1};
+        for (size_t i = 0; i < n; ++i)
+            fexp[i] = facc = compose()(facc, fs[i]);
+        MyStl::inclusive_scan(MyStl::execution::par, fs.data(), fs.data() + n, fout.data(), compose(), affine{3, 1});
+        assert(fout == fexp);
+        facc = affine{1, 0};
+        for (size_t i = 0; i < n; ++i)
+        {
+            fexp[i] = facc;
+            facc = compose()(facc, fs[i]);
+        }
+        MyStl::exclusive_scan(MyStl::execution::par_unseq, fs.data(), fs.data() + n, fout.data(),
+                              affine{1, 0}, compose());
+        assert(fout == fexp);
+    }
+}
+
+void test_reduce()
+{
+    for (auto n : sizes)
+    {
+        const std::vector<uint64_t> in = random_values(n);
+        uint64_t sum = 11, dot = 0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            sum += in[i];
+            dot += in[i] * in[n - 1 - i];
+        }
+        MyStl::vector<uint64_t> min(in.data(), in.data() + n);
+        assert(MyStl::reduce(MyStl::execution::par, min.begin(), min.end(), uint64_t(11)) == sum);
+        assert(MyStl::reduce(MyStl::execution::seq, in.data(), in.data() + n, uint64_t(11)) == sum);
+        std::vector<uint64_t> rev(in.rbegin(), in.rend());
+        assert(MyStl::transform_reduce(MyStl::execution::par, in.data(), in.data() + n, rev.data(),
+                                       uint64_t(0)) == dot);
+        assert(MyStl::count(MyStl::execution::par, in.data(), in.data() + n, uint64_t(7))
+               == static_cast<size_t>(std::count(in.begin(), in.end(), uint64_t(7))));
+    }
+}
+
+// 按 keep_percent 的比例选中元素，分别检查 copy_if、remove_if 和 partition_copy
+template <class T, class Make>
+void check_select(size_t n, unsigned keep_percent, Make make)
+{
+    std::vector<T> in(n);
+    std::vector<unsigned char> keep(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        in[i] = make(i);
+        keep[i] = rng() % 100 < keep_percent;
+    }
+    const T *base = in.data();
+    auto pred = [&](const T &x) { return keep[&x - base] != 0; };
+    std::vector<T> yes, no;
+    for (size_t i = 0; i < n; ++i)
+        (keep[i] ? yes : no).push_back(in[i]);
+
+    std::vector<T> out(n);
+    T *end = MyStl::copy_if(MyStl::execution::par, in.data(), in.data() + n, out.data(), pred);
+    assert(std::vector<T>(out.data(), end) == yes);
+
+    std::vector<T> t(n), f(n);
+    auto r = MyStl::partition_copy(MyStl::execution::par, in.data(), in.data() + n, t.data(), f.data(), pred);
+    assert(std::vector<T>(t.data(), r.first) == yes);
+    assert(std::vector<T>(f.data(), r.second) == no);
+
+    // remove_if 会移动元素，谓词按值判断
+    std::vector<T> work = in;
+    std::vector<unsigned char> drop(n);
+    for (size_t i = 0; i < n; ++i)
+        drop[i] = keep[i];
+    const T *wbase = work.data();
+    T *kept_end = MyStl::remove_if(MyStl::execution::par, work.data(), work.data() + n,
+                                   [&](const T &x) { return drop[&x - wbase] != 0; });
+    assert(std::vector<T>(work.data(), kept_end) == no);
+}
+
+void test_select()
+{
+    const unsigned percents[] = {0, 1, 50, 99, 100};
+    for (auto n : sizes)
+    {
+        for (auto p : percents)
+        {
+            check_select<uint32_t>(n, p, [](size_t i) { return static_cast<uint32_t>(i * 2654435761u); });
+            check_select<uint64_t>(n, p, [](size_t i) { return static_cast<uint64_t>(i) << 20; });
+            if (n <= 100003)
+                check_select<std::string>(n, p, [](size_t i) { return std::to_string(i) + " padding past SSO"; });
+        }
+    }
+}
+
+// 只能移动的元素：remove_if 的缓冲区只移动构造保留的元素，不拷贝，也不多构造；移动后全部析构
+// live 统计存活的对象，copies 统计拷贝次数（只对可拷贝的 counted 有意义）
+std::atomic<long> live(0);
+std::atomic<long> copies(0);
+
+struct move_only
+{
+    std::unique_ptr<uint64_t> p;
+    explicit move_only(uint64_t v) : p(new uint64_t(v)) { ++live; }
+    move_only(move_only &&rhs) noexcept : p(std::move(rhs.p)) { ++live; }
+    move_only& operator=(move_only &&rhs) noexcept { p = std::move(rhs.p); return *this; }
+    ~move_only() { --live; }
+};
+
+// 可以拷贝，但移动构造没有 noexcept，remove_if 不使用缓冲区
+struct counted
+{
+    uint64_t v;
+    explicit counted(uint64_t x) : v(x) { ++live; }
+    counted(const counted &rhs) : v(rhs.v) { ++live; ++copies; }
+    counted(counted &&rhs) : v(rhs.v) { ++live; }
+    counted& operator=(const counted &rhs) { v = rhs.v; ++copies; return *this; }
+    counted& operator=(counted &&rhs) { v = rhs.v; return *this; }
+    ~counted() { --live; }
+};
+
+template <class T, class Value>
+void check_remove_if_objects(size_t n, unsigned keep_percent, Value value)
+{
+    std::vector<unsigned char> drop(n);
+    std::vector<uint64_t> expected;
+    {
+        std::vector<T> v;
+        v.reserve(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            drop[i] = rng() % 100 >= keep_percent;
+            v.emplace_back(i);
+            if (!drop[i])
+                expected.push_back(i);
+        }
+        const long live_before = live.load();
+        const long copies_before = copies.load();
+        T *end = MyStl::remove_if(MyStl::execution::par, v.data(), v.data() + n,
+                                  [&](const T &x) { return drop[value(x)] != 0; });
+        assert(static_cast<size_t>(end - v.data()) == expected.size());
+        for (size_t i = 0; i < expected.size(); ++i)
+            assert(value(v[i]) == expected[i]);
+        assert(live.load() == live_before);
+        assert(copies.load() == copies_before);
+        (void)end; (void)live_before; (void)copies_before;
+    }
+    assert(live.load() == 0);
+}
+
+void test_remove_if_objects()
+{
+    for (auto n : {size_t(100), size_t(2 * MYSTL_PAR_MIN_GRAIN + 1), size_t(100003)})
+    {
+        for (unsigned p : {1u, 50u, 99u})
+        {
+            check_remove_if_objects<move_only>(n, p, [](const move_only &x) { return *x.p; });
+            check_remove_if_objects<counted>(n, p, [](const counted &x) { return x.v; });
+        }
+    }
+}
+
+// 找到靠前的匹配后，后面的块应当被跳过：谓词的调用次数远小于区间长度
+void test_find_cancel()
+{
+    const size_t n = 1 << 22;
+    std::vector<uint32_t> v(n, 0);
+    for (auto pos : {size_t(0), size_t(5000), n / 3, n - 1})
+    {
+        v[pos] = 1;
+        v[n - 1 - (n - 1 - pos) / 2] = 1;   // 位置更靠后的第二个匹配，结果仍应是第一个
+        assert(MyStl::find(MyStl::execution::par, v.data(), v.data() + n, 1u) == v.data() + pos);
+        std::atomic<size_t> calls(0);
+        const uint32_t *it = MyStl::find_if(MyStl::execution::par, v.data(), v.data() + n, 1u,
+                                            [&](uint32_t x, uint32_t y)
+        {
+            calls.fetch_add(1, std::memory_order_relaxed);
+            return x == y;
+        });
+        assert(static_cast<size_t>(it - v.data()) == pos);
+        if (pos < n / 8)
+            assert(calls.load() < n / 4);
+        v[pos] = 0;
+        v[n - 1 - (n - 1 - pos) / 2] = 0;
+    }
+    assert(MyStl::find(MyStl::execution::par, v.data(), v.data() + n, 1u) == v.data() + n);
+
+    std::atomic<size_t> calls(0);
+    v[10] = 1;
+    bool any = MyStl::any_of(MyStl::execution::par, v.data(), v.data() + n, [&](uint32_t x)
+    {
+        calls.fetch_add(1, std::memory_order_relaxed);
+        return x == 1;
+    });
+    assert(any && calls.load() < n / 4);
+    (void)any;
+    assert(!MyStl::all_of(MyStl::execution::par, v.data(), v.data() + n, [](uint32_t x) { return x == 0; }));
+    assert(MyStl::none_of(MyStl::execution::par, v.data() + 11, v.data() + n, [](uint32_t x) { return x == 1; }));
+}
+
+// 任务中抛出的异常在调用线程上重新抛出；抛出之前其他块都已结束，线程池之后仍然可用
+void test_exception()
+{
+    const size_t n = 1000000;
+    std::vector<uint64_t> v(n, 1);
+    for (auto bad : {size_t(0), n / 2, n - 1})
+    {
+        std::atomic<size_t> visited(0);
+        bool caught = false;
+        try
+        {
+            MyStl::for_each(MyStl::execution::par, v.data(), v.data() + n, [&](uint64_t &x)
+            {
+                if (static_cast<size_t>(&x - v.data()) == bad)
+                    throw std::runtime_error("bad element");
+                visited.fetch_add(1, std::memory_order_relaxed);
+            });
+        }
+        catch (const std::runtime_error &e)
+        {
+            caught = std::string(e.what()) == "bad element";
+        }
+        assert(caught);
+        assert(visited.load() < n);
+
+        caught = false;
+        std::vector<uint64_t> out(n);
+        try
+        {
+            MyStl::copy_if(MyStl::execution::par, v.data(), v.data() + n, out.data(), [&](const uint64_t &x)
+            {
+                if (static_cast<size_t>(&x - v.data()) == bad)
+                    throw std::logic_error("bad predicate");
+                return true;
+            });
+        }
+        catch (const std::logic_error&)
+        {
+            caught = true;
+        }
+        assert(caught);
+        (void)caught;
+    }
+    assert(MyStl::reduce(MyStl::execution::par, v.data(), v.data() + n, uint64_t(0)) == n);
+}
+
+} // namespace
+
+int main()
+{
+    bool configured = MyStl::thread_pool::configure(4);
+    assert(configured && MyStl::thread_pool::instance().concurrency() == 4);
+    (void)configured;
+    test_scan();
+    test_reduce();
+    test_select();
+    test_remove_if_objects();
+    test_find_cancel();
+    test_exception();
+    std::puts("parallel_algo_test: ok");
+    return 0;
+}
@@ -0,0 +1,346 @@
+// random.h 中 shuffle / shuffle_merge / sample 以及并行 shuffle 的均匀性测试（卡方检验）
+// 小区间统计每种排列或每个子集出现的次数，较长的区间统计每个元素落在每个位置（或被选中）的次数，
+// 卡方统计量与自由度 df 下 p = 1e-6 的上分位点（Wilson-Hilferty 近似）比较；种子固定，结果是确定的
+// 另外用一个有偏的朴素洗牌作对照，确认同样的检验能发现偏差
+// MYSTL_PAR_MIN_GRAIN 调小到 4，十几个元素的区间就会分块并行洗牌再逐层合并
+// g++ -std=c++14 -O2 -pthread -I.. random_test.cpp -o random_test && ./random_test
+
+#ifndef MYSTL_PAR_MIN_GRAIN
+#define MYSTL_PAR_MIN_GRAIN 4
+#endif
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "../list.h"
+#include "../parallel_algo.h"
+#include "../random.h"
+
+namespace
+{
+
+// 卡方统计量，每一格的期望次数都是 expected
+double chi_square(const std::vector<size_t> &counts, double expected)
+{
+    double s = 0;
+    for (size_t c : counts)
+    {
+        const double d = static_cast<double>(c) - expected;
+        s += d * d / expected;
+    }
+    return s;
+}
+
+// 自由度为 df 的卡方分布在 p = 1e-6 处的上分位点
+double chi_square_limit(size_t df)
+{
+    const double z = 4.753;
+    const double k = static_cast<double>(df);
+    const double t = 1 - 2 / (9 * k) + z * std::sqrt(2 / (9 * k));
+    return k * t * t * t;
+}
+
+bool uniform(const std::vector<size_t> &counts, double expected, size_t df, const char *what)
+{
+    const double s = chi_square(counts, expected);
+    const double limit = chi_square_limit(df);
+    if (s > limit)
+        std::printf("%s: chi-square %.1f > %.1f (df = %zu)\n", what, s, limit, df);
+    return s <= limit;
+}
+
+// 0..n-1 的排列在 n! 种排列中的序号（Lehmer 码）
+size_t permutation_rank(const int *p, size_t n)
+{
+    size_t rank = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        size_t smaller = 0;
+        for (size_t j = i + 1; j < n; ++j)
+            smaller += p[j] < p[i];
+        rank = rank * (n - i) + smaller;
+    }
+    return rank;
+}
+
+/*****************************************************************************************/
+// 5 个元素的 120 种排列出现的次数
+/*****************************************************************************************/
+const size_t perm_n = 5;
+const size_t perm_cells = 120;
+const size_t perm_trials = perm_cells * 400;
+
+template <class Shuffler>
+std::vector<size_t> permutation_counts(Shuffler shuffle_once)
+{
+    std::vector<size_t> counts(perm_cells);
+    int v[perm_n];
+    for (size_t t = 0; t < perm_trials; ++t)
+    {
+        for (size_t i = 0; i < perm_n; ++i)
+            v[i] = static_cast<int>(i);
+        shuffle_once(v);
+        ++counts[permutation_rank(v, perm_n)];
+    }
+    return counts;
+}
+
+template <class Shuffler>
+bool permutations_uniform(Shuffler shuffle_once, const char *what)
+{
+    return uniform(permutation_counts(shuffle_once), static_cast<double>(perm_trials) / perm_cells,
+                   perm_cells - 1, what);
+}
+
+// n 个元素中每个元素落在每个位置的次数；各行各列之和固定，自由度为 (n - 1)^2
+template <class Shuffler>
+bool positions_uniform(size_t n, size_t trials, Shuffler shuffle_once, const char *what)
+{
+    std::vector<size_t> counts(n * n);
+    std::vector<int> v(n);
+    for (size_t t = 0; t < trials; ++t)
+    {
+        for (size_t i = 0; i < n; ++i)
+            v[i] = static_cast<int>(i);
+        shuffle_once(v.data());
+        for (size_t i = 0; i < n; ++i)
+            ++counts[static_cast<size_t>(v[i]) * n + i];
+    }
+    return uniform(counts, static_cast<double>(trials) / static_cast<double>(n), (n - 1) * (n - 1), what);
+}
+
+/*****************************************************************************************/
+// shuffle
+/*****************************************************************************************/
+void test_shuffle()
+{
+    MyStl::xoshiro256ss xo(1);
+    MyStl::pcg32 pcg(2);
+    std::mt19937 mt(3);
+    assert(permutations_uniform([&](int *v) { MyStl::shuffle(v, v + perm_n, xo); }, "shuffle xoshiro256ss"));
+    assert(permutations_uniform([&](int *v) { MyStl::shuffle(v, v + perm_n, pcg); }, "shuffle pcg32"));
+    assert(permutations_uniform([&](int *v) { MyStl::shuffle(v, v + perm_n, mt); }, "shuffle mt19937"));
+    // 不预取的通用版本
+    assert(permutations_uniform([&](int *v) { MyStl::shuffle_dispatch<int*>(v, v + perm_n, xo); },
+                                "shuffle_dispatch"));
+
+    // 长度超过 shuffle_prefetch_distance，预取流水线的各个阶段都会用到
+    for (size_t n : {MyStl::shuffle_prefetch_distance, MyStl::shuffle_prefetch_distance + 1, size_t(64)})
+    {
+        assert(positions_uniform(n, n * 200, [&](int *v) { MyStl::shuffle(v, v + n, xo); }, "shuffle positions"));
+        assert(positions_uniform(n, n * 200, [&](int *v) { MyStl::shuffle(v, v + n, mt); },
+                                 "shuffle positions mt19937"));
+    }
+
+    // 预取版本与通用版本抽取随机数的顺序相同，同一个种子得到同一个排列
+    for (size_t n : {0u, 1u, 2u, 15u, 16u, 17u, 1000u})
+    {
+        std::vector<int> a(n), b(n);
+        for (size_t i = 0; i < n; ++i)
+            a[i] = b[i] = static_cast<int>(i);
+        MyStl::xoshiro256ss g1(n), g2(n);
+        MyStl::shuffle(a.data(), a.data() + n, g1);
+        MyStl::shuffle_dispatch<int*>(b.data(), b.data() + n, g2);
+        assert(a == b);
+        std::sort(a.begin(), a.end());
+        for (size_t i = 0; i < n; ++i)
+            assert(a[i] == static_cast<int>(i));
+    }
+}
+
+// 对照：每一步都在整个区间中选交换位置的朴素洗牌是有偏的，检验必须能发现
+void test_detects_bias()
+{
+    MyStl::xoshiro256ss g(4);
+    auto naive = [&](int *v)
+    {
+        for (size_t i = 0; i < perm_n; ++i)
+            MyStl::iter_swap(v + i, v + MyStl::uniform_index(g, perm_n));
+    };
+    const auto counts = permutation_counts(naive);
+    const double s = chi_square(counts, static_cast<double>(perm_trials) / perm_cells);
+    assert(s > chi_square_limit(perm_cells - 1));
+    (void)s;
+}
+
+/*****************************************************************************************/
+// shuffle_merge：两段各自均匀随机时，合并后整个区间均匀随机
+/*****************************************************************************************/
+void test_shuffle_merge()
+{
+    MyStl::xoshiro256ss g(5);
+    for (size_t n1 = 0; n1 <= perm_n; ++n1)
+    {
+        const size_t n2 = perm_n - n1;
+        assert(permutations_uniform([&](int *v)
+        {
+            MyStl::shuffle(v, v + n1, g);
+            MyStl::shuffle(v + n1, v + perm_n, g);
+            MyStl::shuffle_merge(v, n1, n2, g);
+        }, "shuffle_merge"));
+    }
+    // 较长的区间：硬币会跨过一个 64 位随机数，也会出现一段先取完、其余元素随机插入的收尾
+    for (size_t n1 : {1u, 20u, 70u, 139u})
+    {
+        const size_t n = 140;
+        assert(positions_uniform(n, n * 100, [&](int *v)
+        {
+            MyStl::shuffle(v, v + n1, g);
+            MyStl::shuffle(v + n1, v + n, g);
+            MyStl::shuffle_merge(v, n1, n - n1, g);
+        }, "shuffle_merge positions"));
+    }
+}
+
+/*****************************************************************************************/
+// 并行 shuffle：分块洗牌再逐层合并，块数为奇数时最后一块留到下一层
+/*****************************************************************************************/
+void test_shuffle_par()
+{
+    MyStl::xoshiro256ss g(6);
+    for (size_t n : {8u, 12u, 20u, 37u})
+    {
+        assert(positions_uniform(n, n * 300, [&](int *v) { MyStl::shuffle(MyStl::execution::par, v, v + n, g); },
+                                 "shuffle par positions"));
+    }
+    // 只有 8 个元素时统计所有 40320 种排列
+    std::vector<size_t> counts(40320);
+    int v[8];
+    for (size_t t = 0; t < counts.size() * 20; ++t)
+    {
+        for (int i = 0; i < 8; ++i)
+            v[i] = i;
+        MyStl::shuffle(MyStl::execution::par, v, v + 8, g);
+        ++counts[permutation_rank(v, 8)];
+    }
+    assert(uniform(counts, 20, counts.size() - 1, "shuffle par permutations"));
+}
+
+/*****************************************************************************************/
+// sample
+/*****************************************************************************************/
+// 只能遍历一次的输入迭代器，sample 走蓄水池抽样
+struct input_iter : public MyStl::iterator<MyStl::input_iterator_tag, int>
+{
+    const int *p;
+    explicit input_iter(const int *x) : p(x) {}
+    const int &operator*() const { return *p; }
+    input_iter &operator++()
+    {
+        ++p;
+        return *this;
+    }
+    bool operator==(const input_iter &rhs) const { return p == rhs.p; }
+    bool operator!=(const input_iter &rhs) const { return p != rhs.p; }
+};
+
+// 从 0..N-1 中选 k 个，统计每个 k 元子集（按位掩码）出现的次数
+template <class Sampler>
+bool subsets_uniform(size_t N, size_t k, size_t trials_per_subset, Sampler sample_once, bool keeps_order,
+                     const char *what)
+{
+    std::vector<int> in(N);
+    for (size_t i = 0; i < N; ++i)
+        in[i] = static_cast<int>(i);
+    std::vector<size_t> by_mask(static_cast<size_t>(1) << N);
+    size_t subsets = 0;
+    for (size_t m = 0; m < by_mask.size(); ++m)
+        subsets += static_cast<size_t>(__builtin_popcountll(m)) == k;
+    std::vector<int> out(k);
+    for (size_t t = 0; t < subsets * trials_per_subset; ++t)
+    {
+        int *end = sample_once(in.data(), in.data() + N, out.data(), k);
+        assert(end == out.data() + k);
+        size_t mask = 0;
+        for (size_t i = 0; i < k; ++i)
+        {
+            assert((mask & (static_cast<size_t>(1) << out[i])) == 0);
+            mask |= static_cast<size_t>(1) << out[i];
+            assert(!keeps_order || i == 0 || out[i - 1] < out[i]);
+        }
+        ++by_mask[mask];
+        (void)end;
+    }
+    std::vector<size_t> counts;
+    for (size_t m = 0; m < by_mask.size(); ++m)
+    {
+        if (static_cast<size_t>(__builtin_popcountll(m)) == k)
+            counts.push_back(by_mask[m]);
+    }
+    return uniform(counts, static_cast<double>(trials_per_subset), subsets - 1, what);
+}
+
+// 从 0..N-1 中选 k 个，统计每个元素被选中的次数，期望都是 trials * k / N
+template <class Sampler>
+bool inclusion_uniform(size_t N, size_t k, size_t trials, Sampler sample_once, const char *what)
+{
+    std::vector<int> in(N);
+    for (size_t i = 0; i < N; ++i)
+        in[i] = static_cast<int>(i);
+    std::vector<size_t> counts(N);
+    std::vector<int> out(k);
+    for (size_t t = 0; t < trials; ++t)
+    {
+        sample_once(in.data(), in.data() + N, out.data(), k);
+        for (int x : out)
+            ++counts[static_cast<size_t>(x)];
+    }
+    return uniform(counts, static_cast<double>(trials) * k / N, N - 1, what);
+}
+
+void test_sample()
+{
+    MyStl::xoshiro256ss g(7);
+    auto selection = [&](const int *first, const int *last, int *out, size_t k)
+    {
+        return MyStl::sample(first, last, out, k, g);
+    };
+    auto reservoir = [&](const int *first, const int *last, int *out, size_t k)
+    {
+        return MyStl::sample(input_iter(first), input_iter(last), out, k, g);
+    };
+    for (size_t k : {1u, 3u, 5u, 9u})
+    {
+        assert(subsets_uniform(10, k, 200, selection, true, "sample (selection)"));
+        assert(subsets_uniform(10, k, 200, reservoir, false, "sample (reservoir)"));
+    }
+    // 较长的输入：蓄水池填满后按几何分布跳过元素
+    for (size_t k : {1u, 4u, 50u})
+    {
+        assert(inclusion_uniform(2000, k, 2000 * 100 / k, selection, "sample inclusion (selection)"));
+        assert(inclusion_uniform(2000, k, 2000 * 100 / k, reservoir, "sample inclusion (reservoir)"));
+    }
+
+    // 要选的个数不少于元素个数时全部选出；list 走选择抽样
+    int in[6] = {0, 1, 2, 3, 4, 5};
+    int out[8];
+    assert(MyStl::sample(in, in + 6, out, 8, g) == out + 6 && std::equal(in, in + 6, out));
+    int *end = MyStl::sample(input_iter(in), input_iter(in + 6), out, 6, g);
+    assert(end == out + 6 && std::equal(in, in + 6, out));
+    assert(MyStl::sample(in, in + 6, out, 0, g) == out);
+    MyStl::list<int> l(in, in + 6);
+    end = MyStl::sample(l.begin(), l.end(), out, 3, g);
+    assert(end == out + 3 && out[0] < out[1] && out[1] < out[2]);
+    (void)end;
+}
+
+} // namespace
+
+int main()
+{
+    bool configured = MyStl::thread_pool::configure(4);
+    assert(configured);
+    (void)configured;
+    test_shuffle();
+    test_detects_bias();
+    test_shuffle_merge();
+    test_shuffle_par();
+    test_sample();
+    std::printf("random_test: ok\n");
+    return 0;
+}
@@ -0,0 +1,259 @@
+// rotate 的测试，结果与 std::rotate 对照，并检查返回值是原 *first 的新位置
+// 覆盖每种迭代器类别：前向迭代器的块交换、list 的三次翻转、随机访问迭代器的置换环（rotate_cycles），
+// 以及可平凡拷贝元素的原生指针：较短一段在 rotate_stack_bytes（256 B）和 rotate_buffer_bytes（1 MiB）两侧时
+// 分别走栈上缓冲区、临时缓冲区和块交换；rotate_bytes / rotate_blocks 也在这些边界上直接调用
+// g++ -std=c++14 -O2 -I.. rotate_test.cpp -o rotate_test && ./rotate_test
+// 另外用 -DMYSTL_NO_AVX2 和 -DMYSTL_NO_SIMD 各构建一次
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../algo.h"
+#include "../list.h"
+#include "simd_test_util.h"
+
+namespace
+{
+
+std::mt19937_64 rng(48);
+
+// 24 字节，256 不是它的整数倍
+struct rec
+{
+    uint64_t a, b, c;
+};
+
+bool operator==(const rec &x, const rec &y)
+{
+    return x.a == y.a && x.b == y.b && x.c == y.c;
+}
+
+template <class T>
+T make(uint64_t x)
+{
+    return static_cast<T>(x);
+}
+
+template <>
+rec make<rec>(uint64_t x)
+{
+    return rec{x, ~x, x * 0x9e3779b97f4a7c15ull};
+}
+
+template <>
+std::string make<std::string>(uint64_t x)
+{
+    return std::to_string(x);
+}
+
+template <class T>
+std::vector<T> sequence(size_t n)
+{
+    std::vector<T> v(n);
+    const uint64_t seed = rng();
+    for (size_t i = 0; i < n; ++i)
+        v[i] = make<T>(seed + i);
+    return v;
+}
+
+// 只提供前向迭代器的包装，用来走 forward_iterator_tag 版本
+template <class T>
+struct forward_iter : public MyStl::iterator<MyStl::forward_iterator_tag, T>
+{
+    T *p;
+    explicit forward_iter(T *x) : p(x) {}
+    T &operator*() const { return *p; }
+    forward_iter &operator++()
+    {
+        ++p;
+        return *this;
+    }
+    forward_iter operator++(int)
+    {
+        forward_iter tmp(*this);
+        ++p;
+        return tmp;
+    }
+    bool operator==(const forward_iter &rhs) const { return p == rhs.p; }
+    bool operator!=(const forward_iter &rhs) const { return p != rhs.p; }
+};
+
+// 对 v 的 [0, k) 与 [k, n) 调用 rotate_fn，与 std::rotate 对照
+template <class T, class Rotate>
+void check(size_t n, size_t k, Rotate rotate_fn)
+{
+    std::vector<T> v = sequence<T>(n), e(v);
+    std::rotate(e.begin(), e.begin() + k, e.end());
+    T *r = rotate_fn(v.data(), v.data() + k, v.data() + n);
+    assert(v == e);
+    assert(r == v.data() + (n - k));
+    (void)r;
+}
+
+template <class T>
+T* public_rotate(T *first, T *middle, T *last)
+{
+    return MyStl::rotate(first, middle, last);
+}
+
+template <class T>
+T* forward_rotate(T *first, T *middle, T *last)
+{
+    return MyStl::rotate(forward_iter<T>(first), forward_iter<T>(middle), forward_iter<T>(last)).p;
+}
+
+// rotate_cycles 和 rotate_blocks 与 rotate_dispatch 一样要求两段都非空，由 rotate 检查
+template <class T>
+T* cycles_rotate(T *first, T *middle, T *last)
+{
+    if (first == middle || middle == last)
+        return first + (last - middle);
+    return MyStl::rotate_cycles(first, middle, last);
+}
+
+template <class T>
+T* blocks_rotate(T *first, T *middle, T *last)
+{
+    if (first == middle || middle == last)
+        return first + (last - middle);
+    return MyStl::rotate_blocks(first, middle, last);
+}
+
+template <class T>
+T* bytes_rotate(T *first, T *middle, T *last)
+{
+    const size_t left = static_cast<size_t>(middle - first) * sizeof(T);
+    const size_t right = static_cast<size_t>(last - middle) * sizeof(T);
+    std::vector<unsigned char> buffer((left < right ? left : right) + 1);
+    MyStl::rotate_bytes(reinterpret_cast<unsigned char*>(first), left, right, buffer.data());
+    return first + (last - middle);
+}
+
+// 长度不超过 40 时遍历所有旋转量
+template <class T>
+void test_small()
+{
+    for (size_t n = 0; n <= 40; ++n)
+    {
+        for (size_t k = 0; k <= n; ++k)
+        {
+            check<T>(n, k, public_rotate<T>);
+            check<T>(n, k, forward_rotate<T>);
+            check<T>(n, k, cycles_rotate<T>);
+        }
+    }
+}
+
+template <class T>
+void test_small_trivial()
+{
+    test_small<T>();
+    for (size_t n = 0; n <= 40; ++n)
+    {
+        for (size_t k = 0; k <= n; ++k)
+        {
+            check<T>(n, k, blocks_rotate<T>);
+            check<T>(n, k, bytes_rotate<T>);
+        }
+    }
+}
+
+// 较短一段为 s 个元素，较长一段取几种长度，较短一段分别在左、在右
+template <class T, class Rotate>
+void check_short_side(size_t s, Rotate rotate_fn)
+{
+    for (size_t l : {s, s + 1, 2 * s + 3, 5 * s + 17})
+    {
+        check<T>(s + l, s, rotate_fn);
+        check<T>(s + l, l, rotate_fn);
+    }
+}
+
+// 较短一段的字节数在 256 B 和 1 MiB 两侧
+template <class T>
+void test_boundaries()
+{
+    const size_t stack = MyStl::rotate_stack_bytes / sizeof(T);
+    const size_t heap = MyStl::rotate_buffer_bytes / sizeof(T);
+    for (size_t s : {stack - 1, stack, stack + 1, 2 * stack + 1, heap - 1, heap, heap + 1})
+    {
+        check_short_side<T>(s, public_rotate<T>);
+        check_short_side<T>(s, blocks_rotate<T>);
+        check_short_side<T>(s, bytes_rotate<T>);
+    }
+    // 块交换若干轮后剩下的一段恰好跨过栈上缓冲区的大小
+    const size_t n = 7 * heap / 2;
+    for (size_t k : {stack - 1, stack, stack + 1, heap + stack, n - heap - stack - 1})
+    {
+        check<T>(n, k, public_rotate<T>);
+        check<T>(n, k, blocks_rotate<T>);
+    }
+}
+
+// 双向迭代器：list 走三次翻转
+void test_list()
+{
+    for (size_t n = 0; n <= 30; ++n)
+    {
+        for (size_t k = 0; k <= n; ++k)
+        {
+            std::vector<int> e(n);
+            for (size_t i = 0; i < n; ++i)
+                e[i] = static_cast<int>(i);
+            MyStl::list<int> l(e.data(), e.data() + n);
+            auto middle = l.begin();
+            MyStl::advance(middle, k);
+            auto r = MyStl::rotate(l.begin(), middle, l.end());
+            std::rotate(e.begin(), e.begin() + k, e.end());
+            size_t i = 0;
+            for (auto it = l.begin(); it != l.end(); ++it, ++i)
+            {
+                assert(*it == e[i]);
+                if (i == n - k)
+                    assert(it == r);
+            }
+            assert(k != 0 || r == l.end());
+        }
+    }
+}
+
+void test_rotate_copy()
+{
+    for (size_t n = 0; n <= 20; ++n)
+    {
+        for (size_t k = 0; k <= n; ++k)
+        {
+            std::vector<int> v(n), out(n + 1, -1), e(n);
+            for (size_t i = 0; i < n; ++i)
+                v[i] = static_cast<int>(i);
+            std::rotate_copy(v.begin(), v.begin() + k, v.end(), e.begin());
+            int *r = MyStl::rotate_copy(v.data(), v.data() + k, v.data() + n, out.data());
+            assert(r == out.data() + n && out[n] == -1);
+            assert(std::equal(e.begin(), e.end(), out.begin()));
+            (void)r;
+        }
+    }
+}
+
+} // namespace
+
+int main()
+{
+    test_small_trivial<uint8_t>();
+    test_small_trivial<uint32_t>();
+    test_small_trivial<uint64_t>();
+    test_small_trivial<rec>();
+    test_small<std::string>();
+    test_boundaries<uint8_t>();
+    test_boundaries<uint32_t>();
+    test_boundaries<uint64_t>();
+    test_boundaries<rec>();
+    test_list();
+    test_rotate_copy();
+    simd_test::report("rotate_test");
+    return 0;
+}
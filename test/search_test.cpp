@@ -0,0 +1,91 @@
+// MyStl::search 与 boyer_moore_horspool_searcher 的测试
+// 各种元素类型和迭代器的结果都与 std::search 对照
+// g++ -std=c++14 -O2 -I.. search_test.cpp -o search_test && ./search_test
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "../algo.h"
+#include "../vector.h"
+
+namespace
+{
+
+std::mt19937 rng(13);
+
+// 随机生成文本和模式串，一半的情况把模式串嵌进文本，保证有匹配
+// alphabet 中的值彼此只在高位或只在低位不同，用来检验宽类型跳跃表的散列
+template <class T>
+void make_case(std::vector<T> &text, std::vector<T> &pat, const std::vector<T> &alphabet, size_t round)
+{
+    size_t n = rng() % 300;
+    size_t m = rng() % (round % 10 == 0 ? 120 : 8);
+    size_t alpha = 1 + rng() % alphabet.size();
+    text.resize(n);
+    pat.resize(m);
+    for (auto &c : text) c = alphabet[rng() % alpha];
+    for (auto &c : pat)  c = alphabet[rng() % alpha];
+    if (m <= n && n > 0 && rng() % 2)
+        std::copy(pat.begin(), pat.end(), text.begin() + rng() % (n - m + 1));
+}
+
+template <class T>
+void check_type(const std::vector<T> &alphabet)
+{
+    for (size_t round = 0; round < 20000; ++round)
+    {
+        std::vector<T> text, pat;
+        make_case(text, pat, alphabet, round);
+        const ptrdiff_t expected = std::search(text.begin(), text.end(), pat.begin(), pat.end()) - text.begin();
+        const T *tp = text.data();
+        const T *pp = pat.data();
+        const size_t n = text.size(), m = pat.size();
+
+        // 原生指针
+        assert(MyStl::search(tp, tp + n, pp, pp + m) - tp == expected);
+
+        // 预处理一次的查找器
+        MyStl::boyer_moore_horspool_searcher<const T*> searcher(pp, pp + m);
+        auto r = searcher(tp, tp + n);
+        assert(r.first - tp == expected);
+        assert(r.first == tp + n || static_cast<size_t>(r.second - r.first) == m);
+        assert(MyStl::search(tp, tp + n, searcher) - tp == expected);
+
+        // 非指针的随机访问迭代器
+        MyStl::vector<T> vt(tp, tp + n), vp(pp, pp + m);
+        assert(MyStl::search(vt.begin(), vt.end(), vp.begin(), vp.end()) - vt.begin() == expected);
+    }
+}
+
+// 文本中大量出现模式串末字符的情况：最坏情况下也要得到正确结果
+void test_periodic()
+{
+    std::vector<int> text(100000, 7);
+    std::vector<int> pat(1000, 7);
+    pat[0] = 8;
+    assert(MyStl::search(text.data(), text.data() + text.size(), pat.data(), pat.data() + pat.size())
+           == text.data() + text.size());
+    text[50000] = 8;
+    assert(MyStl::search(text.data(), text.data() + text.size(), pat.data(), pat.data() + pat.size())
+           == text.data() + 50000);
+}
+
+} // namespace
+
+int main()
+{
+    check_type<char>({'a', 'b', 'c', 'd'});
+    check_type<unsigned char>({0, 1, 0x80, 0xff});
+    check_type<uint16_t>({0x0001, 0x0101, 0x0201, 0x8001});
+    check_type<wchar_t>({L'a', L'š', L'中', L'丮'});
+    check_type<char16_t>({u'a', u'Ā', u'Ȁ', u'￿'});
+    check_type<int>({-1, 0, 256, 65536});
+    check_type<long long>({1LL, 1LL << 40, (1LL << 40) + 1, -(1LL << 62)});
+    test_periodic();
+    std::puts("search_test: ok");
+    return 0;
+}
@@ -0,0 +1,389 @@
+// partition / stable_partition / nth_element / partial_sort / partial_sort_copy / top_k 与 heap 算法的测试，结果与 std 的算法对照
+// 覆盖随机、有序、逆序、全部相等、少量不同值和风琴形的输入，指针、vector 和 list 迭代器，自定义比较器；
+// stable_partition 的缓冲区不足时的分治路径、nth_element 的中位数的中位数路径直接调用检查；
+// 只能移动的元素（unique_ptr）用于所有原地重排的算法，检查不拷贝、不泄漏
+// g++ -std=c++14 -O2 -I.. select_heap_test.cpp -o select_heap_test && ./select_heap_test
+
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "../algo.h"
+#include "../list.h"
+#include "../vector.h"
+
+namespace
+{
+
+std::mt19937_64 rng(45);
+
+const size_t sizes[] = {0, 1, 2, 3, 5, 16, 17, 63, 64, 127, 128, 129, 200, 1000, 4097};
+
+// 各种分布的输入
+std::vector<int> make_input(size_t n, int shape)
+{
+    std::vector<int> v(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        const int x = static_cast<int>(i);
+        switch (shape)
+        {
+        case 0: v[i] = static_cast<int>(rng() % 1000000); break;        // 随机
+        case 1: v[i] = x; break;                                         // 有序
+        case 2: v[i] = static_cast<int>(n) - x; break;                   // 逆序
+        case 3: v[i] = 7; break;                                         // 全部相等
+        case 4: v[i] = static_cast<int>(rng() % 3); break;               // 少量不同值
+        default: v[i] = x < static_cast<int>(n / 2) ? x : static_cast<int>(n) - x; break;   // 风琴形
+        }
+    }
+    return v;
+}
+
+const int shapes = 6;
+
+std::vector<int> sorted_copy(std::vector<int> v)
+{
+    std::sort(v.begin(), v.end());
+    return v;
+}
+
+// 只能移动的元素，live 统计存活的对象
+long live = 0;
+
+struct boxed
+{
+    std::unique_ptr<int> p;
+    explicit boxed(int v) : p(new int(v)) { ++live; }
+    boxed(boxed &&rhs) noexcept : p(std::move(rhs.p)) { ++live; }
+    boxed& operator=(boxed &&rhs) noexcept { p = std::move(rhs.p); return *this; }
+    ~boxed() { --live; }
+};
+
+struct boxed_less
+{
+    bool operator()(const boxed &a, const boxed &b) const { return *a.p < *b.p; }
+};
+
+std::vector<boxed> box(const std::vector<int> &v)
+{
+    std::vector<boxed> b;
+    b.reserve(v.size());
+    for (int x : v)
+        b.emplace_back(x);
+    return b;
+}
+
+std::vector<int> unbox(const std::vector<boxed> &b)
+{
+    std::vector<int> v;
+    for (const auto &x : b)
+        v.push_back(*x.p);
+    return v;
+}
+
+// MyStl 的迭代器不带 std::iterator_traits，逐个取出
+std::vector<int> to_vector(const MyStl::list<int> &l)
+{
+    std::vector<int> v;
+    for (auto it = l.begin(); it != l.end(); ++it)
+        v.push_back(*it);
+    return v;
+}
+
+/*****************************************************************************************/
+// partition / stable_partition
+/*****************************************************************************************/
+void test_partition()
+{
+    for (size_t n : sizes)
+    {
+        for (unsigned percent : {0u, 1u, 50u, 99u, 100u})
+        {
+            std::vector<int> v(n);
+            for (auto &x : v)
+                x = static_cast<int>(rng() % 1000);
+            const int cut = static_cast<int>(percent * 10);
+            auto pred = [cut](int x) { return x < cut; };
+            const size_t trues = static_cast<size_t>(std::count_if(v.begin(), v.end(), pred));
+
+            // 指针（分块版本）、vector 迭代器和 list（双向版本）
+            std::vector<int> a(v);
+            int *mid = MyStl::partition(a.data(), a.data() + n, pred);
+            assert(static_cast<size_t>(mid - a.data()) == trues);
+            assert(std::is_partitioned(a.begin(), a.end(), pred));
+            assert(sorted_copy(a) == sorted_copy(v));
+
+            MyStl::vector<int> mv(v.data(), v.data() + n);
+            auto mmid = MyStl::partition(mv.begin(), mv.end(), pred);
+            assert(static_cast<size_t>(mmid - mv.begin()) == trues);
+            assert(std::is_partitioned(mv.begin(), mv.end(), pred));
+
+            MyStl::list<int> ml(v.data(), v.data() + n);
+            auto lmid = MyStl::partition(ml.begin(), ml.end(), pred);
+            assert(static_cast<size_t>(MyStl::distance(ml.begin(), lmid)) == trues);
+            std::vector<int> lv = to_vector(ml);
+            assert(std::is_partitioned(lv.begin(), lv.end(), pred));
+
+            std::vector<int> s(v), expected(v);
+            int *smid = MyStl::stable_partition(s.data(), s.data() + n, pred);
+            std::stable_partition(expected.begin(), expected.end(), pred);
+            assert(static_cast<size_t>(smid - s.data()) == trues);
+            assert(s == expected);
+
+            MyStl::list<int> sl(v.data(), v.data() + n);
+            MyStl::stable_partition(sl.begin(), sl.end(), pred);
+            assert(to_vector(sl) == expected);
+            (void)mid; (void)mmid; (void)lmid; (void)smid;
+        }
+    }
+}
+
+// 缓冲区不足时的分治路径：直接用小缓冲区调用 stable_partition_adaptive
+void test_stable_partition_small_buffer()
+{
+    for (size_t n : {2u, 5u, 17u, 100u, 1000u})
+    {
+        for (ptrdiff_t buffer_size : {0, 1, 3, 16})
+        {
+            std::vector<int> v(n);
+            for (auto &x : v)
+                x = static_cast<int>(rng() % 100);
+            auto pred = [](int x) { return x % 3 == 0; };
+            std::vector<int> expected(v);
+            std::stable_partition(expected.begin(), expected.end(), pred);
+            MyStl::move_buffer<int> buf(buffer_size);
+            int *mid = MyStl::stable_partition_adaptive(v.data(), v.data() + n, pred, static_cast<ptrdiff_t>(n),
+                                                        buf.begin(), buf.size());
+            assert(v == expected);
+            assert(mid == v.data() + std::count_if(v.begin(), v.end(), pred));
+            (void)mid;
+        }
+    }
+}
+
+/*****************************************************************************************/
+// nth_element / partial_sort / partial_sort_copy / top_k
+/*****************************************************************************************/
+void check_nth(std::vector<int> v, size_t k)
+{
+    const std::vector<int> expected = sorted_copy(v);
+    MyStl::nth_element(v.data(), v.data() + k, v.data() + v.size());
+    if (k == v.size())
+    {
+        assert(sorted_copy(v) == expected);
+        return;
+    }
+    assert(v[k] == expected[k]);
+    for (size_t i = 0; i < k; ++i)
+        assert(!(v[k] < v[i]));
+    for (size_t i = k + 1; i < v.size(); ++i)
+        assert(!(v[i] < v[k]));
+    assert(sorted_copy(v) == expected);
+}
+
+void test_nth_element()
+{
+    for (size_t n : sizes)
+    {
+        for (int shape = 0; shape < shapes; ++shape)
+        {
+            const std::vector<int> v = make_input(n, shape);
+            for (size_t k : {size_t(0), n / 4, n / 2, n > 0 ? n - 1 : 0, n})
+                check_nth(v, k);
+        }
+    }
+    // 中位数的中位数的路径直接调用
+    for (size_t n : {17u, 18u, 19u, 20u, 21u, 100u, 1000u, 5000u})
+    {
+        for (int shape = 0; shape < shapes; ++shape)
+        {
+            std::vector<int> v = make_input(n, shape);
+            const std::vector<int> expected = sorted_copy(v);
+            for (size_t k : {size_t(0), n / 3, n - 1})
+            {
+                std::vector<int> w(v);
+                MyStl::median_of_medians_select(w.data(), w.data() + k, w.data() + n, MyStl::less<int>());
+                assert(w[k] == expected[k]);
+                for (size_t i = 0; i < k; ++i)
+                    assert(!(w[k] < w[i]));
+                for (size_t i = k + 1; i < n; ++i)
+                    assert(!(w[i] < w[k]));
+            }
+        }
+    }
+}
+
+void test_partial_sort()
+{
+    for (size_t n : sizes)
+    {
+        for (int shape = 0; shape < shapes; ++shape)
+        {
+            const std::vector<int> v = make_input(n, shape);
+            const std::vector<int> expected = sorted_copy(v);
+            for (size_t k : {size_t(0), size_t(1), n / 2, n})
+            {
+                if (k > n)
+                    continue;
+                std::vector<int> w(v);
+                MyStl::partial_sort(w.data(), w.data() + k, w.data() + n);
+                assert(std::equal(w.begin(), w.begin() + k, expected.begin()));
+                assert(sorted_copy(w) == expected);
+
+                // 比较器为 greater 时得到最大的 k 个，递减排列
+                std::vector<int> g(v);
+                MyStl::partial_sort(g.data(), g.data() + k, g.data() + n, MyStl::greater<int>());
+                assert(std::equal(g.begin(), g.begin() + k, expected.rbegin()));
+
+                // partial_sort_copy 与 top_k 只需要输入迭代器，结果区间可以比输入长
+                MyStl::list<int> input(v.data(), v.data() + n);
+                for (size_t out_len : {k, k + 3})
+                {
+                    std::vector<int> out(out_len, -1);
+                    int *end = MyStl::partial_sort_copy(input.begin(), input.end(), out.data(), out.data() + out_len);
+                    const size_t written = std::min(out_len, n);
+                    assert(static_cast<size_t>(end - out.data()) == written);
+                    assert(std::equal(out.begin(), out.begin() + written, expected.begin()));
+
+                    std::vector<int> top(out_len, -1);
+                    end = MyStl::top_k(input.begin(), input.end(), top.data(), top.data() + out_len);
+                    assert(static_cast<size_t>(end - top.data()) == written);
+                    assert(std::equal(top.begin(), top.begin() + written, expected.rbegin()));
+                    (void)end;
+                }
+            }
+        }
+    }
+}
+
+/*****************************************************************************************/
+// heap
+/*****************************************************************************************/
+template <class Compared>
+void check_heap(const std::vector<int> &v, Compared comp)
+{
+    // make_heap
+    std::vector<int> h(v);
+    MyStl::make_heap(h.data(), h.data() + h.size(), comp);
+    assert(std::is_heap(h.begin(), h.end(), comp));
+    assert(sorted_copy(h) == sorted_copy(v));
+
+    // 逐个 push_heap
+    std::vector<int> p;
+    for (int x : v)
+    {
+        p.push_back(x);
+        MyStl::push_heap(p.data(), p.data() + p.size(), comp);
+        assert(std::is_heap(p.begin(), p.end(), comp));
+    }
+
+    // 逐个 pop_heap：依次取出 comp 意义下的最大值
+    std::vector<int> expected(v);
+    std::sort(expected.begin(), expected.end(), comp);
+    for (size_t len = p.size(); len > 0; --len)
+    {
+        MyStl::pop_heap(p.data(), p.data() + len, comp);
+        assert(p[len - 1] == expected[len - 1]);
+        assert(std::is_heap(p.begin(), p.begin() + (len - 1), comp));
+    }
+
+    MyStl::sort_heap(h.data(), h.data() + h.size(), comp);
+    assert(h == expected);
+}
+
+void test_heap()
+{
+    for (size_t n : sizes)
+    {
+        for (int shape = 0; shape < shapes; ++shape)
+        {
+            const std::vector<int> v = make_input(n, shape);
+            check_heap(v, MyStl::less<int>());
+            check_heap(v, MyStl::greater<int>());
+        }
+    }
+    // 非指针的随机访问迭代器
+    std::vector<int> v = make_input(300, 0);
+    MyStl::vector<int> mv(v.data(), v.data() + v.size());
+    MyStl::make_heap(mv.begin(), mv.end());
+    assert(std::is_heap(mv.begin(), mv.end()));
+    MyStl::sort_heap(mv.begin(), mv.end());
+    assert(std::vector<int>(mv.begin(), mv.end()) == sorted_copy(v));
+}
+
+/*****************************************************************************************/
+// 只能移动的元素
+/*****************************************************************************************/
+void test_move_only()
+{
+    boxed_less less;
+    for (size_t n : sizes)
+    {
+        for (int shape = 0; shape < shapes; ++shape)
+        {
+            const std::vector<int> v = make_input(n, shape);
+            const std::vector<int> expected = sorted_copy(v);
+            const int median = n ? expected[n / 2] : 0;
+            auto pred = [median](const boxed &b) { return *b.p < median; };
+            auto ipred = [median](int x) { return x < median; };
+
+            std::vector<boxed> b = box(v);
+            MyStl::partition(b.data(), b.data() + n, pred);
+            std::vector<int> r = unbox(b);
+            assert(std::is_partitioned(r.begin(), r.end(), ipred) && sorted_copy(r) == expected);
+
+            b = box(v);
+            MyStl::stable_partition(b.data(), b.data() + n, pred);
+            std::vector<int> sp(v);
+            std::stable_partition(sp.begin(), sp.end(), ipred);
+            assert(unbox(b) == sp);
+
+            if (n > 0)
+            {
+                b = box(v);
+                MyStl::nth_element(b.data(), b.data() + n / 2, b.data() + n, less);
+                assert(*b[n / 2].p == expected[n / 2]);
+                assert(sorted_copy(unbox(b)) == expected);
+            }
+
+            b = box(v);
+            MyStl::partial_sort(b.data(), b.data() + n / 2, b.data() + n, less);
+            r = unbox(b);
+            assert(std::equal(r.begin(), r.begin() + n / 2, expected.begin()));
+
+            b = box(v);
+            MyStl::make_heap(b.data(), b.data() + n, less);
+            for (size_t len = n; len > 0; --len)
+                MyStl::pop_heap(b.data(), b.data() + len, less);
+            assert(unbox(b) == expected);
+            for (size_t len = 1; len <= n; ++len)
+                MyStl::push_heap(b.data(), b.data() + len, less);
+            MyStl::sort_heap(b.data(), b.data() + n, less);
+            assert(unbox(b) == expected);
+
+            // 元素只被移动：每个 unique_ptr 仍然有值
+            for (const auto &x : b)
+                assert(x.p != nullptr);
+            (void)median;
+        }
+    }
+    assert(live == 0);
+}
+
+} // namespace
+
+int main()
+{
+    test_partition();
+    test_stable_partition_small_buffer();
+    test_nth_element();
+    test_partial_sort();
+    test_heap();
+    test_move_only();
+    std::printf("select_heap_test: ok\n");
+    return 0;
+}
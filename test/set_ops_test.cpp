@@ -0,0 +1,304 @@
+// set_union / set_intersection / set_difference / set_symmetric_difference 与 kway_merge 的测试，结果与 std 的算法对照
+// 覆盖多重集合（重复元素）、空区间、list 迭代器、自定义比较器、4 字节整数走 simd::intersect32 的路径（含负数和重复元素）；
+// 倍增查找的切换点：长度比恰好在 set_gallop_ratio 两侧时，用计数比较器确认走的是逐个归并还是倍增查找；
+// kway_merge 检查 k 从 0 到 100、含空区间、相等元素按区间先后输出（稳定）
+// g++ -std=c++14 -O2 -I.. set_ops_test.cpp -o set_ops_test && ./set_ops_test
+// 另外用 -DMYSTL_NO_AVX2 和 -DMYSTL_NO_SIMD 各构建一次
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <vector>
+
+#include "../algo.h"
+#include "../list.h"
+#include "simd_test_util.h"
+
+namespace
+{
+
+std::mt19937_64 rng(46);
+
+// 有序的随机多重集合，值取自 [0, range)
+template <class T>
+std::vector<T> sorted_random(size_t n, uint64_t range, int64_t bias = 0)
+{
+    std::vector<T> v(n);
+    for (auto &x : v)
+        x = static_cast<T>(static_cast<int64_t>(rng() % range) + bias);
+    std::sort(v.begin(), v.end());
+    return v;
+}
+
+// 严格递增的随机序列
+template <class T>
+std::vector<T> strictly_increasing(size_t n, uint64_t range, int64_t bias = 0)
+{
+    std::vector<T> v = sorted_random<T>(n, range, bias);
+    v.erase(std::unique(v.begin(), v.end()), v.end());
+    return v;
+}
+
+template <class T>
+std::vector<T> to_vector(const MyStl::list<T> &l)
+{
+    std::vector<T> v;
+    for (auto it = l.begin(); it != l.end(); ++it)
+        v.push_back(*it);
+    return v;
+}
+
+// 四种集合运算在指针和 list 上都与 std 一致
+template <class T>
+void check_set_ops(const std::vector<T> &a, const std::vector<T> &b)
+{
+    const T *a0 = a.data(), *a1 = a0 + a.size();
+    const T *b0 = b.data(), *b1 = b0 + b.size();
+    std::vector<T> out(a.size() + b.size()), expected;
+
+    expected.clear();
+    std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+    assert(std::vector<T>(out.data(), MyStl::set_union(a0, a1, b0, b1, out.data())) == expected);
+
+    expected.clear();
+    std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+    assert(std::vector<T>(out.data(), MyStl::set_intersection(a0, a1, b0, b1, out.data())) == expected);
+
+    expected.clear();
+    std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+    assert(std::vector<T>(out.data(), MyStl::set_difference(a0, a1, b0, b1, out.data())) == expected);
+
+    expected.clear();
+    std::set_symmetric_difference(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+    assert(std::vector<T>(out.data(), MyStl::set_symmetric_difference(a0, a1, b0, b1, out.data())) == expected);
+}
+
+void test_set_ops()
+{
+    const size_t lens[] = {0, 1, 2, 7, 8, 9, 33, 100, 1000};
+    for (size_t n1 : lens)
+    {
+        for (size_t n2 : lens)
+        {
+            for (uint64_t range : {3u, 50u, 100000u})
+            {
+                const auto a = sorted_random<int>(n1, range);
+                const auto b = sorted_random<int>(n2, range);
+                check_set_ops(a, b);
+
+                // 长度相差很大，走倍增查找
+                const auto big = sorted_random<int>(n1 * 40 + 1, range);
+                check_set_ops(big, b);
+                check_set_ops(b, big);
+
+                // list 迭代器走逐个归并
+                MyStl::list<int> la(a.data(), a.data() + a.size()), lb(b.data(), b.data() + b.size());
+                std::vector<int> out(n1 + n2), expected;
+                std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+                int *end = MyStl::set_union(la.begin(), la.end(), lb.begin(), lb.end(), out.data());
+                assert(std::vector<int>(out.data(), end) == expected);
+                expected.clear();
+                std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected));
+                end = MyStl::set_difference(la.begin(), la.end(), lb.begin(), lb.end(), out.data());
+                assert(std::vector<int>(out.data(), end) == expected);
+                (void)end;
+            }
+        }
+    }
+
+    // 自定义比较器：递减序列
+    auto a = sorted_random<int>(500, 300), b = sorted_random<int>(20, 300);
+    std::reverse(a.begin(), a.end());
+    std::reverse(b.begin(), b.end());
+    std::vector<int> out(520), expected;
+    std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected), std::greater<int>());
+    int *end = MyStl::set_intersection(a.data(), a.data() + a.size(), b.data(), b.data() + b.size(), out.data(),
+                                       MyStl::greater<int>());
+    assert(std::vector<int>(out.data(), end) == expected);
+    (void)end;
+}
+
+// 4 字节整数：严格递增时走 simd::intersect32，含重复元素时走逐个比较
+template <class T>
+void test_intersect32()
+{
+    const int64_t bias = std::is_signed<T>::value ? -50000 : 0;
+    for (size_t n1 = 0; n1 <= 200; n1 += 1 + rng() % 4)
+    {
+        for (size_t n2 : {0u, 1u, 7u, 8u, 9u, 16u, 31u, 100u, 200u})
+        {
+            for (uint64_t range : {64u, 400u, 100000u})
+            {
+                check_set_ops(strictly_increasing<T>(n1, range, bias), strictly_increasing<T>(n2, range, bias));
+                check_set_ops(sorted_random<T>(n1, range, bias), strictly_increasing<T>(n2, range, bias));
+            }
+        }
+    }
+    // 较长的区间，命中率从很低到几乎全部命中
+    for (uint64_t range : {20000u, 3000000u, 100000000u})
+        check_set_ops(strictly_increasing<T>(100000, range, bias), strictly_increasing<T>(60000, range, bias));
+    // 极值
+    std::vector<T> a = {std::numeric_limits<T>::min(), T(-1), T(0), T(1), std::numeric_limits<T>::max()};
+    a.erase(std::unique(a.begin(), a.end()), a.end());
+    std::sort(a.begin(), a.end());
+    a.erase(std::unique(a.begin(), a.end()), a.end());
+    std::vector<T> b(a);
+    for (T x = T(2); x < T(40); ++x)
+        b.push_back(x);
+    std::sort(b.begin(), b.end());
+    b.erase(std::unique(b.begin(), b.end()), b.end());
+    check_set_ops(a, b);
+}
+
+/*****************************************************************************************/
+// 倍增查找的切换点
+/*****************************************************************************************/
+struct counting_less
+{
+    size_t *count;
+    template <class T, class U>
+    bool operator()(const T &lhs, const U &rhs) const
+    {
+        ++*count;
+        return lhs < rhs;
+    }
+};
+
+// 长度为 n_long 的区间与散布其中的 n_short 个元素，每个都落在各自一段的末尾，一半与区间中的值相等；
+// 逐个归并要走完整个较长区间，比较次数与 n_long 成正比，倍增查找则远少于它
+void check_cutover(size_t n_short, size_t n_long)
+{
+    std::vector<int> longer(n_long), shorter(n_short);
+    for (size_t i = 0; i < n_long; ++i)
+        longer[i] = static_cast<int>(2 * i);
+    for (size_t i = 0; i < n_short; ++i)
+        shorter[i] = static_cast<int>(2 * ((i + 1) * n_long / n_short - 1) + (i % 2));
+    const int *l0 = longer.data(), *l1 = l0 + n_long;
+    const int *s0 = shorter.data(), *s1 = s0 + n_short;
+    std::vector<int> out(n_long + n_short);
+    const bool gallop = n_long / MyStl::set_gallop_ratio > n_short;
+
+    size_t merged = 0, actual = 0;
+    counting_less cm{&merged}, ca{&actual};
+
+    // 区间一较长、区间二较长两种方向，与只走逐个归并的 m_false_type 版本比较
+    MyStl::set_intersection_dispatch(l0, l1, s0, s1, out.data(), cm, MyStl::m_false_type());
+    MyStl::set_intersection(l0, l1, s0, s1, out.data(), ca);
+    assert(gallop ? actual < merged : actual == merged);
+
+    merged = actual = 0;
+    MyStl::set_intersection_dispatch(s0, s1, l0, l1, out.data(), cm, MyStl::m_false_type());
+    MyStl::set_intersection(s0, s1, l0, l1, out.data(), ca);
+    assert(gallop ? actual < merged : actual == merged);
+
+    merged = actual = 0;
+    MyStl::set_union_dispatch(l0, l1, s0, s1, out.data(), cm, MyStl::m_false_type());
+    MyStl::set_union(l0, l1, s0, s1, out.data(), ca);
+    assert(gallop ? actual < merged : actual == merged);
+
+    merged = actual = 0;
+    MyStl::set_difference_dispatch(s0, s1, l0, l1, out.data(), cm, MyStl::m_false_type());
+    MyStl::set_difference(s0, s1, l0, l1, out.data(), ca);
+    assert(gallop ? actual < merged : actual == merged);
+
+    // 无论走哪条路径，结果都与 std 一致
+    check_set_ops(longer, shorter);
+    check_set_ops(shorter, longer);
+}
+
+void test_gallop_cutover()
+{
+    const size_t r = MyStl::set_gallop_ratio;
+    for (size_t n_short : {1u, 2u, 10u, 100u})
+    {
+        // n_long / r > n_short 即 n_long >= r * (n_short + 1)
+        const size_t edge = r * (n_short + 1);
+        for (size_t n_long : {edge - r, edge - 1, edge, edge + 1, 4 * edge})
+            check_cutover(n_short, n_long);
+    }
+}
+
+/*****************************************************************************************/
+// kway_merge
+/*****************************************************************************************/
+struct tagged
+{
+    int key;
+    size_t range;
+    size_t index;
+};
+
+struct key_less
+{
+    bool operator()(const tagged &a, const tagged &b) const { return a.key < b.key; }
+};
+
+void test_kway_merge()
+{
+    for (size_t k : {0u, 1u, 2u, 3u, 4u, 5u, 8u, 17u, 100u})
+    {
+        for (uint64_t range : {1u, 5u, 1000u})
+        {
+            std::vector<std::vector<tagged>> inputs(k);
+            std::vector<tagged> expected;
+            for (size_t r = 0; r < k; ++r)
+            {
+                const size_t len = rng() % 4 == 0 ? 0 : rng() % 200;
+                const auto keys = sorted_random<int>(len, range);
+                for (size_t i = 0; i < len; ++i)
+                    inputs[r].push_back(tagged{keys[i], r, i});
+                expected.insert(expected.end(), inputs[r].begin(), inputs[r].end());
+            }
+            // 稳定：相等的键按区间序号、再按区间内位置输出
+            std::stable_sort(expected.begin(), expected.end(), key_less());
+
+            std::vector<MyStl::pair<const tagged*, const tagged*>> ranges;
+            for (const auto &in : inputs)
+                ranges.emplace_back(in.data(), in.data() + in.size());
+            std::vector<tagged> out(expected.size() + 1);
+            tagged *end = MyStl::kway_merge(ranges.data(), ranges.data() + k, out.data(), key_less());
+            assert(static_cast<size_t>(end - out.data()) == expected.size());
+            for (size_t i = 0; i < expected.size(); ++i)
+                assert(out[i].key == expected[i].key && out[i].range == expected[i].range &&
+                       out[i].index == expected[i].index);
+            (void)end;
+        }
+    }
+
+    // 默认比较器、list 区间、输出到 list
+    std::vector<MyStl::list<int>> lists(6);
+    std::vector<int> all;
+    for (auto &l : lists)
+    {
+        for (int x : sorted_random<int>(rng() % 50, 100))
+        {
+            l.emplace_back(x);
+            all.push_back(x);
+        }
+    }
+    std::sort(all.begin(), all.end());
+    typedef MyStl::list<int>::iterator list_iter;
+    std::vector<MyStl::pair<list_iter, list_iter>> ranges;
+    for (auto &l : lists)
+        ranges.emplace_back(l.begin(), l.end());
+    MyStl::list<int> merged(all.size(), -1);
+    auto end = MyStl::kway_merge(ranges.data(), ranges.data() + ranges.size(), merged.begin());
+    assert(end == merged.end());
+    assert(to_vector(merged) == all);
+    (void)end;
+}
+
+} // namespace
+
+int main()
+{
+    test_set_ops();
+    test_intersect32<uint32_t>();
+    test_intersect32<int32_t>();
+    test_gallop_cutover();
+    test_kway_merge();
+    simd_test::report("set_ops_test");
+    return 0;
+}
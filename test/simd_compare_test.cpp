@@ -0,0 +1,196 @@
+// equal / mismatch / lexicographical_compare 在原生指针上的快速路径测试，结果与逐个比较的朴素循环对照
+// 两个区间的起点各自错开，差异放在每个位置、元素内的每个字节上
+// g++ -std=c++14 -O2 -I.. simd_compare_test.cpp -o simd_compare_test && ./simd_compare_test
+// 另外用 -DMYSTL_NO_AVX2 和 -DMYSTL_NO_SIMD 各构建一次
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "../algobase.h"
+#include "simd_test_util.h"
+
+namespace
+{
+
+std::mt19937_64 rng(32);
+
+enum class color : uint16_t { red = 1, green = 0x100, blue = 0xffff };
+
+template <class T>
+size_t naive_mismatch(const T *a, const T *b, size_t n)
+{
+    size_t i = 0;
+    while (i < n && a[i] == b[i])
+        ++i;
+    return i;
+}
+
+// 把 b[pos] 的第 byte 个字节翻转，使两个元素只在这一个字节上不同
+template <class T>
+void flip_byte(T &x, size_t byte)
+{
+    unsigned char raw[sizeof(T)];
+    std::memcpy(raw, &x, sizeof(T));
+    raw[byte] ^= 0x5a;
+    std::memcpy(&x, raw, sizeof(T));
+}
+
+template <class T>
+void check_pair(const T *a, const T *b, size_t n)
+{
+    const size_t expected = naive_mismatch(a, b, n);
+    assert(MyStl::equal(a, a + n, b) == (expected == n));
+    auto r = MyStl::mismatch(a, a + n, b);
+    assert(r.first == a + expected && r.second == b + expected);
+}
+
+template <class T>
+void check_type(const std::vector<T> &alphabet)
+{
+    std::vector<T> sa(400), sb(400);
+    for (size_t round = 0; round < 6; ++round)
+    {
+        simd_test::fill_random(sa, alphabet, alphabet.size(), rng);
+        for (size_t offset_a = 0; offset_a < 9; ++offset_a)
+        {
+            size_t offset_b = (offset_a * 5 + round) % 11;
+            for (size_t n = 0; n <= 300; n += 1 + (n > 70 ? rng() % 9 : 0))
+            {
+                T *a = sa.data() + offset_a;
+                T *b = sb.data() + offset_b;
+                std::memcpy(b, a, n * sizeof(T));
+                check_pair<T>(a, b, n);
+                if (n == 0)
+                    continue;
+                // 差异放在开头、结尾和随机位置，元素内每个字节都试一次
+                size_t positions[3] = {0, n - 1, static_cast<size_t>(rng() % n)};
+                for (auto pos : positions)
+                {
+                    for (size_t byte = 0; byte < sizeof(T); ++byte)
+                    {
+                        T saved = b[pos];
+                        flip_byte(b[pos], byte);
+                        check_pair<T>(a, b, n);
+                        b[pos] = saved;
+                    }
+                }
+            }
+        }
+    }
+}
+
+// 浮点数走逐个比较：+0 与 -0 相等，NaN 与自身不等
+void test_float()
+{
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    double a[] = {1.0, 0.0, 2.0, nan};
+    double b[] = {1.0, -0.0, 2.0, nan};
+    assert(MyStl::equal(a, a + 3, b));
+    assert(!MyStl::equal(a, a + 4, b));
+    assert(MyStl::mismatch(a, a + 4, b).first == a + 3);
+}
+
+// 字典序：两个区间有随机长度的公共前缀，之后随机不同；长度也各自随机
+template <class T>
+void check_lexico(const std::vector<T> &alphabet)
+{
+    std::vector<T> sa(300), sb(300);
+    for (size_t round = 0; round < 20000; ++round)
+    {
+        size_t len1 = rng() % 260, len2 = rng() % 260;
+        size_t offset1 = rng() % 33, offset2 = rng() % 33;
+        T *a = sa.data() + offset1;
+        T *b = sb.data() + offset2;
+        for (size_t i = 0; i < len1; ++i) a[i] = alphabet[rng() % alphabet.size()];
+        for (size_t i = 0; i < len2; ++i) b[i] = alphabet[rng() % alphabet.size()];
+        size_t prefix = rng() % (std::min(len1, len2) + 1);
+        std::copy(a, a + prefix, b);
+        if (rng() % 4 == 0)
+        {
+            std::copy(a, a + std::min(len1, len2), b);   // 只有长度不同
+            if (rng() % 2)
+                len2 = len1;
+        }
+        const T *ca = a, *cb = b;
+        assert(MyStl::lexicographical_compare(ca, ca + len1, cb, cb + len2) ==
+               std::lexicographical_compare(ca, ca + len1, cb, cb + len2));
+        assert(MyStl::lexicographical_compare(cb, cb + len2, ca, ca + len1) ==
+               std::lexicographical_compare(cb, cb + len2, ca, ca + len1));
+    }
+}
+
+// 以大端字节序存放的定长键，特化 is_memcmp_ordered 之后整体走 memcmp
+struct be_key
+{
+    unsigned char bytes[6];
+
+    static be_key from(uint64_t v)
+    {
+        be_key k;
+        for (int i = 5; i >= 0; --i, v >>= 8)
+            k.bytes[i] = static_cast<unsigned char>(v);
+        return k;
+    }
+    uint64_t value() const
+    {
+        uint64_t v = 0;
+        for (auto b : bytes)
+            v = (v << 8) | b;
+        return v;
+    }
+    bool operator<(const be_key &rhs) const { return value() < rhs.value(); }
+    bool operator==(const be_key &rhs) const { return value() == rhs.value(); }
+};
+
+} // namespace
+
+namespace MyStl
+{
+template <>
+struct is_memcmp_ordered<be_key> : m_true_type {};
+} // namespace MyStl
+
+namespace
+{
+
+void test_big_endian_keys()
+{
+    static_assert(MyStl::is_lexico_fast_pair<const be_key, const be_key, MyStl::is_memcmp_ordered>::value,
+                  "be_key should take the memcmp path");
+    std::vector<be_key> alphabet;
+    const uint64_t values[] = {0, 1, 0xff, 0x100, 0x10000, 0xffffffffffffULL, 0x800000000000ULL, 0x7fffffffffffULL};
+    for (auto v : values)
+        alphabet.push_back(be_key::from(v));
+    check_lexico<be_key>(alphabet);
+}
+
+} // namespace
+
+int main()
+{
+    check_type<unsigned char>({0, 1, 0x7f, 0x80, 0xff});
+    check_type<char>({'a', 'b', '\0', static_cast<char>(0x80)});
+    check_type<int16_t>({0, -1, 0x7fff, -0x8000, 0x100});
+    check_type<uint32_t>({0, 1, 0xffffffffu, 0x80000000u, 0x10000u});
+    check_type<int64_t>({0, -1, std::numeric_limits<int64_t>::min(), 1LL << 40});
+    check_type<color>({color::red, color::green, color::blue});
+    static int targets[4];
+    check_type<int*>({targets, targets + 1, targets + 3, nullptr});
+    test_float();
+    check_lexico<unsigned char>({0, 1, 0x7f, 0x80, 0xff});
+    check_lexico<signed char>({0, 1, -1, 127, -128});
+    check_lexico<char>({'a', 'b', '\0', static_cast<char>(0x80), static_cast<char>(0xff)});
+    check_lexico<int16_t>({0, -1, 1, 0x7fff, -0x8000, 0x100, 0xff});
+    check_lexico<uint16_t>({0, 1, 0xff, 0x100, 0xffff, 0x8000});
+    check_lexico<uint32_t>({0, 1, 0xff, 0x100, 0xffffffffu, 0x80000000u, 0x01000000u});
+    check_lexico<int64_t>({0, -1, 1, std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::max(), 256});
+    check_lexico<uint64_t>({0, 1, 0xff, 0x100, ~0ULL, 1ULL << 63, 1ULL << 56});
+    test_big_endian_keys();
+    simd_test::report("simd_compare_test");
+    return 0;
+}
@@ -0,0 +1,179 @@
+// copy / move / copy_backward / move_backward / uninitialized_copy 在原生指针上的字节拷贝路径测试
+// 覆盖 0 到 300 的长度、源和目的地址的各种字节对齐、向前和向后重叠的区间，检查区间外的字节没有被改写；
+// 另在非临时存储阈值上下各取几个长度，确认阈值两侧都走到了并且结果正确
+// g++ -std=c++14 -O2 -I.. simd_copy_test.cpp -o simd_copy_test && ./simd_copy_test
+// 另外用 -DMYSTL_NO_AVX2、-DMYSTL_NO_SIMD 以及 -DMYSTL_NT_STORE_THRESHOLD=4096（让短拷贝也走非临时存储）各构建一次
+
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "../algobase.h"
+#include "../uninitialized.h"
+#include "simd_test_util.h"
+
+namespace
+{
+
+const unsigned char guard = 0xa5;
+
+// 源区间填入与位置相关的字节，便于发现错位
+void fill_pattern(unsigned char *p, size_t n, unsigned seed)
+{
+    for (size_t i = 0; i < n; ++i)
+        p[i] = static_cast<unsigned char>(i * 131 + seed);
+}
+
+// 把 src 中从第 src_off 个字节开始的 n 个 T 拷贝到 dst 中从第 dst_off 个字节开始的位置，
+// 与 memcpy 得到的结果逐字节比较，目的区间两侧的 64 个保护字节不能被改写
+template <class T, class Copy>
+void check_copy(std::vector<unsigned char> &src, std::vector<unsigned char> &dst,
+                size_t src_off, size_t dst_off, size_t n, Copy copy)
+{
+    const size_t bytes = n * sizeof(T);
+    fill_pattern(src.data(), src_off + bytes, static_cast<unsigned>(n + src_off));
+    std::memset(dst.data(), guard, dst_off + bytes + 64);
+    auto first = reinterpret_cast<const T*>(src.data() + src_off);
+    auto result = reinterpret_cast<T*>(dst.data() + dst_off);
+    copy(first, n, result);
+    for (size_t i = 0; i < dst_off; ++i)
+        assert(dst[i] == guard);
+    assert(std::memcmp(dst.data() + dst_off, src.data() + src_off, bytes) == 0);
+    for (size_t i = dst_off + bytes; i < dst_off + bytes + 64; ++i)
+        assert(dst[i] == guard);
+}
+
+template <class T>
+void copy_all(const T *first, size_t n, T *result)
+{
+    T *end = MyStl::copy(first, first + n, result);
+    assert(end == result + n);
+    (void)end;
+}
+
+template <class T>
+void move_all(const T *first, size_t n, T *result)
+{
+    T *end = MyStl::move(const_cast<T*>(first), const_cast<T*>(first) + n, result);
+    assert(end == result + n);
+    (void)end;
+}
+
+template <class T>
+void copy_backward_all(const T *first, size_t n, T *result)
+{
+    T *begin = MyStl::copy_backward(first, first + n, result + n);
+    assert(begin == result);
+    (void)begin;
+}
+
+template <class T>
+void move_backward_all(const T *first, size_t n, T *result)
+{
+    T *begin = MyStl::move_backward(const_cast<T*>(first), const_cast<T*>(first) + n, result + n);
+    assert(begin == result);
+    (void)begin;
+}
+
+template <class T>
+void uninit_copy_all(const T *first, size_t n, T *result)
+{
+    T *end = MyStl::uninitialized_copy(first, first + n, result);
+    assert(end == result + n);
+    (void)end;
+}
+
+template <class T>
+void check_all(std::vector<unsigned char> &src, std::vector<unsigned char> &dst,
+               size_t src_off, size_t dst_off, size_t n)
+{
+    check_copy<T>(src, dst, src_off, dst_off, n, copy_all<T>);
+    check_copy<T>(src, dst, src_off, dst_off, n, move_all<T>);
+    check_copy<T>(src, dst, src_off, dst_off, n, copy_backward_all<T>);
+    check_copy<T>(src, dst, src_off, dst_off, n, move_backward_all<T>);
+    check_copy<T>(src, dst, src_off, dst_off, n, uninit_copy_all<T>);
+}
+
+// 源和目的各自取 64 字节内的每种元素对齐
+template <class T>
+void check_type()
+{
+    std::vector<unsigned char> src(64 + 300 * sizeof(T) + 128), dst(src.size());
+    for (size_t src_off = 0; src_off < 64; src_off += 4 * alignof(T))
+        for (size_t dst_off = 0; dst_off < 64; dst_off += alignof(T))
+            for (size_t n = 0; n <= 300; ++n)
+                check_all<T>(src, dst, src_off, dst_off, n);
+}
+
+// 同一块内存中前后错开 shift 个元素的重叠拷贝：copy/move 向前搬（目的在前），
+// copy_backward/move_backward 向后搬（目的在后），结果与 memmove 相同
+template <class T>
+void check_overlap()
+{
+    const size_t n = 1000;
+    std::vector<T> buffer(2 * n), expected(2 * n);
+    for (size_t shift = 1; shift < 70; shift += 3)
+    {
+        for (size_t i = 0; i < buffer.size(); ++i)
+            buffer[i] = static_cast<T>(i * 7 + shift);
+        expected = buffer;
+        T *p = buffer.data();
+        std::memmove(expected.data(), expected.data() + shift, n * sizeof(T));
+        MyStl::copy(p + shift, p + shift + n, p);
+        assert(buffer == expected);
+
+        std::memmove(expected.data() + shift, expected.data(), n * sizeof(T));
+        MyStl::copy_backward(p, p + n, p + shift + n);
+        assert(buffer == expected);
+
+        std::memmove(expected.data(), expected.data() + shift, n * sizeof(T));
+        MyStl::move(p + shift, p + shift + n, p);
+        assert(buffer == expected);
+
+        std::memmove(expected.data() + shift, expected.data(), n * sizeof(T));
+        MyStl::move_backward(p, p + n, p + shift + n);
+        assert(buffer == expected);
+    }
+}
+
+// 非临时存储阈值两侧：阈值以下交给 memmove，以上用非临时存储，两边结果都要正确
+// 默认阈值是最后一级缓存的大小，可能有几百 MiB，所以只取阈值附近的几个长度
+template <class T>
+void check_threshold()
+{
+    const size_t threshold = MyStl::simd::nt_store_threshold();
+    std::vector<unsigned char> src(threshold + 1024), dst(threshold + 1024);
+    const size_t at = threshold / sizeof(T);
+    const size_t lengths[] = {at - 3, at - 1, at, at + 1, at + 5};
+    const size_t offsets[] = {0, 40 - 40 % alignof(T)};
+    size_t below = 0, above = 0;
+    for (auto n : lengths)
+    {
+        for (auto offset : offsets)
+        {
+            (MyStl::simd::use_nt_store(n * sizeof(T)) ? above : below) += 1;
+            check_copy<T>(src, dst, alignof(T), offset, n, copy_all<T>);
+        }
+    }
+    assert(below > 0 && above > 0);
+}
+
+} // namespace
+
+int main()
+{
+    check_type<unsigned char>();
+    check_type<uint16_t>();
+    check_type<uint32_t>();
+    check_type<double>();
+    check_overlap<unsigned char>();
+    check_overlap<uint32_t>();
+    check_overlap<uint64_t>();
+    std::printf("non-temporal threshold: %zu bytes\n", MyStl::simd::nt_store_threshold());
+    check_threshold<unsigned char>();
+    check_threshold<uint64_t>();
+    simd_test::report("simd_copy_test");
+    return 0;
+}
@@ -0,0 +1,123 @@
+// fill / fill_n / uninitialized_fill_n / vector(n, value) 的广播存储路径测试
+// 覆盖 1/2/4/8/16 字节的元素、0 到 300 的长度、目的地址的每种字节对齐，检查区间外的字节没有被改写；
+// 另在非临时存储阈值上下各取几个长度，确认阈值两侧都走到了并且结果正确
+// g++ -std=c++14 -O2 -I.. simd_fill_test.cpp -o simd_fill_test && ./simd_fill_test
+// 另外用 -DMYSTL_NO_AVX2、-DMYSTL_NO_SIMD 以及 -DMYSTL_NT_STORE_THRESHOLD=4096（让短填充也走非临时存储）各构建一次
+
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "../algobase.h"
+#include "../uninitialized.h"
+#include "../vector.h"
+#include "simd_test_util.h"
+
+namespace
+{
+
+struct pod16
+{
+    uint32_t a, b, c, d;
+    bool operator==(const pod16 &rhs) const { return a == rhs.a && b == rhs.b && c == rhs.c && d == rhs.d; }
+};
+
+// 不是 1/2/4/8/16 字节，走逐个赋值的通用循环
+struct pod12
+{
+    uint32_t a, b, c;
+    bool operator==(const pod12 &rhs) const { return a == rhs.a && b == rhs.b && c == rhs.c; }
+};
+
+const unsigned char guard = 0xa5;
+
+// 在 buffer 中从第 offset 个字节开始的 n 个元素上执行 fill，检查元素值和两侧的保护字节
+template <class T, class Fill>
+void check_fill(std::vector<unsigned char> &buffer, size_t offset, size_t n, const T &value, Fill fill)
+{
+    const size_t bytes = n * sizeof(T);
+    std::memset(buffer.data(), guard, offset + bytes + 64);
+    auto first = reinterpret_cast<T*>(buffer.data() + offset);
+    fill(first, n, value);
+    for (size_t i = 0; i < offset; ++i)
+        assert(buffer[i] == guard);
+    for (size_t i = 0; i < n; ++i)
+    {
+        T x;
+        std::memcpy(&x, buffer.data() + offset + i * sizeof(T), sizeof(T));
+        assert(x == value);
+    }
+    for (size_t i = offset + bytes; i < offset + bytes + 64; ++i)
+        assert(buffer[i] == guard);
+}
+
+// 元素按自身对齐放置，起点覆盖 64 字节内的每种对齐
+template <class T>
+void check_type(const T &value)
+{
+    std::vector<unsigned char> buffer(64 + 300 * sizeof(T) + 128);
+    for (size_t offset = 0; offset < 64; offset += alignof(T))
+    {
+        for (size_t n = 0; n <= 300; ++n)
+        {
+            check_fill(buffer, offset, n, value, [](T *p, size_t k, const T &v) { MyStl::fill_n(p, k, v); });
+            check_fill(buffer, offset, n, value, [](T *p, size_t k, const T &v) { MyStl::fill(p, p + k, v); });
+            check_fill(buffer, offset, n, value,
+                       [](T *p, size_t k, const T &v) { MyStl::uninitialized_fill_n(p, k, v); });
+        }
+    }
+    for (size_t n = 0; n <= 300; n += 7)
+    {
+        MyStl::vector<T> v(n, value);
+        assert(v.size() == n);
+        for (size_t i = 0; i < n; ++i)
+            assert(v[i] == value);
+    }
+}
+
+// 非临时存储阈值两侧：阈值以下用普通存储，以上用非临时存储，两边结果都要正确
+// 默认阈值是最后一级缓存的大小，可能有几百 MiB，所以只取阈值附近的几个长度
+template <class T>
+void check_threshold(const T &value)
+{
+    const size_t threshold = MyStl::simd::nt_store_threshold();
+    assert(!MyStl::simd::use_nt_store(threshold - 1));
+    assert(MyStl::simd::use_nt_store(threshold));
+    std::vector<unsigned char> buffer(threshold + 1024);
+    const size_t at = threshold / sizeof(T);
+    const size_t lengths[] = {at - 3, at - 1, at, at + 1, at + 5};
+    const size_t offsets[] = {0, 3 * alignof(T) % 64, 40 - 40 % alignof(T)};
+    size_t below = 0, above = 0;
+    for (auto n : lengths)
+    {
+        for (auto offset : offsets)
+        {
+            (MyStl::simd::use_nt_store(n * sizeof(T)) ? above : below) += 1;
+            check_fill(buffer, offset, n, value, [](T *p, size_t k, const T &v) { MyStl::fill_n(p, k, v); });
+        }
+    }
+    assert(below > 0 && above > 0);
+}
+
+} // namespace
+
+int main()
+{
+    check_type<unsigned char>(0x3c);
+    check_type<uint16_t>(0xbeef);
+    check_type<int32_t>(-123456);
+    check_type<float>(1.5f);
+    check_type<double>(-2.25);
+    check_type<uint64_t>(0x0123456789abcdefULL);
+    check_type<pod16>(pod16{1, 2, 3, 0xffffffffu});
+    check_type<pod12>(pod12{4, 5, 6});
+
+    std::printf("non-temporal threshold: %zu bytes\n", MyStl::simd::nt_store_threshold());
+    check_threshold<uint16_t>(0x1234);
+    check_threshold<double>(3.0);
+    check_threshold<pod16>(pod16{7, 8, 9, 10});
+    simd_test::report("simd_fill_test");
+    return 0;
+}
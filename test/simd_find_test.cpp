@@ -0,0 +1,140 @@
+// find / count / count_if 在原生指针上的 SIMD 路径测试，结果与逐个比较的朴素循环对照
+// 覆盖所有可向量化的元素类型、0 到 200 的长度、起点不对齐的区间、需要转换的查找值和浮点数的特殊值
+// g++ -std=c++14 -O2 -I.. simd_find_test.cpp -o simd_find_test && ./simd_find_test
+// 另外用 -DMYSTL_NO_AVX2 和 -DMYSTL_NO_SIMD 各构建一次
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "../algo.h"
+#include "simd_test_util.h"
+
+namespace
+{
+
+std::mt19937_64 rng(31);
+
+template <class T, class U>
+const T* naive_find(const T *first, const T *last, const U &value)
+{
+    for (; first != last; ++first)
+        if (*first == value)
+            return first;
+    return last;
+}
+
+template <class T, class U>
+size_t naive_count(const T *first, const T *last, const U &value)
+{
+    size_t n = 0;
+    for (; first != last; ++first)
+        if (*first == value)
+            ++n;
+    return n;
+}
+
+// 从每个起点偏移、每个长度上对照，查找值取自字母表，也取字母表外的值
+template <class T>
+void check_type(const std::vector<T> &alphabet)
+{
+    std::vector<T> storage(256 + 64);
+    for (size_t round = 0; round < 40; ++round)
+    {
+        size_t alpha = 1 + rng() % alphabet.size();
+        simd_test::fill_random(storage, alphabet, alpha, rng);
+        for (size_t offset = 0; offset < 33; ++offset)
+        {
+            for (size_t n = 0; n <= 200; n += 1 + (n > 70 ? rng() % 7 : 0))
+            {
+                T *first = storage.data() + offset;
+                T *last = first + n;
+                const T *cfirst = first, *clast = last;
+                for (size_t a = 0; a < alphabet.size(); ++a)
+                {
+                    const T value = alphabet[a];
+                    assert(MyStl::find(first, last, value) == naive_find(cfirst, clast, value));
+                    assert(MyStl::find(cfirst, clast, value) == naive_find(cfirst, clast, value));
+                    assert(MyStl::count(cfirst, clast, value) == naive_count(cfirst, clast, value));
+                    assert(MyStl::count_if(cfirst, clast, value, MyStl::equal_to<T>()) ==
+                           naive_count(cfirst, clast, value));
+                }
+            }
+        }
+    }
+}
+
+template <class T>
+std::vector<T> int_alphabet()
+{
+    typedef std::numeric_limits<T> lim;
+    return {T(0), T(1), T(lim::max()), T(lim::min()), T(lim::max() - 1), T(lim::min() + 1), T(7), T(T(1) << (sizeof(T) * 8 - 2))};
+}
+
+// 查找值的类型与元素不同：转换后值变了就不可能匹配
+void test_value_conversion()
+{
+    std::vector<unsigned char> bytes(100, 44);
+    bytes[50] = 255;
+    const unsigned char *b = bytes.data(), *e = b + bytes.size();
+    assert(MyStl::find(b, e, 300) == e);              // 300 截断为 44，但不应匹配
+    assert(MyStl::count(b, e, 300) == 0);
+    assert(MyStl::find(b, e, -1) == e);               // -1 转换为 255，但 255 != -1
+    assert(MyStl::find(b, e, 255) == b + 50);
+    assert(MyStl::count(b, e, 44L) == 99);
+    assert(MyStl::count(b, e, 44ULL) == 99);
+
+    std::vector<int16_t> shorts(100, -3);
+    const int16_t *s = shorts.data(), *t = s + shorts.size();
+    assert(MyStl::count(s, t, -3) == 100);
+    assert(MyStl::count(s, t, 65533) == 0);
+    assert(MyStl::find(s, t, static_cast<long long>(-3)) == s);
+
+    std::vector<double> doubles(64, 2.0);
+    const double *d = doubles.data(), *f = d + doubles.size();
+    assert(MyStl::count(d, f, 2) == 64);              // 整数查找值可以精确转换
+    assert(MyStl::find(d, f, 3) == f);
+}
+
+// 浮点数按 operator== 比较：+0 等于 -0，NaN 不等于任何值
+void test_float_special()
+{
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    std::vector<double> v = {1.0, -0.0, nan, 0.0, 2.0, nan, -0.0, 3.0, 0.0, 1.0, 5.0, 6.0, 7.0, 8.0, 9.0, 10.0, 11.0};
+    const double *b = v.data(), *e = b + v.size();
+    assert(MyStl::find(b, e, 0.0) == b + 1);
+    assert(MyStl::count(b, e, 0.0) == 4);
+    assert(MyStl::count(b, e, -0.0) == 4);
+    assert(MyStl::find(b, e, nan) == e);
+    assert(MyStl::count(b, e, nan) == 0);
+
+    std::vector<float> w(40, std::numeric_limits<float>::quiet_NaN());
+    w[37] = -0.0f;
+    const float *p = w.data(), *q = p + w.size();
+    assert(MyStl::find(p, q, 0.0f) == p + 37);
+    assert(MyStl::count(p, q, std::numeric_limits<float>::quiet_NaN()) == 0);
+}
+
+} // namespace
+
+int main()
+{
+    check_type<char>({'a', 'b', 'c', '\0', '\x7f', static_cast<char>(0x80), static_cast<char>(0xff)});
+    check_type<signed char>(int_alphabet<signed char>());
+    check_type<unsigned char>(int_alphabet<unsigned char>());
+    check_type<int16_t>(int_alphabet<int16_t>());
+    check_type<uint16_t>(int_alphabet<uint16_t>());
+    check_type<int32_t>(int_alphabet<int32_t>());
+    check_type<uint32_t>(int_alphabet<uint32_t>());
+    check_type<int64_t>(int_alphabet<int64_t>());
+    check_type<uint64_t>(int_alphabet<uint64_t>());
+    check_type<float>({0.0f, 1.5f, -2.25f, 1e30f, -1e-30f, 3.0f});
+    check_type<double>({0.0, 1.5, -2.25, 1e300, -1e-300, 3.0});
+    test_value_conversion();
+    test_float_special();
+    simd_test::report("simd_find_test");
+    return 0;
+}
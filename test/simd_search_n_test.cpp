@@ -0,0 +1,224 @@
+// search_n / adjacent_find 在原生指针上的 SIMD 路径测试，结果与逐个比较的朴素循环对照
+// 覆盖所有可向量化的元素类型、0 到 200 的长度、起点不对齐的区间、1 到 40 的重复次数、需要转换的查找值和浮点数的特殊值；
+// 另外检查随机访问迭代器的跳跃版本、前向迭代器和带比较器的版本
+// adjacent_find(first, last, comp) 原来把迭代器而不是元素传给 comp，只接受元素的比较器无法编译，这里一并回归
+// g++ -std=c++14 -O2 -I.. simd_search_n_test.cpp -o simd_search_n_test && ./simd_search_n_test
+// 另外用 -DMYSTL_NO_AVX2 和 -DMYSTL_NO_SIMD 各构建一次
+
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "../algo.h"
+#include "../list.h"
+#include "../vector.h"
+#include "simd_test_util.h"
+
+namespace
+{
+
+std::mt19937_64 rng(41);
+
+template <class T, class U>
+const T* naive_search_n(const T *first, const T *last, size_t n, const U &value)
+{
+    if (n == 0)
+        return first;
+    for (const T *p = first; static_cast<size_t>(last - p) >= n; ++p)
+    {
+        size_t k = 0;
+        while (k < n && p[k] == value)
+            ++k;
+        if (k == n)
+            return p;
+    }
+    return last;
+}
+
+template <class T>
+const T* naive_adjacent_find(const T *first, const T *last)
+{
+    for (const T *p = first; p != last && p + 1 != last; ++p)
+        if (p[0] == p[1])
+            return p;
+    return last;
+}
+
+// 相等元素成段出现的随机序列：段长随机，段的值取自字母表的前 alpha 个
+template <class T>
+void fill_runs(std::vector<T> &v, const std::vector<T> &alphabet, size_t alpha, size_t max_run)
+{
+    for (size_t i = 0; i < v.size();)
+    {
+        const T x = alphabet[rng() % alpha];
+        for (size_t k = 1 + rng() % max_run; k > 0 && i < v.size(); --k)
+            v[i++] = x;
+    }
+}
+
+template <class T>
+void check_type(const std::vector<T> &alphabet)
+{
+    std::vector<T> storage(256 + 64);
+    for (size_t round = 0; round < 30; ++round)
+    {
+        const size_t alpha = 1 + rng() % alphabet.size();
+        fill_runs(storage, alphabet, alpha, round % 3 == 0 ? 2 : 24);
+        for (size_t offset = 0; offset < 33; offset += 1 + rng() % 4)
+        {
+            for (size_t len = 0; len <= 200; len += 1 + (len > 70 ? rng() % 7 : 0))
+            {
+                const T *first = storage.data() + offset;
+                const T *last = first + len;
+                assert(MyStl::adjacent_find(first, last) == naive_adjacent_find(first, last));
+                for (size_t n : {0u, 1u, 2u, 3u, 5u, 8u, 16u, 17u, 31u, 40u})
+                {
+                    const T value = alphabet[rng() % alpha];
+                    assert(MyStl::search_n(first, last, n, value) == naive_search_n(first, last, n, value));
+                }
+            }
+        }
+    }
+}
+
+// 只有一对相等的相邻元素，逐个位置检查
+template <class T>
+void check_adjacent_positions()
+{
+    std::vector<T> v(300);
+    for (size_t i = 0; i < v.size(); ++i)
+        v[i] = static_cast<T>(i % 2 == 0 ? i / 2 % 50 : 100 + i / 2 % 50);
+    const T *first = v.data();
+    assert(MyStl::adjacent_find(first, first + v.size()) == first + v.size());
+    for (size_t pos = 0; pos + 1 < v.size(); ++pos)
+    {
+        const T saved = v[pos + 1];
+        v[pos + 1] = v[pos];
+        for (size_t offset : {0u, 1u, 7u})
+        {
+            if (offset > pos)
+                continue;
+            assert(MyStl::adjacent_find(first + offset, first + v.size()) == first + pos);
+        }
+        v[pos + 1] = saved;
+    }
+}
+
+// 查找值需要转换：超出元素类型范围的值不可能匹配
+void test_converted_value()
+{
+    std::vector<unsigned char> bytes(100, 255);
+    const unsigned char *b = bytes.data();
+    assert(MyStl::search_n(b, b + 100, 3, 255) == b);
+    assert(MyStl::search_n(b, b + 100, 3, -1) == b + 100);
+    assert(MyStl::search_n(b, b + 100, 3, 511) == b + 100);
+    std::vector<int> ints(100, 7);
+    assert(MyStl::search_n(ints.data(), ints.data() + 100, 100, 7LL) == ints.data());
+    assert(MyStl::search_n(ints.data(), ints.data() + 100, 101, 7) == ints.data() + 100);
+    assert(MyStl::search_n(ints.data(), ints.data() + 100, 2, 7LL + (1LL << 32)) == ints.data() + 100);
+}
+
+// NaN 与任何值都不相等；0.0 与 -0.0 相等
+template <class T>
+void test_float_specials()
+{
+    const T nan = std::numeric_limits<T>::quiet_NaN();
+    std::vector<T> v = {1, nan, nan, nan, 2, T(0.0), T(-0.0), T(-0.0), 3};
+    const T *p = v.data();
+    const T *end = p + v.size();
+    assert(MyStl::adjacent_find(p, end) == p + 5);
+    assert(MyStl::search_n(p, end, 2, nan) == end);
+    assert(MyStl::search_n(p, end, 3, T(0.0)) == p + 5);
+    assert(MyStl::search_n(p, end, 3, T(-0.0)) == p + 5);
+    std::vector<T> nans(50, nan);
+    assert(MyStl::adjacent_find(nans.data(), nans.data() + 50) == nans.data() + 50);
+    (void)end;
+}
+
+// 非指针的随机访问迭代器、前向迭代器和比较器版本
+void test_generic()
+{
+    const std::vector<int> alphabet = {1, 2, 3};
+    std::vector<int> v(300);
+    for (size_t round = 0; round < 200; ++round)
+    {
+        fill_runs(v, alphabet, 1 + round % 3, 12);
+        const size_t len = rng() % 300;
+        const int *p = v.data();
+        MyStl::vector<int> mv(p, p + len);
+        MyStl::list<int> ml(p, p + len);
+        for (size_t n : {0u, 1u, 2u, 4u, 9u, 13u})
+        {
+            const int value = 1 + static_cast<int>(rng() % 3);
+            const auto expected = naive_search_n(p, p + len, n, value) - p;
+            assert(MyStl::search_n(mv.begin(), mv.end(), n, value) - mv.begin() == expected);
+            assert(MyStl::distance(ml.begin(), MyStl::search_n(ml.begin(), ml.end(), n, value)) == expected);
+            assert(MyStl::search_n(p, p + len, n, value, MyStl::equal_op()) - p == expected);
+            assert(MyStl::search_n(mv.begin(), mv.end(), n, value, MyStl::equal_op()) - mv.begin() == expected);
+            // 比较器：元素不小于 value
+            const int *q = p;
+            for (; static_cast<size_t>(p + len - q) >= n; ++q)
+            {
+                size_t k = 0;
+                while (k < n && q[k] >= value)
+                    ++k;
+                if (k == n)
+                    break;
+            }
+            if (static_cast<size_t>(p + len - q) < n)
+                q = p + len;
+            auto ge = [](int x, int y) { return x >= y; };
+            assert(MyStl::search_n(mv.begin(), mv.end(), n, value, ge) - mv.begin() == q - p);
+            (void)expected;
+        }
+
+        const auto adj = naive_adjacent_find(p, p + len) - p;
+        assert(MyStl::adjacent_find(mv.begin(), mv.end()) - mv.begin() == adj);
+        assert(MyStl::distance(ml.begin(), MyStl::adjacent_find(ml.begin(), ml.end())) == adj);
+
+        // 比较器只接受元素：找第一对后一个比前一个大的相邻元素
+        auto rises = [](int a, int b) { return b > a; };
+        long rise = static_cast<long>(len);
+        for (size_t i = 0; i + 1 < len; ++i)
+        {
+            if (p[i + 1] > p[i])
+            {
+                rise = static_cast<long>(i);
+                break;
+            }
+        }
+        assert(MyStl::adjacent_find(p, p + len, rises) - p == rise);
+        assert(MyStl::distance(ml.begin(), MyStl::adjacent_find(ml.begin(), ml.end(), rises)) == rise);
+        (void)adj; (void)rise;
+    }
+}
+
+} // namespace
+
+int main()
+{
+    check_type<int8_t>({0, 1, -1, 127, -128});
+    check_type<uint8_t>({0, 1, 0x80, 0xff});
+    check_type<int16_t>({0, 1, -1, 0x100, -0x8000});
+    check_type<uint16_t>({0, 1, 0x8000, 0xffff});
+    check_type<int32_t>({0, 1, -1, 1 << 24, INT32_MIN});
+    check_type<uint32_t>({0, 1, 0x80000000u, 0xffffffffu});
+    check_type<int64_t>({0, 1, -1, 1LL << 40, INT64_MIN});
+    check_type<uint64_t>({0, 1, 1ULL << 63, ~0ULL});
+    check_type<float>({0.0f, 1.5f, -2.0f, 1e30f});
+    check_type<double>({0.0, 1.5, -2.0, 1e300});
+    check_adjacent_positions<uint8_t>();
+    check_adjacent_positions<uint16_t>();
+    check_adjacent_positions<uint32_t>();
+    check_adjacent_positions<uint64_t>();
+    check_adjacent_positions<double>();
+    test_converted_value();
+    test_float_specials<float>();
+    test_float_specials<double>();
+    test_generic();
+    simd_test::report("simd_search_n_test");
+    return 0;
+}
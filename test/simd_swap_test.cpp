@@ -0,0 +1,241 @@
+// swap_range / reverse 在原生指针上的 SIMD 路径测试，结果与逐个交换的朴素循环对照
+// 覆盖 1/2/4/8 字节的元素、不能按通道逆序的 3 字节和 16 字节结构体、0 到 300 的长度、起点不对齐的区间和重叠区间；
+// 另外检查不可逐字节交换的类型、数组 swap，以及 util.h 不再依赖 simd.h
+// g++ -std=c++14 -O2 -I.. simd_swap_test.cpp -o simd_swap_test && ./simd_swap_test
+// 另外用 -DMYSTL_NO_AVX2 和 -DMYSTL_NO_SIMD 各构建一次
+
+// util.h 必须能单独包含，且不能把 simd.h 带进来
+#include "../util.h"
+#ifdef MYSTL_SIMD_H_
+#error "util.h must not include simd.h"
+#endif
+
+#include <cassert>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../algo.h"
+#include "../vector.h"
+#include "simd_test_util.h"
+
+namespace
+{
+
+std::mt19937_64 rng(42);
+
+struct rgb
+{
+    unsigned char r, g, b;
+};
+
+bool operator==(const rgb &x, const rgb &y)
+{
+    return x.r == y.r && x.g == y.g && x.b == y.b;
+}
+
+struct wide
+{
+    uint64_t lo, hi;
+};
+
+bool operator==(const wide &x, const wide &y)
+{
+    return x.lo == y.lo && x.hi == y.hi;
+}
+
+template <class T>
+T make(uint64_t x)
+{
+    return static_cast<T>(x);
+}
+
+template <>
+rgb make<rgb>(uint64_t x)
+{
+    return rgb{static_cast<unsigned char>(x), static_cast<unsigned char>(x >> 8), static_cast<unsigned char>(x >> 16)};
+}
+
+template <>
+wide make<wide>(uint64_t x)
+{
+    return wide{x, ~x};
+}
+
+template <>
+std::string make<std::string>(uint64_t x)
+{
+    return std::string(static_cast<size_t>(x % 40), static_cast<char>('a' + x % 26));
+}
+
+template <class T>
+void fill(std::vector<T> &v)
+{
+    for (auto &x : v)
+        x = make<T>(rng());
+}
+
+template <class T>
+T* naive_swap_range(T *first1, T *last1, T *first2)
+{
+    for (; first1 != last1; ++first1, ++first2)
+    {
+        T tmp = *first1;
+        *first1 = *first2;
+        *first2 = tmp;
+    }
+    return first2;
+}
+
+template <class T>
+void naive_reverse(T *first, T *last)
+{
+    while (first < last)
+    {
+        --last;
+        T tmp = *first;
+        *first = *last;
+        *last = tmp;
+        ++first;
+    }
+}
+
+// 两段不重叠的区间，各自起点不对齐
+template <class T>
+void check_swap_range()
+{
+    std::vector<T> a(300 + 40), b(300 + 40);
+    for (size_t round = 0; round < 4; ++round)
+    {
+        for (size_t len = 0; len <= 300; len += 1 + (len > 70 ? rng() % 9 : 0))
+        {
+            const size_t oa = rng() % 33, ob = rng() % 33;
+            fill(a);
+            fill(b);
+            std::vector<T> ea(a), eb(b);
+            T *r = MyStl::swap_range(a.data() + oa, a.data() + oa + len, b.data() + ob);
+            naive_swap_range(ea.data() + oa, ea.data() + oa + len, eb.data() + ob);
+            assert(r == b.data() + ob + len);
+            assert(a == ea && b == eb);
+            (void)r;
+        }
+    }
+}
+
+// 同一个数组内两段重叠的区间退回逐个交换，结果必须和顺序逐个交换一致
+template <class T>
+void check_swap_range_overlap()
+{
+    std::vector<T> v(400);
+    for (size_t len = 1; len <= 200; len += 1 + rng() % 5)
+    {
+        for (size_t shift : {1u, 2u, 7u, 16u, 33u})
+        {
+            if (shift >= len)
+                continue;
+            fill(v);
+            std::vector<T> e(v);
+            const size_t from = rng() % 100;
+            T *r = MyStl::swap_range(v.data() + from, v.data() + from + len, v.data() + from + shift);
+            naive_swap_range(e.data() + from, e.data() + from + len, e.data() + from + shift);
+            assert(r == v.data() + from + shift + len);
+            assert(v == e);
+            // 反方向：第二段在前
+            fill(v);
+            e = v;
+            r = MyStl::swap_range(v.data() + from + shift, v.data() + from + shift + len, v.data() + from);
+            naive_swap_range(e.data() + from + shift, e.data() + from + shift + len, e.data() + from);
+            assert(r == v.data() + from + len);
+            assert(v == e);
+            (void)r;
+        }
+    }
+}
+
+template <class T>
+void check_reverse()
+{
+    std::vector<T> v(300 + 40);
+    for (size_t round = 0; round < 4; ++round)
+    {
+        for (size_t len = 0; len <= 300; ++len)
+        {
+            const size_t offset = rng() % 33;
+            fill(v);
+            std::vector<T> e(v);
+            MyStl::reverse(v.data() + offset, v.data() + offset + len);
+            naive_reverse(e.data() + offset, e.data() + offset + len);
+            assert(v == e);
+        }
+    }
+}
+
+// 迭代器不是原生指针时走逐个交换
+void test_generic()
+{
+    for (size_t len : {0u, 1u, 2u, 31u, 32u, 33u, 100u})
+    {
+        std::vector<int> src(len);
+        fill(src);
+        MyStl::vector<int> v(src.data(), src.data() + len);
+        MyStl::reverse(v.begin(), v.end());
+        for (size_t i = 0; i < len; ++i)
+            assert(v[i] == src[len - 1 - i]);
+        MyStl::vector<int> w(len, 7);
+        MyStl::swap_range(v.begin(), v.end(), w.begin());
+        for (size_t i = 0; i < len; ++i)
+            assert(w[i] == src[len - 1 - i] && v[i] == 7);
+    }
+}
+
+void test_array_swap()
+{
+    uint32_t a[37], b[37];
+    for (uint32_t i = 0; i < 37; ++i)
+    {
+        a[i] = i;
+        b[i] = 100 + i;
+    }
+    MyStl::swap(a, b);
+    for (uint32_t i = 0; i < 37; ++i)
+        assert(a[i] == 100 + i && b[i] == i);
+    std::string s[3] = {"x", "y", "z"}, t[3] = {"1", "2", "3"};
+    MyStl::swap(s, t);
+    assert(s[0] == "1" && s[2] == "3" && t[0] == "x" && t[2] == "z");
+}
+
+} // namespace
+
+int main()
+{
+    static_assert(MyStl::is_bitwise_swappable<int>::value, "");
+    static_assert(MyStl::is_bitwise_swappable<rgb>::value, "");
+    static_assert(!MyStl::is_bitwise_swappable<const int>::value, "");
+    static_assert(!MyStl::is_bitwise_swappable<std::string>::value, "");
+
+    check_swap_range<uint8_t>();
+    check_swap_range<uint16_t>();
+    check_swap_range<uint32_t>();
+    check_swap_range<uint64_t>();
+    check_swap_range<double>();
+    check_swap_range<rgb>();
+    check_swap_range<wide>();
+    check_swap_range<std::string>();
+    check_swap_range_overlap<uint8_t>();
+    check_swap_range_overlap<uint32_t>();
+    check_swap_range_overlap<rgb>();
+    check_reverse<int8_t>();
+    check_reverse<uint16_t>();
+    check_reverse<int32_t>();
+    check_reverse<float>();
+    check_reverse<uint64_t>();
+    check_reverse<double>();
+    check_reverse<rgb>();
+    check_reverse<wide>();
+    check_reverse<std::string>();
+    test_generic();
+    test_array_swap();
+    simd_test::report("simd_swap_test");
+    return 0;
+}
@@ -0,0 +1,42 @@
+#ifndef MYSTL_TEST_SIMD_TEST_UTIL_H_
+#define MYSTL_TEST_SIMD_TEST_UTIL_H_
+
+// SIMD 快速路径测试共用的小工具
+// 每个测试都应在三种构建下各跑一次：默认（CPU 支持时走 AVX2）、-DMYSTL_NO_AVX2（SSE2）、-DMYSTL_NO_SIMD（标量）
+
+#include <cstddef>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "../simd.h"
+
+namespace simd_test
+{
+
+// 当前构建实际走的内核
+inline const char* path_name()
+{
+#if defined(MYSTL_SIMD_X86)
+    return MyStl::simd::has_avx2() ? "avx2" : "sse2";
+#else
+    return "scalar";
+#endif
+}
+
+inline void report(const char *test)
+{
+    std::printf("%s: ok (%s)\n", test, path_name());
+}
+
+// 从 alphabet 的前 alpha 个值中随机取值，值域越小重复越多
+template <class T, class Rng>
+void fill_random(std::vector<T> &v, const std::vector<T> &alphabet, size_t alpha, Rng &rng)
+{
+    for (auto &x : v)
+        x = alphabet[rng() % alpha];
+}
+
+} // namespace simd_test
+
+#endif
@@ -0,0 +1,155 @@
+// skip_list 的多线程压力测试
+// 每个线程只修改属于自己的键（key % threads == id），并用 std::set 记录这些键的预期状态，
+// 同时查找、扫描所有线程的键；最后检查全部删除之后跳表为空
+// g++ -std=c++14 -O2 -pthread -I.. skip_list_stress.cpp -o skip_list_stress && ./skip_list_stress [threads] [ops]
+// 也应在 -fsanitize=thread 与 -fsanitize=address 下运行
+
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "../skip_list.h"
+
+namespace
+{
+
+typedef MyStl::skip_list<uint64_t, uint64_t> list_type;
+
+// 键的范围较小，插入和删除频繁地落在相同的前驱上
+const uint64_t key_range = 4096;
+
+uint64_t value_of(uint64_t k) { return k * 7 + 1; }
+
+void worker(list_type &list, unsigned id, unsigned threads, size_t ops)
+{
+    std::mt19937_64 rng(id * 7919 + 1);
+    std::set<uint64_t> own;
+    auto own_key = [&]() { return (rng() % (key_range / threads)) * threads + id; };
+
+    for (size_t i = 0; i < ops; ++i)
+    {
+        unsigned op = static_cast<unsigned>(rng() % 100);
+        if (op < 35)
+        {
+            uint64_t k = own_key();
+            bool inserted = list.insert(k, value_of(k));
+            assert(inserted == own.insert(k).second);
+            (void)inserted;
+        }
+        else if (op < 65)
+        {
+            uint64_t k = own_key();
+            bool erased = list.erase(k);
+            assert(erased == (own.erase(k) == 1));
+            (void)erased;
+        }
+        else if (op < 90)
+        {
+            // 查任意线程的键，自己的键必须与预期一致
+            uint64_t k = rng() % key_range;
+            uint64_t value = 0;
+            bool found = list.find(k, value);
+            assert(!found || value == value_of(k));
+            assert(found == list.contains(k) || k % threads != id);
+            if (k % threads == id)
+                assert(found == (own.count(k) == 1));
+        }
+        else
+        {
+            uint64_t low = rng() % key_range;
+            uint64_t high = low + rng() % 512;
+            std::vector<uint64_t> seen;
+            size_t visited = list.scan(low, high, [&](const uint64_t &k, const uint64_t &value)
+            {
+                assert(k >= low && k < high);
+                assert(seen.empty() || seen.back() < k);
+                assert(value == value_of(k));
+                seen.push_back(k);
+            });
+            assert(visited == seen.size());
+            (void)visited;
+            std::vector<uint64_t> mine, expected;
+            for (auto k : seen)
+                if (k % threads == id) mine.push_back(k);
+            for (auto it = own.lower_bound(low); it != own.end() && *it < high; ++it)
+                expected.push_back(*it);
+            assert(mine == expected);
+        }
+    }
+
+    // 删除自己剩下的键
+    for (auto k : own)
+    {
+        bool erased = list.erase(k);
+        assert(erased);
+        (void)erased;
+    }
+}
+
+void test_concurrent(unsigned threads, size_t ops)
+{
+    list_type list;
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; ++t)
+        pool.emplace_back(worker, std::ref(list), t, threads, ops);
+    for (auto &th : pool)
+        th.join();
+    assert(list.size() == 0 && list.empty());
+    size_t left = list.scan(0, key_range, [](const uint64_t &, const uint64_t &) {});
+    assert(left == 0);
+    (void)left;
+}
+
+// 多个线程同时插入、删除同一批键：每个键最终的存在性由成功次数之差决定
+void test_contended(unsigned threads, size_t rounds)
+{
+    const uint64_t keys = 64;
+    list_type list;
+    std::vector<std::vector<int>> balance(threads, std::vector<int>(keys, 0));
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; ++t)
+    {
+        pool.emplace_back([&, t]()
+        {
+            std::mt19937_64 rng(t + 100);
+            for (size_t i = 0; i < rounds; ++i)
+            {
+                uint64_t k = rng() % keys;
+                if (rng() % 2)
+                    balance[t][k] += list.insert(k, value_of(k)) ? 1 : 0;
+                else
+                    balance[t][k] -= list.erase(k) ? 1 : 0;
+            }
+        });
+    }
+    for (auto &th : pool)
+        th.join();
+    size_t present = 0;
+    for (uint64_t k = 0; k < keys; ++k)
+    {
+        int sum = 0;
+        for (unsigned t = 0; t < threads; ++t)
+            sum += balance[t][k];
+        assert(sum == 0 || sum == 1);
+        assert(list.contains(k) == (sum == 1));
+        present += sum;
+    }
+    assert(list.size() == present);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    unsigned threads = argc > 1 ? static_cast<unsigned>(std::atoi(argv[1])) : 8;
+    size_t ops = argc > 2 ? static_cast<size_t>(std::atoll(argv[2])) : 200000;
+    test_concurrent(threads, ops);
+    test_contended(threads, ops);
+    std::puts("skip_list_stress: ok");
+    return 0;
+}
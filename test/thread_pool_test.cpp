@@ -0,0 +1,274 @@
+// thread_pool.h 的测试
+// 覆盖 ws_deque 的所有者与窃取者并发（每个任务恰好被取走一次）、task_group 的异常传播（包括嵌套的任务组）、
+// parallel_for 每个下标恰好执行一次、parallel_invoke，以及线程数的配置顺序：
+// configure 优先于环境变量 MYSTL_NUM_THREADS，二者都没有时取硬件线程数，线程池创建之后 configure 不再生效
+// 线程池是进程内的单例，配置相关的检查通过以不同环境变量重新运行本程序完成
+// g++ -std=c++14 -O2 -pthread -I.. thread_pool_test.cpp -o thread_pool_test && ./thread_pool_test
+// 也应在 -fsanitize=thread 与 -fsanitize=address 下运行
+
+#include <atomic>
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../thread_pool.h"
+
+namespace
+{
+
+// 所有者在底部压入、弹出，3 个窃取者在顶部窃取，每个任务恰好被取走一次
+void test_ws_deque()
+{
+    const size_t n = 200000;
+    std::vector<MyStl::task_base> tasks(n);
+    std::vector<std::atomic<int>> taken(n);
+    for (auto &t : taken)
+        t.store(0);
+    MyStl::ws_deque deque;
+    std::atomic<bool> done{false};
+    std::atomic<size_t> stolen{0};
+
+    auto take = [&](MyStl::task_base *t)
+    {
+        const size_t i = static_cast<size_t>(t - tasks.data());
+        int before = taken[i].fetch_add(1, std::memory_order_relaxed);
+        assert(before == 0);
+        (void)before;
+    };
+    std::vector<std::thread> thieves;
+    for (int k = 0; k < 3; ++k)
+    {
+        thieves.emplace_back([&]
+        {
+            while (!done.load(std::memory_order_acquire))
+            {
+                MyStl::task_base *t = deque.steal();
+                if (t != nullptr)
+                {
+                    take(t);
+                    stolen.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+    // 每压入 3 个弹出 1 个，中途队列会扩容多次
+    for (size_t i = 0; i < n; ++i)
+    {
+        deque.push(&tasks[i]);
+        if (i % 3 == 2)
+        {
+            MyStl::task_base *t = deque.pop();
+            if (t != nullptr)
+                take(t);
+        }
+    }
+    for (MyStl::task_base *t; (t = deque.pop()) != nullptr;)
+        take(t);
+    done.store(true, std::memory_order_release);
+    for (auto &th : thieves)
+        th.join();
+    assert(deque.empty());
+    for (auto &t : taken)
+        assert(t.load() == 1);
+    std::printf("test_ws_deque: %zu of %zu tasks stolen\n", stolen.load(), n);
+}
+
+// sync 重新抛出第一个异常，其余任务照常完成；之后任务组可以继续使用
+void test_task_group_exception()
+{
+    MyStl::task_group group;
+    std::atomic<int> finished{0};
+    for (int i = 0; i < 100; ++i)
+    {
+        group.spawn([&, i]
+        {
+            if (i % 10 == 3)
+                throw std::runtime_error("task " + std::to_string(i));
+            finished.fetch_add(1);
+        });
+    }
+    bool caught = false;
+    try
+    {
+        group.sync();
+    }
+    catch (const std::runtime_error &e)
+    {
+        caught = std::strncmp(e.what(), "task ", 5) == 0;
+    }
+    assert(caught);
+    assert(finished.load() == 90);
+
+    // 异常已经被取走，再次使用不会重复抛出
+    group.spawn([&] { finished.fetch_add(1); });
+    group.sync();
+    assert(finished.load() == 91);
+
+    // 内层任务组的异常经过外层任务传到调用线程
+    caught = false;
+    try
+    {
+        MyStl::task_group outer;
+        for (int i = 0; i < 8; ++i)
+        {
+            outer.spawn([i]
+            {
+                MyStl::task_group inner;
+                for (int j = 0; j < 8; ++j)
+                {
+                    inner.spawn([i, j]
+                    {
+                        if (i == 5 && j == 6)
+                            throw std::logic_error("inner");
+                    });
+                }
+                inner.sync();
+            });
+        }
+        outer.sync();
+    }
+    catch (const std::logic_error &e)
+    {
+        caught = std::string(e.what()) == "inner";
+    }
+    assert(caught);
+
+    // 不调用 sync 直接析构时只等待任务结束，不抛出
+    {
+        MyStl::task_group dropped;
+        dropped.spawn([] { throw std::runtime_error("ignored"); });
+    }
+    (void)caught;
+}
+
+void test_parallel_for()
+{
+    auto &pool = MyStl::thread_pool::instance();
+    const size_t sizes[] = {0, 1, 7, 1000, 100003};
+    const size_t grains[] = {0, 1, 64, 1000000};
+    for (auto n : sizes)
+    {
+        for (auto grain : grains)
+        {
+            std::vector<std::atomic<int>> hits(n);
+            for (auto &h : hits)
+                h.store(0);
+            pool.parallel_for(n, grain, [&](size_t b, size_t e)
+            {
+                assert(b < e && e <= n);
+                for (; b != e; ++b)
+                    hits[b].fetch_add(1, std::memory_order_relaxed);
+            });
+            for (auto &h : hits)
+                assert(h.load() == 1);
+        }
+    }
+
+    bool caught = false;
+    try
+    {
+        pool.parallel_for(100000, 16, [](size_t b, size_t e)
+        {
+            if (b <= 77777 && 77777 < e)
+                throw std::out_of_range("77777");
+        });
+    }
+    catch (const std::out_of_range&)
+    {
+        caught = true;
+    }
+    assert(caught);
+
+    // 一侧抛出时另一侧仍会执行完
+    std::atomic<bool> right_done{false};
+    caught = false;
+    try
+    {
+        pool.parallel_invoke([] { throw std::runtime_error("left"); },
+                             [&] { right_done.store(true); });
+    }
+    catch (const std::runtime_error&)
+    {
+        caught = true;
+    }
+    assert(caught && right_done.load());
+    (void)caught;
+}
+
+// 子进程：按参数 configure，然后检查线程池的实际线程数
+int child(int argc, char **argv)
+{
+    size_t configure = 0, expect = 0;
+    bool pin = false;
+    for (int i = 2; i + 1 < argc; i += 2)
+    {
+        if (std::strcmp(argv[i], "--configure") == 0)
+            configure = std::strtoul(argv[i + 1], nullptr, 10);
+        else if (std::strcmp(argv[i], "--expect") == 0)
+            expect = std::strtoul(argv[i + 1], nullptr, 10);
+        else if (std::strcmp(argv[i], "--pin") == 0)
+            pin = std::strcmp(argv[i + 1], "1") == 0;
+    }
+    if (configure != 0 && !MyStl::thread_pool::configure(configure, pin))
+        return 2;
+    auto &pool = MyStl::thread_pool::instance();
+    if (MyStl::thread_pool::configure(1))
+        return 3;
+    std::atomic<size_t> sum{0};
+    pool.parallel_for(10000, 10, [&](size_t b, size_t e)
+    {
+        for (; b != e; ++b)
+            sum.fetch_add(b, std::memory_order_relaxed);
+    });
+    if (sum.load() != 10000 * 9999 / 2)
+        return 4;
+    return pool.concurrency() == expect ? 0 : 1;
+}
+
+void test_configure(const char *self)
+{
+    const size_t hardware = std::thread::hardware_concurrency() == 0 ? 1 : std::thread::hardware_concurrency();
+    struct
+    {
+        const char *env;
+        const char *args;
+        size_t      expect;
+    } cases[] = {
+        {"",                                         "",                   hardware},
+        {"MYSTL_NUM_THREADS=3",                      "",                   3},
+        {"MYSTL_NUM_THREADS=1",                      "",                   1},
+        {"MYSTL_NUM_THREADS=3",                      "--configure 5",      5},
+        {"",                                         "--configure 2",      2},
+        {"MYSTL_NUM_THREADS=4 MYSTL_PIN_THREADS=1",  "",                   4},
+        {"",                                         "--configure 3 --pin 1", 3},
+    };
+    for (auto &c : cases)
+    {
+        const std::string cmd = std::string("env -u MYSTL_NUM_THREADS -u MYSTL_PIN_THREADS ") + c.env + " '" +
+                                self + "' --child " + c.args + " --expect " + std::to_string(c.expect);
+        int status = std::system(cmd.c_str());
+        if (status != 0)
+            std::printf("failed: %s (status %d)\n", cmd.c_str(), status);
+        assert(status == 0);
+    }
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    if (argc > 1 && std::strcmp(argv[1], "--child") == 0)
+        return child(argc, argv);
+    test_configure(argv[0]);
+    MyStl::thread_pool::configure(4);
+    test_ws_deque();
+    test_task_group_exception();
+    test_parallel_for();
+    std::puts("thread_pool_test: ok");
+    return 0;
+}
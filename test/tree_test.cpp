@@ -0,0 +1,177 @@
+// tree.hpp 的遍历与析构测试
+// g++ -std=c++14 -O2 -I.. tree_test.cpp -o tree_test && ./tree_test
+
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include "../tree.hpp"
+
+namespace
+{
+
+struct visitor_error : std::runtime_error
+{
+    visitor_error() : std::runtime_error("visitor_error") {}
+};
+
+template <class Tree>
+std::vector<int> collect(Tree &tree, int order)
+{
+    std::vector<int> out;
+    auto push = [&](const int &v) { out.push_back(v); };
+    if (order == 0) tree.pre_order(push);
+    else if (order == 1) tree.in_order(push);
+    else if (order == 2) tree.post_order(push);
+    else tree.level_order(push);
+    return out;
+}
+
+// 访问器在第 k 个结点处抛出异常或返回 false 后，树的结构必须与遍历前完全相同
+template <class Tree>
+void check_interrupted(Tree &tree)
+{
+    std::vector<int> expected[4];
+    for (int order = 0; order < 4; ++order)
+        expected[order] = collect(tree, order);
+    const size_t n = expected[0].size();
+    for (int order = 0; order < 3; ++order)
+    {
+        for (size_t k = 0; k < n; ++k)
+        {
+            size_t seen = 0;
+            bool thrown = false;
+            try
+            {
+                auto visit = [&](const int &) {
+                    if (seen++ == k)
+                        throw visitor_error();
+                };
+                if (order == 0) tree.pre_order(visit);
+                else if (order == 1) tree.in_order(visit);
+                else tree.post_order(visit);
+            }
+            catch (const visitor_error &)
+            {
+                thrown = true;
+            }
+            assert(thrown && seen == k + 1);
+            for (int o = 0; o < 4; ++o)
+                assert(collect(tree, o) == expected[o]);
+
+            seen = 0;
+            auto stop = [&](const int &) { return seen++ != k; };
+            bool done = order == 0 ? tree.pre_order(stop) : order == 1 ? tree.in_order(stop) : tree.post_order(stop);
+            assert(!done && seen == k + 1);
+            for (int o = 0; o < 4; ++o)
+                assert(collect(tree, o) == expected[o]);
+        }
+    }
+}
+
+void test_interrupted_traversal()
+{
+    AVL<int> avl{50, 20, 80, 10, 30, 70, 90, 5, 15, 25, 35, 65, 75, 85, 95, 1, 99, 33};
+    check_interrupted(avl);
+
+    // 形状不规则的普通二叉树，-1 表示空结点
+    BinaryTree<int> tree({1, 2, 4, -1, 7, -1, -1, 5, 8, -1, -1, -1, 3, -1, 6, 9, -1, -1, 10, -1, -1, -1});
+    assert(collect(tree, 0) == std::vector<int>({1, 2, 4, 7, 5, 8, 3, 6, 9, 10}));
+    assert(collect(tree, 1) == std::vector<int>({4, 7, 2, 8, 5, 1, 3, 9, 6, 10}));
+    assert(collect(tree, 2) == std::vector<int>({7, 4, 8, 5, 2, 9, 10, 6, 3, 1}));
+    assert(collect(tree, 3) == std::vector<int>({1, 2, 3, 4, 5, 6, 7, 8, 9, 10}));
+    check_interrupted(tree);
+}
+
+// 一百万个结点的链状树：建树、遍历、统计和析构都不能递归
+void test_degenerate_tree()
+{
+    const int n = 1000000;
+    for (int left_chain = 0; left_chain < 2; ++left_chain)
+    {
+        std::vector<int> preorder;
+        for (int i = 1; i <= n; ++i)
+        {
+            preorder.push_back(i);
+            if (!left_chain)
+                preorder.push_back(-1);
+        }
+        for (int i = 0; i <= (left_chain ? n : 1); ++i)
+            preorder.push_back(-1);
+        BinaryTree<int> tree(preorder);
+        assert(tree.get_height() == n);
+        assert(tree.get_all_num() == n);
+        assert(tree.get_all_leaf() == 1);
+        long long sum = 0;
+        tree.post_order([&](const int &v) { sum += v; });
+        assert(sum == 1LL * n * (n + 1) / 2);
+        sum = 0;
+        tree.level_order([&](const int &v) { sum += v; });
+        assert(sum == 1LL * n * (n + 1) / 2);
+    }
+}
+
+// AVL 的 rank / select / erase，值域很小，保证有大量重复元素；与有序 vector 对照
+void test_order_statistics()
+{
+    std::mt19937 rng(7);
+    AVL<int> avl;
+    std::vector<int> expected;
+    assert(avl.size() == 0);
+    assert(!avl.select(0).second);
+    assert(avl.rank(0) == 0);
+    for (int round = 0; round < 20000; ++round)
+    {
+        int value = static_cast<int>(rng() % 64);
+        if (rng() % 3 != 0)
+        {
+            avl.insert(value);
+            expected.insert(std::upper_bound(expected.begin(), expected.end(), value), value);
+        }
+        else
+        {
+            auto it = std::lower_bound(expected.begin(), expected.end(), value);
+            bool present = it != expected.end() && *it == value;
+            assert(avl.erase(value) == present);
+            if (present)
+                expected.erase(it);
+        }
+        assert(avl.size() == expected.size());
+        if (round % 97 != 0)
+            continue;
+        assert(avl.is_balance());
+        for (size_t k = 0; k < expected.size(); ++k)
+        {
+            auto r = avl.select(k);
+            assert(r.second && r.first -> value == expected[k]);
+        }
+        assert(!avl.select(expected.size()).second);
+        for (int v = -1; v <= 65; ++v)
+        {
+            size_t lower = std::lower_bound(expected.begin(), expected.end(), v) - expected.begin();
+            assert(avl.rank(v) == lower);
+        }
+    }
+    // 全部删完后树为空
+    for (auto v : expected)
+    {
+        bool erased = avl.erase(v);
+        assert(erased);
+        (void)erased;
+    }
+    assert(avl.size() == 0 && !avl.erase(0));
+}
+
+} // namespace
+
+int main()
+{
+    test_interrupted_traversal();
+    test_degenerate_tree();
+    test_order_statistics();
+    std::puts("tree_test: ok");
+    return 0;
+}
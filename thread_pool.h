@@ -0,0 +1,618 @@
+#ifndef MYSTL_THREAD_POOL_H_
+#define MYSTL_THREAD_POOL_H_
+
+// 这个头文件包含 MyStl 并行算法共用的工作窃取调度器
+//
+// notes:
+//
+// 结构：
+//   * 每个工作线程拥有一个 Chase-Lev 双端队列：自己在底部压入、弹出，其他线程在顶部无锁窃取
+//   * 非工作线程提交的任务进入一个加锁的注入队列
+//   * 空闲线程随机选择受害者窃取，多次失败后在条件变量上休眠，有新任务时被唤醒
+// 接口：
+//   * task_group::spawn / sync：派生任务并等待其全部完成，等待期间当前线程会帮忙执行任务
+//   * parallel_for：惰性二分（lazy binary splitting），只有在本地队列为空、其他线程可能饥饿时才切分区间，
+//     否则按 grain 顺序执行，块大小随负载自动调整
+//   * parallel_invoke：并行执行两个函数对象
+// 配置：
+//   * 线程数依次取 thread_pool::configure、环境变量 MYSTL_NUM_THREADS、硬件线程数
+//   * configure 的 pin 参数或环境变量 MYSTL_PIN_THREADS=1 把工作线程绑定到各自的 CPU（仅 Linux）
+//   * 配置只在线程池第一次使用之前有效
+// 任务抛出的第一个异常会在 sync / parallel_for 的调用线程上重新抛出
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+// 空闲线程休眠前尝试窃取的轮数
+#ifndef MYSTL_POOL_SPIN
+#define MYSTL_POOL_SPIN 64
+#endif
+
+namespace MyStl
+{
+
+class thread_pool;
+
+// 所有任务的公共基类，execute 负责执行并释放自身
+struct task_base
+{
+    void (*execute)(task_base*);
+};
+
+/*****************************************************************************************/
+// ws_deque
+// Chase-Lev 工作窃取双端队列（按 Lê 等人给出的 C11 内存序实现）
+// 只有所有者线程调用 push / pop，任意线程调用 steal；扩容后的旧数组保留到析构，窃取者可能仍在读取
+/*****************************************************************************************/
+class ws_deque
+{
+private:
+    struct ring
+    {
+        int64_t                 capacity;
+        std::atomic<task_base*> *slots;
+
+        explicit ring(int64_t cap) : capacity(cap), slots(new std::atomic<task_base*>[cap]) {}
+        ~ring() { delete[] slots; }
+
+        task_base* get(int64_t i) const { return slots[i & (capacity - 1)].load(std::memory_order_acquire); }
+        void put(int64_t i, task_base *t) { slots[i & (capacity - 1)].store(t, std::memory_order_release); }
+    };
+
+    alignas(64) std::atomic<int64_t> top{0};
+    alignas(64) std::atomic<int64_t> bottom{0};
+    std::atomic<ring*>               array;
+    std::vector<ring*>               retired;   // 只由所有者访问
+
+public:
+    ws_deque() : array(new ring(1024)) {}
+
+    ~ws_deque()
+    {
+        delete array.load(std::memory_order_relaxed);
+        for (auto r : retired)
+            delete r;
+    }
+
+    ws_deque(const ws_deque&) = delete;
+    ws_deque& operator=(const ws_deque&) = delete;
+
+    void push(task_base *t)
+    {
+        const int64_t b = bottom.load(std::memory_order_relaxed);
+        const int64_t tp = top.load(std::memory_order_acquire);
+        ring *a = array.load(std::memory_order_relaxed);
+        if (b - tp > a -> capacity - 1)
+            a = grow(a, tp, b);
+        a -> put(b, t);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom.store(b + 1, std::memory_order_relaxed);
+    }
+
+    task_base* pop()
+    {
+        const int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        ring *a = array.load(std::memory_order_relaxed);
+        bottom.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t tp = top.load(std::memory_order_relaxed);
+        if (tp > b)
+        {
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        task_base *t = a -> get(b);
+        if (tp == b)
+        {
+            // 只剩最后一个元素，与窃取者竞争
+            if (!top.compare_exchange_strong(tp, tp + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                t = nullptr;
+            bottom.store(b + 1, std::memory_order_relaxed);
+        }
+        return t;
+    }
+
+    task_base* steal()
+    {
+        int64_t tp = top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t b = bottom.load(std::memory_order_acquire);
+        if (tp >= b)
+            return nullptr;
+        ring *a = array.load(std::memory_order_acquire);
+        task_base *t = a -> get(tp);
+        if (!top.compare_exchange_strong(tp, tp + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            return nullptr;
+        return t;
+    }
+
+    // 近似判断是否为空，用于切分决策
+    bool empty() const
+    {
+        return bottom.load(std::memory_order_relaxed) <= top.load(std::memory_order_relaxed);
+    }
+
+private:
+    ring* grow(ring *old, int64_t tp, int64_t b)
+    {
+        ring *a = new ring(old -> capacity * 2);
+        for (int64_t i = tp; i < b; ++i)
+            a -> put(i, old -> get(i));
+        retired.push_back(old);
+        array.store(a, std::memory_order_release);
+        return a;
+    }
+};
+
+/*****************************************************************************************/
+// task_group
+// 派生一组任务并等待它们完成
+/*****************************************************************************************/
+class task_group
+{
+    friend class thread_pool;
+
+private:
+    std::atomic<size_t> pending{0};
+    std::mutex          error_mutex;
+    std::exception_ptr  error;
+
+    template <class Function>
+    struct task_node : task_base
+    {
+        Function   f;
+        task_group *group;
+
+        task_node(Function &&func, task_group *g) : f(std::move(func)), group(g)
+        {
+            execute = &task_node::run;
+        }
+
+        static void run(task_base *base)
+        {
+            auto node = static_cast<task_node*>(base);
+            auto group = node -> group;
+            try
+            {
+                node -> f();
+            }
+            catch (...)
+            {
+                group -> set_error(std::current_exception());
+            }
+            delete node;
+            // 这是任务对 group 的最后一次访问，之后 sync 可能返回、group 被销毁
+            group -> pending.fetch_sub(1, std::memory_order_acq_rel);
+        }
+    };
+
+public:
+    task_group() = default;
+    task_group(const task_group&) = delete;
+    task_group& operator=(const task_group&) = delete;
+
+    ~task_group() { wait(); }
+
+    template <class Function>
+    void spawn(Function &&f);
+
+    // 等待所有任务完成，期间帮忙执行任务；如有任务抛出异常则重新抛出第一个
+    void sync()
+    {
+        wait();
+        if (error)
+        {
+            auto e = error;
+            error = nullptr;
+            std::rethrow_exception(e);
+        }
+    }
+
+    // 只等待，不抛出异常
+    void wait();
+
+private:
+    void set_error(std::exception_ptr e)
+    {
+        std::lock_guard<std::mutex> lock(error_mutex);
+        if (!error)
+            error = e;
+    }
+};
+
+/*****************************************************************************************/
+// thread_pool
+/*****************************************************************************************/
+class thread_pool
+{
+    friend class task_group;
+
+private:
+    struct config
+    {
+        size_t threads = 0;      // 0 表示未指定
+        int    pin     = -1;     // -1 表示未指定
+        std::atomic<bool> created{false};
+    };
+
+    struct alignas(64) worker
+    {
+        ws_deque deque;
+        uint64_t seed;           // 只由所有者使用的随机数状态
+    };
+
+private:
+    std::vector<std::thread>     threads;
+    std::unique_ptr<unsigned char[]> worker_storage;  // C++14 的 new[] 不保证 64 字节对齐，在这块内存里手动对齐
+    worker                       *workers = nullptr;
+    size_t                       worker_count = 0;
+
+    std::mutex                   inject_mutex;
+    std::deque<task_base*>       injected;       // 非工作线程提交的任务
+    std::atomic<size_t>          injected_size{0};
+
+    std::mutex                   sleep_mutex;
+    std::condition_variable      sleep_cv;
+    std::atomic<uint64_t>        wake_epoch{0};
+    std::atomic<size_t>          sleepers{0};
+    std::atomic<bool>            stop{false};
+
+public:
+    static thread_pool& instance()
+    {
+        static thread_pool pool;
+        return pool;
+    }
+
+    // 在第一次使用线程池之前设置线程数和是否绑定 CPU，已经创建时返回 false
+    static bool configure(size_t threads, bool pin = false)
+    {
+        auto &c = get_config();
+        if (c.created.load(std::memory_order_acquire))
+            return false;
+        c.threads = threads;
+        c.pin = pin ? 1 : 0;
+        return true;
+    }
+
+    ~thread_pool()
+    {
+        stop.store(true, std::memory_order_seq_cst);
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex);
+        }
+        sleep_cv.notify_all();
+        for (auto &t : threads)
+            t.join();
+        for (size_t i = 0; i < worker_count; ++i)
+            workers[i].~worker();
+    }
+
+    // 参与并行计算的线程数（工作线程加上发起线程）
+    size_t concurrency() const { return worker_count + 1; }
+
+    // 对 [0, n) 执行 f(begin, end)，grain 为顺序执行的最小块，全部完成后返回
+    template <class Function>
+    void parallel_for(size_t n, size_t grain, Function f)
+    {
+        if (n == 0)
+            return;
+        if (grain == 0)
+            grain = 1;
+        if (worker_count == 0 || n <= grain)
+        {
+            f(0, n);
+            return;
+        }
+        task_group group;
+        try
+        {
+            run_range(group, f, 0, n, grain);
+        }
+        catch (...)
+        {
+            // 派生出去的任务仍引用 f 和 group，必须等它们结束
+            group.wait();
+            throw;
+        }
+        group.sync();
+    }
+
+    // 并行执行 f1 和 f2
+    template <class Function1, class Function2>
+    void parallel_invoke(Function1 &&f1, Function2 &&f2)
+    {
+        if (worker_count == 0)
+        {
+            f1();
+            f2();
+            return;
+        }
+        task_group group;
+        group.spawn(std::forward<Function2>(f2));
+        try
+        {
+            f1();
+        }
+        catch (...)
+        {
+            group.wait();
+            throw;
+        }
+        group.sync();
+    }
+
+private:
+    thread_pool()
+    {
+        auto &c = get_config();
+        c.created.store(true, std::memory_order_release);
+
+        size_t n = c.threads;
+        if (n == 0)
+            n = env_size("MYSTL_NUM_THREADS");
+        if (n == 0)
+            n = std::thread::hardware_concurrency();
+        if (n == 0)
+            n = 1;
+        const bool pin = c.pin >= 0 ? c.pin == 1 : env_size("MYSTL_PIN_THREADS") == 1;
+
+        worker_count = n - 1;
+        size_t space = sizeof(worker) * worker_count + alignof(worker);
+        worker_storage.reset(new unsigned char[space]);
+        void *p = worker_storage.get();
+        workers = static_cast<worker*>(std::align(alignof(worker), sizeof(worker) * worker_count, p, space));
+        for (size_t i = 0; i < worker_count; ++i)
+        {
+            ::new (static_cast<void*>(workers + i)) worker();
+            workers[i].seed = 0x9E3779B97F4A7C15ull * (i + 1);
+        }
+        for (size_t i = 0; i < worker_count; ++i)
+            threads.emplace_back([this, i] { worker_loop(i); });
+        if (pin)
+            pin_threads();
+    }
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    static config& get_config()
+    {
+        static config c;
+        return c;
+    }
+
+    static size_t env_size(const char *name)
+    {
+        const char *value = std::getenv(name);
+        return value == nullptr ? 0 : static_cast<size_t>(std::strtoul(value, nullptr, 10));
+    }
+
+    // 当前线程在池中的下标，非工作线程为 -1
+    static long& local_index()
+    {
+        static thread_local long index = -1;
+        return index;
+    }
+
+    void pin_threads()
+    {
+#if defined(__linux__)
+        cpu_set_t allowed;
+        CPU_ZERO(&allowed);
+        if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0)
+            return;
+        std::vector<int> cpus;
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+            if (CPU_ISSET(cpu, &allowed))
+                cpus.push_back(cpu);
+        if (cpus.empty())
+            return;
+        // 发起线程通常运行在第一个 CPU 上，工作线程从第二个开始依次绑定
+        for (size_t i = 0; i < threads.size(); ++i)
+        {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpus[(i + 1) % cpus.size()], &set);
+            pthread_setaffinity_np(threads[i].native_handle(), sizeof(set), &set);
+        }
+#endif
+    }
+
+    void submit(task_base *t)
+    {
+        const long self = local_index();
+        if (self >= 0)
+        {
+            workers[self].deque.push(t);
+        }
+        else
+        {
+            std::lock_guard<std::mutex> lock(inject_mutex);
+            injected.push_back(t);
+            injected_size.fetch_add(1, std::memory_order_release);
+        }
+        wake_one();
+    }
+
+    void wake_one()
+    {
+        wake_epoch.fetch_add(1, std::memory_order_seq_cst);
+        if (sleepers.load(std::memory_order_seq_cst) != 0)
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex);
+            sleep_cv.notify_one();
+        }
+    }
+
+    // 当前线程的本地队列是否为空；为空说明派生出去的任务都已被取走，值得继续切分
+    bool local_empty() const
+    {
+        const long self = local_index();
+        if (self >= 0)
+            return workers[self].deque.empty();
+        return injected_size.load(std::memory_order_relaxed) == 0;
+    }
+
+    task_base* take_injected()
+    {
+        if (injected_size.load(std::memory_order_acquire) == 0)
+            return nullptr;
+        std::lock_guard<std::mutex> lock(inject_mutex);
+        if (injected.empty())
+            return nullptr;
+        task_base *t = injected.front();
+        injected.pop_front();
+        injected_size.fetch_sub(1, std::memory_order_relaxed);
+        return t;
+    }
+
+    // 依次尝试：本地队列底部、注入队列、随机受害者的队列顶部
+    task_base* find_task()
+    {
+        const long self = local_index();
+        task_base *t = nullptr;
+        if (self >= 0 && (t = workers[self].deque.pop()) != nullptr)
+            return t;
+        if ((t = take_injected()) != nullptr)
+            return t;
+        if (worker_count == 0)
+            return nullptr;
+        size_t start;
+        if (self >= 0)
+        {
+            // xorshift64
+            uint64_t &x = workers[self].seed;
+            x ^= x << 13;
+            x ^= x >> 7;
+            x ^= x << 17;
+            start = static_cast<size_t>(x % worker_count);
+        }
+        else
+        {
+            start = static_cast<size_t>(std::hash<std::thread::id>()(std::this_thread::get_id()) % worker_count);
+        }
+        for (size_t k = 0; k < worker_count; ++k)
+        {
+            const size_t victim = (start + k) % worker_count;
+            if (static_cast<long>(victim) == self)
+                continue;
+            if ((t = workers[victim].deque.steal()) != nullptr)
+                return t;
+        }
+        return nullptr;
+    }
+
+    bool run_one()
+    {
+        task_base *t = find_task();
+        if (t == nullptr)
+            return false;
+        t -> execute(t);
+        return true;
+    }
+
+    // 惰性二分：本地队列为空时把右半部分派生出去，否则顺序执行一块
+    template <class Function>
+    void run_range(task_group &group, Function &f, size_t begin, size_t end, size_t grain)
+    {
+        while (end - begin > grain)
+        {
+            if (local_empty())
+            {
+                const size_t mid = begin + (end - begin) / 2;
+                group.spawn([this, &group, &f, mid, end, grain]
+                {
+                    run_range(group, f, mid, end, grain);
+                });
+                end = mid;
+            }
+            else
+            {
+                f(begin, begin + grain);
+                begin += grain;
+            }
+        }
+        f(begin, end);
+    }
+
+    void worker_loop(size_t index)
+    {
+        local_index() = static_cast<long>(index);
+        while (!stop.load(std::memory_order_acquire))
+        {
+            if (run_one())
+                continue;
+            bool found = false;
+            for (int spin = 0; spin < MYSTL_POOL_SPIN && !found; ++spin)
+            {
+                std::this_thread::yield();
+                found = run_one();
+            }
+            if (found)
+                continue;
+
+            const uint64_t epoch = wake_epoch.load(std::memory_order_seq_cst);
+            sleepers.fetch_add(1, std::memory_order_seq_cst);
+            if (run_one())
+            {
+                sleepers.fetch_sub(1, std::memory_order_seq_cst);
+                continue;
+            }
+            {
+                std::unique_lock<std::mutex> lock(sleep_mutex);
+                sleep_cv.wait(lock, [this, epoch]
+                {
+                    return stop.load(std::memory_order_seq_cst) ||
+                           wake_epoch.load(std::memory_order_seq_cst) != epoch;
+                });
+            }
+            sleepers.fetch_sub(1, std::memory_order_seq_cst);
+        }
+    }
+};
+
+template <class Function>
+void task_group::spawn(Function &&f)
+{
+    typedef task_node<typename std::decay<Function>::type> node_type;
+    auto &pool = thread_pool::instance();
+    if (pool.worker_count == 0)
+    {
+        f();
+        return;
+    }
+    pending.fetch_add(1, std::memory_order_relaxed);
+    pool.submit(new node_type(typename std::decay<Function>::type(std::forward<Function>(f)), this));
+}
+
+inline void task_group::wait()
+{
+    auto &pool = thread_pool::instance();
+    while (pending.load(std::memory_order_acquire) != 0)
+    {
+        if (!pool.run_one())
+            std::this_thread::yield();
+    }
+}
+
+} // namespace MyStl
+
+#endif
@@ -9,6 +9,7 @@
 #include <algorithm>
 #include <stack>
 #include <functional>
+#include <type_traits>
 using namespace std;
 
 template <class T>
@@ -26,116 +27,221 @@ public:
     
 };
 
+// AVL 结点：额外缓存子树高度和子树结点数
+// height 让旋转判定不再需要递归求高度，size 用于 O(log n) 的 rank / select
 template <class T>
+class AVLNode
+{
+public:
+    T value;
+    AVLNode* left;
+    AVLNode* right;
+    int height;
+    size_t size;
+
+public:
+    AVLNode(const T &value) : value(value), left(nullptr), right(nullptr), height(1), size(1) {}
+    ~AVLNode() = default;
+};
+
+// 左右子树变化后刷新结点缓存，由 AVL 的旋转和重平衡调用
+template <class Node>
+void update_avl_height_size(Node *node)
+{
+    int lh = node -> left ? node -> left -> height : 0;
+    int rh = node -> right ? node -> right -> height : 0;
+    node -> height = max(lh, rh) + 1;
+    node -> size = (node -> left ? node -> left -> size : 0) +
+                   (node -> right ? node -> right -> size : 0) + 1;
+}
+
+template <class T>
+void update_avl_node(AVLNode<T> *node)
+{
+    update_avl_height_size(node);
+}
+
+// Node 只需要提供 value / left / right，遍历等算法对所有结点类型通用
+template <class T, class Node = BinaryNode<T>>
 class BaseTree
 {
 public:
-    typedef BinaryNode<T>   BNode;
+    typedef Node            BNode;
     typedef T               value_type;
 protected:
-    BNode *root;
+    BNode *root = nullptr;
 public:
     BaseTree() = default;
     virtual ~BaseTree() = default;
 public:
     void pre_order()
     {
-        stack<BNode*> s;
-        s.push(root);
-        while (s.size())
-        {
-            auto tmp = s.top();
-            cout << tmp -> value << " ";
-            s.pop();
-            if (tmp -> right)
-                s.push(tmp -> right);
-            if (tmp -> left)
-                s.push(tmp -> left);
-        }
+        pre_order([](const value_type &value) { cout << value << " "; });
         cout << endl;
     }
 
     void in_order()
     {
-        stack<BNode*> s;
-        auto node = root;
-        while (node != nullptr || s.size())
+        in_order([](const value_type &value) { cout << value << " "; });
+        cout << endl;
+    }
+
+    void post_order()
+    {
+        post_order([](const value_type &value) { cout << value << " "; });
+        cout << endl;
+    }
+
+public:
+    // 带访问器的遍历：visit(const T&) 返回 false 时提前终止，返回 void 时遍历全部结点
+    // 遍历完成返回 true，被提前终止返回 false
+    // 前序/中序/后序使用 Morris 遍历，借用叶子的空右指针建立线索，不递归也不申请内存，
+    // 退化成链表的树也不会栈溢出。遍历期间会临时改写右指针，结束、提前终止或访问器抛出异常时
+    // 都由 morris_guard 复原，所以不能和其他读者并发遍历同一棵树
+    template <class Visitor>
+    bool pre_order(Visitor visit)
+    {
+        auto curr = root;
+        morris_guard guard(curr);
+        while (curr != nullptr)
         {
-            while (node != nullptr)
+            if (curr -> left == nullptr)
             {
-                s.push(node);
-                node = node -> left;
+                if (!call_visitor(visit, curr -> value))
+                    return false;
+                curr = curr -> right;
+                continue;
             }
-            if (s.size())
+            auto pre = rightmost_before(curr -> left, curr);
+            if (pre -> right == nullptr)
             {
-                node = s.top();
-                cout << node -> value << " ";
-                s.pop();
-                node = node -> right;
+                // 第一次到达：先访问，再建立线索进入左子树
+                if (!call_visitor(visit, curr -> value))
+                    return false;
+                pre -> right = curr;
+                curr = curr -> left;
+            }
+            else
+            {
+                // 沿线索回到 curr：左子树已访问完，拆除线索
+                pre -> right = nullptr;
+                curr = curr -> right;
             }
         }
-        cout << endl;
+        return true;
     }
 
-    void post_order()
+    template <class Visitor>
+    bool in_order(Visitor visit)
     {
-        stack<BNode*> s;
         auto curr = root;
-        BNode *pre = nullptr;
-        s.push(root);
-        while (s.size())
+        morris_guard guard(curr);
+        while (curr != nullptr)
         {
-            curr = s.top();
-            if ((curr -> left == nullptr && curr -> right == nullptr) || 
-                (pre != nullptr && (pre == curr -> left || pre == curr -> right)))
+            if (curr -> left == nullptr)
             {
-                cout << curr -> value << " ";
-                pre = curr;
-                s.pop();
-                
+                if (!call_visitor(visit, curr -> value))
+                    return false;
+                curr = curr -> right;
+                continue;
             }
-            else 
+            auto pre = rightmost_before(curr -> left, curr);
+            if (pre -> right == nullptr)
             {
-                if (curr -> right)
-                    s.push(curr -> right);
-                if (curr -> left)
-                    s.push(curr -> left);
+                pre -> right = curr;
+                curr = curr -> left;
+            }
+            else
+            {
+                pre -> right = nullptr;
+                if (!call_visitor(visit, curr -> value))
+                    return false;
+                curr = curr -> right;
             }
         }
-        cout << endl;
-        
+        return true;
     }
 
-public:
-    void pre_order_rec()
-    {
-        pre_order_impl(root);
-        cout << endl;
-    }
-    void in_order_rec()
+    template <class Visitor>
+    bool post_order(Visitor visit)
     {
-        in_order_impl(root);
-        cout << endl;
+        auto curr = root;
+        morris_guard guard(curr);
+        while (curr != nullptr)
+        {
+            if (curr -> left == nullptr)
+            {
+                curr = curr -> right;
+                continue;
+            }
+            auto pre = rightmost_before(curr -> left, curr);
+            if (pre -> right == nullptr)
+            {
+                pre -> right = curr;
+                curr = curr -> left;
+            }
+            else
+            {
+                // 左子树的右边界逆序输出即为这一段的后序
+                pre -> right = nullptr;
+                if (!visit_right_path_reversed(curr -> left, visit))
+                    return false;
+                curr = curr -> right;
+            }
+        }
+        return visit_right_path_reversed(root, visit);
     }
-    void post_order_rec()
+
+    // 层序遍历需要 O(宽度) 的额外空间：当前层和下一层各用一块连续缓冲区，
+    // 每层结束后交换并清空复用，代替 std::queue 按结点申请内存
+    template <class Visitor>
+    bool level_order(Visitor visit)
     {
-        post_order_impl(root);
-        cout << endl;
+        if (root == nullptr) return true;
+        vector<BNode*> level, next;
+        level.push_back(root);
+        while (!level.empty())
+        {
+            for (auto node : level)
+            {
+                if (!call_visitor(visit, node -> value))
+                    return false;
+                if (node -> left)
+                    next.push_back(node -> left);
+                if (node -> right)
+                    next.push_back(node -> right);
+            }
+            level.swap(next);
+            next.clear();
+        }
+        return true;
     }
+
+public:
+    // 保留原来的接口名，实际转发到不递归的 Morris 遍历
+    void pre_order_rec() { pre_order(); }
+    void in_order_rec() { in_order(); }
+    void post_order_rec() { post_order(); }
     void level_order()
     {
-        level_order_impl(root);
+        level_order([](const value_type &value) { cout << value << " "; });
         cout << endl;
     }
 
     int get_all_num()
     {
-        return get_all_num_impl(root);
+        int num = 0;
+        walk_nodes(root, [&](BNode *, int) { ++num; });
+        return num;
     }
 
     int get_all_leaf()
     {
-        return get_all_leaf_impl(root);
+        int leaf = 0;
+        walk_nodes(root, [&](BNode *node, int) {
+            if (node -> left == nullptr && node -> right == nullptr) ++leaf;
+        });
+        return leaf;
     }
 
     int get_height()
@@ -144,78 +250,142 @@ public:
     }
     
 protected:
+    // 不递归地释放整棵子树：有左孩子时右旋把左孩子提上来，没有左孩子时释放当前结点并沿右链前进
+    // 每个结点至多被旋转一次，O(n) 时间、O(1) 额外空间，退化成链表的树也不会栈溢出
     void freeBinaryTree(BNode *node)
     {
-        if (node == nullptr)
-            return;
-        BNode* left_node = node -> left;
-        BNode* right_node = node -> right;
-
-        delete node;
-        freeBinaryTree(left_node);
-        freeBinaryTree(right_node);
-        
+        while (node != nullptr)
+        {
+            if (node -> left != nullptr)
+            {
+                auto left = node -> left;
+                node -> left = left -> right;
+                left -> right = node;
+                node = left;
+            }
+            else
+            {
+                auto right = node -> right;
+                delete node;
+                node = right;
+            }
+        }
     }
-    
-    void pre_order_impl(BNode *node)
+
+    // 用显式栈前序访问 node 子树的每个结点，f(node, depth) 中根结点的深度为 1
+    // 栈放在堆上，深度只受内存限制
+    template <class F>
+    static void walk_nodes(BNode *node, F f)
     {
         if (node == nullptr) return;
-        cout << node -> value << " ";
-        pre_order_impl(node -> left);
-        pre_order_impl(node -> right);
+        vector<pair<BNode*, int>> stack;
+        stack.emplace_back(node, 1);
+        while (!stack.empty())
+        {
+            auto top = stack.back();
+            stack.pop_back();
+            f(top.first, top.second);
+            if (top.first -> right)
+                stack.emplace_back(top.first -> right, top.second + 1);
+            if (top.first -> left)
+                stack.emplace_back(top.first -> left, top.second + 1);
+        }
     }
 
-    void in_order_impl(BNode *node)
+    // 右指针被改写后，由析构函数负责复原的 Morris 线索：
+    // 正常结束时 curr 为空，什么也不做；提前终止或访问器抛出异常时从 curr 往上拆除剩余的线索
+    struct morris_guard
     {
-        if (node == nullptr) return;
-        in_order_impl(node -> left);
-        cout << node -> value << " ";
-        in_order_impl(node -> right);
+        BNode *&curr;
+        explicit morris_guard(BNode *&curr) : curr(curr) {}
+        ~morris_guard() { morris_restore(curr); }
+        morris_guard(const morris_guard&) = delete;
+        morris_guard& operator=(const morris_guard&) = delete;
+    };
+
+    // 右边界被反转期间，由析构函数把它反转回来
+    struct reversed_path_guard
+    {
+        BNode *tail;
+        explicit reversed_path_guard(BNode *tail) : tail(tail) {}
+        ~reversed_path_guard() { reverse_right_path(tail); }
+        reversed_path_guard(const reversed_path_guard&) = delete;
+        reversed_path_guard& operator=(const reversed_path_guard&) = delete;
+    };
+
+    // 访问器返回 void 时视为一直继续
+    template <class Visitor>
+    static bool call_visitor(Visitor &visit, const value_type &value, true_type)
+    {
+        visit(value);
+        return true;
     }
 
-    void post_order_impl(BNode *node)
+    template <class Visitor>
+    static bool call_visitor(Visitor &visit, const value_type &value, false_type)
     {
-        if (node == nullptr) return;
-        post_order_impl(node -> left);
-        post_order_impl(node -> right);
-        cout << node -> value << " ";
+        return static_cast<bool>(visit(value));
     }
-    
-    void level_order_impl(BNode *node)
+
+    template <class Visitor>
+    static bool call_visitor(Visitor &visit, const value_type &value)
     {
-        if (node == nullptr) return;
-        queue<BNode*> q;
-        q.push(node);
-        while (q.size())
+        return call_visitor(visit, value, is_void<decltype(visit(value))>{});
+    }
+
+    // 找到 node 所在右边界上最后一个结点，遇到指回 stop 的线索时停下
+    static BNode* rightmost_before(BNode *node, BNode *stop)
+    {
+        while (node -> right != nullptr && node -> right != stop)
+            node = node -> right;
+        return node;
+    }
+
+    // 提前终止时拆除尚未拆除的线索：只有"当前位置在其左子树中"的祖先才挂着线索，
+    // 沿右指针（含线索）往上爬即可逐个遇到它们，不需要再走一遍整棵树
+    static void morris_restore(BNode *node)
+    {
+        while (node != nullptr)
         {
-            auto node = q.front();
-            q.pop();
-            cout << node -> value << " ";
-            if (node -> left) 
-                q.push(node -> left);
-            if (node -> right)
-                q.push(node -> right);
+            if (node -> left != nullptr)
+            {
+                auto pre = rightmost_before(node -> left, node);
+                if (pre -> right == node)
+                    pre -> right = nullptr;
+            }
+            node = node -> right;
         }
-        
     }
 
-    int get_all_num_impl(BNode *node)
+    static BNode* reverse_right_path(BNode *node)
     {
-        if (node == nullptr) return 0;
-        return get_all_num_impl(node -> left) + get_all_num_impl(node -> right) + 1;
+        BNode *prev = nullptr;
+        while (node != nullptr)
+        {
+            auto next = node -> right;
+            node -> right = prev;
+            prev = node;
+            node = next;
+        }
+        return prev;
     }
 
-    int get_all_leaf_impl(BNode *node)
+    // 将 node 的右边界反转后自底向上访问，再反转回来；提前终止或抛出异常时同样会复原
+    template <class Visitor>
+    static bool visit_right_path_reversed(BNode *node, Visitor &visit)
     {
-        if (node == nullptr) return 0;
-        if (node -> left == nullptr && node -> right == nullptr) return 1;
-        return get_all_leaf_impl(node -> left) + get_all_leaf_impl(node -> right);
+        reversed_path_guard guard(reverse_right_path(node));
+        for (auto curr = guard.tail; curr != nullptr; curr = curr -> right)
+            if (!call_visitor(visit, curr -> value))
+                return false;
+        return true;
     }
 
-    int get_height_impl(BNode *node)
+    static int get_height_impl(BNode *node)
     {
-        if (node == nullptr) return 0;
-        return max(get_height_impl(node -> left), get_height_impl(node -> right)) + 1;
+        int height = 0;
+        walk_nodes(node, [&](BNode *, int depth) { height = max(height, depth); });
+        return height;
     }
 
 };
@@ -252,15 +422,25 @@ template <class T>
 typename BinaryTree<T>::BNode*
 BinaryTree<T>::create_node(const vector<T> &vec, int &index)
 {
-    if (vec[index] == mark)
+    // 按前序序列建树，mark 表示空结点；待填的孩子指针放在显式栈里，左孩子先出栈，不递归
+    BNode *result = nullptr;
+    vector<BNode**> slots;
+    slots.push_back(&result);
+    while (!slots.empty())
     {
-        ++index;
-        return nullptr;
+        auto slot = slots.back();
+        slots.pop_back();
+        if (vec[index] == mark)
+        {
+            ++index;
+            continue;
+        }
+        auto node = new BNode(vec[index++]);
+        *slot = node;
+        slots.push_back(&node -> right);
+        slots.push_back(&node -> left);
     }
-    auto node = new BinaryNode(vec[index++]);
-    node -> left = create_node(vec, index);
-    node -> right = create_node(vec, index);
-    return node;
+    return result;
 }
 
 
@@ -331,45 +511,26 @@ bool BinarySearchTree<T>::is_balance_impl(BNode *node)
 template <class T>
 void  BinarySearchTree<T>::create_node(const T &value, BNode *node)
 {
-    if (value > node -> value)
+    // 沿查找路径向下走到空位，循环代替尾递归，有序输入建出的链状树也不会栈溢出
+    while (true)
     {
-        if (node -> right == nullptr)
+        BNode *&child = value > node -> value ? node -> right : node -> left;
+        if (child == nullptr)
         {
-            node -> right = new BNode(value);
+            child = new BNode(value);
             return;
         }
-        else
-        {
-            create_node(value, node -> right);
-        }
-        
+        node = child;
     }
-    else 
-    {
-        if (node -> left == nullptr)
-        {
-            node -> left = new BNode(value);
-            return;
-        }
-        else
-        {
-            create_node(value, node -> left);
-        }
-    }    
 }
 
 template <class T>
 pair<typename BinarySearchTree<T>::BNode*, bool> BinarySearchTree<T>::find_value_impl(const T &value, BNode *node)
 {
-    if (node == nullptr) return {nullptr,false};
-    if (node -> value == value) return {node, true};
-    if (value > node -> value)
+    while (node != nullptr)
     {
-        return find_value_impl(value, node -> right);
-    }
-    else
-    {
-        return find_value_impl(value, node -> left);
+        if (node -> value == value) return {node, true};
+        node = value > node -> value ? node -> right : node -> left;
     }
     return {nullptr, false}; 
 }
@@ -479,181 +640,502 @@ pair<typename BinarySearchTree<T>::BNode*, bool> BinarySearchTree<T>::find_paren
                                                                     typename BinarySearchTree<T>::BNode *node, 
                                                                     typename BinarySearchTree<T>::BNode *pNode)
 {
-    if (node == nullptr) return {nullptr, false};
-    if (value == root -> value ) return {nullptr, false};
-    if (node -> value == value) return {pNode, true};
-    if (value > node -> value)
+    if (root == nullptr || value == root -> value) return {nullptr, false};
+    while (node != nullptr)
     {
+        if (node -> value == value) return {pNode, true};
         pNode = node;
-        return find_parent_impl(value, node -> right, pNode);
-    }
-    else
-    {
-        pNode = node;
-        return find_parent_impl(value, node -> left, pNode);
+        node = value > node -> value ? node -> right : node -> left;
     }
+    return {nullptr, false};
 }
 
 template <class T>
 void BinarySearchTree<T>::insert_node(BNode *node, BNode *start)
 {
-    if (node -> value > start -> value)
-    {
-        if (start -> right == nullptr)
-        {
-            start -> right = node;
-            return; 
-        }
-        else
-        {
-            insert_node(node, start -> right);
-        }
-    }
-    else
+    while (true)
     {
-        if (start -> left == nullptr)
+        BNode *&child = node -> value > start -> value ? start -> right : start -> left;
+        if (child == nullptr)
         {
-            start -> left = node;
+            child = node;
             return;
         }
-        else 
-        {
-            insert_node(node ,start -> left);
-        }
+        start = child;
     }
 }
 
-template <class T>
-class AVL : public BaseTree<T>
+template <class T, class Node = AVLNode<T>>
+class AVL : public BaseTree<T, Node>
 {
-private:
-    using BaseTree<T>::root;
-    using BaseTree<T>::freeBinaryTree;
-    typedef  typename BaseTree<T>::BNode BNode;
+protected:
+    typedef BaseTree<T, Node> base_type;
+    using base_type::root;
+    using base_type::freeBinaryTree;
+    typedef typename base_type::BNode BNode;
 public:
+    AVL() = default;
     AVL(const initializer_list<T> &li)
     {
-        auto it = li.begin();
-        root = new BNode(*it);
-        ++it;
-        for(; it != li.end(); ++it)
-        {
-           root = insert(*it);
-        }
-        
+        for (auto &value : li)
+            root = insert_impl(value, root);
     }
     ~AVL()
     {
         freeBinaryTree(root);
     }
 public:
-    BNode* insert(const T &value) { return insert_impl(value, root); }
+    // 返回插入后的根结点
+    BNode* insert(const T &value) { root = insert_impl(value, root); return root; }
+    // 删除一个等于 value 的结点，树中不存在时返回 false
+    bool erase(const T &value)
+    {
+        bool erased = false;
+        root = erase_impl(value, root, erased);
+        return erased;
+    }
     bool is_balance() { return is_balance_impl(root); }
 
-private:
+    // 结点数直接读根结点缓存的 size，O(1)
+    size_t size() const { return node_size(root); }
+    int get_all_num() { return static_cast<int>(node_size(root)); }
+    int get_height() { return node_height(root); }
+
+    // 顺序统计，均为 O(log n)
+    // select: 第 k 小的元素（k 从 0 开始），k 越界时返回 {nullptr, false}
+    pair<BNode*, bool> select(size_t k);
+    // rank: 树中严格小于 value 的元素个数
+    size_t rank(const T &value);
+
+protected:
     BNode* insert_impl(const T &value, BNode *node);
+    BNode* erase_impl(const T &value, BNode *node, bool &erased);
+    BNode* erase_min(BNode *node, BNode *&min_node);
     
     BNode* ll_rotate(BNode *node);
     BNode* rr_rotate(BNode *node);
     BNode* lr_rotate(BNode *node);
     BNode* rl_rotate(BNode *node);
+    BNode* rebalance(BNode *node);
+
+    static int    node_height(BNode *node) { return node == nullptr ? 0 : node -> height; }
+    static size_t node_size(BNode *node)   { return node == nullptr ? 0 : node -> size; }
+    // 按结点类型重载 update_avl_node，增强型结点可以顺带维护自己的附加信息
+    static void   update(BNode *node) { update_avl_node(node); }
 
     bool is_balance_impl(BNode *node);
 
     
 };
 
-template <class T>
-typename AVL<T>::BNode* AVL<T>::rr_rotate(BNode *node)
+template <class T, class Node>
+typename AVL<T, Node>::BNode* AVL<T, Node>::rr_rotate(BNode *node)
 {
     // 左旋, 失衡节点右结点的左孩子给失衡节点做右孩子，失衡节点做失衡结点右孩子的左孩子
     auto right = node -> right;
     node -> right = right -> left;
     right -> left = node;
+    // 先更新下沉的结点，再更新新的子树根
+    update(node);
+    update(right);
     return right;
 }
 
-template <class T>
-typename AVL<T>::BNode* AVL<T>::ll_rotate(BNode *node)
+template <class T, class Node>
+typename AVL<T, Node>::BNode* AVL<T, Node>::ll_rotate(BNode *node)
 {
     auto left = node -> left;
     node -> left = left -> right;
     left -> right = node;
+    update(node);
+    update(left);
     return left;
     
 }
 
-template <class T>
-typename AVL<T>::BNode* AVL<T>::lr_rotate(BNode *node)
+template <class T, class Node>
+typename AVL<T, Node>::BNode* AVL<T, Node>::lr_rotate(BNode *node)
 {
     node -> left = rr_rotate(node ->left); 
     return ll_rotate(node);
     
 }
 
-template <class T>
-typename AVL<T>::BNode* AVL<T>::rl_rotate(BNode *node)
+template <class T, class Node>
+typename AVL<T, Node>::BNode* AVL<T, Node>::rl_rotate(BNode *node)
 {
     node -> right = ll_rotate(node -> right);
     return rr_rotate(node);
     
 }
 
-template <class T>
-typename AVL<T>::BNode* AVL<T>::insert_impl(const T &value, BNode *node)
+// 子树发生变化后刷新缓存，并按平衡因子选择旋转方式
+template <class T, class Node>
+typename AVL<T, Node>::BNode* AVL<T, Node>::rebalance(BNode *node)
 {
-    if (node == nullptr)
+    update(node);
+    int factor = node_height(node -> left) - node_height(node -> right);
+    if (factor > 1)
+    {
+        if (node_height(node -> left -> left) < node_height(node -> left -> right))
+            return lr_rotate(node);
+        return ll_rotate(node);
+    }
+    if (factor < -1)
     {
-        cout << "已插入: " << value << endl;
+        if (node_height(node -> right -> right) < node_height(node -> right -> left))
+            return rl_rotate(node);
+        return rr_rotate(node);
+    }
+    return node;
+}
+
+template <class T, class Node>
+typename AVL<T, Node>::BNode* AVL<T, Node>::insert_impl(const T &value, BNode *node)
+{
+    if (node == nullptr)
         return new BNode(value);
+    if (value > node -> value)
+        node -> right = insert_impl(value, node -> right);
+    else 
+        node -> left = insert_impl(value, node -> left);
+    return rebalance(node);
+    
+}
+
+// 摘下子树中的最小结点，由 min_node 带出
+template <class T, class Node>
+typename AVL<T, Node>::BNode* AVL<T, Node>::erase_min(BNode *node, BNode *&min_node)
+{
+    if (node -> left == nullptr)
+    {
+        min_node = node;
+        return node -> right;
     }
+    node -> left = erase_min(node -> left, min_node);
+    return rebalance(node);
+}
+
+template <class T, class Node>
+typename AVL<T, Node>::BNode* AVL<T, Node>::erase_impl(const T &value, BNode *node, bool &erased)
+{
+    if (node == nullptr)
+        return nullptr;
     if (value > node -> value)
     {
-        node -> right = insert_impl(value, node -> right);
-        if (!is_balance_impl(node))
+        node -> right = erase_impl(value, node -> right, erased);
+    }
+    else if (value < node -> value)
+    {
+        node -> left = erase_impl(value, node -> left, erased);
+    }
+    else
+    {
+        erased = true;
+        auto left = node -> left;
+        auto right = node -> right;
+        delete node;
+        if (right == nullptr)
+            return left;
+        // 用右子树的最小结点顶替被删除的结点
+        BNode *min_node = nullptr;
+        right = erase_min(right, min_node);
+        min_node -> left = left;
+        min_node -> right = right;
+        return rebalance(min_node);
+    }
+    return rebalance(node);
+}
+
+template <class T, class Node>
+pair<typename AVL<T, Node>::BNode*, bool> AVL<T, Node>::select(size_t k)
+{
+    auto node = root;
+    while (node != nullptr)
+    {
+        auto left_size = node_size(node -> left);
+        if (k < left_size)
         {
-            if (value > node -> right -> value)
-            {
-                node = rr_rotate(node);
-            }
-            else 
-            {
-                node = rl_rotate(node);
-            }
+            node = node -> left;
+        }
+        else if (k == left_size)
+        {
+            return {node, true};
+        }
+        else
+        {
+            k -= left_size + 1;
+            node = node -> right;
         }
     }
-    else 
+    return {nullptr, false};
+}
+
+template <class T, class Node>
+size_t AVL<T, Node>::rank(const T &value)
+{
+    size_t result = 0;
+    auto node = root;
+    while (node != nullptr)
     {
-        node -> left = insert_impl(value, node -> left);
-        if (!is_balance_impl(node))
+        if (value > node -> value)
         {
-            if (value > node -> left -> value)
-            {
-                node = lr_rotate(node);
-            }
-            else 
-            {
-                node = ll_rotate(node);
-            }
+            result += node_size(node -> left) + 1;
+            node = node -> right;
+        }
+        else
+        {
+            node = node -> left;
         }
-    
     }
-    return node;
-    
+    return result;
 }
 
-template <class T>
-bool AVL<T>::is_balance_impl(BNode *node)
+template <class T, class Node>
+bool AVL<T, Node>::is_balance_impl(BNode *node)
 {
     if (node == nullptr) return true;
-    int lh = AVL<T>::get_height_impl(node -> left);
-    int rh = AVL<T>::get_height_impl(node -> right);
-    if (abs(lh - rh) < 2) return true;
-    else return false;
+    if (abs(node_height(node -> left) - node_height(node -> right)) > 1) return false;
     return is_balance_impl(node -> left) && is_balance_impl(node -> right);
     
 }
 
 
 
+// 区间 [low, high)，按 (low, high) 排序，作为 IntervalTree 的元素
+template <class K>
+struct Interval
+{
+    K low;
+    K high;
+
+    bool operator<(const Interval &rhs) const
+    {
+        return low < rhs.low || (!(rhs.low < low) && high < rhs.high);
+    }
+    bool operator>(const Interval &rhs) const { return rhs < *this; }
+    bool operator==(const Interval &rhs) const { return !(*this < rhs) && !(rhs < *this); }
+
+    // 半开区间相交：两者都在对方结束之前开始
+    bool overlaps(const K &lo, const K &hi) const { return low < hi && lo < high; }
+    bool contains(const K &point) const { return !(point < low) && point < high; }
+};
+
+// 区间树结点：在 AVL 结点的基础上缓存子树中最大的右端点
+template <class K>
+class IntervalNode
+{
+public:
+    Interval<K> value;
+    IntervalNode* left;
+    IntervalNode* right;
+    int height;
+    size_t size;
+    K max_high;
+
+public:
+    IntervalNode(const Interval<K> &value)
+        : value(value), left(nullptr), right(nullptr), height(1), size(1), max_high(value.high) {}
+    ~IntervalNode() = default;
+};
+
+template <class K>
+void update_avl_node(IntervalNode<K> *node)
+{
+    update_avl_height_size(node);
+    node -> max_high = node -> value.high;
+    if (node -> left && node -> max_high < node -> left -> max_high)
+        node -> max_high = node -> left -> max_high;
+    if (node -> right && node -> max_high < node -> right -> max_high)
+        node -> max_high = node -> right -> max_high;
+}
+
+// 动态区间树：按左端点排序的 AVL，旋转时顺带维护子树最大右端点
+// 查询时左子树 max_high 不超过查询起点就整棵剪掉，右子树左端点不小于查询终点也整棵剪掉
+// 每个命中的区间最多带来一条 O(log n) 的搜索路径，所以 k 个命中时复杂度为 O(min(n, (k + 1) log n))，
+// 而不是 O(log n + k)：命中的结点可能分散在树的各处，之间的路径无法合并
+template <class K>
+class IntervalTree : public AVL<Interval<K>, IntervalNode<K>>
+{
+private:
+    typedef AVL<Interval<K>, IntervalNode<K>> base_type;
+    typedef typename base_type::BNode BNode;
+    using base_type::root;
+public:
+    typedef Interval<K> interval_type;
+
+    IntervalTree() = default;
+    IntervalTree(const initializer_list<interval_type> &li) : base_type(li) {}
+
+public:
+    using base_type::insert;
+    using base_type::erase;
+    BNode* insert(const K &low, const K &high) { return insert(interval_type{low, high}); }
+    bool erase(const K &low, const K &high) { return erase(interval_type{low, high}); }
+
+    // 把所有与 [low, high) 相交的区间按左端点顺序写入 result，返回写入结束的位置
+    template <class OutputIter>
+    OutputIter overlap_query(const K &low, const K &high, OutputIter result)
+    {
+        overlap_impl(root, low, high, result);
+        return result;
+    }
+
+    // 把所有包含 point 的区间写入 result
+    template <class OutputIter>
+    OutputIter stab_query(const K &point, OutputIter result)
+    {
+        stab_impl(root, point, result);
+        return result;
+    }
+
+private:
+    template <class OutputIter>
+    void overlap_impl(BNode *node, const K &low, const K &high, OutputIter &result);
+    template <class OutputIter>
+    void stab_impl(BNode *node, const K &point, OutputIter &result);
+};
+
+template <class K>
+template <class OutputIter>
+void IntervalTree<K>::overlap_impl(BNode *node, const K &low, const K &high, OutputIter &result)
+{
+    if (node == nullptr || !(low < node -> max_high))
+        return;
+    overlap_impl(node -> left, low, high, result);
+    if (!(node -> value.low < high))
+        return;
+    if (node -> value.overlaps(low, high))
+        *result++ = node -> value;
+    overlap_impl(node -> right, low, high, result);
+}
+
+template <class K>
+template <class OutputIter>
+void IntervalTree<K>::stab_impl(BNode *node, const K &point, OutputIter &result)
+{
+    if (node == nullptr || !(point < node -> max_high))
+        return;
+    stab_impl(node -> left, point, result);
+    if (point < node -> value.low)
+        return;
+    if (node -> value.contains(point))
+        *result++ = node -> value;
+    stab_impl(node -> right, point, result);
+}
+
+// 静态区间树：面向构建后不再修改的区间集合
+// 区间按左端点排好序放在连续数组里，以 [l, r) 的中点作为隐式平衡树的根，
+// max_high[m] 记录这棵隐式子树的最大右端点。没有结点指针，查询时访存连续
+// 剪枝规则与 IntervalTree 相同，查询复杂度同样是 O(min(n, (k + 1) log n))
+template <class K>
+class StaticIntervalTree
+{
+public:
+    typedef Interval<K> interval_type;
+
+    StaticIntervalTree() = default;
+    StaticIntervalTree(vector<interval_type> intervals) : items(std::move(intervals))
+    {
+        build();
+    }
+    template <class InputIter>
+    StaticIntervalTree(InputIter first, InputIter last) : items(first, last)
+    {
+        build();
+    }
+
+public:
+    size_t size() const { return items.size(); }
+
+    template <class OutputIter>
+    OutputIter overlap_query(const K &low, const K &high, OutputIter result) const
+    {
+        overlap_impl(0, items.size(), low, high, result);
+        return result;
+    }
+
+    template <class OutputIter>
+    OutputIter stab_query(const K &point, OutputIter result) const
+    {
+        stab_impl(0, items.size(), point, result);
+        return result;
+    }
+
+private:
+    vector<interval_type> items;
+    vector<K> max_high;
+
+    void build()
+    {
+        sort(items.begin(), items.end());
+        max_high.resize(items.size());
+        if (!items.empty())
+            build_impl(0, items.size());
+    }
+
+    const K& build_impl(size_t l, size_t r);
+    template <class OutputIter>
+    void overlap_impl(size_t l, size_t r, const K &low, const K &high, OutputIter &result) const;
+    template <class OutputIter>
+    void stab_impl(size_t l, size_t r, const K &point, OutputIter &result) const;
+};
+
+template <class K>
+const K& StaticIntervalTree<K>::build_impl(size_t l, size_t r)
+{
+    size_t m = l + (r - l) / 2;
+    max_high[m] = items[m].high;
+    if (l < m)
+    {
+        const K &left = build_impl(l, m);
+        if (max_high[m] < left)
+            max_high[m] = left;
+    }
+    if (m + 1 < r)
+    {
+        const K &right = build_impl(m + 1, r);
+        if (max_high[m] < right)
+            max_high[m] = right;
+    }
+    return max_high[m];
+}
+
+template <class K>
+template <class OutputIter>
+void StaticIntervalTree<K>::overlap_impl(size_t l, size_t r, const K &low, const K &high,
+                                         OutputIter &result) const
+{
+    if (l >= r)
+        return;
+    size_t m = l + (r - l) / 2;
+    if (!(low < max_high[m]))
+        return;
+    overlap_impl(l, m, low, high, result);
+    if (!(items[m].low < high))
+        return;
+    if (items[m].overlaps(low, high))
+        *result++ = items[m];
+    overlap_impl(m + 1, r, low, high, result);
+}
+
+template <class K>
+template <class OutputIter>
+void StaticIntervalTree<K>::stab_impl(size_t l, size_t r, const K &point, OutputIter &result) const
+{
+    if (l >= r)
+        return;
+    size_t m = l + (r - l) / 2;
+    if (!(point < max_high[m]))
+        return;
+    stab_impl(l, m, point, result);
+    if (point < items[m].low)
+        return;
+    if (items[m].contains(point))
+        *result++ = items[m];
+    stab_impl(m + 1, r, point, result);
+}
+
+
+
 #endif
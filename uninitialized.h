@@ -38,7 +38,7 @@ unchecked_uninit_copy(InputIter first, InputIter last, ForwardIter result, std::
     {
         // 中途创建失败就全部销毁
         for(; result != cur; ++result)
-            MyStl:destroy(&*result);
+            MyStl::destroy(&*result);
         throw;
     }
     return cur;
@@ -91,10 +91,10 @@ template <class InputIter, class Size, class ForwardIter>
 ForwardIter
 uninitialized_copy_n(InputIter first, Size n, ForwardIter result) 
 {
-    return unchecked_copy_n(first, n, result,
-                            std::is_trivially_copy_assignable<
-                            typename MyStl::iterator_traits<ForwardIter>::
-                            value_type>{});
+    return unchecked_uninit_copy_n(first, n, result,
+                                   std::is_trivially_copy_assignable<
+                                   typename MyStl::iterator_traits<ForwardIter>::
+                                   value_type>{});
 }
 
 
@@ -181,7 +181,7 @@ template <class ForwardIter, class Size, class T>
 ForwardIter
 uninitialized_fill_n(ForwardIter first, Size n, const T &value)
 {
-    return uncehcked_uninit_fill_n(first, n, value,
+    return unchecked_uninit_fill_n(first, n, value,
                                    std::is_trivially_copy_assignable<
                                    typename MyStl::iterator_traits<ForwardIter>::
                                    value_type>{});
@@ -217,6 +217,7 @@ unchecked_uninit_move(InputIter first, InputIter last, ForwardIter result, std::
         MyStl::destroy(result, cur);
         throw;
     }
+    return cur;
 }
 
 template <class InputIter, class ForwardIter>